@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "DirectorySnapshot.h"
+#include "FileSystem.h"
+
+namespace {
+struct DirectorySnapshotFix : testing::Test {
+  void SetUp() override {
+    std::filesystem::remove_all(rootPath);
+    std::filesystem::create_directories(rootPath / "src" / "detail");
+    writeFile(rootPath / "main.cpp", "int main() {}");
+    writeFile(rootPath / "src" / "a.cpp", "a");
+    writeFile(rootPath / "src" / "a.h", "a");
+    writeFile(rootPath / "src" / "detail" / "b.cpp", "bb");
+    writeFile(rootPath / "readme.txt", "text");
+
+    // last written long enough ago to be kept by the snapshot
+    for(const std::filesystem::path& path : {rootPath, rootPath / "src", rootPath / "src" / "detail"}) {
+      setToPast(path);
+    }
+  }
+
+  void TearDown() override {
+    std::filesystem::remove_all(rootPath);
+  }
+
+  static void writeFile(const std::filesystem::path& path, const std::string& text) {
+    std::ofstream(path) << text;
+  }
+
+  static void setToPast(const std::filesystem::path& path) {
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+  }
+
+  std::vector<std::wstring> getFilePaths(DirectorySnapshot* snapshot) const {
+    std::vector<std::wstring> filePaths;
+    for(const FilePath& filePath :
+        FileSystem::getFilePathsFromPaths({FilePath(rootPath.wstring())}, {L".cpp", L".h"}, snapshot)) {
+      filePaths.push_back(filePath.wstr());
+    }
+    return filePaths;
+  }
+
+  std::wstring getCanonical(const std::filesystem::path& path) const {
+    return FilePath(path.wstring()).getCanonical().wstr();
+  }
+
+  const std::filesystem::path rootPath = std::filesystem::temp_directory_path() / "DirectorySnapshotTestSuite";
+};
+}    // namespace
+
+TEST_F(DirectorySnapshotFix, findsSameFilesAsFileInfos) {
+  const std::vector<FileInfo> fileInfos = FileSystem::getFileInfosFromPaths({FilePath(rootPath.wstring())}, {L".cpp", L".h"});
+  const std::vector<std::wstring> filePaths = getFilePaths(nullptr);
+
+  ASSERT_EQ(4, fileInfos.size());
+  ASSERT_EQ(4, filePaths.size());
+  for(size_t i = 0; i < fileInfos.size(); i++) {
+    EXPECT_EQ(fileInfos[i].path.wstr(), filePaths[i]);
+  }
+
+  const auto it = std::find_if(fileInfos.begin(), fileInfos.end(), [this](const FileInfo& fileInfo) {
+    return fileInfo.path.wstr() == getCanonical(rootPath / "src" / "detail" / "b.cpp");
+  });
+  ASSERT_TRUE(it != fileInfos.end());
+  EXPECT_TRUE(it->lastWriteTime.isValid());
+}
+
+TEST_F(DirectorySnapshotFix, listsUnchangedDirectoriesFromSnapshot) {
+  DirectorySnapshot snapshot;
+  EXPECT_EQ(4, getFilePaths(&snapshot).size());
+  EXPECT_EQ(3, snapshot.getDirectoryCount());
+
+  // a new file without a new last write time of its directory stays unnoticed
+  const auto lastWriteTime = std::filesystem::last_write_time(rootPath / "src");
+  writeFile(rootPath / "src" / "c.cpp", "c");
+  std::filesystem::last_write_time(rootPath / "src", lastWriteTime);
+  EXPECT_EQ(4, getFilePaths(&snapshot).size());
+  EXPECT_EQ(3, snapshot.getDirectoryCount());
+
+  std::filesystem::last_write_time(rootPath / "src", lastWriteTime + std::chrono::minutes(1));
+  EXPECT_EQ(5, getFilePaths(&snapshot).size());
+}
+
+TEST_F(DirectorySnapshotFix, doesNotKeepRecentlyWrittenDirectories) {
+  DirectorySnapshot snapshot;
+  writeFile(rootPath / "src" / "detail" / "c.cpp", "c");
+  getFilePaths(&snapshot);
+
+  EXPECT_EQ(2, snapshot.getDirectoryCount());
+}
+
+TEST_F(DirectorySnapshotFix, savesAndLoadsDirectories) {
+  const FilePath snapshotFilePath((rootPath / "snapshot.srctrlfs").wstring());
+  {
+    DirectorySnapshot snapshot;
+    getFilePaths(&snapshot);
+    EXPECT_TRUE(snapshot.save(snapshotFilePath));
+  }
+
+  std::shared_ptr<DirectorySnapshot> snapshot = DirectorySnapshot::load(snapshotFilePath);
+  EXPECT_EQ(3, snapshot->getDirectoryCount());
+  EXPECT_EQ(4, getFilePaths(snapshot.get()).size());
+}
+
+TEST_F(DirectorySnapshotFix, loadsEmptySnapshotWithoutFile) {
+  EXPECT_EQ(0, DirectorySnapshot::load(FilePath((rootPath / "missing.srctrlfs").wstring()))->getDirectoryCount());
+}
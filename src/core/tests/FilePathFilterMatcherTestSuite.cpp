@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "FilePathFilter.h"
+#include "FilePathFilterMatcher.h"
+
+TEST(FilePathFilterMatcher, matchesIfAnyFilterMatches) {
+  FilePathFilterMatcher matcher(std::vector<FilePathFilter> {FilePathFilter(L"root/**/test.h"), FilePathFilter(L"*/build/*")});
+
+  EXPECT_TRUE(matcher.isMatching(FilePath(L"root/folder1/folder2/test.h")));
+  EXPECT_TRUE(matcher.isMatching(FilePath(L"project/build/main.o")));
+  EXPECT_FALSE(matcher.isMatching(FilePath(L"project/build/obj/main.o")));
+  EXPECT_FALSE(matcher.isMatching(FilePath(L"root/folder1/test.cpp")));
+  EXPECT_TRUE(matcher.isDeterministic());
+}
+
+TEST(FilePathFilterMatcher, matchesNothingWithoutFilters) {
+  FilePathFilterMatcher matcher(std::vector<FilePathFilter> {});
+
+  EXPECT_FALSE(matcher.isMatching(FilePath(L"test.h")));
+  EXPECT_FALSE(matcher.isMatching(std::wstring()));
+}
+
+TEST(FilePathFilterMatcher, matchesSlashesAndBackslashesAlike) {
+  FilePathFilterMatcher matcher(std::vector<FilePathFilter> {FilePathFilter(L"folder\\*.h")});
+
+  EXPECT_TRUE(matcher.isMatching(FilePath(L"folder/test.h")));
+  EXPECT_TRUE(matcher.isMatching(FilePath(L"folder\\test.h")));
+}
+
+TEST(FilePathFilterMatcher, usesRegexForFiltersThatCanNotBeCompiled) {
+  FilePathFilterMatcher matcher(std::vector<FilePathFilter> {FilePathFilter(L"folder/test[.h"), FilePathFilter(L"**.cpp")});
+
+  EXPECT_EQ(1, matcher.getCompiledFilterCount());
+  EXPECT_TRUE(matcher.isMatching(FilePath(L"folder/test[.h")));
+  EXPECT_TRUE(matcher.isMatching(FilePath(L"folder/test.cpp")));
+  EXPECT_FALSE(matcher.isMatching(FilePath(L"folder/test.h")));
+}
+
+TEST(FilePathFilterMatcher, agreesWithSingleFilters) {
+  const std::vector<std::wstring> filterStrings = {L"test.h",
+                                                   L"*test.*",
+                                                   L"*/this_is_a_test.h",
+                                                   L"**test.h",
+                                                   L"root/**/test.h",
+                                                   L"**/test.h",
+                                                   L"folder/test+.h",
+                                                   L"folder/test$.h",
+                                                   L"folder/test(.h",
+                                                   L"folder\\test{}.h",
+                                                   L"/usr/include/**",
+                                                   L"*/*/*.*"};
+  const std::vector<std::wstring> paths = {L"test.h",
+                                           L"testyh",
+                                           L"this_is_a_test.h",
+                                           L"folder/this_is_a_test.h",
+                                           L"root/folder1/folder2/test.h",
+                                           L"root/test.h",
+                                           L"folder/test+.h",
+                                           L"folder/test$.h",
+                                           L"folder\\test(.h",
+                                           L"folder/test{}.h",
+                                           L"/usr/include/stdio.h",
+                                           L"/usr/include",
+                                           L"a/b/c.d",
+                                           L"a/b/c/d.e"};
+
+  for(const std::wstring& filterString : filterStrings) {
+    const FilePathFilter filter(filterString);
+    const FilePathFilterMatcher matcher(std::vector<FilePathFilter> {filter});
+    for(const std::wstring& path : paths) {
+      EXPECT_EQ(filter.isMatching(path), matcher.isMatching(path));
+    }
+  }
+}
@@ -1,6 +1,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+
 #include "TextAccess.h"
 
 namespace {
@@ -96,6 +99,33 @@ TEST(TextAccess, textAccessStringAllLines) {
   EXPECT_EQ(lineCount, lines.size());
 }
 
+TEST(TextAccess, textAccessLinesAreKeptAsTheyAre) {
+  const auto textAccess = TextAccess::createFromLines({"first", "second\n", ""});
+
+  ASSERT_EQ(3, textAccess->getLineCount());
+  EXPECT_THAT(textAccess->getLine(1), testing::StrEq("first"));
+  EXPECT_THAT(textAccess->getLine(2), testing::StrEq("second\n"));
+  EXPECT_THAT(textAccess->getLine(3), testing::StrEq(""));
+  EXPECT_THAT(textAccess->getText(), testing::StrEq("firstsecond\n"));
+}
+
+TEST(TextAccess, textAccessFileLineEndingsAreNormalized) {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "TextAccessTestSuite.txt";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "windows\r\nmac\rlast";
+  }
+
+  const auto textAccess = TextAccess::createFromFile(FilePath(path.wstring()));
+  std::filesystem::remove(path);
+
+  ASSERT_EQ(3, textAccess->getLineCount());
+  EXPECT_THAT(textAccess->getLine(1), testing::StrEq("windows\n"));
+  EXPECT_THAT(textAccess->getLine(2), testing::StrEq("mac\n"));
+  EXPECT_THAT(textAccess->getLine(3), testing::StrEq("last\n"));
+  EXPECT_THAT(textAccess->getText(), testing::StrEq("windows\nmac\nlast\n"));
+}
+
 class TextAccessFix : public testing::Test {
 public:
   void SetUp() override {
@@ -1,117 +1,31 @@
 #include "HierarchyCache.h"
 
-#include "utility.h"
+#include <algorithm>
 
-HierarchyCache::HierarchyNode::HierarchyNode(Id nodeId)
-    : m_nodeId(nodeId), m_edgeId(0), m_parent(nullptr), m_isVisible(true), m_isImplicit(false) {}
-
-Id HierarchyCache::HierarchyNode::getNodeId() const {
-  return m_nodeId;
-}
-
-Id HierarchyCache::HierarchyNode::getEdgeId() const {
-  return m_edgeId;
-}
-
-void HierarchyCache::HierarchyNode::setEdgeId(Id edgeId) {
-  m_edgeId = edgeId;
-}
-
-HierarchyCache::HierarchyNode* HierarchyCache::HierarchyNode::getParent() const {
-  return m_parent;
-}
-
-void HierarchyCache::HierarchyNode::setParent(HierarchyNode* parent) {
-  m_parent = parent;
-}
-
-void HierarchyCache::HierarchyNode::addBase(HierarchyNode* base, Id edgeId) {
-  m_bases.push_back(base);
-  m_baseEdgeIds.push_back(edgeId);
-}
-
-void HierarchyCache::HierarchyNode::addChild(HierarchyNode* child) {
-  m_children.push_back(child);
-}
-
-size_t HierarchyCache::HierarchyNode::getChildrenCount() const {
-  return m_children.size();
-}
-
-size_t HierarchyCache::HierarchyNode::getNonImplicitChildrenCount() const {
-  size_t count = 0;
-  for(const HierarchyNode* child : m_children) {
-    if(!child->isImplicit()) {
-      count++;
-    }
-  }
-  return count;
-}
-
-void HierarchyCache::HierarchyNode::addChildIds(std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const {
-  for(const HierarchyNode* child : m_children) {
-    nodeIds->push_back(child->getNodeId());
-    edgeIds->push_back(child->getEdgeId());
-  }
-}
-
-void HierarchyCache::HierarchyNode::addNonImplicitChildIds(std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const {
-  for(const HierarchyNode* child : m_children) {
-    if(!child->isImplicit()) {
-      nodeIds->push_back(child->getNodeId());
-      edgeIds->push_back(child->getEdgeId());
-    }
-  }
-}
-
-void HierarchyCache::HierarchyNode::addChildIdsRecursive(std::set<Id>* nodeIds, std::set<Id>* edgeIds) const {
-  for(const HierarchyNode* child : m_children) {
-    nodeIds->insert(child->getNodeId());
-    edgeIds->insert(child->getEdgeId());
-
-    child->addChildIdsRecursive(nodeIds, edgeIds);
-  }
-}
-
-bool HierarchyCache::HierarchyNode::isVisible() const {
-  return m_isVisible;
-}
-
-void HierarchyCache::HierarchyNode::setIsVisible(bool isVisible) {
-  m_isVisible = isVisible;
-}
-
-bool HierarchyCache::HierarchyNode::isImplicit() const {
-  return m_isImplicit;
-}
-
-void HierarchyCache::HierarchyNode::setIsImplicit(bool isImplicit) {
-  m_isImplicit = isImplicit;
-}
+void HierarchyCache::clear() {
+  std::lock_guard<std::mutex> lock(m_layoutMutex);
 
-std::map</*target*/ Id, std::vector<std::pair</*source*/ Id, /*edge*/ Id>>> HierarchyCache::HierarchyNode::
-    getReverseReachableInheritanceSubgraph() const {
-  std::map<Id, std::vector<std::pair<Id, Id>>> reverseGraph;
-  reverseGraph.try_emplace(getNodeId());    // mark start node as visited
-  getReverseReachableInheritanceSubgraphHelper(reverseGraph);
-  return reverseGraph;
-}
+  m_indices.clear();
 
-void HierarchyCache::HierarchyNode::getReverseReachableInheritanceSubgraphHelper(
-    std::map</*target*/ Id, std::vector<std::pair</*source*/ Id, /*edge*/ Id>>>& reverseGraph) const {
-  for(size_t i = 0; i < m_bases.size(); ++i) {
-    HierarchyNode* base = m_bases[i];
-    auto emplacedBase = reverseGraph.try_emplace(base->getNodeId());
-    emplacedBase.first->second.push_back({getNodeId(), m_baseEdgeIds[i]});
-    if(emplacedBase.second) {
-      base->getReverseReachableInheritanceSubgraphHelper(reverseGraph);
-    }
-  }
-}
+  m_nodeIds.clear();
+  m_edgeIds.clear();
+  m_parents.clear();
+  m_connectionOrders.clear();
+  m_flags.clear();
+  m_connectionCount = 0;
+  m_inheritances.clear();
 
+  m_childOffsets.clear();
+  m_children.clear();
+  m_baseOffsets.clear();
+  m_bases.clear();
+  m_tour.clear();
+  m_tourBegins.clear();
+  m_tourEnds.clear();
+  m_lastVisibleParents.clear();
+  m_indicesOfLastVisibleParents.clear();
 
-void HierarchyCache::clear() {
-  m_nodes.clear();
+  m_layoutDirty = false;
 }
 
 void HierarchyCache::createConnection(Id edgeId, Id fromId, Id toId, bool sourceVisible, bool sourceImplicit, bool targetImplicit) {
@@ -119,17 +33,17 @@ void HierarchyCache::createConnection(Id edgeId, Id fromId, Id toId, bool source
     return;
   }
 
-  HierarchyNode* from = createNode(fromId);
-  HierarchyNode* to = createNode(toId);
+  const uint32_t from = createIndex(fromId);
+  const uint32_t to = createIndex(toId);
 
-  from->addChild(to);
-  to->setParent(from);
+  m_parents[to] = from;
+  m_connectionOrders[to] = m_connectionCount++;
+  m_edgeIds[to] = edgeId;
 
-  from->setIsVisible(sourceVisible);
-  from->setIsImplicit(sourceImplicit);
+  m_flags[from] = (sourceVisible ? NODE_FLAG_VISIBLE : 0) | (sourceImplicit ? NODE_FLAG_IMPLICIT : 0);
+  m_flags[to] = (m_flags[to] & ~NODE_FLAG_IMPLICIT) | (targetImplicit ? NODE_FLAG_IMPLICIT : 0);
 
-  to->setEdgeId(edgeId);
-  to->setIsImplicit(targetImplicit);
+  m_layoutDirty = true;
 }
 
 void HierarchyCache::createInheritance(Id edgeId, Id fromId, Id toId) {
@@ -137,134 +51,131 @@ void HierarchyCache::createInheritance(Id edgeId, Id fromId, Id toId) {
     return;
   }
 
-  HierarchyNode* from = createNode(fromId);
-  HierarchyNode* to = createNode(toId);
+  const uint32_t from = createIndex(fromId);
+  const uint32_t to = createIndex(toId);
 
-  from->addBase(to, edgeId);
+  m_inheritances.push_back({from, to, edgeId});
+
+  m_layoutDirty = true;
 }
 
 Id HierarchyCache::getLastVisibleParentNodeId(Id nodeId) const {
-  HierarchyNode* node = nullptr;
-  HierarchyNode* parent = getNode(nodeId);
-
-  while(parent && parent->isVisible()) {
-    node = parent;
-    parent = node->getParent();
-
-    nodeId = node->getNodeId();
+  const uint32_t index = getIndex(nodeId);
+  if(index == s_noIndex) {
+    return nodeId;
   }
 
-  return nodeId;
+  updateLayout();
+  return m_nodeIds[m_lastVisibleParents[index]];
 }
 
 size_t HierarchyCache::getIndexOfLastVisibleParentNode(Id nodeId) const {
-  HierarchyNode* node = nullptr;
-  HierarchyNode* parent = getNode(nodeId);
-
-  size_t idx = 0;
-  bool visible = false;
-
-  while(parent) {
-    node = parent;
-    parent = node->getParent();
-
-    if(node->isVisible() && !idx) {
-      visible = true;
-    } else if(visible) {
-      idx++;
-    }
+  const uint32_t index = getIndex(nodeId);
+  if(index == s_noIndex) {
+    return 0;
   }
 
-  return idx;
+  updateLayout();
+  return m_indicesOfLastVisibleParents[index];
 }
 
 void HierarchyCache::addAllVisibleParentIdsForNodeId(Id nodeId, std::set<Id>* nodeIds, std::set<Id>* edgeIds) const {
-  HierarchyNode* node = getNode(nodeId);
-  Id edgeId = 0;
-  while(node && node->isVisible()) {
-    if(edgeId) {
-      edgeIds->insert(edgeId);
-    }
+  uint32_t index = getIndex(nodeId);
+  if(index == s_noIndex || !isVisible(index)) {
+    return;
+  }
 
-    nodeIds->insert(node->getNodeId());
-    edgeId = node->getEdgeId();
+  // ending at the last visible parent of the layout also ends the walk where a cycle of parents was broken up
+  updateLayout();
+  const uint32_t lastVisibleParent = m_lastVisibleParents[index];
 
-    node = node->getParent();
+  nodeIds->insert(m_nodeIds[index]);
+  while(index != lastVisibleParent) {
+    edgeIds->insert(m_edgeIds[index]);
+    index = m_parents[index];
+    nodeIds->insert(m_nodeIds[index]);
   }
 }
 
 void HierarchyCache::addAllChildIdsForNodeId(Id nodeId, std::set<Id>* nodeIds, std::set<Id>* edgeIds) const {
-  HierarchyNode* node = getNode(nodeId);
-  if(node && node->isVisible()) {
-    node->addChildIdsRecursive(nodeIds, edgeIds);
+  const uint32_t index = getIndex(nodeId);
+  if(index == s_noIndex || !isVisible(index)) {
+    return;
+  }
+
+  updateLayout();
+  for(uint32_t i = m_tourBegins[index] + 1; i < m_tourEnds[index]; i++) {
+    const uint32_t child = m_tour[i];
+    nodeIds->insert(m_nodeIds[child]);
+    edgeIds->insert(m_edgeIds[child]);
   }
 }
 
 void HierarchyCache::addFirstChildIdsForNodeId(Id nodeId, std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const {
-  HierarchyNode* node = getNode(nodeId);
-  if(node) {
-    if(node->isImplicit()) {
-      node->addChildIds(nodeIds, edgeIds);
-    } else {
-      node->addNonImplicitChildIds(nodeIds, edgeIds);
+  const uint32_t index = getIndex(nodeId);
+  if(index == s_noIndex) {
+    return;
+  }
+
+  updateLayout();
+  const bool addImplicit = isImplicit(index);
+  for(uint32_t i = m_childOffsets[index]; i < m_childOffsets[index + 1]; i++) {
+    const uint32_t child = m_children[i];
+    if(addImplicit || !isImplicit(child)) {
+      nodeIds->push_back(m_nodeIds[child]);
+      edgeIds->push_back(m_edgeIds[child]);
     }
   }
 }
 
 size_t HierarchyCache::getFirstChildIdsCountForNodeId(Id nodeId) const {
-  HierarchyNode* node = getNode(nodeId);
-  if(node) {
-    if(node->isImplicit()) {
-      return node->getChildrenCount();
-    } else {
-      return node->getNonImplicitChildrenCount();
-    }
+  const uint32_t index = getIndex(nodeId);
+  if(index == s_noIndex) {
+    return 0;
+  }
+
+  updateLayout();
+  if(isImplicit(index)) {
+    return m_childOffsets[index + 1] - m_childOffsets[index];
   }
-  return 0;
+
+  return static_cast<size_t>(std::count_if(m_children.begin() + m_childOffsets[index],
+                                           m_children.begin() + m_childOffsets[index + 1],
+                                           [this](uint32_t child) { return !isImplicit(child); }));
 }
 
 bool HierarchyCache::isChildOfVisibleNodeOrInvisible(Id nodeId) const {
-  HierarchyNode* node = getNode(nodeId);
-  if(!node) {
+  const uint32_t index = getIndex(nodeId);
+  if(index == s_noIndex) {
     return false;
   }
 
-  if(!node->isVisible()) {
-    return true;
-  }
-
-  if(node->getParent() && node->getParent()->isVisible()) {
+  if(!isVisible(index)) {
     return true;
   }
 
-  return false;
+  const uint32_t parent = m_parents[index];
+  return parent != s_noIndex && isVisible(parent);
 }
 
 bool HierarchyCache::nodeHasChildren(Id nodeId) const {
-  HierarchyNode* node = getNode(nodeId);
-  if(node) {
-    return node->getChildrenCount();
+  const uint32_t index = getIndex(nodeId);
+  if(index == s_noIndex) {
+    return false;
   }
 
-  return false;
+  updateLayout();
+  return m_childOffsets[index + 1] > m_childOffsets[index];
 }
 
 bool HierarchyCache::nodeIsVisible(Id nodeId) const {
-  HierarchyNode* node = getNode(nodeId);
-  if(node) {
-    return node->isVisible();
-  }
-
-  return false;
+  const uint32_t index = getIndex(nodeId);
+  return index != s_noIndex && isVisible(index);
 }
 
 bool HierarchyCache::nodeIsImplicit(Id nodeId) const {
-  HierarchyNode* node = getNode(nodeId);
-  if(node) {
-    return node->isImplicit();
-  }
-
-  return false;
+  const uint32_t index = getIndex(nodeId);
+  return index != s_noIndex && isImplicit(index);
 }
 
 std::vector<std::tuple</*source*/ Id, /*target*/ Id, std::vector</*edge*/ Id>>> HierarchyCache::getInheritanceEdgesForNodeId(
@@ -297,12 +208,13 @@ std::vector<std::tuple</*source*/ Id, /*target*/ Id, std::vector</*edge*/ Id>>>
     return inheritanceEdges;
   }
 
-  HierarchyNode* sourceNode = getNode(sourceId);
-  if(!sourceNode) {
+  const uint32_t sourceIndex = getIndex(sourceId);
+  if(sourceIndex == s_noIndex) {
     return inheritanceEdges;
   }
 
-  std::map<Id, std::vector<std::pair<Id, Id>>> reverseGraph = sourceNode->getReverseReachableInheritanceSubgraph();
+  updateLayout();
+  std::map<Id, std::vector<std::pair<Id, Id>>> reverseGraph = getReverseReachableInheritanceSubgraph(sourceIndex);
 
   for(Id targetId : targetIds) {
     std::set<Id> nodes;
@@ -338,22 +250,176 @@ void HierarchyCache::getReverseReachable(Id nodeId,
   }
 }
 
-HierarchyCache::HierarchyNode* HierarchyCache::getNode(Id nodeId) const {
-  auto it = m_nodes.find(nodeId);
+std::map</*target*/ Id, std::vector<std::pair</*source*/ Id, /*edge*/ Id>>> HierarchyCache::
+    getReverseReachableInheritanceSubgraph(uint32_t index) const {
+  std::map<Id, std::vector<std::pair<Id, Id>>> reverseGraph;
+  reverseGraph.try_emplace(m_nodeIds[index]);    // mark start node as visited
+  getReverseReachableInheritanceSubgraphHelper(index, reverseGraph);
+  return reverseGraph;
+}
 
-  if(it != m_nodes.end()) {
-    return it->second.get();
+void HierarchyCache::getReverseReachableInheritanceSubgraphHelper(
+    uint32_t index, std::map</*target*/ Id, std::vector<std::pair</*source*/ Id, /*edge*/ Id>>>& reverseGraph) const {
+  for(uint32_t i = m_baseOffsets[index]; i < m_baseOffsets[index + 1]; i++) {
+    const auto& [base, edgeId] = m_bases[i];
+    auto emplacedBase = reverseGraph.try_emplace(m_nodeIds[base]);
+    emplacedBase.first->second.push_back({m_nodeIds[index], edgeId});
+    if(emplacedBase.second) {
+      getReverseReachableInheritanceSubgraphHelper(base, reverseGraph);
+    }
   }
+}
+
+uint32_t HierarchyCache::getIndex(Id nodeId) const {
+  auto it = m_indices.find(nodeId);
+  return it != m_indices.end() ? it->second : s_noIndex;
+}
+
+uint32_t HierarchyCache::createIndex(Id nodeId) {
+  auto [it, inserted] = m_indices.emplace(nodeId, static_cast<uint32_t>(m_nodeIds.size()));
+  if(inserted) {
+    m_nodeIds.push_back(nodeId);
+    m_edgeIds.push_back(0);
+    m_parents.push_back(s_noIndex);
+    m_connectionOrders.push_back(0);
+    m_flags.push_back(NODE_FLAG_VISIBLE);
+  }
+  return it->second;
+}
+
+bool HierarchyCache::isVisible(uint32_t index) const {
+  return m_flags[index] & NODE_FLAG_VISIBLE;
+}
 
-  return nullptr;
+bool HierarchyCache::isImplicit(uint32_t index) const {
+  return m_flags[index] & NODE_FLAG_IMPLICIT;
 }
 
-HierarchyCache::HierarchyNode* HierarchyCache::createNode(Id nodeId) {
-  auto it = m_nodes.find(nodeId);
+void HierarchyCache::updateLayout() const {
+  if(!m_layoutDirty) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_layoutMutex);
+  if(!m_layoutDirty) {
+    return;
+  }
+
+  const uint32_t nodeCount = static_cast<uint32_t>(m_nodeIds.size());
+
+  // children rows, each in connection order
+  std::vector<uint32_t> connectedNodes;
+  for(uint32_t i = 0; i < nodeCount; i++) {
+    if(m_parents[i] != s_noIndex) {
+      connectedNodes.push_back(i);
+    }
+  }
+  std::sort(connectedNodes.begin(), connectedNodes.end(), [this](uint32_t a, uint32_t b) {
+    return m_connectionOrders[a] < m_connectionOrders[b];
+  });
+
+  m_childOffsets.assign(nodeCount + 1, 0);
+  for(uint32_t child : connectedNodes) {
+    m_childOffsets[m_parents[child] + 1]++;
+  }
+  for(uint32_t i = 0; i < nodeCount; i++) {
+    m_childOffsets[i + 1] += m_childOffsets[i];
+  }
+
+  std::vector<uint32_t> positions(m_childOffsets.begin(), m_childOffsets.end() - 1);
+  m_children.resize(connectedNodes.size());
+  for(uint32_t child : connectedNodes) {
+    m_children[positions[m_parents[child]]++] = child;
+  }
+
+  // base rows, each in creation order
+  m_baseOffsets.assign(nodeCount + 1, 0);
+  for(const Inheritance& inheritance : m_inheritances) {
+    m_baseOffsets[inheritance.from + 1]++;
+  }
+  for(uint32_t i = 0; i < nodeCount; i++) {
+    m_baseOffsets[i + 1] += m_baseOffsets[i];
+  }
+
+  positions.assign(m_baseOffsets.begin(), m_baseOffsets.end() - 1);
+  m_bases.resize(m_inheritances.size());
+  for(const Inheritance& inheritance : m_inheritances) {
+    m_bases[positions[inheritance.from]++] = {inheritance.to, inheritance.edgeId};
+  }
 
-  if(it == m_nodes.end()) {
-    it = m_nodes.emplace(nodeId, std::make_unique<HierarchyNode>(nodeId)).first;
+  // preorder tour, parents are always visited before their children
+  m_tour.clear();
+  m_tour.reserve(nodeCount);
+  m_tourBegins.assign(nodeCount, s_noIndex);
+  m_tourEnds.assign(nodeCount, 0);
+  m_lastVisibleParents.assign(nodeCount, s_noIndex);
+  m_indicesOfLastVisibleParents.assign(nodeCount, 0);
+
+  std::vector<uint32_t> depths(nodeCount, 0);
+  std::vector<uint32_t> firstVisibleNodes(nodeCount, s_noIndex);      // the node itself or its closest ancestor
+  std::vector<uint32_t> firstInvisibleNodes(nodeCount, s_noIndex);    // the node itself or its closest ancestor
+  std::vector<uint32_t> treeParents(nodeCount, s_noIndex);
+
+  std::vector<std::pair</*node*/ uint32_t, /*next child*/ uint32_t>> stack;
+  auto enter = [&](uint32_t index, uint32_t parent) {
+    const bool visible = isVisible(index);
+    treeParents[index] = parent;
+
+    if(parent == s_noIndex) {
+      m_lastVisibleParents[index] = index;
+      firstVisibleNodes[index] = visible ? index : s_noIndex;
+      firstInvisibleNodes[index] = visible ? s_noIndex : index;
+    } else {
+      depths[index] = depths[parent] + 1;
+      m_lastVisibleParents[index] = (visible && isVisible(parent)) ? m_lastVisibleParents[parent] : index;
+      firstVisibleNodes[index] = visible ? index : firstVisibleNodes[parent];
+      firstInvisibleNodes[index] = visible ? firstInvisibleNodes[parent] : index;
+    }
+
+    // counts the nodes from the first invisible ancestor of the first visible node up to the root
+    const uint32_t firstVisibleNode = firstVisibleNodes[index];
+    if(firstVisibleNode != s_noIndex && treeParents[firstVisibleNode] != s_noIndex) {
+      const uint32_t invisibleNode = firstInvisibleNodes[treeParents[firstVisibleNode]];
+      if(invisibleNode != s_noIndex) {
+        m_indicesOfLastVisibleParents[index] = depths[invisibleNode] + 1;
+      }
+    }
+
+    m_tourBegins[index] = static_cast<uint32_t>(m_tour.size());
+    m_tour.push_back(index);
+    stack.emplace_back(index, m_childOffsets[index]);
+  };
+
+  auto visitTree = [&](uint32_t root) {
+    enter(root, s_noIndex);
+    while(!stack.empty()) {
+      const uint32_t node = stack.back().first;
+      const uint32_t nextChild = stack.back().second;
+      if(nextChild < m_childOffsets[node + 1]) {
+        stack.back().second++;
+        const uint32_t child = m_children[nextChild];
+        if(m_tourBegins[child] == s_noIndex) {
+          enter(child, node);
+        }
+      } else {
+        m_tourEnds[node] = static_cast<uint32_t>(m_tour.size());
+        stack.pop_back();
+      }
+    }
+  };
+
+  for(uint32_t i = 0; i < nodeCount; i++) {
+    if(m_parents[i] == s_noIndex) {
+      visitTree(i);
+    }
+  }
+
+  // nodes on a cycle of parents aren't reachable from a root, the first one found starts its own tree
+  for(uint32_t i = 0; i < nodeCount; i++) {
+    if(m_tourBegins[i] == s_noIndex) {
+      visitTree(i);
+    }
   }
 
-  return it->second.get();
+  m_layoutDirty = false;
 }
@@ -1,13 +1,24 @@
 #ifndef HIERARCHY_CACHE_H
 #define HIERARCHY_CACHE_H
 
+#include <atomic>
+#include <cstdint>
 #include <map>
-#include <memory>
+#include <mutex>
 #include <set>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include "types.h"
 
+/**
+ * Member and inheritance hierarchy of all nodes.
+ *
+ * Node ids are remapped to dense indices and every property is a column indexed by them. After the connections have
+ * been created the derived columns are computed once: children in compressed sparse row layout, a preorder tour in
+ * which every subtree is a contiguous range, and the last visible parent of every node.
+ */
 class HierarchyCache {
 public:
   void clear();
@@ -35,10 +46,14 @@ public:
       Id sourceId, const std::set<Id>& targetIds) const;
 
 private:
+  static constexpr uint32_t s_noIndex = UINT32_MAX;
+
+  enum NodeFlag : uint8_t { NODE_FLAG_VISIBLE = 1 << 0, NODE_FLAG_IMPLICIT = 1 << 1 };
+
   /**
    * Determine nodes and edges from which a specific node can be reached in a reversed graph.
    *
-   * A reversed graph can be produced by HierarchyNode::getReverseReachableInheritanceSubgraph().
+   * A reversed graph can be produced by getReverseReachableInheritanceSubgraph().
    *
    * @param[in]  nodeId        ID of the target node.
    * @param[in]  reverseGraph  The reversed graph.
@@ -52,69 +67,58 @@ private:
                                   std::set<Id>& nodes,
                                   std::vector<Id>& edges);
 
-  class HierarchyNode {
-  public:
-    HierarchyNode(Id nodeId);
-
-    Id getNodeId() const;
-
-    Id getEdgeId() const;
-    void setEdgeId(Id edgeId);
-
-    HierarchyNode* getParent() const;
-    void setParent(HierarchyNode* parent);
-
-    void addBase(HierarchyNode* base, Id edgeId);
-
-    void addChild(HierarchyNode* child);
-
-    size_t getChildrenCount() const;
-    size_t getNonImplicitChildrenCount() const;
-
-    void addChildIds(std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const;
-    void addNonImplicitChildIds(std::vector<Id>* nodeIds, std::vector<Id>* edgeIds) const;
-    void addChildIdsRecursive(std::set<Id>* nodeIds, std::set<Id>* edgeIds) const;
-
-    bool isVisible() const;
-    void setIsVisible(bool isVisible);
-
-    bool isImplicit() const;
-    void setIsImplicit(bool isImplicit);
-
-    /**
-     * Determine the reversed subgraph of all nodes and edges that are reachable from this node.
-     *
-     * The subgraph is represented by a map that maps a node ID *t* to a set of pairs where each
-     * pair consists of a node ID *s* and and edge ID *e* such that *e* refers to an edge from
-     * *s* to *t*. Note that the mapping is reversed compared to the edges.
-     */
-    std::map</*target*/ Id, std::vector<std::pair</*source*/ Id, /*edge*/ Id>>> getReverseReachableInheritanceSubgraph() const;
-
-  private:
-    /**
-     * Helper for getReverseReachableInheritanceSubgraph().
-     */
-    void getReverseReachableInheritanceSubgraphHelper(
-        std::map</*target*/ Id, std::vector<std::pair</*source*/ Id, /*edge*/ Id>>>&) const;
-
-    const Id m_nodeId;
-    Id m_edgeId;
-
-    HierarchyNode* m_parent;
-
-    std::vector<HierarchyNode*> m_bases;
-    std::vector<Id> m_baseEdgeIds;
-
-    std::vector<HierarchyNode*> m_children;
-
-    bool m_isVisible;
-    bool m_isImplicit;
+  /**
+   * Determine the reversed subgraph of all nodes and edges that are reachable from a node via inheritance.
+   *
+   * The subgraph is represented by a map that maps a node ID *t* to a set of pairs where each
+   * pair consists of a node ID *s* and and edge ID *e* such that *e* refers to an edge from
+   * *s* to *t*. Note that the mapping is reversed compared to the edges.
+   */
+  std::map</*target*/ Id, std::vector<std::pair</*source*/ Id, /*edge*/ Id>>> getReverseReachableInheritanceSubgraph(
+      uint32_t index) const;
+  void getReverseReachableInheritanceSubgraphHelper(
+      uint32_t index, std::map</*target*/ Id, std::vector<std::pair</*source*/ Id, /*edge*/ Id>>>& reverseGraph) const;
+
+  uint32_t getIndex(Id nodeId) const;
+  uint32_t createIndex(Id nodeId);
+
+  bool isVisible(uint32_t index) const;
+  bool isImplicit(uint32_t index) const;
+
+  // computes the derived columns if connections were created since they were last computed
+  void updateLayout() const;
+
+  std::unordered_map<Id, uint32_t> m_indices;
+
+  // columns filled while creating connections
+  std::vector<Id> m_nodeIds;
+  std::vector<Id> m_edgeIds;    // member edge to the parent
+  std::vector<uint32_t> m_parents;
+  std::vector<uint32_t> m_connectionOrders;    // children are listed in the order they were connected
+  std::vector<uint8_t> m_flags;
+  uint32_t m_connectionCount = 0;
+
+  // inheritance edges in the order they were created, grouped into rows when the layout is computed
+  struct Inheritance {
+    uint32_t from;
+    uint32_t to;
+    Id edgeId;
   };
-
-  HierarchyNode* getNode(Id nodeId) const;
-  HierarchyNode* createNode(Id nodeId);
-
-  std::map<Id, std::unique_ptr<HierarchyNode>> m_nodes;
+  std::vector<Inheritance> m_inheritances;
+
+  // derived columns
+  mutable std::vector<uint32_t> m_childOffsets;
+  mutable std::vector<uint32_t> m_children;
+  mutable std::vector<uint32_t> m_baseOffsets;
+  mutable std::vector<std::pair</*base*/ uint32_t, /*edge*/ Id>> m_bases;
+  mutable std::vector<uint32_t> m_tour;
+  mutable std::vector<uint32_t> m_tourBegins;
+  mutable std::vector<uint32_t> m_tourEnds;
+  mutable std::vector<uint32_t> m_lastVisibleParents;
+  mutable std::vector<uint32_t> m_indicesOfLastVisibleParents;    // see getIndexOfLastVisibleParentNode()
+
+  mutable std::atomic<bool> m_layoutDirty {false};
+  mutable std::mutex m_layoutMutex;
 };
 
 #endif    // HIERARCHY_CACHE_H
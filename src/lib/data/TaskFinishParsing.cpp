@@ -29,7 +29,12 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
   TimeStamp start = TimeStamp::now();
 
   m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Optimizing database");
+  m_storage->updateFileDependencies();
+  // names of the nodes removed while clearing stay behind unless something refers to them again
+  m_storage->removeUnreferencedNames();
+  m_storage->removeUnreferencedIndexingCosts();
   m_storage->optimizeMemory();
+  m_storage->checkpoint();
   m_dialogView->hideUnknownProgressDialog();
 
   double time = TimeStamp::durationSeconds(start);
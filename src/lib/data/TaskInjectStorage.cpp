@@ -2,20 +2,47 @@
 
 #include <utility>
 
+#include "Blackboard.h"
+#include "IntermediateStorage.h"
 #include "Storage.h"
 #include "StorageProvider.h"
 
 TaskInjectStorage::TaskInjectStorage(std::shared_ptr<StorageProvider> storageProvider, std::weak_ptr<Storage> target)
     : m_storageProvider(std::move(storageProvider)), m_target(std::move(target)) {}
 
+TaskInjectStorage::~TaskInjectStorage() {
+  discardPreparedStorage();
+}
+
 void TaskInjectStorage::doEnter(std::shared_ptr<Blackboard> /*blackboard*/) {}
 
-Task::TaskState TaskInjectStorage::doUpdate(std::shared_ptr<Blackboard> /*blackboard*/) {
-  if(m_storageProvider->getStorageCount() > 0) {
-    std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeLargestStorage();
+Task::TaskState TaskInjectStorage::doUpdate(std::shared_ptr<Blackboard> blackboard) {
+  if(m_interrupted) {
+    discardPreparedStorage();
+    return STATE_FAILURE;
+  }
+
+  if(!m_preparedStorage.valid()) {
+    prepareNextStorage();
+  }
+
+  if(m_preparedStorage.valid()) {
+    std::shared_ptr<IntermediateStorage> source = m_preparedStorage.get();
+
+    // prepare the following storage while this one is written
+    prepareNextStorage();
+
     if(source) {
       if(std::shared_ptr<Storage> target = m_target.lock()) {
+        if(m_interrupted) {
+          target->discardPreparedInjection(source.get());
+          discardPreparedStorage();
+          return STATE_FAILURE;
+        }
+
         target->inject(source.get());
+        // wakes up the indexer waiting for the storage provider to drain
+        blackboard->notifyUpdate();
         return STATE_SUCCESS;
       }
     }
@@ -26,8 +53,46 @@ Task::TaskState TaskInjectStorage::doUpdate(std::shared_ptr<Blackboard> /*blackb
 
 void TaskInjectStorage::doExit(std::shared_ptr<Blackboard> /*blackboard*/) {}
 
-void TaskInjectStorage::doReset(std::shared_ptr<Blackboard> /*blackboard*/) {}
+void TaskInjectStorage::doReset(std::shared_ptr<Blackboard> /*blackboard*/) {
+  // an interruption drops what was queued when it happened, storages provided afterwards are injected again
+  if(m_interrupted.exchange(false)) {
+    discardPreparedStorage();
+  }
+}
 
 void TaskInjectStorage::handleMessage(MessageIndexingInterrupted* /*message*/) {
+  // the prepared storage is owned by the updating thread, it drops it on its next update
+  m_interrupted = true;
   m_storageProvider->clear();
 }
+
+void TaskInjectStorage::prepareNextStorage() {
+  if(m_interrupted) {
+    return;
+  }
+
+  std::shared_ptr<IntermediateStorage> storage = m_storageProvider->consumeLargestStorage();
+  if(!storage) {
+    return;
+  }
+
+  m_preparedStorage = std::async(std::launch::async, [storage, target = m_target]() {
+    if(std::shared_ptr<Storage> targetStorage = target.lock()) {
+      targetStorage->prepareInjection(storage.get());
+    }
+    return storage;
+  });
+}
+
+void TaskInjectStorage::discardPreparedStorage() {
+  if(!m_preparedStorage.valid()) {
+    return;
+  }
+
+  std::shared_ptr<IntermediateStorage> storage = m_preparedStorage.get();
+  if(storage) {
+    if(std::shared_ptr<Storage> target = m_target.lock()) {
+      target->discardPreparedInjection(storage.get());
+    }
+  }
+}
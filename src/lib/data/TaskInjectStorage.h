@@ -1,20 +1,30 @@
 #ifndef TASK_INJECT_STORAGE_H
 #define TASK_INJECT_STORAGE_H
 
-#include <vector>
+#include <atomic>
+#include <future>
+#include <memory>
 
 #include "MessageIndexingInterrupted.h"
 #include "MessageListener.h"
 #include "Task.h"
 
+class IntermediateStorage;
 class Storage;
 class StorageProvider;
 
+/*
+ * Injects the queued intermediate storages into the target one after another. While a storage is written, the next one
+ * is already consumed and prepared for injection (Storage::prepareInjection) on a separate thread, so the writing
+ * thread does not wait for file io between injections. Once indexing is interrupted, the prepared storage is dropped
+ * instead of injected.
+ */
 class TaskInjectStorage
     : public Task
     , public MessageListener<MessageIndexingInterrupted> {
 public:
   TaskInjectStorage(std::shared_ptr<StorageProvider> storageProvider, std::weak_ptr<Storage> target);
+  ~TaskInjectStorage() override;
 
 private:
   void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -24,8 +34,14 @@ private:
 
   void handleMessage(MessageIndexingInterrupted* message) override;
 
+  void prepareNextStorage();
+  void discardPreparedStorage();
+
   std::shared_ptr<StorageProvider> m_storageProvider;
   std::weak_ptr<Storage> m_target;
+
+  std::future<std::shared_ptr<IntermediateStorage>> m_preparedStorage;
+  std::atomic<bool> m_interrupted = false;
 };
 
 #endif    // TASK_INJECT_STORAGE_H
@@ -1,33 +1,51 @@
 #include "TaskMergeStorages.h"
 
+#include <algorithm>
+#include <chrono>
+
+#include "Blackboard.h"
+#include "IntermediateStorage.h"
 #include "StorageProvider.h"
 
-TaskMergeStorages::TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider) : m_storageProvider(storageProvider) {}
+const size_t TaskMergeStorages::s_maxMergeStorageCount = 8;
+
+TaskMergeStorages::TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider, size_t maxParallelMergeCount)
+    : m_storageProvider(storageProvider), m_maxParallelMergeCount(std::max<size_t>(1, maxParallelMergeCount)) {}
 
 void TaskMergeStorages::doEnter(std::shared_ptr<Blackboard> /*blackboard*/) {}
 
-Task::TaskState TaskMergeStorages::doUpdate(std::shared_ptr<Blackboard> /*blackboard*/) {
-  if(m_storageProvider->getStorageCount() > 2)    // largest storage won't be touched here
-  {
-    std::shared_ptr<IntermediateStorage> target = m_storageProvider->consumeSecondLargestStorage();
-    std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeSecondLargestStorage();
-    if(target && source) {
-      target->inject(source.get());
-      m_storageProvider->insert(target);
-      return STATE_SUCCESS;
-    } else {
-      if(target) {
-        m_storageProvider->insert(target);
-      }
-      if(source) {
-        m_storageProvider->insert(source);
-      }
+Task::TaskState TaskMergeStorages::doUpdate(std::shared_ptr<Blackboard> blackboard) {
+  collectFinishedMerges();
+
+  while(m_runningMerges.size() < m_maxParallelMergeCount) {
+    StorageProvider::MergeGroup mergeGroup = m_storageProvider->consumeMergeGroup(s_maxMergeStorageCount);
+    if(mergeGroup.storages.empty()) {
+      break;
     }
+
+    std::shared_ptr<StorageProvider> storageProvider = m_storageProvider;
+    m_runningMerges.push_back(std::async(std::launch::async, [storageProvider, blackboard, mergeGroup = std::move(mergeGroup)]() {
+      storageProvider->insertMergeResult(mergeGroup, IntermediateStorage::merge(mergeGroup.storages));
+      // wakes up the surrounding repeat and the injection waiting for storages
+      blackboard->notifyUpdate();
+    }));
   }
 
-  return STATE_FAILURE;
+  // running merges persist across resets, so the surrounding repeat only ends after they have been inserted again
+  return m_runningMerges.empty() ? STATE_FAILURE : STATE_SUCCESS;
 }
 
 void TaskMergeStorages::doExit(std::shared_ptr<Blackboard> /*blackboard*/) {}
 
 void TaskMergeStorages::doReset(std::shared_ptr<Blackboard> /*blackboard*/) {}
+
+void TaskMergeStorages::collectFinishedMerges() {
+  for(auto it = m_runningMerges.begin(); it != m_runningMerges.end();) {
+    if(it->wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+      it->get();
+      it = m_runningMerges.erase(it);
+    } else {
+      it++;
+    }
+  }
+}
@@ -1,15 +1,17 @@
 #ifndef TASK_MERGE_STORAGES_H
 #define TASK_MERGE_STORAGES_H
 
+#include <future>
 #include <vector>
 
 #include "Task.h"
 
 class StorageProvider;
 
+// keeps up to maxParallelMergeCount merges running on separate threads, succeeds while merges are running
 class TaskMergeStorages : public Task {
 public:
-  TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider);
+  TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider, size_t maxParallelMergeCount = 1);
 
 private:
   void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -17,7 +19,15 @@ private:
   void doExit(std::shared_ptr<Blackboard> blackboard) override;
   void doReset(std::shared_ptr<Blackboard> blackboard) override;
 
+  void collectFinishedMerges();
+
+  // storages merged at once by IntermediateStorage::merge
+  static const size_t s_maxMergeStorageCount;
+
   std::shared_ptr<StorageProvider> m_storageProvider;
+  const size_t m_maxParallelMergeCount;
+
+  std::vector<std::future<void>> m_runningMerges;
 };
 
 #endif    // TASK_MERGE_STORAGES_H
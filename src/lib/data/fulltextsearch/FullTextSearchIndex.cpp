@@ -1,24 +1,129 @@
 #include "FullTextSearchIndex.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <limits>
+#include <map>
 
 #include "logging.h"
 #include "tracing.h"
+#include "utilityUuid.h"
+
+namespace {
+std::string getSegmentKey(Id fileId, const std::string& fileKey) {
+  return std::to_string(fileId) + ";" + fileKey;
+}
+
+Id getSegmentKeyFileId(const std::string& segmentKey) {
+  return static_cast<Id>(std::strtoull(segmentKey.c_str(), nullptr, 10));
+}
+
+bool replaceSegmentFile(const std::string& segmentFilePath, const SuffixArray::KeyedArrays& arrays) {
+  if(arrays.empty()) {
+    std::remove(segmentFilePath.c_str());
+    return false;
+  }
+
+  // unique, so concurrent writers of the same segment never share a temp file
+  const std::string tempFilePath = segmentFilePath + "." + utility::getUuidString() + ".tmp";
+  if(SuffixArray::writeToFile(tempFilePath, arrays)) {
+    std::remove(segmentFilePath.c_str());
+    if(std::rename(tempFilePath.c_str(), segmentFilePath.c_str()) == 0) {
+      return true;
+    }
+  }
+
+  LOG_WARNING("Failed to write fulltextsearch segment: " + segmentFilePath);
+  std::remove(tempFilePath.c_str());
+  return false;
+}
+}    // namespace
 
 void FullTextSearchIndex::addFile(Id fileId, const std::wstring& fileContent) {
   if(fileContent.empty()) {
     LOG_ERROR("empty file not added to fulltextsearch index");
+    return;
   }
 
-  if(static_cast<int>(fileContent.size()) >= std::numeric_limits<int>::max()) {
+  if(fileContent.size() >= static_cast<size_t>(std::numeric_limits<int>::max())) {
     LOG_ERROR("file too big not added to fulltextsearch index");
+    return;
+  }
+
+  FullTextSearchFile fts_file(fileId, std::make_shared<SuffixArray>(fileContent));
+
+  {
+    std::lock_guard<std::mutex> lock(m_filesMutex);
+    m_files.push_back(std::move(fts_file));
+  }
+}
+
+void FullTextSearchIndex::addSegment(const std::string& segmentFilePath,
+                                     const std::vector<std::pair<Id, std::string>>& fileKeys,
+                                     const std::function<std::wstring(Id)>& getFileContent) {
+  std::map<std::string, std::shared_ptr<SuffixArray>> storedArrays;
+  for(auto& [key, array] : SuffixArray::loadFromFile(segmentFilePath)) {
+    storedArrays.emplace(std::move(key), std::move(array));
   }
 
-  FullTextSearchFile fts_file(fileId, SuffixArray(fileContent));
+  SuffixArray::KeyedArrays arrays;
+  std::vector<Id> fileIds;
+  bool segmentChanged = false;
+  for(const auto& [fileId, fileKey] : fileKeys) {
+    const std::string key = getSegmentKey(fileId, fileKey);
+    auto it = storedArrays.find(key);
+    if(it != storedArrays.end()) {
+      arrays.emplace_back(key, std::move(it->second));
+      fileIds.push_back(fileId);
+      storedArrays.erase(it);
+      continue;
+    }
+
+    const std::wstring fileContent = getFileContent(fileId);
+    if(fileContent.empty() || fileContent.size() >= static_cast<size_t>(std::numeric_limits<int>::max())) {
+      addFile(fileId, fileContent);
+      continue;
+    }
+
+    arrays.emplace_back(key, std::make_shared<SuffixArray>(fileContent));
+    fileIds.push_back(fileId);
+    segmentChanged = true;
+  }
+
+  // arrays left over belong to files that moved to another segment or were removed
+  if(segmentChanged || !storedArrays.empty()) {
+    storedArrays.clear();
+    if(replaceSegmentFile(segmentFilePath, arrays)) {
+      // the built arrays are released in favor of the mapped ones
+      SuffixArray::KeyedArrays writtenArrays = SuffixArray::loadFromFile(segmentFilePath);
+      if(writtenArrays.size() == arrays.size()) {
+        arrays = std::move(writtenArrays);
+      }
+    }
+  }
 
   {
     std::lock_guard<std::mutex> lock(m_filesMutex);
-    m_files.push_back(fts_file);
+    for(size_t i = 0; i < arrays.size(); i++) {
+      m_files.emplace_back(fileIds[i], std::move(arrays[i].second));
+    }
+  }
+}
+
+void FullTextSearchIndex::removeFromSegment(const std::string& segmentFilePath, const std::set<Id>& fileIds) {
+  SuffixArray::KeyedArrays arrays = SuffixArray::loadFromFile(segmentFilePath);
+  const size_t storedArrayCount = arrays.size();
+
+  arrays.erase(std::remove_if(arrays.begin(),
+                              arrays.end(),
+                              [&fileIds](const auto& keyedArray) {
+                                return fileIds.find(getSegmentKeyFileId(keyedArray.first)) != fileIds.end();
+                              }),
+               arrays.end());
+
+  if(arrays.size() != storedArrayCount) {
+    replaceSegmentFile(segmentFilePath, arrays);
   }
 }
 
@@ -29,7 +134,7 @@ std::vector<FullTextSearchResult> FullTextSearchIndex::searchForTerm(const std::
     for(auto& f : m_files) {
       FullTextSearchResult hit;
       hit.fileId = f.fileId;
-      hit.positions = f.array.searchForTerm(term);
+      hit.positions = f.array->searchForTerm(term);
       std::sort(hit.positions.begin(), hit.positions.end());
       if(!hit.positions.empty()) {
         ret.push_back(hit);
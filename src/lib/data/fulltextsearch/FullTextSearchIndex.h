@@ -1,6 +1,10 @@
 #pragma once
 // STL
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <set>
+#include <string>
 #include <vector>
 
 #include <unordered_map>
@@ -17,14 +21,23 @@ struct FullTextSearchResult {
 };
 
 struct FullTextSearchFile {
-  FullTextSearchFile(Id fileId_, SuffixArray array_) : fileId(fileId_), array(array_) {}
+  FullTextSearchFile(Id fileId_, std::shared_ptr<SuffixArray> array_) : fileId(fileId_), array(std::move(array_)) {}
   Id fileId;
-  SuffixArray array;
+  std::shared_ptr<SuffixArray> array;
 };
 
 class FullTextSearchIndex {
 public:
   void addFile(Id fileId, const std::wstring& file);
+
+  // maps the segment file and reuses the arrays it stores for files with the same key, the arrays of all other files are
+  // built from getFileContent(). The segment file is replaced if it does not store exactly these files
+  void addSegment(const std::string& segmentFilePath,
+                  const std::vector<std::pair<Id, std::string>>& fileKeys,
+                  const std::function<std::wstring(Id)>& getFileContent);
+
+  // drops the arrays of the files from the segment file, e.g. because the files were refreshed or removed
+  static void removeFromSegment(const std::string& segmentFilePath, const std::set<Id>& fileIds);
   std::vector<FullTextSearchResult> searchForTerm(const std::wstring& term) const;
 
   size_t fileCount() const;
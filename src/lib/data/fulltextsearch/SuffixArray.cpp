@@ -1,156 +1,298 @@
 #include "SuffixArray.h"
 
 #include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 
-struct suffix {
-  int index;
-  int rank[2];
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace {
+constexpr uint32_t s_segmentMagic = 0x47455346;    // "FSEG"
+constexpr uint32_t s_segmentVersion = 2;
+
+struct SegmentHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t charSize;
+  uint32_t keySize;
+  uint64_t textSize;
 };
 
-int SuffixArray::cmp(const struct suffix& a, const struct suffix& b) {
-  return (a.rank[0] == b.rank[0]) ? (a.rank[1] < b.rank[1] ? 1 : 0) : (a.rank[0] < b.rank[0] ? 1 : 0);
+// offsets are relative to the start of an array's entry, the key is padded to 8 bytes and the text to 4 bytes, so text
+// and array can be used in place. Entries are padded to 8 bytes as well and follow each other
+size_t alignTo(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
 }
 
-SuffixArray::SuffixArray(const std::wstring& text) : m_text(text) {
-  std::transform(m_text.begin(), m_text.end(), m_text.begin(), ::towlower);
-  m_array = buildSuffixArray();
-  m_lcp = buildLCP();
+size_t getTextOffset(size_t keySize) {
+  return alignTo(sizeof(SegmentHeader) + keySize, 8);
 }
 
-void SuffixArray::printArray() const {
-  std::cout << "Suffix Array : \n";
-  printArr(m_array);
-  for(size_t i = 0; i < m_array.size(); i++) {
-    std::wstring suffix = m_text.substr(m_array[i]);
-    std::wcout << i << ": \"" << suffix << "\"" << std::endl;
-  }
+size_t getArrayOffset(size_t keySize, size_t textSize) {
+  return alignTo(getTextOffset(keySize) + textSize * sizeof(wchar_t), sizeof(uint32_t));
 }
 
-void SuffixArray::printLCP() const {
-  std::cout << "\nLCP Array : \n";
-  printArr(m_lcp);
-  for(size_t i = 0; i < m_array.size(); i++) {
-    std::wstring prefix = m_text.substr(m_array[i], m_lcp[i]);
-    std::wcout << i << ": \"" << prefix << "\"" << std::endl;
-  }
+size_t getEntrySize(size_t keySize, size_t textSize) {
+  return alignTo(getArrayOffset(keySize, textSize) + textSize * sizeof(uint32_t), 8);
 }
+}    // namespace
+
+SuffixArray::SuffixArray(const std::wstring& text) : m_text(text) {
+  std::transform(m_text.begin(), m_text.end(), m_text.begin(), ::towlower);
 
-std::vector<int> SuffixArray::buildLCP() {
-  const int n = static_cast<int>(m_array.size());
+  // reduce the text to the ranks of its characters, so the buckets only cover characters that occur
+  std::vector<wchar_t> alphabet(m_text.begin(), m_text.end());
+  std::sort(alphabet.begin(), alphabet.end());
+  alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
 
-  std::vector<int> lcp(n, 0);
-  std::vector<int> invSuff(n, 0);
+  std::vector<int> ranks;
+  ranks.reserve(m_text.size());
+  for(wchar_t c : m_text) {
+    ranks.push_back(static_cast<int>(std::lower_bound(alphabet.begin(), alphabet.end(), c) - alphabet.begin()));
+  }
 
-  for(int i = 0; i < n; i++) {
-    invSuff[m_array[i]] = i;
+  const std::vector<int> array = buildSuffixArray(ranks, std::max(static_cast<int>(alphabet.size()) - 1, 0));
+  m_array.assign(array.begin(), array.end());
+}
+
+SuffixArray::KeyedArrays SuffixArray::loadFromFile(const std::string& filePath) {
+  std::shared_ptr<boost::interprocess::mapped_region> region;
+  try {
+    const boost::interprocess::file_mapping mapping(filePath.c_str(), boost::interprocess::read_only);
+    region = std::make_shared<boost::interprocess::mapped_region>(mapping, boost::interprocess::read_only);
+  } catch(const boost::interprocess::interprocess_exception&) {
+    return {};
   }
 
-  int k = 0;
+  const char* data = static_cast<const char*>(region->get_address());
+  const size_t size = region->get_size();
 
-  for(int i = 0; i < n; i++) {
-    if(invSuff[i] == n - 1) {
-      k = 0;
-      continue;
+  KeyedArrays arrays;
+  for(size_t offset = 0; offset < size;) {
+    SegmentHeader header;
+    if(size - offset < sizeof(SegmentHeader)) {
+      return {};
     }
+    std::memcpy(&header, data + offset, sizeof(SegmentHeader));
 
-    int j = m_array[invSuff[i] + 1];
-
-    while(i + k < n && j + k < n && m_text[i + k] == m_text[j + k]) {
-      k++;
+    if(header.magic != s_segmentMagic || header.version != s_segmentVersion || header.charSize != sizeof(wchar_t) ||
+       header.keySize > size || header.textSize > size || size - offset < getTextOffset(header.keySize) ||
+       size - offset < getEntrySize(header.keySize, static_cast<size_t>(header.textSize))) {
+      return {};
     }
 
-    lcp[invSuff[i]] = k;
+    std::shared_ptr<SuffixArray> array(new SuffixArray());
+    array->m_mappedText = reinterpret_cast<const wchar_t*>(data + offset + getTextOffset(header.keySize));
+    array->m_mappedArray = reinterpret_cast<const uint32_t*>(data + offset + getArrayOffset(header.keySize, header.textSize));
+    array->m_mappedSize = static_cast<size_t>(header.textSize);
+    array->m_region = region;
+    arrays.emplace_back(std::string(data + offset + sizeof(SegmentHeader), header.keySize), std::move(array));
 
-    if(k > 0) {
-      k--;
-    }
+    offset += getEntrySize(header.keySize, static_cast<size_t>(header.textSize));
   }
+  return arrays;
+}
+
+bool SuffixArray::writeToFile(const std::string& filePath, const KeyedArrays& arrays) {
+  const std::vector<char> padding(8, 0);
+  auto writePadding = [&](std::ofstream& stream, size_t size) {
+    stream.write(padding.data(), static_cast<std::streamsize>(size));
+  };
+
+  std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+  for(const auto& [key, array] : arrays) {
+    const std::wstring_view text = array->getText();
+    const SegmentHeader header = {
+        s_segmentMagic, s_segmentVersion, sizeof(wchar_t), static_cast<uint32_t>(key.size()), text.size()};
 
-  return lcp;
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(SegmentHeader));
+    stream.write(key.data(), static_cast<std::streamsize>(key.size()));
+    writePadding(stream, getTextOffset(key.size()) - sizeof(SegmentHeader) - key.size());
+    stream.write(reinterpret_cast<const char*>(text.data()), static_cast<std::streamsize>(text.size() * sizeof(wchar_t)));
+    writePadding(stream, getArrayOffset(key.size(), text.size()) - getTextOffset(key.size()) - text.size() * sizeof(wchar_t));
+    stream.write(reinterpret_cast<const char*>(array->getArray()),
+                 static_cast<std::streamsize>(text.size() * sizeof(uint32_t)));
+    writePadding(stream,
+                 getEntrySize(key.size(), text.size()) - getArrayOffset(key.size(), text.size()) -
+                     text.size() * sizeof(uint32_t));
+  }
+  return static_cast<bool>(stream);
+}
+
+void SuffixArray::printArray() const {
+  const std::wstring_view text = getText();
+  std::cout << "Suffix Array : \n";
+  printArr(std::vector<uint32_t>(getArray(), getArray() + text.size()));
+  for(size_t i = 0; i < text.size(); i++) {
+    std::wcout << i << ": \"" << text.substr(getArray()[i]) << "\"" << std::endl;
+  }
+}
+
+size_t SuffixArray::getByteSize() const {
+  return m_array.size() * sizeof(uint32_t) + m_text.size() * sizeof(wchar_t);
+}
+
+std::wstring_view SuffixArray::getText() const {
+  return m_region ? std::wstring_view(m_mappedText, m_mappedSize) : std::wstring_view(m_text);
+}
+
+const uint32_t* SuffixArray::getArray() const {
+  return m_region ? m_mappedArray : m_array.data();
 }
 
 std::vector<int> SuffixArray::searchForTerm(const std::wstring& searchTerm) const {
   std::wstring term = searchTerm;
   std::transform(term.begin(), term.end(), term.begin(), ::towlower);
 
-  const int termLength = static_cast<int>(term.length());
-  const int textLength = static_cast<int>(m_text.length());
-  int l = -1;
-  int r = textLength;
-  int m;
-
-  std::vector<int> matches;
-  int compareResult;
-  while(l + 1 < r) {
-    m = (l + r + 1) / 2;
-    compareResult = term.compare(m_text.substr(m_array[m], termLength));
-    if(compareResult < 0) {
-      r = m;
-    } else if(compareResult > 0) {
-      l = m;
-    } else {
-      matches.push_back(m_array[m]);
-      for(int lower = m - 1; lower >= 0 && m_lcp[lower] >= termLength; lower--) {
-        matches.push_back(m_array[lower]);
-      }
-      for(int higher = m + 1; higher < textLength && m_lcp[higher - 1] >= termLength; higher++) {
-        matches.push_back(m_array[higher]);
-      }
-      break;
-    }
+  if(term.empty()) {
+    return {};
   }
 
+  // all suffixes starting with the term form one range of the array
+  const std::wstring_view text = getText();
+  const uint32_t* array = getArray();
+  const uint32_t* first = std::lower_bound(array, array + text.size(), term, [&text](uint32_t pos, const std::wstring& value) {
+    return text.compare(pos, value.size(), value) < 0;
+  });
+  const uint32_t* last = std::upper_bound(first, array + text.size(), term, [&text](const std::wstring& value, uint32_t pos) {
+    return text.compare(pos, value.size(), value) > 0;
+  });
+
+  std::vector<int> matches(first, last);
   std::sort(matches.begin(), matches.end());
 
   return matches;
 }
 
-std::vector<int> SuffixArray::buildSuffixArray() {
-  const int n = static_cast<int>(m_text.length());
-  std::vector<suffix> suffixes;
-  suffixes.reserve(n);
-
-  suffix s;
-  for(int i = 0; i < n; i++) {
-    s.index = i;
-    s.rank[0] = m_text[i];
-    s.rank[1] = ((i + 1) < n) ? (m_text[i + 1]) : -1;
-    suffixes.push_back(s);
+std::vector<int> SuffixArray::buildSuffixArray(const std::vector<int>& s, int upper) {
+  const int n = static_cast<int>(s.size());
+  if(n == 0) {
+    return {};
+  }
+  if(n == 1) {
+    return {0};
+  }
+  if(n < 8) {
+    std::vector<int> sa(n);
+    for(int i = 0; i < n; i++) {
+      sa[i] = i;
+    }
+    std::sort(sa.begin(), sa.end(), [&s](int a, int b) {
+      return std::lexicographical_compare(s.begin() + a, s.end(), s.begin() + b, s.end());
+    });
+    return sa;
   }
 
-  std::sort(suffixes.begin(), suffixes.end(), SuffixArray::cmp);
+  // classify suffixes into S type (smaller than the next suffix) and L type
+  std::vector<int> sa(n);
+  std::vector<bool> isS(n);
+  for(int i = n - 2; i >= 0; i--) {
+    isS[i] = (s[i] == s[i + 1]) ? isS[i + 1] : (s[i] < s[i + 1]);
+  }
 
-  std::vector<int> ind(n, 0);
-  for(int k = 4; k < 2 * n; k = k * 2) {
-    int rank = 0;
-    int prev_rank = suffixes[0].rank[0];
-    suffixes[0].rank[0] = rank;
-    ind[suffixes[0].index] = 0;
+  // bucket starts for L type (sumL) and S type (sumS) suffixes of each character
+  std::vector<int> sumL(upper + 1, 0);
+  std::vector<int> sumS(upper + 1, 0);
+  for(int i = 0; i < n; i++) {
+    if(!isS[i]) {
+      sumS[s[i]]++;
+    } else {
+      sumL[s[i] + 1]++;
+    }
+  }
+  for(int i = 0; i <= upper; i++) {
+    sumS[i] += sumL[i];
+    if(i < upper) {
+      sumL[i + 1] += sumS[i];
+    }
+  }
 
-    for(int i = 1; i < n; i++) {
-      if(suffixes[i].rank[0] == prev_rank && suffixes[i].rank[1] == suffixes[i - 1].rank[1]) {
-        prev_rank = suffixes[i].rank[0];
-        suffixes[i].rank[0] = rank;
-      } else {
-        prev_rank = suffixes[i].rank[0];
-        suffixes[i].rank[0] = ++rank;
+  // places the given LMS suffixes and induces the order of all other suffixes from them
+  auto induce = [&](const std::vector<int>& lms) {
+    std::fill(sa.begin(), sa.end(), -1);
+    std::vector<int> buffer(sumS);
+    for(int pos : lms) {
+      if(pos != n) {
+        sa[buffer[s[pos]]++] = pos;
       }
-      ind[suffixes[i].index] = i;
     }
 
+    buffer = sumL;
+    sa[buffer[s[n - 1]]++] = n - 1;
     for(int i = 0; i < n; i++) {
-      int nextindex = suffixes[i].index + k / 2;
-      suffixes[i].rank[1] = (nextindex < n) ? suffixes[ind[nextindex]].rank[0] : -1;
+      const int pos = sa[i];
+      if(pos >= 1 && !isS[pos - 1]) {
+        sa[buffer[s[pos - 1]]++] = pos - 1;
+      }
     }
 
-    std::sort(suffixes.begin(), suffixes.end(), cmp);
+    buffer = sumL;
+    for(int i = n - 1; i >= 0; i--) {
+      const int pos = sa[i];
+      if(pos >= 1 && isS[pos - 1]) {
+        sa[--buffer[s[pos - 1] + 1]] = pos - 1;
+      }
+    }
+  };
+
+  std::vector<int> lmsIndices(n + 1, -1);
+  std::vector<int> lms;
+  for(int i = 1; i < n; i++) {
+    if(!isS[i - 1] && isS[i]) {
+      lmsIndices[i] = static_cast<int>(lms.size());
+      lms.push_back(i);
+    }
   }
+  const int lmsCount = static_cast<int>(lms.size());
 
-  std::vector<int> suffixArr;
-  for(int i = 0; i < n; i++) {
-    suffixArr.push_back(suffixes[i].index);
+  induce(lms);
+
+  if(lmsCount) {
+    std::vector<int> sortedLms;
+    sortedLms.reserve(lmsCount);
+    for(int pos : sa) {
+      if(lmsIndices[pos] != -1) {
+        sortedLms.push_back(pos);
+      }
+    }
+
+    // name the LMS substrings by their rank and sort the reduced string recursively
+    std::vector<int> reduced(lmsCount);
+    int reducedUpper = 0;
+    reduced[lmsIndices[sortedLms[0]]] = 0;
+    for(int i = 1; i < lmsCount; i++) {
+      int l = sortedLms[i - 1];
+      int r = sortedLms[i];
+      const int endL = (lmsIndices[l] + 1 < lmsCount) ? lms[lmsIndices[l] + 1] : n;
+      const int endR = (lmsIndices[r] + 1 < lmsCount) ? lms[lmsIndices[r] + 1] : n;
+
+      bool same = true;
+      if(endL - l != endR - r) {
+        same = false;
+      } else {
+        while(l < endL && s[l] == s[r]) {
+          l++;
+          r++;
+        }
+        if(l == n || s[l] != s[r]) {
+          same = false;
+        }
+      }
+
+      if(!same) {
+        reducedUpper++;
+      }
+      reduced[lmsIndices[sortedLms[i]]] = reducedUpper;
+    }
+
+    const std::vector<int> reducedArray = buildSuffixArray(reduced, reducedUpper);
+    for(int i = 0; i < lmsCount; i++) {
+      sortedLms[i] = lms[reducedArray[i]];
+    }
+    induce(sortedLms);
   }
 
-  return suffixArr;
+  return sa;
 }
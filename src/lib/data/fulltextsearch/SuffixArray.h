@@ -1,20 +1,42 @@
 #ifndef SUFFIX_ARRAY_H
 #define SUFFIX_ARRAY_H
 
+#include <cstdint>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+namespace boost::interprocess {
+class mapped_region;
+}    // namespace boost::interprocess
+
+// case insensitive suffix array of one text, built in linear time with SA-IS over the alphabet of the text
 class SuffixArray {
 public:
   SuffixArray(const std::wstring& text);
+
+  // a segment file stores several arrays, each under its own key
+  using KeyedArrays = std::vector<std::pair<std::string, std::shared_ptr<SuffixArray>>>;
+
+  // maps a segment file written by writeToFile() once for all of its arrays, returns them in the order they were written
+  // or nothing if the file is missing or invalid
+  static KeyedArrays loadFromFile(const std::string& filePath);
+
+  static bool writeToFile(const std::string& filePath, const KeyedArrays& arrays);
+
   std::vector<int> searchForTerm(const std::wstring& searchTerm) const;
-  static int cmp(const struct suffix& a, const struct suffix& b);
 
   void printArray() const;
-  void printLCP() const;
+
+  // memory owned by this array, mapped segments are not counted
+  size_t getByteSize() const;
 
 private:
+  SuffixArray() = default;
+
   template <typename T>
   void printArr(std::vector<T> arr) const {
     for(size_t i = 0; i < arr.size(); i++) {
@@ -23,11 +45,20 @@ private:
     std::cout << std::endl;
   }
 
-  std::vector<int> buildLCP();
-  std::vector<int> buildSuffixArray();
-  std::vector<int> m_array;
-  std::vector<int> m_lcp;
+  // s contains values in [0, upper]
+  static std::vector<int> buildSuffixArray(const std::vector<int>& s, int upper);
+
+  std::wstring_view getText() const;
+  const uint32_t* getArray() const;
+
+  std::vector<uint32_t> m_array;
   std::wstring m_text;
+
+  // set instead of the members above if the array was loaded from a segment file
+  std::shared_ptr<boost::interprocess::mapped_region> m_region;
+  const wchar_t* m_mappedText = nullptr;
+  const uint32_t* m_mappedArray = nullptr;
+  size_t m_mappedSize = 0;
 };
 
 #endif    // SUFFIX_ARRAY_H
@@ -0,0 +1,49 @@
+#include "IndexedHeaderRegistry.h"
+
+IndexedHeaderRegistry::~IndexedHeaderRegistry() = default;
+
+Id IndexedHeaderRegistry::createOwnerId() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return ++m_lastOwnerId;
+}
+
+bool IndexedHeaderRegistry::claimHeader(const std::string& headerKey, Id ownerId) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto [it, inserted] = m_claimedHeaderKeys.emplace(headerKey, ownerId);
+  if(inserted) {
+    m_provisionalHeaderKeys[ownerId].push_back(headerKey);
+    return true;
+  }
+  return it->second != 0;
+}
+
+void IndexedHeaderRegistry::confirmClaims(Id ownerId) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_provisionalHeaderKeys.find(ownerId);
+  if(it == m_provisionalHeaderKeys.end()) {
+    return;
+  }
+
+  for(const std::string& headerKey : it->second) {
+    m_claimedHeaderKeys[headerKey] = 0;
+  }
+  m_provisionalHeaderKeys.erase(it);
+}
+
+void IndexedHeaderRegistry::releaseClaims(Id ownerId) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_provisionalHeaderKeys.find(ownerId);
+  if(it == m_provisionalHeaderKeys.end()) {
+    return;
+  }
+
+  for(const std::string& headerKey : it->second) {
+    m_claimedHeaderKeys.erase(headerKey);
+  }
+  m_provisionalHeaderKeys.erase(it);
+}
+
+size_t IndexedHeaderRegistry::getClaimedHeaderCount() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_claimedHeaderKeys.size();
+}
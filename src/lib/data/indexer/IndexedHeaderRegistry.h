@@ -0,0 +1,46 @@
+#pragma once
+// STL
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+// internal
+#include "types.h"
+
+/*
+ * IndexedHeaderRegistry
+ *
+ * Remembers which headers were already indexed during the current indexing run. A header key combines the header path
+ * with hashes of its content, of the macro context and of the lexical context it was parsed in, so only the first
+ * translation unit that claims a key records the declarations of that header and all others can skip them.
+ *
+ * Claims are provisional until their owner confirms them after its intermediate storage was handed on, only confirmed
+ * claims let other translation units skip a header. If the translation unit fails or is interrupted, its claims are
+ * released so later translation units record the headers.
+ */
+class IndexedHeaderRegistry {
+public:
+  virtual ~IndexedHeaderRegistry();
+
+  // identifies a claiming indexer, it indexes one translation unit at a time
+  virtual Id createOwnerId();
+
+  // returns false if another owner already confirmed a claim of the header key, a provisional claim of another owner
+  // may still be released, so the header is recorded by this owner as well
+  virtual bool claimHeader(const std::string& headerKey, Id ownerId);
+
+  // makes the provisional claims of the owner permanent
+  virtual void confirmClaims(Id ownerId);
+
+  // drops the provisional claims of the owner
+  virtual void releaseClaims(Id ownerId);
+
+  size_t getClaimedHeaderCount() const;
+
+private:
+  mutable std::mutex m_mutex;
+  Id m_lastOwnerId = 0;
+  // owner of the claim, 0 once confirmed
+  std::unordered_map<std::string, Id> m_claimedHeaderKeys;
+  std::unordered_map<Id, std::vector<std::string>> m_provisionalHeaderKeys;
+};
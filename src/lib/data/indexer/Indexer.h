@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "IndexedHeaderRegistry.h"
 #include "IndexerBase.h"
 #include "IndexerCommand.h"
 #include "IndexerStateInfo.h"
@@ -16,6 +17,9 @@ public:
   IndexerCommandType getSupportedIndexerCommandType() const override;
   std::shared_ptr<IntermediateStorage> index(std::shared_ptr<IndexerCommand> indexerCommand) override;
   void interrupt() override;
+  void setIndexedHeaderRegistry(std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry) override;
+  void confirmIndexedHeaders() override;
+  void releaseIndexedHeaders() override;
 
 private:
   virtual void doIndex(std::shared_ptr<T> indexerCommand,
@@ -41,6 +45,28 @@ void Indexer<T>::interrupt() {
   m_indexerStateInfo->indexingInterrupted = true;
 }
 
+template <typename T>
+void Indexer<T>::setIndexedHeaderRegistry(std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry) {
+  m_indexerStateInfo->indexedHeaderRegistry = std::move(indexedHeaderRegistry);
+  if(m_indexerStateInfo->indexedHeaderRegistry) {
+    m_indexerStateInfo->indexedHeaderOwnerId = m_indexerStateInfo->indexedHeaderRegistry->createOwnerId();
+  }
+}
+
+template <typename T>
+void Indexer<T>::confirmIndexedHeaders() {
+  if(m_indexerStateInfo->indexedHeaderRegistry) {
+    m_indexerStateInfo->indexedHeaderRegistry->confirmClaims(m_indexerStateInfo->indexedHeaderOwnerId);
+  }
+}
+
+template <typename T>
+void Indexer<T>::releaseIndexedHeaders() {
+  if(m_indexerStateInfo->indexedHeaderRegistry) {
+    m_indexerStateInfo->indexedHeaderRegistry->releaseClaims(m_indexerStateInfo->indexedHeaderOwnerId);
+  }
+}
+
 template <typename T>
 std::shared_ptr<IntermediateStorage> Indexer<T>::index(std::shared_ptr<IndexerCommand> indexerCommand) {
   std::shared_ptr<T> castCommand = std::dynamic_pointer_cast<T>(indexerCommand);
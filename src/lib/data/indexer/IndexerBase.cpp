@@ -2,4 +2,10 @@
 
 IndexerBase::IndexerBase() = default;
 
-IndexerBase::~IndexerBase() = default;
\ No newline at end of file
+IndexerBase::~IndexerBase() = default;
+
+void IndexerBase::setIndexedHeaderRegistry(std::shared_ptr<IndexedHeaderRegistry> /*indexedHeaderRegistry*/) {}
+
+void IndexerBase::confirmIndexedHeaders() {}
+
+void IndexerBase::releaseIndexedHeaders() {}
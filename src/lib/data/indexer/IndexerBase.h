@@ -4,6 +4,7 @@
 
 #include "IndexerCommandType.h"
 
+class IndexedHeaderRegistry;
 class IndexerCommand;
 class IntermediateStorage;
 
@@ -15,4 +16,12 @@ public:
   [[nodiscard]] virtual IndexerCommandType getSupportedIndexerCommandType() const = 0;
   virtual std::shared_ptr<IntermediateStorage> index(std::shared_ptr<IndexerCommand> indexerCommand) = 0;
   virtual void interrupt() = 0;
+
+  // indexers supporting it skip headers that were claimed by other translation units, does nothing by default
+  virtual void setIndexedHeaderRegistry(std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry);
+
+  // headers claimed by the last indexed translation unit stay provisional until its storage was handed on
+  virtual void confirmIndexedHeaders();
+  // lets other translation units record the headers again if the last one failed or was interrupted
+  virtual void releaseIndexedHeaders();
 };
\ No newline at end of file
@@ -29,3 +29,21 @@ void IndexerComposite::interrupt() {
     indexer->interrupt();
   }
 }
+
+void IndexerComposite::setIndexedHeaderRegistry(std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry) {
+  for(auto& [type, indexer] : m_indexers) {
+    indexer->setIndexedHeaderRegistry(indexedHeaderRegistry);
+  }
+}
+
+void IndexerComposite::confirmIndexedHeaders() {
+  for(auto& [type, indexer] : m_indexers) {
+    indexer->confirmIndexedHeaders();
+  }
+}
+
+void IndexerComposite::releaseIndexedHeaders() {
+  for(auto& [type, indexer] : m_indexers) {
+    indexer->releaseIndexedHeaders();
+  }
+}
@@ -17,6 +17,10 @@ public:
 
   void interrupt() override;
 
+  void setIndexedHeaderRegistry(std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry) override;
+  void confirmIndexedHeaders() override;
+  void releaseIndexedHeaders() override;
+
 private:
   std::map<IndexerCommandType, std::shared_ptr<IndexerBase>> m_indexers;
 };
\ No newline at end of file
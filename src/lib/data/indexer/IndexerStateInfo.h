@@ -1,6 +1,16 @@
 #pragma once
+// STL
+#include <memory>
+// internal
+#include "types.h"
+
+class IndexedHeaderRegistry;
 
 struct IndexerStateInfo {
 public:
   bool indexingInterrupted;
+  // only set if headers already indexed by another translation unit should be skipped
+  std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry;
+  // owner of the header claims made by this indexer
+  Id indexedHeaderOwnerId = 0;
 };
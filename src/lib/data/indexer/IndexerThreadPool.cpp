@@ -0,0 +1,259 @@
+#include "IndexerThreadPool.h"
+// STL
+#include <algorithm>
+// fmt
+#include <fmt/format.h>
+// internal
+#include "IndexerBase.h"
+#include "IndexerCommand.h"
+#include "IntermediateStorage.h"
+#include "TimeStamp.h"
+#include "logging.h"
+
+IndexerThreadPool::IndexerThreadPool(size_t workerCount, IndexerFactory indexerFactory)
+    : m_indexerFactory(std::move(indexerFactory)) {
+  for(size_t i = 0; i < std::max<size_t>(1, workerCount); i++) {
+    m_workers.push_back(std::make_unique<Worker>());
+  }
+}
+
+IndexerThreadPool::~IndexerThreadPool() {
+  interrupt();
+  join();
+}
+
+size_t IndexerThreadPool::getWorkerCount() const {
+  return m_workers.size();
+}
+
+void IndexerThreadPool::start() {
+  {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_finished = false;
+    m_interrupted = false;
+  }
+
+  for(size_t i = 0; i < m_workers.size(); i++) {
+    if(m_workers[i]->thread.joinable()) {
+      LOG_ERROR("Unable to start indexer thread pool. Workers are already running.");
+      return;
+    }
+  }
+
+  m_runningWorkerCount = m_workers.size();
+  for(size_t i = 0; i < m_workers.size(); i++) {
+    m_workers[i]->thread = std::thread(&IndexerThreadPool::runWorker, this, i);
+  }
+}
+
+void IndexerThreadPool::finish() {
+  {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_finished = true;
+  }
+  m_commandsCondition.notify_all();
+}
+
+void IndexerThreadPool::interrupt() {
+  {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_interrupted = true;
+
+    for(const std::unique_ptr<Worker>& worker : m_workers) {
+      if(worker->indexer) {
+        worker->indexer->interrupt();
+      }
+    }
+  }
+
+  clearCommands();
+
+  m_commandsCondition.notify_all();
+  {
+    // taking the lock makes sure workers are either before their check or already waiting
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+  }
+  m_resultsCondition.notify_all();
+}
+
+void IndexerThreadPool::join() {
+  for(const std::unique_ptr<Worker>& worker : m_workers) {
+    if(worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+void IndexerThreadPool::pushCommands(const std::vector<std::shared_ptr<IndexerCommand>>& commands) {
+  for(const std::shared_ptr<IndexerCommand>& command : commands) {
+    Worker& worker = *m_workers[m_nextWorkerIndex];
+    m_nextWorkerIndex = (m_nextWorkerIndex + 1) % m_workers.size();
+
+    std::lock_guard<std::mutex> lock(worker.commandsMutex);
+    worker.commands.push_back(command);
+    m_queuedCommandCount++;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+  }
+  m_commandsCondition.notify_all();
+}
+
+size_t IndexerThreadPool::getQueuedCommandCount() const {
+  return m_queuedCommandCount;
+}
+
+void IndexerThreadPool::clearCommands() {
+  for(const std::unique_ptr<Worker>& worker : m_workers) {
+    std::lock_guard<std::mutex> lock(worker->commandsMutex);
+    m_queuedCommandCount -= worker->commands.size();
+    worker->commands.clear();
+  }
+}
+
+size_t IndexerThreadPool::getRunningWorkerCount() const {
+  return m_runningWorkerCount;
+}
+
+std::vector<FilePath> IndexerThreadPool::popStartedSourceFilePaths() {
+  std::lock_guard<std::mutex> lock(m_filesMutex);
+  std::vector<FilePath> startedFiles;
+  startedFiles.swap(m_startedFiles);
+  return startedFiles;
+}
+
+std::vector<FilePath> IndexerThreadPool::getCrashedSourceFilePaths() const {
+  std::lock_guard<std::mutex> lock(m_filesMutex);
+  return m_crashedFiles;
+}
+
+std::shared_ptr<IntermediateStorage> IndexerThreadPool::popResult() {
+  std::shared_ptr<IntermediateStorage> result;
+  {
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    if(m_results.empty()) {
+      return nullptr;
+    }
+
+    result = m_results.front();
+    m_results.pop_front();
+  }
+  m_resultsCondition.notify_one();
+  return result;
+}
+
+size_t IndexerThreadPool::getResultCount() const {
+  std::lock_guard<std::mutex> lock(m_resultsMutex);
+  return m_results.size();
+}
+
+void IndexerThreadPool::runWorker(size_t workerIndex) {
+  Worker& worker = *m_workers[workerIndex];
+
+  std::shared_ptr<IndexerBase> indexer = m_indexerFactory();
+  {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    worker.indexer = indexer;
+    if(m_interrupted && indexer) {
+      indexer->interrupt();
+    }
+  }
+
+  while(indexer) {
+    std::shared_ptr<IndexerCommand> command = takeCommand(workerIndex);
+    if(!command) {
+      std::unique_lock<std::mutex> lock(m_stateMutex);
+      m_commandsCondition.wait(lock, [this]() { return m_queuedCommandCount > 0 || m_finished || m_interrupted; });
+
+      if(m_interrupted || (m_finished && m_queuedCommandCount == 0)) {
+        break;
+      }
+      continue;
+    }
+
+    if(!waitForResultCapacity()) {
+      break;
+    }
+
+    const FilePath sourceFilePath = command->getSourceFilePath();
+    {
+      std::lock_guard<std::mutex> lock(m_filesMutex);
+      m_startedFiles.push_back(sourceFilePath);
+    }
+
+    std::shared_ptr<IntermediateStorage> result;
+    try {
+      const TimeStamp start = TimeStamp::now();
+      result = indexer->index(command);
+      if(result) {
+        result->addIndexingCosts({StorageIndexingCost(sourceFilePath.wstr(), TimeStamp::now().deltaMS(start))});
+      }
+    } catch(std::exception& e) {
+      LOG_ERROR(fmt::format("{} indexer threw: {}", workerIndex + 1, e.what()));
+      std::lock_guard<std::mutex> lock(m_filesMutex);
+      m_crashedFiles.push_back(sourceFilePath);
+    } catch(...) {
+      LOG_ERROR(fmt::format("{} indexer threw an unknown exception", workerIndex + 1));
+      std::lock_guard<std::mutex> lock(m_filesMutex);
+      m_crashedFiles.push_back(sourceFilePath);
+    }
+
+    if(result) {
+      {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        m_results.push_back(result);
+      }
+      indexer->confirmIndexedHeaders();
+    } else {
+      // thrown or interrupted, the headers of this translation unit were not recorded anywhere
+      indexer->releaseIndexedHeaders();
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    worker.indexer.reset();
+  }
+  m_runningWorkerCount--;
+}
+
+std::shared_ptr<IndexerCommand> IndexerThreadPool::takeCommand(size_t workerIndex) {
+  {
+    Worker& worker = *m_workers[workerIndex];
+    std::lock_guard<std::mutex> lock(worker.commandsMutex);
+    if(!worker.commands.empty()) {
+      std::shared_ptr<IndexerCommand> command = worker.commands.front();
+      worker.commands.pop_front();
+      m_queuedCommandCount--;
+      return command;
+    }
+  }
+
+  for(size_t i = 1; i < m_workers.size(); i++) {
+    Worker& victim = *m_workers[(workerIndex + i) % m_workers.size()];
+    std::lock_guard<std::mutex> lock(victim.commandsMutex);
+    if(!victim.commands.empty()) {
+      std::shared_ptr<IndexerCommand> command = victim.commands.back();
+      victim.commands.pop_back();
+      m_queuedCommandCount--;
+      return command;
+    }
+  }
+
+  return nullptr;
+}
+
+bool IndexerThreadPool::waitForResultCapacity() {
+  // same back pressure as the indexer processes, which hold at most two unfetched storages each
+  const size_t maxResultCount = m_workers.size() * 2;
+
+  std::unique_lock<std::mutex> lock(m_resultsMutex);
+  m_resultsCondition.wait(lock, [this, maxResultCount]() {
+    std::lock_guard<std::mutex> stateLock(m_stateMutex);
+    return m_results.size() < maxResultCount || m_interrupted;
+  });
+
+  std::lock_guard<std::mutex> stateLock(m_stateMutex);
+  return !m_interrupted;
+}
@@ -0,0 +1,97 @@
+#pragma once
+// STL
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// internal
+#include "FilePath.h"
+
+class IndexerBase;
+class IndexerCommand;
+class IntermediateStorage;
+
+/*
+ * IndexerThreadPool
+ *
+ * Runs indexer commands on worker threads of the app process, used instead of the shared memory queues when indexing
+ * is not split into multiple processes.
+ *
+ * - every worker owns a command deque, pushed commands are dealt round robin
+ * - workers take commands from the front of their own deque and steal from the back of the others when it runs dry
+ * - results are queued in the pool and fetched by the indexing task, workers pause while too many results are pending
+ */
+class IndexerThreadPool final {
+public:
+  using IndexerFactory = std::function<std::shared_ptr<IndexerBase>()>;
+
+  IndexerThreadPool(size_t workerCount, IndexerFactory indexerFactory);
+  ~IndexerThreadPool();
+
+  IndexerThreadPool(const IndexerThreadPool&) = delete;
+  IndexerThreadPool& operator=(const IndexerThreadPool&) = delete;
+
+  size_t getWorkerCount() const;
+
+  void start();
+
+  // workers exit after the remaining commands are done
+  void finish();
+
+  // interrupts running indexers, drops queued commands and lets workers exit
+  void interrupt();
+
+  void join();
+
+  void pushCommands(const std::vector<std::shared_ptr<IndexerCommand>>& commands);
+  size_t getQueuedCommandCount() const;
+  void clearCommands();
+
+  size_t getRunningWorkerCount() const;
+
+  // returns and forgets the source files that were started since the last call
+  std::vector<FilePath> popStartedSourceFilePaths();
+
+  // source files whose indexer threw instead of returning a result
+  std::vector<FilePath> getCrashedSourceFilePaths() const;
+
+  std::shared_ptr<IntermediateStorage> popResult();
+  size_t getResultCount() const;
+
+private:
+  struct Worker {
+    std::deque<std::shared_ptr<IndexerCommand>> commands;
+    std::mutex commandsMutex;
+    std::shared_ptr<IndexerBase> indexer;
+    std::thread thread;
+  };
+
+  void runWorker(size_t workerIndex);
+  std::shared_ptr<IndexerCommand> takeCommand(size_t workerIndex);
+  bool waitForResultCapacity();
+
+  const IndexerFactory m_indexerFactory;
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  size_t m_nextWorkerIndex = 0;
+
+  std::atomic<size_t> m_queuedCommandCount = 0;
+  std::atomic<size_t> m_runningWorkerCount = 0;
+
+  // guards the flags below and pairs with m_commandsCondition
+  mutable std::mutex m_stateMutex;
+  std::condition_variable m_commandsCondition;
+  bool m_finished = false;
+  bool m_interrupted = false;
+
+  mutable std::mutex m_resultsMutex;
+  std::condition_variable m_resultsCondition;
+  std::deque<std::shared_ptr<IntermediateStorage>> m_results;
+
+  mutable std::mutex m_filesMutex;
+  std::vector<FilePath> m_startedFiles;
+  std::vector<FilePath> m_crashedFiles;
+};
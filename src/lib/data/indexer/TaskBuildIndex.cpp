@@ -5,7 +5,7 @@
 #include "AppPath.h"
 #include "Blackboard.h"
 #include "DialogView.h"
-#include "InterprocessIndexer.h"
+#include "IndexerThreadPool.h"
 #include "MessageIndexingStatus.h"
 #include "MessageStatus.h"
 #include "ParserClientImpl.h"
@@ -18,11 +18,11 @@ TaskBuildIndex::TaskBuildIndex(size_t processCount,
                                std::shared_ptr<StorageProvider> storageProvider,
                                std::shared_ptr<DialogView> dialogView,
                                const std::string& appUUID,
-                               bool multiProcessIndexing)
+                               std::shared_ptr<IndexerThreadPool> indexerThreadPool)
     : m_storageProvider(storageProvider)
     , m_dialogView(dialogView)
     , m_appUUID(appUUID)
-    , m_multiProcessIndexing(multiProcessIndexing)
+    , m_indexerThreadPool(std::move(indexerThreadPool))
     , m_interprocessIndexingStatusManager(appUUID, 0, true)
     , m_indexerCommandQueueStopped(false)
     , m_processCount(processCount)
@@ -36,6 +36,12 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard) {
   m_indexingFileCount = 0;
   updateIndexingDialog(blackboard, std::vector<FilePath>());
 
+  if(m_indexerThreadPool) {
+    m_indexerThreadPool->start();
+    blackboard->set<bool>("indexer_threads_started", true);
+    return;
+  }
+
   // FIXME(Hussein): Multiprocess needs the file to log
   std::wstring logFilePath;
   // Logger* logger = LogManager::getInstance()->getLoggerByType("FileLogger");
@@ -55,26 +61,30 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard) {
     m_interprocessIntermediateStorageManagers.push_back(
         std::make_shared<InterprocessIntermediateStorageManager>(m_appUUID, processId, true));
 
-    if(m_multiProcessIndexing) {
-      m_processThreads.push_back(new std::thread(&TaskBuildIndex::runIndexerProcess, this, processId, logFilePath));
-    } else {
-      m_processThreads.push_back(new std::thread(&TaskBuildIndex::runIndexerThread, this, processId));
-    }
+    m_processThreads.push_back(new std::thread(&TaskBuildIndex::runIndexerProcess, this, processId, logFilePath));
   }
 
   blackboard->set<bool>("indexer_threads_started", true);
 }
 
 Task::TaskState TaskBuildIndex::doUpdate(std::shared_ptr<Blackboard> blackboard) {
+  const size_t updateCount = blackboard->getUpdateCount();
+
+  blackboard->get<bool>("indexer_command_queue_stopped", m_indexerCommandQueueStopped);
+
   size_t runningThreadCount = 0;
-  {
+  if(m_indexerThreadPool) {
+    if(m_indexerCommandQueueStopped) {
+      m_indexerThreadPool->finish();
+    }
+    runningThreadCount = m_indexerThreadPool->getRunningWorkerCount();
+  } else {
     std::lock_guard<std::mutex> lock(m_runningThreadCountMutex);
     runningThreadCount = m_runningThreadCount;
   }
 
-  blackboard->get<bool>("indexer_command_queue_stopped", m_indexerCommandQueueStopped);
-
-  const std::vector<FilePath> indexingFiles = m_interprocessIndexingStatusManager.getCurrentlyIndexedSourceFilePaths();
+  const std::vector<FilePath> indexingFiles = m_indexerThreadPool ? m_indexerThreadPool->popStartedSourceFilePaths() :
+                                                                    m_interprocessIndexingStatusManager.getCurrentlyIndexedSourceFilePaths();
   if(!indexingFiles.empty()) {
     updateIndexingDialog(blackboard, indexingFiles);
   }
@@ -92,12 +102,17 @@ Task::TaskState TaskBuildIndex::doUpdate(std::shared_ptr<Blackboard> blackboard)
     updateIndexingDialog(blackboard, std::vector<FilePath>());
   }
 
-  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  // indexers can't signal the blackboard, so their storages are polled
+  blackboard->waitForUpdate(updateCount, std::chrono::milliseconds(50));
 
   return STATE_RUNNING;
 }
 
 void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard) {
+  if(m_indexerThreadPool) {
+    m_indexerThreadPool->join();
+  }
+
   for(auto processThread : m_processThreads) {
     processThread->join();
     delete processThread;
@@ -109,7 +124,8 @@ void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard) {
       ;
   }
 
-  std::vector<FilePath> crashedFiles = m_interprocessIndexingStatusManager.getCrashedSourceFilePaths();
+  std::vector<FilePath> crashedFiles = m_indexerThreadPool ? m_indexerThreadPool->getCrashedSourceFilePaths() :
+                                                            m_interprocessIndexingStatusManager.getCrashedSourceFilePaths();
   if(!crashedFiles.empty()) {
     std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
     std::shared_ptr<ParserClientImpl> parserClient = std::make_shared<ParserClientImpl>(storage.get());
@@ -138,6 +154,9 @@ void TaskBuildIndex::doReset(std::shared_ptr<Blackboard> /*blackboard*/) {}
 
 void TaskBuildIndex::terminate() {
   m_interrupted = true;
+  if(m_indexerThreadPool) {
+    m_indexerThreadPool->interrupt();
+  }
   utility::killRunningProcesses();
 }
 
@@ -146,6 +165,9 @@ void TaskBuildIndex::handleMessage(MessageIndexingInterrupted* /*message*/) {
 
   m_interprocessIndexingStatusManager.setIndexingInterrupted(true);
   m_interrupted = true;
+  if(m_indexerThreadPool) {
+    m_indexerThreadPool->interrupt();
+  }
 
   m_dialogView->showUnknownProgressDialog(L"Interrupting Indexing", L"Waiting for indexer\nthreads to finish");
 }
@@ -181,37 +203,32 @@ void TaskBuildIndex::runIndexerProcess(int processId, const std::wstring& logFil
   }
 }
 
-void TaskBuildIndex::runIndexerThread(int processId) {
-  do {
-    InterprocessIndexer indexer(m_appUUID, processId);
-    indexer.work();    // this will only return if there are no indexer commands left in the queue
-    if(!m_interrupted) {
-      // sleeping if interrupted may result in a crash due to objects that are already
-      // destroyed after waking up again
-      std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    }
-  } while(!m_indexerCommandQueueStopped && !m_interrupted);
-
-  {
-    std::lock_guard<std::mutex> lock(m_runningThreadCountMutex);
-    m_runningThreadCount--;
-  }
-}
-
 bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> blackboard) {
   int poppedStorageCount = 0;
 
-  int providerStorageCount = m_storageProvider->getStorageCount();
-  if(providerStorageCount > 10) {
-    LOG_INFO(fmt::format("waiting, too many storages queued: {}", providerStorageCount));
+  const size_t providerByteSize = m_storageProvider->getByteSize();
+  if(providerByteSize > m_storageProvider->getByteSizeBudget()) {
+    LOG_INFO(fmt::format("waiting, too many storages queued: {} MB", providerByteSize / 1024 / 1024));
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // injecting a storage notifies the blackboard
+    blackboard->waitForUpdate(blackboard->getUpdateCount(), std::chrono::milliseconds(100));
 
     return true;
   }
 
   TimeStamp t = TimeStamp::now();
   do {
+    if(m_indexerThreadPool) {
+      std::shared_ptr<IntermediateStorage> storage = m_indexerThreadPool->popResult();
+      if(!storage) {
+        break;
+      }
+
+      m_storageProvider->insert(storage);
+      poppedStorageCount++;
+      continue;
+    }
+
     Id finishedProcessId = m_interprocessIndexingStatusManager.getNextFinishedProcessId();
     if(!finishedProcessId || finishedProcessId > m_interprocessIntermediateStorageManagers.size()) {
       break;
@@ -228,7 +245,8 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
     LOG_INFO(fmt::format("{} - storage count: {}", storageManager->getProcessId(), storageCount));
     m_storageProvider->insert(storageManager->popIntermediateStorage());
     poppedStorageCount++;
-  } while(TimeStamp::now().deltaMS(t) < 500);    // don't process all storages at once to allow for status updates in-between
+  } while(TimeStamp::now().deltaMS(t) < 500 &&    // don't process all storages at once to allow for status updates in-between
+          m_storageProvider->getByteSize() <= m_storageProvider->getByteSizeBudget());
 
   if(poppedStorageCount > 0) {
     blackboard->update<int>("indexed_source_file_count", [=](int count) { return count + poppedStorageCount; });
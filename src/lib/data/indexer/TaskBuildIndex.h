@@ -13,6 +13,7 @@
 class DialogView;
 class StorageProvider;
 class IndexerCommandList;
+class IndexerThreadPool;
 
 class TaskBuildIndex
     : public Task
@@ -22,7 +23,7 @@ public:
                  std::shared_ptr<StorageProvider> storageProvider,
                  std::shared_ptr<DialogView> dialogView,
                  const std::string& appUUID,
-                 bool multiProcessIndexing);
+                 std::shared_ptr<IndexerThreadPool> indexerThreadPool);
 
 protected:
   void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -34,7 +35,6 @@ protected:
   void handleMessage(MessageIndexingInterrupted* message) override;
 
   void runIndexerProcess(int processId, const std::wstring& logFilePath);
-  void runIndexerThread(int processId);
   bool fetchIntermediateStorages(std::shared_ptr<Blackboard> blackboard);
   void updateIndexingDialog(std::shared_ptr<Blackboard> blackboard, const std::vector<FilePath>& sourcePaths);
 
@@ -44,7 +44,8 @@ protected:
   std::shared_ptr<StorageProvider> m_storageProvider;
   std::shared_ptr<DialogView> m_dialogView;
   const std::string m_appUUID;
-  bool m_multiProcessIndexing;
+  // indexes within the app process if set, otherwise indexer processes are started
+  std::shared_ptr<IndexerThreadPool> m_indexerThreadPool;
 
   InterprocessIndexingStatusManager m_interprocessIndexingStatusManager;
   bool m_indexerCommandQueueStopped;
@@ -3,20 +3,26 @@
 #include "Blackboard.h"
 #include "FileSystem.h"
 #include "IndexerCommandProvider.h"
+#include "IndexerThreadPool.h"
 #include "logging.h"
 #include "utilityFile.h"
 
 TaskFillIndexerCommandsQueue::TaskFillIndexerCommandsQueue(const std::string& appUUID,
                                                            std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-                                                           size_t maximumQueueSize)
+                                                           size_t maximumQueueSize,
+                                                           std::map<std::wstring, uint64_t> indexingDurationsMS,
+                                                           std::shared_ptr<IndexerThreadPool> indexerThreadPool)
     : m_indexerCommandProvider(std::move(indexerCommandProvider))
     , m_indexerCommandManager(appUUID, 0, true)
+    , m_indexerThreadPool(std::move(indexerThreadPool))
+    , m_indexingDurationsMS(std::move(indexingDurationsMS))
     , m_maximumQueueSize(maximumQueueSize) {}
 
 void TaskFillIndexerCommandsQueue::doEnter(std::shared_ptr<Blackboard> blackboard) {
   {
     std::lock_guard<std::mutex> lock(m_commandsMutex);
-    for(const FilePath& filePath : utility::partitionFilePathsBySize(m_indexerCommandProvider->getAllSourceFilePaths(), 2)) {
+    for(const FilePath& filePath :
+        utility::orderFilePathsByIndexingCost(m_indexerCommandProvider->getAllSourceFilePaths(), m_indexingDurationsMS)) {
       m_filePathQueue.emplace(filePath);
     }
   }
@@ -26,12 +32,17 @@ void TaskFillIndexerCommandsQueue::doEnter(std::shared_ptr<Blackboard> blackboar
   blackboard->set<bool>("indexer_command_queue_started", true);
 }
 
-Task::TaskState TaskFillIndexerCommandsQueue::doUpdate(std::shared_ptr<Blackboard> /*blackboard*/) {
+Task::TaskState TaskFillIndexerCommandsQueue::doUpdate(std::shared_ptr<Blackboard> blackboard) {
   if(m_interrupted) {
     return STATE_FAILURE;
   }
 
-  if(!fillCommandQueue()) {
+  const size_t updateCount = blackboard->getUpdateCount();
+
+  if(fillCommandQueue()) {
+    // wakes up indexer threads waiting for commands
+    blackboard->notifyUpdate();
+  } else {
     std::lock_guard<std::mutex> lock(m_commandsMutex);
 
     if(m_indexerCommandProvider->empty()) {
@@ -39,7 +50,8 @@ Task::TaskState TaskFillIndexerCommandsQueue::doUpdate(std::shared_ptr<Blackboar
     }
   }
 
-  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  // fetching finished storages notifies the blackboard, which is when the queue has room again
+  blackboard->waitForUpdate(updateCount, std::chrono::milliseconds(200));
 
   return STATE_RUNNING;
 }
@@ -59,25 +71,30 @@ void TaskFillIndexerCommandsQueue::terminate() {
 void TaskFillIndexerCommandsQueue::handleMessage(MessageIndexingInterrupted* /*message*/) {
   std::lock_guard<std::mutex> lock(m_commandsMutex);
 
-  LOG_INFO("Discarding remaining " +
-           std::to_string(m_indexerCommandProvider->size() + m_indexerCommandManager.indexerCommandCount()) +
+  LOG_INFO("Discarding remaining " + std::to_string(m_indexerCommandProvider->size() + getQueuedCommandCount()) +
            " indexer commands.");
 
   std::queue<FilePath> empty;
   std::swap(m_filePathQueue, empty);
 
   m_indexerCommandProvider->clear();
-  m_indexerCommandManager.clearIndexerCommands();
+  if(m_indexerThreadPool) {
+    m_indexerThreadPool->clearCommands();
+  } else {
+    m_indexerCommandManager.clearIndexerCommands();
+  }
 
-  LOG_INFO("Remaining: " + std::to_string(m_indexerCommandProvider->size() + m_indexerCommandManager.indexerCommandCount()) + ".");
+  LOG_INFO("Remaining: " + std::to_string(m_indexerCommandProvider->size() + getQueuedCommandCount()) + ".");
 }
 
 bool TaskFillIndexerCommandsQueue::fillCommandQueue() {
-  size_t refillAmount = m_maximumQueueSize - m_indexerCommandManager.indexerCommandCount();
-  if(!refillAmount) {
+  const size_t queuedCommandCount = getQueuedCommandCount();
+  if(queuedCommandCount >= m_maximumQueueSize) {
     return false;
   }
 
+  const size_t refillAmount = m_maximumQueueSize - queuedCommandCount;
+
   std::lock_guard<std::mutex> lock(m_commandsMutex);
   std::vector<std::shared_ptr<IndexerCommand>> commands;
 
@@ -91,9 +108,17 @@ bool TaskFillIndexerCommandsQueue::fillCommandQueue() {
   }
 
   if(commands.size()) {
-    m_indexerCommandManager.pushIndexerCommands(commands);
+    if(m_indexerThreadPool) {
+      m_indexerThreadPool->pushCommands(commands);
+    } else {
+      m_indexerCommandManager.pushIndexerCommands(commands);
+    }
     return true;
   }
 
   return false;
 }
+
+size_t TaskFillIndexerCommandsQueue::getQueuedCommandCount() {
+  return m_indexerThreadPool ? m_indexerThreadPool->getQueuedCommandCount() : m_indexerCommandManager.indexerCommandCount();
+}
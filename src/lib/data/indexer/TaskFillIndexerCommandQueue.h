@@ -1,6 +1,8 @@
 #ifndef TASK_FILL_INDEXER_COMMAND_QUEUE_H
 #define TASK_FILL_INDEXER_COMMAND_QUEUE_H
 
+#include <cstdint>
+#include <map>
 #include <queue>
 
 #include "InterprocessIndexerCommandManager.h"
@@ -9,14 +11,19 @@
 #include "Task.h"
 
 class IndexerCommandProvider;
+class IndexerThreadPool;
 
 class TaskFillIndexerCommandsQueue
     : public Task
     , public MessageListener<MessageIndexingInterrupted> {
 public:
+  // commands are handed to the thread pool directly if one is passed, otherwise to the indexer processes.
+  // source files are queued by the indexing durations recorded in the previous runs, longest first
   TaskFillIndexerCommandsQueue(const std::string& appUUID,
                                std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-                               size_t maximumQueueSize);
+                               size_t maximumQueueSize,
+                               std::map<std::wstring, uint64_t> indexingDurationsMS = {},
+                               std::shared_ptr<IndexerThreadPool> indexerThreadPool = nullptr);
 
 protected:
   void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -28,10 +35,13 @@ protected:
   void handleMessage(MessageIndexingInterrupted* message) override;
 
   bool fillCommandQueue();
+  size_t getQueuedCommandCount();
 
 private:
   std::unique_ptr<IndexerCommandProvider> m_indexerCommandProvider;
   InterprocessIndexerCommandManager m_indexerCommandManager;
+  std::shared_ptr<IndexerThreadPool> m_indexerThreadPool;
+  const std::map<std::wstring, uint64_t> m_indexingDurationsMS;
 
   const size_t m_maximumQueueSize;
 
@@ -0,0 +1,30 @@
+#include "InterprocessIndexedHeaderRegistry.h"
+// internal
+#include "InterprocessIndexingStatusManager.h"
+
+InterprocessIndexedHeaderRegistry::InterprocessIndexedHeaderRegistry(InterprocessIndexingStatusManager& indexingStatusManager)
+    : m_indexingStatusManager(indexingStatusManager) {}
+
+Id InterprocessIndexedHeaderRegistry::createOwnerId() {
+  return m_indexingStatusManager.getProcessId();
+}
+
+bool InterprocessIndexedHeaderRegistry::claimHeader(const std::string& headerKey, Id /*ownerId*/) {
+  if(m_indexingStatusManager.claimIndexedHeader(headerKey)) {
+    m_provisionalHeaderKeys.push_back(headerKey);
+    return true;
+  }
+  return false;
+}
+
+void InterprocessIndexedHeaderRegistry::confirmClaims(Id /*ownerId*/) {
+  if(!m_provisionalHeaderKeys.empty()) {
+    m_indexingStatusManager.confirmIndexedHeaders(m_provisionalHeaderKeys);
+    m_provisionalHeaderKeys.clear();
+  }
+}
+
+void InterprocessIndexedHeaderRegistry::releaseClaims(Id /*ownerId*/) {
+  m_indexingStatusManager.releaseIndexedHeaders();
+  m_provisionalHeaderKeys.clear();
+}
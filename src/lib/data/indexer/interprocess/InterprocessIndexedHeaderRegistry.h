@@ -0,0 +1,20 @@
+#pragma once
+// internal
+#include "IndexedHeaderRegistry.h"
+
+class InterprocessIndexingStatusManager;
+
+// shares claimed headers between indexer processes through the indexing status shared memory, owned by the process id
+class InterprocessIndexedHeaderRegistry final : public IndexedHeaderRegistry {
+public:
+  explicit InterprocessIndexedHeaderRegistry(InterprocessIndexingStatusManager& indexingStatusManager);
+
+  Id createOwnerId() override;
+  bool claimHeader(const std::string& headerKey, Id ownerId) override;
+  void confirmClaims(Id ownerId) override;
+  void releaseClaims(Id ownerId) override;
+
+private:
+  InterprocessIndexingStatusManager& m_indexingStatusManager;
+  std::vector<std::string> m_provisionalHeaderKeys;
+};
@@ -1,11 +1,19 @@
 #include "InterprocessIndexer.h"
+// STL
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 // fmt
 #include <fmt/format.h>
 // internal
+#include "ApplicationSettings.h"
 #include "IndexerCommand.h"
 #include "IndexerComposite.h"
+#include "InterprocessIndexedHeaderRegistry.h"
+#include "IntermediateStorage.h"
 #include "LanguagePackageManager.h"
 #include "ScopedFunctor.h"
+#include "TimeStamp.h"
 #include "logging.h"
 
 InterprocessIndexer::InterprocessIndexer(const std::string& uuid, Id processId)
@@ -17,16 +25,25 @@ InterprocessIndexer::InterprocessIndexer(const std::string& uuid, Id processId)
 
 void InterprocessIndexer::work() {
   bool updaterThreadRunning = true;
+  std::mutex updaterMutex;
+  std::condition_variable updaterCondition;
   std::shared_ptr<std::thread> pUpdaterThread;
   std::shared_ptr<IndexerBase> pIndexer;
 
   try {
     LOG_INFO(fmt::format("{} starting up indexer", m_processId));
     pIndexer = LanguagePackageManager::getInstance()->instantiateSupportedIndexers();
+    if(ApplicationSettings::getInstance()->getCxxSkipIndexedHeadersEnabled()) {
+      pIndexer->setIndexedHeaderRegistry(std::make_shared<InterprocessIndexedHeaderRegistry>(m_interprocessIndexingStatusManager));
+    }
 
     pUpdaterThread = std::make_shared<std::thread>([&]() {
+      std::unique_lock<std::mutex> lock(updaterMutex);
       while(updaterThreadRunning) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        // the interrupt flag lives in shared memory and has to be polled, but stopping doesn't wait for the interval
+        if(updaterCondition.wait_for(lock, std::chrono::milliseconds(1000), [&]() { return !updaterThreadRunning; })) {
+          break;
+        }
 
         if(m_interprocessIndexingStatusManager.getIndexingInterrupted()) {
           LOG_INFO(fmt::format("{} received indexer interrupt command.", m_processId));
@@ -39,7 +56,11 @@ void InterprocessIndexer::work() {
     });
 
     ScopedFunctor threadStopper([&]() {
-      updaterThreadRunning = false;
+      {
+        std::lock_guard<std::mutex> lock(updaterMutex);
+        updaterThreadRunning = false;
+      }
+      updaterCondition.notify_all();
       if(pUpdaterThread) {
         pUpdaterThread->join();
         pUpdaterThread.reset();
@@ -50,30 +71,48 @@ void InterprocessIndexer::work() {
       LOG_INFO(fmt::format("{} fetched indexer command for \"{}\"", m_processId, pIndexerCommand->getSourceFilePath().str()));
       LOG_INFO(fmt::format("{} indexer commands left: {}", m_processId, m_interprocessIndexerCommandManager.indexerCommandCount()));
 
-      while(updaterThreadRunning) {
-        const size_t storageCount = m_interprocessIntermediateStorageManager.getIntermediateStorageCount();
-        if(storageCount < 2) {
-          break;
-        }
+      {
+        std::unique_lock<std::mutex> lock(updaterMutex);
+        while(updaterThreadRunning) {
+          const size_t storageCount = m_interprocessIntermediateStorageManager.getIntermediateStorageCount();
+          if(storageCount < 2) {
+            break;
+          }
 
-        LOG_INFO(fmt::format("{} waits, too many intermediate storages: {}", m_processId, storageCount));
+          LOG_INFO(fmt::format("{} waits, too many intermediate storages: {}", m_processId, storageCount));
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
-      }
+          // the app fetches storages from shared memory, so only an interrupt can wake this up early
+          updaterCondition.wait_for(lock, std::chrono::milliseconds(200), [&]() { return !updaterThreadRunning; });
+        }
 
-      if(!updaterThreadRunning) {
-        break;
+        if(!updaterThreadRunning) {
+          break;
+        }
       }
 
       LOG_INFO(fmt::format("{} updating indexer status with currently indexed filepath", m_processId));
       m_interprocessIndexingStatusManager.startIndexingSourceFile(pIndexerCommand->getSourceFilePath());
 
       LOG_INFO(fmt::format("{} starting to index current file", m_processId));
-      auto pResult = pIndexer->index(pIndexerCommand);
+      const TimeStamp indexStart = TimeStamp::now();
+      std::shared_ptr<IntermediateStorage> pResult;
+      {
+        // a throwing translation unit must not keep the headers it claimed
+        ScopedFunctor headerReleaser([&]() {
+          if(!pResult) {
+            pIndexer->releaseIndexedHeaders();
+          }
+        });
+        pResult = pIndexer->index(pIndexerCommand);
+      }
 
       if(pResult) {
+        pResult->addIndexingCosts(
+            {StorageIndexingCost(pIndexerCommand->getSourceFilePath().wstr(), TimeStamp::now().deltaMS(indexStart))});
+
         LOG_INFO(fmt::format("{} spushing index to shared memory", m_processId));
         m_interprocessIntermediateStorageManager.pushIntermediateStorage(pResult);
+        pIndexer->confirmIndexedHeaders();
       }
 
       LOG_INFO(fmt::format("{} sfinalizing indexer status for current file", m_processId));
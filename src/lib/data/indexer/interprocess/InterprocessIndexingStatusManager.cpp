@@ -10,6 +10,7 @@ const char* InterprocessIndexingStatusManager::s_currentFilesKeyName = "current_
 const char* InterprocessIndexingStatusManager::s_crashedFilesKeyName = "crashed_files";
 const char* InterprocessIndexingStatusManager::s_finishedProcessIdsKeyName = "finished_process_ids";
 const char* InterprocessIndexingStatusManager::s_indexingInterruptedKeyName = "indexing_interrupted_flag";
+const char* InterprocessIndexingStatusManager::s_indexedHeadersKeyName = "indexed_headers";
 
 InterprocessIndexingStatusManager::InterprocessIndexingStatusManager(const std::string& instanceUuid, Id processId, bool isOwner)
     : BaseInterprocessDataManager(s_sharedMemoryNamePrefix + instanceUuid, 1048576 /* 1 MB */, instanceUuid, processId, isOwner) {}
@@ -60,6 +61,9 @@ void InterprocessIndexingStatusManager::startIndexingSourceFile(const FilePath&
       if(crashedFilesPtr) {
         crashedFilesPtr->push_back(it->second);
       }
+
+      // the crashed translation unit never handed on the headers it claimed
+      releaseIndexedHeaders(access);
     }
 
     SharedMemory::String str(access.getAllocator());
@@ -161,3 +165,71 @@ std::vector<FilePath> InterprocessIndexingStatusManager::getCrashedSourceFilePat
 
   return crashedFiles;
 }
+
+bool InterprocessIndexingStatusManager::claimIndexedHeader(const std::string& headerKey) {
+  SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+  const size_t overestimationMultiplier = 3;
+  const size_t estimatedSize = (1024 + sizeof(SharedMemory::String) + headerKey.size()) * overestimationMultiplier;
+  while(access.getFreeMemorySize() < estimatedSize) {
+    access.growMemory(access.getMemorySize());
+  }
+
+  SharedMemory::Map<SharedMemory::String, Id>* indexedHeadersPtr =
+      access.accessValueWithAllocator<SharedMemory::Map<SharedMemory::String, Id>>(s_indexedHeadersKeyName);
+  if(indexedHeadersPtr == nullptr) {
+    // without the registry every indexer records the header itself
+    return true;
+  }
+
+  SharedMemory::String keyStr(access.getAllocator());
+  keyStr = headerKey.c_str();
+  auto result = indexedHeadersPtr->insert(std::pair<const SharedMemory::String, Id>(keyStr, getHeaderClaimOwnerId()));
+  // only confirmed claims are skipped, the claiming process may still fail
+  return result.second || result.first->second != 0;
+}
+
+void InterprocessIndexingStatusManager::confirmIndexedHeaders(const std::vector<std::string>& headerKeys) {
+  SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+  SharedMemory::Map<SharedMemory::String, Id>* indexedHeadersPtr =
+      access.accessValueWithAllocator<SharedMemory::Map<SharedMemory::String, Id>>(s_indexedHeadersKeyName);
+  if(indexedHeadersPtr == nullptr) {
+    return;
+  }
+
+  SharedMemory::String keyStr(access.getAllocator());
+  for(const std::string& headerKey : headerKeys) {
+    keyStr = headerKey.c_str();
+    auto it = indexedHeadersPtr->find(keyStr);
+    if(it != indexedHeadersPtr->end() && it->second == getHeaderClaimOwnerId()) {
+      it->second = 0;
+    }
+  }
+}
+
+void InterprocessIndexingStatusManager::releaseIndexedHeaders() {
+  SharedMemory::ScopedAccess access(&m_sharedMemory);
+  releaseIndexedHeaders(access);
+}
+
+Id InterprocessIndexingStatusManager::getHeaderClaimOwnerId() const {
+  // 0 marks confirmed claims, but the app process has id 0 as well
+  return getProcessId() + 1;
+}
+
+void InterprocessIndexingStatusManager::releaseIndexedHeaders(SharedMemory::ScopedAccess& access) {
+  SharedMemory::Map<SharedMemory::String, Id>* indexedHeadersPtr =
+      access.accessValueWithAllocator<SharedMemory::Map<SharedMemory::String, Id>>(s_indexedHeadersKeyName);
+  if(indexedHeadersPtr == nullptr) {
+    return;
+  }
+
+  for(auto it = indexedHeadersPtr->begin(); it != indexedHeadersPtr->end();) {
+    if(it->second == getHeaderClaimOwnerId()) {
+      it = indexedHeadersPtr->erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
@@ -22,7 +22,17 @@ public:
   std::vector<FilePath> getCurrentlyIndexedSourceFilePaths();
   std::vector<FilePath> getCrashedSourceFilePaths();
 
+  // returns true if no other indexer process claimed the header key during this indexing run before
+  bool claimIndexedHeader(const std::string& headerKey);
+  // makes the claims of this process permanent after its intermediate storage was pushed
+  void confirmIndexedHeaders(const std::vector<std::string>& headerKeys);
+  // drops all provisional claims of this process
+  void releaseIndexedHeaders();
+
 private:
+  Id getHeaderClaimOwnerId() const;
+  void releaseIndexedHeaders(SharedMemory::ScopedAccess& access);
+
   static const char* s_sharedMemoryNamePrefix;
 
   static const char* s_indexingFilesKeyName;
@@ -30,6 +40,7 @@ private:
   static const char* s_crashedFilesKeyName;
   static const char* s_finishedProcessIdsKeyName;
   static const char* s_indexingInterruptedKeyName;
+  static const char* s_indexedHeadersKeyName;
 };
 
 #endif    // INTERPROCESS_INDEXING_STATUS_MANAGER_H
@@ -1,7 +1,7 @@
 #include "InterprocessIntermediateStorageManager.h"
 
+#include "FlatIntermediateStorage.h"
 #include "IntermediateStorage.h"
-#include "SharedIntermediateStorage.h"
 #include "logging.h"
 
 const char* InterprocessIntermediateStorageManager::s_sharedMemoryNamePrefix = "iist_";
@@ -21,10 +21,10 @@ InterprocessIntermediateStorageManager::InterprocessIntermediateStorageManager(c
 void InterprocessIntermediateStorageManager::pushIntermediateStorage(const std::shared_ptr<IntermediateStorage>& intermediateStorage) {
   const size_t requiredInsertsToShrink = 10;
 
-  const size_t overestimationMultiplier = 2;
-  const size_t requiredSize = (intermediateStorage->getByteSize(sizeof(SharedMemory::String)) + sizeof(SharedIntermediateStorage)) *
-          overestimationMultiplier +
-      1048576 /* 1 MB */;
+  // the allocator's block headers and the queue's own bookkeeping
+  const size_t allocationOverhead = 4096;
+  const size_t byteSize = FlatIntermediateStorage::getByteSize(*intermediateStorage);
+  const size_t requiredSize = byteSize + allocationOverhead;
 
   SharedMemory::ScopedAccess access(&m_sharedMemory);
 
@@ -47,27 +47,40 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(const std::
     m_insertsWithoutGrowth++;
   }
 
-  SharedMemory::Queue<SharedIntermediateStorage>* queue =
-      access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(s_intermediateStoragesKeyName);
-  if(!queue) {
-    return;
+  const size_t maxAllocationAttempts = 3;
+  for(size_t attempt = 1;; attempt++) {
+    SharedMemory::Queue<SharedMemory::Vector<char>>* queue =
+        access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::Vector<char>>>(s_intermediateStoragesKeyName);
+    if(!queue) {
+      return;
+    }
+
+    bool pushed = false;
+    try {
+      queue->push_back(SharedMemory::Vector<char>(access.getAllocator()));
+      pushed = true;
+      queue->back().resize(byteSize);
+      FlatIntermediateStorage::write(*intermediateStorage, &queue->back()[0]);
+      break;
+    } catch(boost::interprocess::bad_alloc&) {
+      if(pushed) {
+        queue->pop_back();
+      }
+
+      if(attempt >= maxAllocationAttempts) {
+        throw;
+      }
+
+      // free memory is fragmented, growing appends a block that fits the buffer on its own
+      LOG_INFO(fmt::format("allocating {} bytes failed, grow memory - size: {} free: {}",
+                           byteSize,
+                           access.getMemorySize(),
+                           access.getFreeMemorySize()));
+      access.growMemory(requiredSize);
+      m_insertsWithoutGrowth = 0;
+    }
   }
 
-  queue->push_back(SharedIntermediateStorage(access.getAllocator()));
-  SharedIntermediateStorage& storage = queue->back();
-
-  storage.setStorageNodes(intermediateStorage->getStorageNodes());
-  storage.setStorageFiles(intermediateStorage->getStorageFiles());
-  storage.setStorageSymbols(intermediateStorage->getStorageSymbols());
-  storage.setStorageEdges(intermediateStorage->getStorageEdges());
-  storage.setStorageLocalSymbols(intermediateStorage->getStorageLocalSymbols());
-  storage.setStorageSourceLocations(intermediateStorage->getStorageSourceLocations());
-  storage.setStorageOccurrences(intermediateStorage->getStorageOccurrences());
-  storage.setStorageComponentAccesses(intermediateStorage->getComponentAccesses());
-  storage.setStorageErrors(intermediateStorage->getErrors());
-
-  storage.setNextId(intermediateStorage->getNextId());
-
   if(m_insertsWithoutGrowth >= requiredInsertsToShrink) {
     m_insertsWithoutGrowth = 0;
 
@@ -82,39 +95,27 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(const std::
 std::shared_ptr<IntermediateStorage> InterprocessIntermediateStorageManager::popIntermediateStorage() {
   SharedMemory::ScopedAccess access(&m_sharedMemory);
 
-  SharedMemory::Queue<SharedIntermediateStorage>* queue =
-      access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(s_intermediateStoragesKeyName);
+  SharedMemory::Queue<SharedMemory::Vector<char>>* queue =
+      access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::Vector<char>>>(s_intermediateStoragesKeyName);
   if(!queue || !queue->size()) {
     return nullptr;
   }
 
-  SharedIntermediateStorage& sharedIntermediateStorage = queue->front();
-
-  std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
-
-  storage->setStorageNodes(sharedIntermediateStorage.getStorageNodes());
-  storage->setStorageFiles(sharedIntermediateStorage.getStorageFiles());
-  storage->setStorageSymbols(sharedIntermediateStorage.getStorageSymbols());
-  storage->setStorageEdges(sharedIntermediateStorage.getStorageEdges());
-  storage->setStorageLocalSymbols(sharedIntermediateStorage.getStorageLocalSymbols());
-  storage->setStorageSourceLocations(sharedIntermediateStorage.getStorageSourceLocations());
-  storage->setStorageOccurrences(sharedIntermediateStorage.getStorageOccurrences());
-  storage->setComponentAccesses(sharedIntermediateStorage.getStorageComponentAccesses());
-  storage->setErrors(sharedIntermediateStorage.getStorageErrors());
-
-  storage->setNextId(sharedIntermediateStorage.getNextId());
+  // decoded straight from the mapped segment, the buffer is released right after
+  const SharedMemory::Vector<char>& buffer = queue->front();
+  std::shared_ptr<IntermediateStorage> intermediateStorage = FlatIntermediateStorage::read(buffer.data(), buffer.size());
 
   queue->pop_front();
   LOG_INFO(access.logString());
 
-  return storage;
+  return intermediateStorage;
 }
 
 size_t InterprocessIntermediateStorageManager::getIntermediateStorageCount() {
   SharedMemory::ScopedAccess access(&m_sharedMemory);
 
-  SharedMemory::Queue<SharedIntermediateStorage>* queue =
-      access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(s_intermediateStoragesKeyName);
+  SharedMemory::Queue<SharedMemory::Vector<char>>* queue =
+      access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::Vector<char>>>(s_intermediateStoragesKeyName);
   if(!queue) {
     return 0;
   }
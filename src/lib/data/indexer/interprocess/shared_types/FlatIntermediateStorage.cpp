@@ -0,0 +1,423 @@
+#include "FlatIntermediateStorage.h"
+// STL
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+// internal
+#include "IntermediateStorage.h"
+#include "logging.h"
+
+namespace {
+constexpr uint32_t s_magic = 0x54534953;    // "SIST"
+constexpr uint32_t s_version = 2;
+
+enum Section : size_t {
+  SECTION_NODES = 0,
+  SECTION_FILES,
+  SECTION_SYMBOLS,
+  SECTION_EDGES,
+  SECTION_LOCAL_SYMBOLS,
+  SECTION_SOURCE_LOCATIONS,
+  SECTION_OCCURRENCES,
+  SECTION_COMPONENT_ACCESSES,
+  SECTION_ELEMENT_COMPONENTS,
+  SECTION_ERRORS,
+  SECTION_INDEXING_COSTS,
+  SECTION_COUNT
+};
+
+struct SectionInfo {
+  uint64_t offset;
+  uint64_t count;
+};
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t nextId;
+  uint64_t stringPoolOffset;
+  uint64_t stringPoolSize;
+  SectionInfo sections[SECTION_COUNT];
+};
+
+// byte range inside the string pool
+struct StringRef {
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct FlatNode {
+  uint64_t id;
+  int64_t type;
+  StringRef serializedName;
+};
+
+struct FlatFile {
+  uint64_t id;
+  StringRef filePath;
+  StringRef languageIdentifier;
+  StringRef modificationTime;
+  uint8_t indexed;
+  uint8_t complete;
+};
+
+struct FlatLocalSymbol {
+  uint64_t id;
+  StringRef name;
+};
+
+struct FlatElementComponent {
+  uint64_t elementId;
+  int64_t type;
+  StringRef data;
+};
+
+struct FlatError {
+  uint64_t id;
+  StringRef message;
+  StringRef translationUnit;
+  uint8_t fatal;
+  uint8_t indexed;
+};
+
+struct FlatIndexingCost {
+  StringRef sourceFilePath;
+  uint64_t durationMS;
+};
+
+static_assert(std::is_trivially_copyable_v<StorageSymbol>);
+static_assert(std::is_trivially_copyable_v<StorageEdge>);
+static_assert(std::is_trivially_copyable_v<StorageSourceLocation>);
+static_assert(std::is_trivially_copyable_v<StorageOccurrence>);
+static_assert(std::is_trivially_copyable_v<StorageComponentAccess>);
+
+size_t align(size_t size) {
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+template <typename StringT>
+size_t byteSizeOf(const StringT& str) {
+  return str.size() * sizeof(typename StringT::value_type);
+}
+
+Header createHeader(const IntermediateStorage& storage) {
+  Header header {};
+  header.magic = s_magic;
+  header.version = s_version;
+  header.nextId = static_cast<uint64_t>(storage.getNextId());
+
+  size_t offset = align(sizeof(Header));
+  auto addSection = [&header, &offset](Section section, size_t count, size_t recordSize) {
+    header.sections[section] = {offset, count};
+    offset = align(offset + count * recordSize);
+  };
+
+  addSection(SECTION_NODES, storage.getStorageNodes().size(), sizeof(FlatNode));
+  addSection(SECTION_FILES, storage.getStorageFiles().size(), sizeof(FlatFile));
+  addSection(SECTION_SYMBOLS, storage.getStorageSymbols().size(), sizeof(StorageSymbol));
+  addSection(SECTION_EDGES, storage.getStorageEdges().size(), sizeof(StorageEdge));
+  addSection(SECTION_LOCAL_SYMBOLS, storage.getStorageLocalSymbols().size(), sizeof(FlatLocalSymbol));
+  addSection(SECTION_SOURCE_LOCATIONS, storage.getStorageSourceLocations().size(), sizeof(StorageSourceLocation));
+  addSection(SECTION_OCCURRENCES, storage.getStorageOccurrences().size(), sizeof(StorageOccurrence));
+  addSection(SECTION_COMPONENT_ACCESSES, storage.getComponentAccesses().size(), sizeof(StorageComponentAccess));
+  addSection(SECTION_ELEMENT_COMPONENTS, storage.getElementComponents().size(), sizeof(FlatElementComponent));
+  addSection(SECTION_ERRORS, storage.getErrors().size(), sizeof(FlatError));
+  addSection(SECTION_INDEXING_COSTS, storage.getIndexingCosts().size(), sizeof(FlatIndexingCost));
+
+  size_t stringPoolSize = 0;
+  for(const StorageNode& node : storage.getStorageNodes()) {
+    stringPoolSize += byteSizeOf(node.serializedName);
+  }
+  for(const StorageFile& file : storage.getStorageFiles()) {
+    stringPoolSize += byteSizeOf(file.filePath) + byteSizeOf(file.languageIdentifier) + byteSizeOf(file.modificationTime);
+  }
+  for(const StorageLocalSymbol& localSymbol : storage.getStorageLocalSymbols()) {
+    stringPoolSize += byteSizeOf(localSymbol.name);
+  }
+  for(const StorageElementComponent& component : storage.getElementComponents()) {
+    stringPoolSize += byteSizeOf(component.data);
+  }
+  for(const StorageError& error : storage.getErrors()) {
+    stringPoolSize += byteSizeOf(error.message) + byteSizeOf(error.translationUnit);
+  }
+  for(const StorageIndexingCost& indexingCost : storage.getIndexingCosts()) {
+    stringPoolSize += byteSizeOf(indexingCost.sourceFilePath);
+  }
+
+  header.stringPoolOffset = offset;
+  header.stringPoolSize = stringPoolSize;
+  return header;
+}
+
+class Writer {
+public:
+  Writer(char* buffer, const Header& header) : m_buffer(buffer), m_header(header) {
+    std::memcpy(m_buffer, &m_header, sizeof(Header));
+  }
+
+  template <typename T>
+  void writeRecords(Section section, const std::vector<T>& records) {
+    if(!records.empty()) {
+      std::memcpy(m_buffer + m_header.sections[section].offset, records.data(), records.size() * sizeof(T));
+    }
+  }
+
+  template <typename FlatT>
+  void writeFlatRecord(Section section, size_t index, const FlatT& record) {
+    std::memcpy(m_buffer + m_header.sections[section].offset + index * sizeof(FlatT), &record, sizeof(FlatT));
+  }
+
+  template <typename StringT>
+  StringRef writeString(const StringT& str) {
+    const StringRef ref = {m_stringOffset, byteSizeOf(str)};
+    if(ref.size) {
+      std::memcpy(m_buffer + m_header.stringPoolOffset + m_stringOffset, str.data(), ref.size);
+    }
+    m_stringOffset += ref.size;
+    return ref;
+  }
+
+private:
+  char* m_buffer;
+  const Header m_header;
+  uint64_t m_stringOffset = 0;
+};
+
+class Reader {
+public:
+  Reader(const char* buffer, size_t bufferSize) : m_buffer(buffer), m_bufferSize(bufferSize) {}
+
+  bool readHeader() {
+    if(m_bufferSize < sizeof(Header)) {
+      return false;
+    }
+
+    std::memcpy(&m_header, m_buffer, sizeof(Header));
+    if(m_header.magic != s_magic || m_header.version != s_version) {
+      return false;
+    }
+
+    if(m_header.stringPoolOffset > m_bufferSize || m_header.stringPoolSize > m_bufferSize - m_header.stringPoolOffset) {
+      return false;
+    }
+
+    const size_t recordSizes[SECTION_COUNT] = {sizeof(FlatNode),
+                                               sizeof(FlatFile),
+                                               sizeof(StorageSymbol),
+                                               sizeof(StorageEdge),
+                                               sizeof(FlatLocalSymbol),
+                                               sizeof(StorageSourceLocation),
+                                               sizeof(StorageOccurrence),
+                                               sizeof(StorageComponentAccess),
+                                               sizeof(FlatElementComponent),
+                                               sizeof(FlatError),
+                                               sizeof(FlatIndexingCost)};
+    for(size_t i = 0; i < SECTION_COUNT; i++) {
+      const SectionInfo& section = m_header.sections[i];
+      if(section.offset > m_header.stringPoolOffset ||
+         section.count > (m_header.stringPoolOffset - section.offset) / recordSizes[i]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  const Header& getHeader() const {
+    return m_header;
+  }
+
+  bool isValid() const {
+    return m_valid;
+  }
+
+  template <typename T>
+  std::vector<T> readRecords(Section section) {
+    std::vector<T> records(m_header.sections[section].count);
+    if(!records.empty()) {
+      std::memcpy(records.data(), m_buffer + m_header.sections[section].offset, records.size() * sizeof(T));
+    }
+    return records;
+  }
+
+  template <typename FlatT>
+  FlatT readFlatRecord(Section section, size_t index) const {
+    FlatT record;
+    std::memcpy(&record, m_buffer + m_header.sections[section].offset + index * sizeof(FlatT), sizeof(FlatT));
+    return record;
+  }
+
+  template <typename StringT>
+  StringT readString(const StringRef& ref) {
+    using CharT = typename StringT::value_type;
+    if(ref.offset > m_header.stringPoolSize || ref.size > m_header.stringPoolSize - ref.offset || ref.size % sizeof(CharT)) {
+      m_valid = false;
+      return StringT();
+    }
+
+    StringT str(ref.size / sizeof(CharT), CharT(0));
+    if(ref.size) {
+      std::memcpy(&str[0], m_buffer + m_header.stringPoolOffset + ref.offset, ref.size);
+    }
+    return str;
+  }
+
+private:
+  const char* m_buffer;
+  const size_t m_bufferSize;
+  Header m_header {};
+  bool m_valid = true;
+};
+}    // namespace
+
+size_t FlatIntermediateStorage::getByteSize(const IntermediateStorage& storage) {
+  const Header header = createHeader(storage);
+  return header.stringPoolOffset + header.stringPoolSize;
+}
+
+void FlatIntermediateStorage::write(const IntermediateStorage& storage, char* buffer) {
+  Writer writer(buffer, createHeader(storage));
+
+  const std::vector<StorageNode>& nodes = storage.getStorageNodes();
+  for(size_t i = 0; i < nodes.size(); i++) {
+    const StorageNode& node = nodes[i];
+    writer.writeFlatRecord(SECTION_NODES, i, FlatNode {node.id, node.type, writer.writeString(node.serializedName)});
+  }
+
+  const std::vector<StorageFile>& files = storage.getStorageFiles();
+  for(size_t i = 0; i < files.size(); i++) {
+    const StorageFile& file = files[i];
+    FlatFile flatFile {};
+    flatFile.id = file.id;
+    flatFile.filePath = writer.writeString(file.filePath);
+    flatFile.languageIdentifier = writer.writeString(file.languageIdentifier);
+    flatFile.modificationTime = writer.writeString(file.modificationTime);
+    flatFile.indexed = file.indexed;
+    flatFile.complete = file.complete;
+    writer.writeFlatRecord(SECTION_FILES, i, flatFile);
+  }
+
+  writer.writeRecords(SECTION_SYMBOLS, storage.getStorageSymbols());
+  writer.writeRecords(SECTION_EDGES, storage.getStorageEdges());
+
+  const std::vector<StorageLocalSymbol>& localSymbols = storage.getStorageLocalSymbols();
+  for(size_t i = 0; i < localSymbols.size(); i++) {
+    const StorageLocalSymbol& localSymbol = localSymbols[i];
+    writer.writeFlatRecord(SECTION_LOCAL_SYMBOLS, i, FlatLocalSymbol {localSymbol.id, writer.writeString(localSymbol.name)});
+  }
+
+  writer.writeRecords(SECTION_SOURCE_LOCATIONS, storage.getStorageSourceLocations());
+  writer.writeRecords(SECTION_OCCURRENCES, storage.getStorageOccurrences());
+  writer.writeRecords(SECTION_COMPONENT_ACCESSES, storage.getComponentAccesses());
+
+  const std::vector<StorageElementComponent>& components = storage.getElementComponents();
+  for(size_t i = 0; i < components.size(); i++) {
+    const StorageElementComponent& component = components[i];
+    writer.writeFlatRecord(SECTION_ELEMENT_COMPONENTS,
+                           i,
+                           FlatElementComponent {component.elementId, component.type, writer.writeString(component.data)});
+  }
+
+  const std::vector<StorageError>& errors = storage.getErrors();
+  for(size_t i = 0; i < errors.size(); i++) {
+    const StorageError& error = errors[i];
+    FlatError flatError {};
+    flatError.id = error.id;
+    flatError.message = writer.writeString(error.message);
+    flatError.translationUnit = writer.writeString(error.translationUnit);
+    flatError.fatal = error.fatal;
+    flatError.indexed = error.indexed;
+    writer.writeFlatRecord(SECTION_ERRORS, i, flatError);
+  }
+
+  const std::vector<StorageIndexingCost>& indexingCosts = storage.getIndexingCosts();
+  for(size_t i = 0; i < indexingCosts.size(); i++) {
+    const StorageIndexingCost& indexingCost = indexingCosts[i];
+    writer.writeFlatRecord(
+        SECTION_INDEXING_COSTS, i, FlatIndexingCost {writer.writeString(indexingCost.sourceFilePath), indexingCost.durationMS});
+  }
+}
+
+std::shared_ptr<IntermediateStorage> FlatIntermediateStorage::read(const char* buffer, size_t bufferSize) {
+  Reader reader(buffer, bufferSize);
+  if(!reader.readHeader()) {
+    LOG_ERROR("Invalid flat intermediate storage header.");
+    return nullptr;
+  }
+
+  const Header& header = reader.getHeader();
+
+  std::vector<StorageNode> nodes;
+  nodes.reserve(header.sections[SECTION_NODES].count);
+  for(size_t i = 0; i < header.sections[SECTION_NODES].count; i++) {
+    const FlatNode node = reader.readFlatRecord<FlatNode>(SECTION_NODES, i);
+    nodes.emplace_back(
+        static_cast<Id>(node.id), static_cast<int>(node.type), reader.readString<std::wstring>(node.serializedName));
+  }
+
+  std::vector<StorageFile> files;
+  files.reserve(header.sections[SECTION_FILES].count);
+  for(size_t i = 0; i < header.sections[SECTION_FILES].count; i++) {
+    const FlatFile file = reader.readFlatRecord<FlatFile>(SECTION_FILES, i);
+    files.emplace_back(static_cast<Id>(file.id),
+                       reader.readString<std::wstring>(file.filePath),
+                       reader.readString<std::wstring>(file.languageIdentifier),
+                       reader.readString<std::string>(file.modificationTime),
+                       file.indexed != 0,
+                       file.complete != 0);
+  }
+
+  std::vector<StorageLocalSymbol> localSymbols;
+  localSymbols.reserve(header.sections[SECTION_LOCAL_SYMBOLS].count);
+  for(size_t i = 0; i < header.sections[SECTION_LOCAL_SYMBOLS].count; i++) {
+    const FlatLocalSymbol localSymbol = reader.readFlatRecord<FlatLocalSymbol>(SECTION_LOCAL_SYMBOLS, i);
+    localSymbols.emplace_back(static_cast<Id>(localSymbol.id), reader.readString<std::wstring>(localSymbol.name));
+  }
+
+  std::vector<StorageElementComponent> components;
+  components.reserve(header.sections[SECTION_ELEMENT_COMPONENTS].count);
+  for(size_t i = 0; i < header.sections[SECTION_ELEMENT_COMPONENTS].count; i++) {
+    const FlatElementComponent component = reader.readFlatRecord<FlatElementComponent>(SECTION_ELEMENT_COMPONENTS, i);
+    components.emplace_back(
+        static_cast<Id>(component.elementId), static_cast<int>(component.type), reader.readString<std::wstring>(component.data));
+  }
+
+  std::vector<StorageError> errors;
+  errors.reserve(header.sections[SECTION_ERRORS].count);
+  for(size_t i = 0; i < header.sections[SECTION_ERRORS].count; i++) {
+    const FlatError error = reader.readFlatRecord<FlatError>(SECTION_ERRORS, i);
+    errors.emplace_back(static_cast<Id>(error.id),
+                        reader.readString<std::wstring>(error.message),
+                        reader.readString<std::wstring>(error.translationUnit),
+                        error.fatal != 0,
+                        error.indexed != 0);
+  }
+
+  std::vector<StorageIndexingCost> indexingCosts;
+  indexingCosts.reserve(header.sections[SECTION_INDEXING_COSTS].count);
+  for(size_t i = 0; i < header.sections[SECTION_INDEXING_COSTS].count; i++) {
+    const FlatIndexingCost indexingCost = reader.readFlatRecord<FlatIndexingCost>(SECTION_INDEXING_COSTS, i);
+    indexingCosts.emplace_back(reader.readString<std::wstring>(indexingCost.sourceFilePath), indexingCost.durationMS);
+  }
+
+  if(!reader.isValid()) {
+    LOG_ERROR("Invalid string reference in flat intermediate storage.");
+    return nullptr;
+  }
+
+  std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+  storage->setStorageNodes(std::move(nodes));
+  storage->setStorageFiles(std::move(files));
+  storage->setStorageSymbols(reader.readRecords<StorageSymbol>(SECTION_SYMBOLS));
+  storage->setStorageEdges(reader.readRecords<StorageEdge>(SECTION_EDGES));
+  storage->setStorageLocalSymbols(std::move(localSymbols));
+  storage->setStorageSourceLocations(reader.readRecords<StorageSourceLocation>(SECTION_SOURCE_LOCATIONS));
+  storage->setStorageOccurrences(reader.readRecords<StorageOccurrence>(SECTION_OCCURRENCES));
+  storage->setComponentAccesses(reader.readRecords<StorageComponentAccess>(SECTION_COMPONENT_ACCESSES));
+  storage->setElementComponents(std::move(components));
+  storage->setErrors(std::move(errors));
+  storage->setIndexingCosts(std::move(indexingCosts));
+  storage->setNextId(static_cast<Id>(header.nextId));
+  return storage;
+}
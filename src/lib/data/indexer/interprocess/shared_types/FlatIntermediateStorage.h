@@ -0,0 +1,31 @@
+#pragma once
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class IntermediateStorage;
+
+/*
+ * FlatIntermediateStorage
+ *
+ * Position independent single buffer encoding of an IntermediateStorage. The indexer process writes it in one pass into
+ * a preallocated block of shared memory and the app reads it back in place:
+ *
+ * - header with section offsets and record counts
+ * - trivially copyable records (symbols, edges, locations, occurrences, accesses) as raw arrays
+ * - records with strings (nodes, files, local symbols, components, errors, indexing costs) as fixed size entries
+ *   referring into one string pool at the end of the buffer
+ *
+ * Both sides run the same binary, so records are stored in their native layout.
+ */
+class FlatIntermediateStorage {
+public:
+  static size_t getByteSize(const IntermediateStorage& storage);
+
+  // buffer has to provide at least getByteSize() bytes
+  static void write(const IntermediateStorage& storage, char* buffer);
+
+  // returns nullptr if the buffer does not contain a valid encoding
+  static std::shared_ptr<IntermediateStorage> read(const char* buffer, size_t bufferSize);
+};
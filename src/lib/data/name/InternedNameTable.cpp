@@ -0,0 +1,114 @@
+#include "InternedNameTable.h"
+
+#include "logging.h"
+#include "utilityHash.h"
+
+namespace {
+// separates the elements of a serialized name hierarchy, see NameHierarchy::serialize()
+const std::wstring_view s_elementDelimiter = L"\tn";
+
+template <typename FuncT>
+bool forEachElement(const std::wstring& serializedName, FuncT func) {
+  size_t begin = 0;
+  while(true) {
+    const size_t end = serializedName.find(s_elementDelimiter, begin);
+    if(!func(std::wstring_view(serializedName).substr(begin, end == std::wstring::npos ? std::wstring::npos : end - begin))) {
+      return false;
+    }
+    if(end == std::wstring::npos) {
+      return true;
+    }
+    begin = end + s_elementDelimiter.size();
+  }
+}
+}    // namespace
+
+Id InternedNameTable::intern(const std::wstring& serializedName, std::vector<Element>* addedElements) {
+  Id id = 0;
+  forEachElement(serializedName, [&](std::wstring_view data) {
+    const size_t index = m_elements.find(Key {id, data});
+    if(index != m_elements.npos) {
+      id = m_elements[index].id;
+      return true;
+    }
+
+    Element element {static_cast<Id>(m_elements.size() + 1), id, std::wstring(data)};
+    if(addedElements) {
+      addedElements->push_back(element);
+    }
+    id = element.id;
+    m_elements.push(std::move(element));
+    return true;
+  });
+  return id;
+}
+
+Id InternedNameTable::find(const std::wstring& serializedName) const {
+  Id id = 0;
+  const bool found = forEachElement(serializedName, [&](std::wstring_view data) {
+    const size_t index = m_elements.find(Key {id, data});
+    if(index == m_elements.npos) {
+      return false;
+    }
+    id = m_elements[index].id;
+    return true;
+  });
+  return found ? id : 0;
+}
+
+std::wstring InternedNameTable::getSerializedName(Id id) const {
+  size_t length = 0;
+  for(Id current = id; current && current <= m_elements.size(); current = m_elements[current - 1].parentId) {
+    length += m_elements[current - 1].data.size() + (length ? s_elementDelimiter.size() : 0);
+  }
+
+  // filled back to front, parents are always stored before their children
+  std::wstring serializedName(length, L'\0');
+  size_t end = length;
+  for(Id current = id; current && current <= m_elements.size(); current = m_elements[current - 1].parentId) {
+    const std::wstring& data = m_elements[current - 1].data;
+    if(end != length) {
+      end -= s_elementDelimiter.size();
+      serializedName.replace(end, s_elementDelimiter.size(), s_elementDelimiter);
+    }
+    end -= data.size();
+    serializedName.replace(end, data.size(), data);
+  }
+  return serializedName;
+}
+
+bool InternedNameTable::add(Element element) {
+  if(element.id != m_elements.size() + 1 || element.parentId >= element.id) {
+    LOG_ERROR("Name element " + std::to_string(element.id) + " is out of order.");
+    return false;
+  }
+
+  m_elements.push(std::move(element));
+  return true;
+}
+
+void InternedNameTable::clear() {
+  m_elements.clear();
+}
+
+size_t InternedNameTable::size() const {
+  return m_elements.size();
+}
+
+size_t InternedNameTable::Hash::operator()(const Element& element) const {
+  return (*this)(Key {element.parentId, element.data});
+}
+
+size_t InternedNameTable::Hash::operator()(const Key& key) const {
+  size_t seed = std::hash<std::wstring_view>()(key.data);
+  utility::hashCombine(seed, key.parentId);
+  return seed;
+}
+
+bool InternedNameTable::Equal::operator()(const Element& element, const Element& other) const {
+  return element.parentId == other.parentId && element.data == other.data;
+}
+
+bool InternedNameTable::Equal::operator()(const Element& element, const Key& key) const {
+  return element.parentId == key.parentId && element.data == key.data;
+}
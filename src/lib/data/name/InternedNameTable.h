@@ -0,0 +1,59 @@
+#ifndef INTERNED_NAME_TABLE_H
+#define INTERNED_NAME_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "RecordColumn.h"
+#include "types.h"
+
+/*
+ * InternedNameTable
+ *
+ * Serialized name hierarchies split into their elements and stored as a parent pointer tree, so names sharing a
+ * prefix (e.g. all members of a class) share its elements. A name is referred to by the id of its last element.
+ * Ids are dense and start at 1, 0 refers to no element.
+ */
+class InternedNameTable {
+public:
+  struct Element {
+    Id id;
+    Id parentId;
+    std::wstring data;    // the first element also contains the delimiter of the hierarchy
+  };
+
+  // returns the id of the name, elements that don't exist yet are added and appended to addedElements
+  Id intern(const std::wstring& serializedName, std::vector<Element>* addedElements = nullptr);
+
+  // returns 0 if the name was never interned
+  Id find(const std::wstring& serializedName) const;
+
+  std::wstring getSerializedName(Id id) const;
+
+  // restores an element, elements have to be added in id order and after their parent
+  bool add(Element element);
+
+  void clear();
+  size_t size() const;
+
+private:
+  struct Key {
+    Id parentId;
+    std::wstring_view data;
+  };
+
+  struct Hash {
+    size_t operator()(const Element& element) const;
+    size_t operator()(const Key& key) const;
+  };
+
+  struct Equal {
+    bool operator()(const Element& element, const Element& other) const;
+    bool operator()(const Element& element, const Key& key) const;
+  };
+
+  RecordColumn<Element, Hash, Equal> m_elements;    // element with id i is stored at index i - 1
+};
+
+#endif    // INTERNED_NAME_TABLE_H
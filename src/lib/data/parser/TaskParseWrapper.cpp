@@ -4,8 +4,8 @@
 #include "DialogView.h"
 #include "PersistentStorage.h"
 
-TaskParseWrapper::TaskParseWrapper(std::weak_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView)
-    : m_storage(storage), m_dialogView(dialogView) {}
+TaskParseWrapper::TaskParseWrapper(std::weak_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView, bool bulkLoad)
+    : m_storage(storage), m_dialogView(dialogView), m_bulkLoad(bulkLoad) {}
 
 void TaskParseWrapper::doEnter(std::shared_ptr<Blackboard> blackboard) {
   int sourceFileCount = 0;
@@ -18,7 +18,7 @@ void TaskParseWrapper::doEnter(std::shared_ptr<Blackboard> blackboard) {
 
   if(sourceFileCount > 0) {
     if(std::shared_ptr<PersistentStorage> storage = m_storage.lock()) {
-      storage->setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+      storage->setMode(m_bulkLoad ? SqliteIndexStorage::STORAGE_MODE_BULK_LOAD : SqliteIndexStorage::STORAGE_MODE_WRITE);
     }
   }
 }
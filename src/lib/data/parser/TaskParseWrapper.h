@@ -14,7 +14,8 @@ class PersistentStorage;
 
 class TaskParseWrapper : public TaskDecorator {
 public:
-  TaskParseWrapper(std::weak_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView);
+  // bulk loading should only be used when the storage starts out empty
+  TaskParseWrapper(std::weak_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView, bool bulkLoad = false);
 
 private:
   void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -24,6 +25,7 @@ private:
 
   std::weak_ptr<PersistentStorage> m_storage;
   std::shared_ptr<DialogView> m_dialogView;
+  const bool m_bulkLoad;
 
   TimeStamp m_start;
 };
@@ -1,13 +1,51 @@
 #include "SearchIndex.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <istream>
 #include <iterator>
+#include <ostream>
 
 #include <ctype.h>
 
+#include "SearchThreadPool.h"
+#include "logging.h"
 #include "utility.h"
 #include "utilityString.h"
 
+namespace {
+constexpr uint32_t s_snapshotMagic = 0x32444953;    // "SID2"
+
+// smaller indices are searched faster than the work is handed to other threads
+constexpr size_t s_minParallelSearchNodeCount = 50000;
+
+template <typename T>
+void writeValue(std::ostream& stream, T value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream& stream, T& value) {
+  return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <typename T>
+void writeArray(std::ostream& stream, const std::vector<T>& values) {
+  stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T>
+bool readArray(std::istream& stream, size_t count, std::vector<T>& values) {
+  values.resize(count);
+  return static_cast<bool>(stream.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+wchar_t toLower(wchar_t c) {
+  return static_cast<wchar_t>(towlower(static_cast<wint_t>(c)));
+}
+}    // namespace
+
 SearchIndex::SearchIndex() {
   clear();
 }
@@ -15,19 +53,23 @@ SearchIndex::SearchIndex() {
 SearchIndex::~SearchIndex() = default;
 
 void SearchIndex::addNode(Id id, std::wstring name, NodeType type) {
-  SearchNode* currentNode = m_root;
+  if(m_buildNodes.empty()) {
+    LOG_ERROR("Nodes can't be added to the search index after finishSetup().");
+    return;
+  }
 
-  while(name.size() > 0) {
-    currentNode->containedTypes.add(type);
+  uint32_t currentNode = 0;
+  size_t namePos = 0;
 
-    auto it = currentNode->edges.find(name[0]);
-    if(it != currentNode->edges.end()) {
-      SearchEdge* currentEdge = it->second;
-      const std::wstring& edgeString = currentEdge->s;
+  while(namePos < name.size()) {
+    auto it = findBuildEdge(m_buildNodes[currentNode], name[namePos]);
+    if(it != m_buildNodes[currentNode].edges.end() && m_buildEdges[*it].text[0] == name[namePos]) {
+      const uint32_t currentEdge = *it;
+      const std::wstring& edgeString = m_buildEdges[currentEdge].text;
 
       size_t matchCount = 1;
-      for(size_t j = 1; j < edgeString.size() && j < name.size(); j++) {
-        if(edgeString[j] != name[j]) {
+      for(size_t j = 1; j < edgeString.size() && namePos + j < name.size(); j++) {
+        if(edgeString[j] != name[namePos + j]) {
           break;
         }
         matchCount++;
@@ -35,59 +77,239 @@ void SearchIndex::addNode(Id id, std::wstring name, NodeType type) {
 
       if(matchCount < edgeString.size()) {
         // split current edge
-        m_nodes.push_back(std::make_unique<SearchNode>(currentNode->containedTypes));
-        SearchNode* n = m_nodes.back().get();
-
-        m_edges.push_back(std::make_unique<SearchEdge>(currentEdge->target, edgeString.substr(matchCount)));
-        SearchEdge* e = m_edges.back().get();
-
-        n->edges.emplace(e->s[0], e);
-
-        currentEdge->s = edgeString.substr(0, matchCount);
-        currentEdge->target = n;
+        const auto n = static_cast<uint32_t>(m_buildNodes.size());
+        const auto e = static_cast<uint32_t>(m_buildEdges.size());
+        m_buildEdges.push_back({m_buildEdges[currentEdge].target, edgeString.substr(matchCount)});
+        m_buildNodes.emplace_back();
+        m_buildNodes[n].edges.push_back(e);
+
+        m_buildEdges[currentEdge].text.resize(matchCount);
+        m_buildEdges[currentEdge].target = n;
       }
 
-      name = name.substr(matchCount);
-      currentNode = currentEdge->target;
+      namePos += matchCount;
+      currentNode = m_buildEdges[currentEdge].target;
     } else {
-      m_nodes.push_back(std::make_unique<SearchNode>(currentNode->containedTypes));
-      SearchNode* n = m_nodes.back().get();
+      const auto n = static_cast<uint32_t>(m_buildNodes.size());
+      const auto e = static_cast<uint32_t>(m_buildEdges.size());
+      m_buildEdges.push_back({n, name.substr(namePos)});
+      m_buildNodes[currentNode].edges.insert(it, e);
+      m_buildNodes.emplace_back();
 
-      m_edges.push_back(std::make_unique<SearchEdge>(n, std::move(name)));
-      SearchEdge* e = m_edges.back().get();
-
-      currentNode->edges.emplace(e->s[0], e);
       currentNode = n;
-
-      name.clear();
+      namePos = name.size();
     }
   }
 
-  currentNode->elementIds.emplace(id, type);
+  m_buildNodes[currentNode].elements.emplace_back(id, type);
 }
 
 void SearchIndex::finishSetup() {
-  for(auto& p : m_root->edges) {
-    populateEdgeGate(p.second);
+  if(m_buildNodes.empty()) {
+    return;
+  }
+
+  m_nodes.clear();
+  m_edges.clear();
+  m_text.clear();
+  m_elementIds.clear();
+  m_elementTypes.clear();
+
+  m_nodes.reserve(m_buildNodes.size());
+  m_edges.reserve(m_buildEdges.size());
+
+  // breadth first, so the edges of each node are adjacent and always point to nodes with a higher index
+  std::vector<uint32_t> buildNodeIndices;
+  buildNodeIndices.reserve(m_buildNodes.size());
+  buildNodeIndices.push_back(0);
+  m_nodes.emplace_back();
+
+  for(size_t i = 0; i < buildNodeIndices.size(); i++) {
+    BuildNode& buildNode = m_buildNodes[buildNodeIndices[i]];
+
+    // keep the first type of an id, like the former map based element list did
+    std::stable_sort(buildNode.elements.begin(), buildNode.elements.end(), [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    });
+    buildNode.elements.erase(
+        std::unique(buildNode.elements.begin(),
+                    buildNode.elements.end(),
+                    [](const auto& a, const auto& b) { return a.first == b.first; }),
+        buildNode.elements.end());
+
+    m_nodes[i].firstElement = static_cast<uint32_t>(m_elementIds.size());
+    m_nodes[i].elementCount = static_cast<uint32_t>(buildNode.elements.size());
+    for(const auto& [elementId, type] : buildNode.elements) {
+      m_elementIds.push_back(elementId);
+      m_elementTypes.push_back(type);
+    }
+
+    m_nodes[i].firstEdge = static_cast<uint32_t>(m_edges.size());
+    m_nodes[i].edgeCount = static_cast<uint32_t>(buildNode.edges.size());
+    for(uint32_t edgeIndex : buildNode.edges) {
+      const BuildEdge& buildEdge = m_buildEdges[edgeIndex];
+      m_edges.push_back({static_cast<uint32_t>(m_nodes.size()),
+                         static_cast<uint32_t>(m_text.size()),
+                         static_cast<uint32_t>(buildEdge.text.size())});
+      m_text += buildEdge.text;
+
+      buildNodeIndices.push_back(buildEdge.target);
+      m_nodes.emplace_back();
+    }
   }
+
+  m_buildNodes.clear();
+  m_buildNodes.shrink_to_fit();
+  m_buildEdges.clear();
+  m_buildEdges.shrink_to_fit();
+
+  m_alphabet.clear();
+  for(wchar_t c : m_text) {
+    m_alphabet.push_back(toLower(c));
+  }
+  std::sort(m_alphabet.begin(), m_alphabet.end());
+  m_alphabet.erase(std::unique(m_alphabet.begin(), m_alphabet.end()), m_alphabet.end());
+
+  populateContainedTypes();
+  populateGates();
 }
 
 void SearchIndex::clear() {
-  m_nodes.clear();
+  m_buildNodes.clear();
+  m_buildEdges.clear();
+  m_buildNodes.emplace_back();
+
+  m_nodes.assign(1, Node());
   m_edges.clear();
+  m_text.clear();
+  m_elementIds.clear();
+  m_elementTypes.clear();
+  m_alphabet.clear();
+  m_gateWordCount = 0;
+  m_gates.clear();
+}
 
-  m_nodes.push_back(std::make_unique<SearchNode>(NodeTypeSet()));
+void SearchIndex::writeToStream(std::ostream& stream) const {
+  writeValue<uint32_t>(stream, s_snapshotMagic);
+  writeValue<uint32_t>(stream, static_cast<uint32_t>(m_nodes.size()));
+  writeValue<uint32_t>(stream, static_cast<uint32_t>(m_edges.size()));
+  writeValue<uint32_t>(stream, static_cast<uint32_t>(m_text.size()));
+  writeValue<uint32_t>(stream, static_cast<uint32_t>(m_elementIds.size()));
+  writeValue<uint32_t>(stream, static_cast<uint32_t>(m_alphabet.size()));
+
+  // the contained types are derived from the elements and not stored
+  std::vector<uint32_t> nodes;
+  nodes.reserve(m_nodes.size() * 4);
+  for(const Node& node : m_nodes) {
+    nodes.insert(nodes.end(), {node.firstEdge, node.edgeCount, node.firstElement, node.elementCount});
+  }
+  writeArray(stream, nodes);
+  writeArray(stream, m_edges);
+
+  writeArray(stream, std::vector<uint32_t>(m_text.begin(), m_text.end()));
+  writeArray(stream, std::vector<uint32_t>(m_alphabet.begin(), m_alphabet.end()));
+  writeArray(stream, m_gates);
+
+  writeArray(stream, std::vector<uint64_t>(m_elementIds.begin(), m_elementIds.end()));
+  std::vector<int32_t> kinds;
+  kinds.reserve(m_elementTypes.size());
+  for(const NodeType& type : m_elementTypes) {
+    kinds.push_back(static_cast<int32_t>(nodeKindToInt(type.getKind())));
+  }
+  writeArray(stream, kinds);
+}
 
-  m_root = m_nodes.back().get();
+bool SearchIndex::readFromStream(std::istream& stream) {
+  clear();
+
+  uint32_t magic = 0;
+  uint32_t nodeCount = 0;
+  uint32_t edgeCount = 0;
+  uint32_t textSize = 0;
+  uint32_t elementCount = 0;
+  uint32_t alphabetSize = 0;
+  if(!readValue(stream, magic) || magic != s_snapshotMagic || !readValue(stream, nodeCount) || !readValue(stream, edgeCount) ||
+     !readValue(stream, textSize) || !readValue(stream, elementCount) || !readValue(stream, alphabetSize) || nodeCount == 0) {
+    LOG_ERROR("Search index snapshot has an invalid header.");
+    return false;
+  }
+
+  const size_t gateWordCount = (alphabetSize + 63) / 64;
+
+  std::vector<uint32_t> nodes;
+  std::vector<uint32_t> text;
+  std::vector<uint32_t> alphabet;
+  std::vector<uint64_t> elementIds;
+  std::vector<int32_t> kinds;
+  bool valid = readArray(stream, size_t(nodeCount) * 4, nodes) && readArray(stream, edgeCount, m_edges) &&
+      readArray(stream, textSize, text) && readArray(stream, alphabetSize, alphabet) &&
+      readArray(stream, size_t(edgeCount) * gateWordCount, m_gates) && readArray(stream, elementCount, elementIds) &&
+      readArray(stream, elementCount, kinds);
+
+  // edges have to stay within their arrays and point to nodes with a higher index, which also rules out cycles
+  m_nodes.resize(nodeCount);
+  for(uint32_t i = 0; i < nodeCount && valid; i++) {
+    Node& node = m_nodes[i];
+    node.firstEdge = nodes[i * 4];
+    node.edgeCount = nodes[i * 4 + 1];
+    node.firstElement = nodes[i * 4 + 2];
+    node.elementCount = nodes[i * 4 + 3];
+
+    valid = size_t(node.firstEdge) + node.edgeCount <= edgeCount && size_t(node.firstElement) + node.elementCount <= elementCount;
+    for(uint32_t j = node.firstEdge; j < node.firstEdge + node.edgeCount && valid; j++) {
+      const Edge& edge = m_edges[j];
+      valid = edge.target > i && edge.target < nodeCount && edge.textLength > 0 &&
+          size_t(edge.textOffset) + edge.textLength <= textSize;
+    }
+  }
+
+  if(!valid) {
+    LOG_ERROR("Search index snapshot is truncated or corrupted.");
+    clear();
+    return false;
+  }
+
+  m_buildNodes.clear();
+  m_text.assign(text.begin(), text.end());
+  m_alphabet.assign(alphabet.begin(), alphabet.end());
+  m_gateWordCount = gateWordCount;
+  m_elementIds.assign(elementIds.begin(), elementIds.end());
+  m_elementTypes.reserve(kinds.size());
+  for(int32_t kind : kinds) {
+    m_elementTypes.emplace_back(intToNodeKind(kind));
+  }
+
+  populateContainedTypes();
+  return true;
 }
 
 std::vector<SearchResult> SearchIndex::search(const std::wstring& query,
                                               NodeTypeSet acceptedNodeTypes,
                                               size_t maxResultCount,
                                               size_t maxBestScoredResultsLength) const {
+  const std::wstring lowerQuery = utility::toLowerCase(query);
+
+  // gates of all query suffixes, a character missing from the alphabet can't be matched at all
+  std::vector<uint64_t> queryGates((lowerQuery.size() + 1) * m_gateWordCount, 0);
+  for(size_t i = lowerQuery.size(); i-- > 0;) {
+    const size_t bit = getAlphabetIndex(lowerQuery[i]);
+    if(bit == m_alphabet.size()) {
+      return {};
+    }
+
+    std::copy_n(queryGates.begin() + static_cast<std::ptrdiff_t>((i + 1) * m_gateWordCount),
+                m_gateWordCount,
+                queryGates.begin() + static_cast<std::ptrdiff_t>(i * m_gateWordCount));
+    queryGates[i * m_gateWordCount + bit / 64] |= uint64_t(1) << (bit % 64);
+  }
+
   // find paths containing query
   std::vector<SearchPath> paths;
-  searchRecursive(SearchPath(L"", {}, m_root), utility::toLowerCase(query), acceptedNodeTypes, &paths);
+  if(m_nodes.size() >= s_minParallelSearchNodeCount && m_nodes.front().edgeCount > 1) {
+    searchParallel(lowerQuery, queryGates, acceptedNodeTypes, &paths);
+  } else {
+    searchRecursive(SearchPath(L"", {}, 0), lowerQuery, 0, queryGates, acceptedNodeTypes, &paths);
+  }
 
   // create scored search results
   std::multiset<SearchResult> searchResults = createScoredResults(paths, acceptedNodeTypes, maxResultCount * 3);
@@ -108,8 +330,20 @@ std::vector<SearchResult> SearchIndex::search(const std::wstring& query,
   std::map<std::wstring, SearchResult> scoresCache;
   std::multiset<SearchResult> bestResults;
   for(const SearchResult& result : searchResults) {
-    if(!maxResultLength || result.text.size() <= maxResultLength) {
-      bestResults.insert(bestScoredResult(result, &scoresCache, maxBestScoredResultsLength));
+    if(maxResultLength && result.text.size() > maxResultLength) {
+      continue;
+    }
+
+    // results that can't get ahead of the current top results are not rescored, they would be dropped anyway
+    if(maxResultCount && bestResults.size() >= maxResultCount &&
+       scoreUpperBound(result.indices) <= std::prev(bestResults.end())->score) {
+      continue;
+    }
+
+    bestResults.insert(bestScoredResult(result, &scoresCache, maxBestScoredResultsLength));
+
+    if(maxResultCount && bestResults.size() > maxResultCount) {
+      bestResults.erase(std::prev(bestResults.end()));
     }
   }
 
@@ -123,60 +357,133 @@ std::vector<SearchResult> SearchIndex::search(const std::wstring& query,
   return std::vector<SearchResult>(bestResults.begin(), it);
 }
 
-void SearchIndex::populateEdgeGate(SearchEdge* e) {
-  for(auto& p : e->target->edges) {
-    SearchEdge* targetEdge = p.second;
-    populateEdgeGate(targetEdge);
-    utility::append(e->gate, targetEdge->gate);
-  }
+std::vector<uint32_t>::iterator SearchIndex::findBuildEdge(BuildNode& node, wchar_t c) {
+  return std::lower_bound(node.edges.begin(), node.edges.end(), c, [this](uint32_t edgeIndex, wchar_t value) {
+    return m_buildEdges[edgeIndex].text[0] < value;
+  });
+}
+
+void SearchIndex::populateContainedTypes() {
+  for(size_t i = m_nodes.size(); i-- > 0;) {
+    Node& node = m_nodes[i];
+    node.containedTypes = NodeTypeSet();
 
-  for(const wchar_t& c : e->s) {
-    e->gate.insert(static_cast<wchar_t>(towlower(static_cast<wint_t>(c))));
+    for(uint32_t j = node.firstElement; j < node.firstElement + node.elementCount; j++) {
+      node.containedTypes.add(m_elementTypes[j]);
+    }
+
+    for(uint32_t j = node.firstEdge; j < node.firstEdge + node.edgeCount; j++) {
+      node.containedTypes.add(m_nodes[m_edges[j].target].containedTypes);
+    }
   }
 }
 
-void SearchIndex::searchRecursive(const SearchPath& path,
-                                  const std::wstring& remainingQuery,
-                                  NodeTypeSet acceptedNodeTypes,
-                                  std::vector<SearchIndex::SearchPath>* results) const {
-  for(const auto& p : path.node->edges) {
-    const SearchEdge* currentEdge = p.second;
+void SearchIndex::populateGates() {
+  m_gateWordCount = (m_alphabet.size() + 63) / 64;
+  m_gates.assign(m_edges.size() * m_gateWordCount, 0);
 
-    if(!acceptedNodeTypes.intersectsWith(currentEdge->target->containedTypes)) {
-      continue;
-    }
+  for(size_t i = m_edges.size(); i-- > 0;) {
+    const Edge& edge = m_edges[i];
+    uint64_t* gate = m_gates.data() + i * m_gateWordCount;
 
-    // test if s passes the edge's gate.
-    bool passesGate = true;
-    for(const wchar_t& c : remainingQuery) {
-      if(currentEdge->gate.find(c) == currentEdge->gate.end()) {
-        passesGate = false;
-        break;
+    const Node& target = m_nodes[edge.target];
+    for(uint32_t j = target.firstEdge; j < target.firstEdge + target.edgeCount; j++) {
+      const uint64_t* targetGate = m_gates.data() + size_t(j) * m_gateWordCount;
+      for(size_t k = 0; k < m_gateWordCount; k++) {
+        gate[k] |= targetGate[k];
       }
     }
 
-    if(!passesGate) {
-      continue;
+    for(uint32_t j = edge.textOffset; j < edge.textOffset + edge.textLength; j++) {
+      const size_t bit = getAlphabetIndex(toLower(m_text[j]));
+      gate[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+  }
+}
+
+size_t SearchIndex::getAlphabetIndex(wchar_t c) const {
+  auto it = std::lower_bound(m_alphabet.begin(), m_alphabet.end(), c);
+  if(it == m_alphabet.end() || *it != c) {
+    return m_alphabet.size();
+  }
+  return static_cast<size_t>(it - m_alphabet.begin());
+}
+
+void SearchIndex::searchParallel(const std::wstring& query,
+                                 const std::vector<uint64_t>& queryGates,
+                                 NodeTypeSet acceptedNodeTypes,
+                                 std::vector<SearchIndex::SearchPath>* results) const {
+  const Node& root = m_nodes.front();
+  const SearchPath rootPath(L"", {}, 0);
+
+  // subtrees differ a lot in size, so the threads pick the next root edge when they are done with the last one
+  std::vector<std::vector<SearchPath>> edgeResults(root.edgeCount);
+  std::atomic<uint32_t> nextEdge = 0;
+  auto searchEdges = [&]() {
+    for(uint32_t i = nextEdge++; i < root.edgeCount; i = nextEdge++) {
+      searchEdge(rootPath, root.firstEdge + i, query, 0, queryGates, acceptedNodeTypes, &edgeResults[i]);
     }
+  };
 
-    // consume characters for edge
-    const std::wstring& edgeString = currentEdge->s;
-    SearchPath currentPath {path.text + edgeString, path.indices, currentEdge->target};
+  SearchThreadPool::getInstance().run(searchEdges, root.edgeCount);
 
-    size_t j = 0;
-    for(size_t i = 0; i < edgeString.size() && j < remainingQuery.size(); i++) {
-      if(towlower(static_cast<wint_t>(edgeString[i])) == static_cast<wint_t>(remainingQuery[j])) {
-        currentPath.indices.push_back(path.text.size() + i);
-        j++;
-      }
+  for(std::vector<SearchPath>& paths : edgeResults) {
+    std::move(paths.begin(), paths.end(), std::back_inserter(*results));
+  }
+}
+
+void SearchIndex::searchRecursive(const SearchPath& path,
+                                  const std::wstring& query,
+                                  size_t queryPos,
+                                  const std::vector<uint64_t>& queryGates,
+                                  NodeTypeSet acceptedNodeTypes,
+                                  std::vector<SearchIndex::SearchPath>* results) const {
+  const Node& node = m_nodes[path.node];
+  for(uint32_t e = node.firstEdge; e < node.firstEdge + node.edgeCount; e++) {
+    searchEdge(path, e, query, queryPos, queryGates, acceptedNodeTypes, results);
+  }
+}
+
+void SearchIndex::searchEdge(const SearchPath& path,
+                             uint32_t edgeIndex,
+                             const std::wstring& query,
+                             size_t queryPos,
+                             const std::vector<uint64_t>& queryGates,
+                             NodeTypeSet acceptedNodeTypes,
+                             std::vector<SearchIndex::SearchPath>* results) const {
+  const Edge& currentEdge = m_edges[edgeIndex];
+
+  if(!acceptedNodeTypes.intersectsWith(m_nodes[currentEdge.target].containedTypes)) {
+    return;
+  }
+
+  // test if the remaining query passes the edge's gate.
+  const uint64_t* queryGate = queryGates.data() + queryPos * m_gateWordCount;
+  const uint64_t* gate = m_gates.data() + size_t(edgeIndex) * m_gateWordCount;
+  for(size_t k = 0; k < m_gateWordCount; k++) {
+    if(queryGate[k] & ~gate[k]) {
+      return;
     }
+  }
 
-    if(j == remainingQuery.size()) {
-      results->push_back(std::move(currentPath));
-    } else {
-      searchRecursive(currentPath, remainingQuery.substr(j), acceptedNodeTypes, results);
+  // consume characters for edge
+  const wchar_t* edgeString = m_text.data() + currentEdge.textOffset;
+  SearchPath currentPath {path.text, path.indices, currentEdge.target};
+  currentPath.text.append(edgeString, currentEdge.textLength);
+
+  size_t j = queryPos;
+  for(size_t i = 0; i < currentEdge.textLength && j < query.size(); i++) {
+    if(towlower(static_cast<wint_t>(edgeString[i])) == static_cast<wint_t>(query[j])) {
+      currentPath.indices.push_back(path.text.size() + i);
+      j++;
     }
   }
+
+  if(j == query.size()) {
+    results->push_back(std::move(currentPath));
+  } else {
+    searchRecursive(currentPath, query, j, queryGates, acceptedNodeTypes, results);
+  }
 }
 
 std::multiset<SearchResult> SearchIndex::createScoredResults(const std::vector<SearchPath>& paths,
@@ -198,11 +505,13 @@ std::multiset<SearchResult> SearchIndex::createScoredResults(const std::vector<S
       std::vector<SearchPath> nextPaths;
 
       for(const SearchPath& path : currentPaths) {
-        if(!path.node->elementIds.empty() && (acceptedNodeTypes.intersectsWith(path.node->containedTypes))) {
+        const Node& node = m_nodes[path.node];
+
+        if(node.elementCount && acceptedNodeTypes.intersectsWith(node.containedTypes)) {
           std::vector<Id> elementIds;
-          for(const auto& p : path.node->elementIds) {
-            if(acceptedNodeTypes.contains(p.second)) {
-              elementIds.push_back(p.first);
+          for(uint32_t i = node.firstElement; i < node.firstElement + node.elementCount; i++) {
+            if(acceptedNodeTypes.contains(m_elementTypes[i])) {
+              elementIds.push_back(m_elementIds[i]);
             }
           }
 
@@ -215,9 +524,11 @@ std::multiset<SearchResult> SearchIndex::createScoredResults(const std::vector<S
           }
         }
 
-        for(auto p : path.node->edges) {
-          const SearchEdge* edge = p.second;
-          nextPaths.emplace_back(path.text + edge->s, path.indices, edge->target);
+        for(uint32_t e = node.firstEdge; e < node.firstEdge + node.edgeCount; e++) {
+          const Edge& edge = m_edges[e];
+          SearchPath nextPath {path.text, path.indices, edge.target};
+          nextPath.text.append(m_text, edge.textOffset, edge.textLength);
+          nextPaths.push_back(std::move(nextPath));
         }
       }
 
@@ -396,6 +707,15 @@ int SearchIndex::scoreText(const std::wstring& text, const std::vector<size_t>&
   return score;
 }
 
+int SearchIndex::scoreUpperBound(const std::vector<size_t>& indices) {
+  // bestScoredResult() only moves matches to the right, so the leftmost match is a lower bound for all positions. Each
+  // match gets at most 4 points for its position and 4 points for following the previous match. The delayed start and
+  // unmatched letter penalties sum up to at most max(n - 1 - lastIndex, -20).
+  const int count = static_cast<int>(indices.size());
+  const int penalties = std::max(count - 1 - static_cast<int>(indices.back()), -20);
+  return 4 * count + 4 * (count - 1) + penalties;
+}
+
 SearchResult SearchIndex::rescoreText(const std::wstring& fulltext,
                                       const std::wstring& text,
                                       const std::vector<size_t>& indices,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <set>
@@ -25,15 +27,33 @@ struct SearchResult {
   int score;
 };
 
+/*
+ * SearchIndex
+ *
+ * Radix trie over element names for fuzzy searching. Names are added to a build representation, finishSetup() compiles
+ * it into flat arrays that are used for searching:
+ *
+ * - nodes and edges are contiguous, the edges of a node are adjacent and sorted by their first character
+ * - edge texts are slices of one character pool
+ * - the elements of a node are a contiguous range of the element arrays (CSR layout)
+ * - each edge has a gate bitset over the lower case characters of its subtree, bits refer to a remapped alphabet
+ */
 class SearchIndex {
 public:
   SearchIndex();
   virtual ~SearchIndex();
 
+  // nodes have to be added before finishSetup()
   void addNode(Id id, std::wstring name, NodeType type = NodeType(NODE_SYMBOL));
   void finishSetup();
   void clear();
 
+  // binary snapshot of the compiled index, the stream has to be opened in binary mode
+  void writeToStream(std::ostream& stream) const;
+
+  // replaces the index with a snapshot, the index is left empty if the snapshot is invalid
+  bool readFromStream(std::istream& stream);
+
   // maxResultCount == 0 means "no restriction".
   std::vector<SearchResult> search(const std::wstring& query,
                                    NodeTypeSet acceptedNodeTypes,
@@ -41,39 +61,69 @@ public:
                                    size_t maxBestScoredResultsLength = 0) const;
 
 private:
-  struct SearchEdge;
-
-  struct SearchNode {
-    SearchNode(NodeTypeSet containedTypes_) : containedTypes(containedTypes_) {}
+  struct BuildEdge {
+    uint32_t target;
+    std::wstring text;
+  };
 
-    std::map<Id, NodeType> elementIds;
-    NodeTypeSet containedTypes;
-    std::map<wchar_t, SearchEdge*> edges;
+  struct BuildNode {
+    std::vector<std::pair<Id, NodeType>> elements;
+    std::vector<uint32_t> edges;    // sorted by the first character of the edge text
   };
 
-  struct SearchEdge {
-    SearchEdge(SearchNode* target_, std::wstring text) : target(target_), s(std::move(text)) {}
+  struct Node {
+    uint32_t firstEdge = 0;
+    uint32_t edgeCount = 0;
+    uint32_t firstElement = 0;
+    uint32_t elementCount = 0;
+    NodeTypeSet containedTypes;    // types of all elements within the subtree
+  };
 
-    SearchNode* target;
-    std::wstring s;
-    std::set<wchar_t> gate;
+  struct Edge {
+    uint32_t target;
+    uint32_t textOffset;
+    uint32_t textLength;
   };
 
   struct SearchPath {
-    SearchPath(std::wstring text_, std::vector<size_t> indices_, SearchNode* node_)
+    SearchPath(std::wstring text_, std::vector<size_t> indices_, uint32_t node_)
         : text(std::move(text_)), indices(std::move(indices_)), node(node_) {}
 
     std::wstring text;
     std::vector<size_t> indices;
-    SearchNode* node;
+    uint32_t node;
   };
 
-  void populateEdgeGate(SearchEdge* e);
+  std::vector<uint32_t>::iterator findBuildEdge(BuildNode& node, wchar_t c);
+
+  // both rely on edges pointing to nodes with a higher index
+  void populateContainedTypes();
+  void populateGates();
+
+  // returns the gate bit of a lower case character or m_alphabet.size() if it is not part of the alphabet
+  size_t getAlphabetIndex(wchar_t c) const;
+
+  // searches the subtrees of the root on multiple threads, results are in the same order as with searchRecursive()
+  void searchParallel(const std::wstring& query,
+                      const std::vector<uint64_t>& queryGates,
+                      NodeTypeSet acceptedNodeTypes,
+                      std::vector<SearchIndex::SearchPath>* results) const;
+
   void searchRecursive(const SearchPath& path,
-                       const std::wstring& remainingQuery,
+                       const std::wstring& query,
+                       size_t queryPos,
+                       const std::vector<uint64_t>& queryGates,
                        NodeTypeSet acceptedNodeTypes,
                        std::vector<SearchIndex::SearchPath>* results) const;
 
+  void searchEdge(const SearchPath& path,
+                  uint32_t edgeIndex,
+                  const std::wstring& query,
+                  size_t queryPos,
+                  const std::vector<uint64_t>& queryGates,
+                  NodeTypeSet acceptedNodeTypes,
+                  std::vector<SearchIndex::SearchPath>* results) const;
+
   std::multiset<SearchResult> createScoredResults(const std::vector<SearchPath>& paths,
                                                   NodeTypeSet acceptedNodeTypes,
                                                   size_t maxResultCount) const;
@@ -89,6 +139,9 @@ private:
                                         SearchResult* result);
   static int scoreText(const std::wstring& text, const std::vector<size_t>& indices);
 
+  // highest score bestScoredResult() can reach for the leftmost match indices of a query
+  static int scoreUpperBound(const std::vector<size_t>& indices);
+
 public:
   static SearchResult rescoreText(const std::wstring& fulltext,
                                   const std::wstring& text,
@@ -99,7 +152,17 @@ public:
   static bool isNoLetter(const wchar_t c);
 
 private:
-  std::vector<std::unique_ptr<SearchNode>> m_nodes;
-  std::vector<std::unique_ptr<SearchEdge>> m_edges;
-  SearchNode* m_root;
+  // build representation, released by finishSetup()
+  std::vector<BuildNode> m_buildNodes;
+  std::vector<BuildEdge> m_buildEdges;
+
+  // compiled representation, the root is the first node
+  std::vector<Node> m_nodes;
+  std::vector<Edge> m_edges;
+  std::wstring m_text;
+  std::vector<Id> m_elementIds;    // sorted by id within each node
+  std::vector<NodeType> m_elementTypes;
+  std::vector<wchar_t> m_alphabet;    // sorted, the position of a character is its gate bit
+  size_t m_gateWordCount = 0;
+  std::vector<uint64_t> m_gates;    // m_gateWordCount words per edge
 };
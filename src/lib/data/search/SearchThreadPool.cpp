@@ -0,0 +1,73 @@
+#include "SearchThreadPool.h"
+// STL
+#include <algorithm>
+
+SearchThreadPool& SearchThreadPool::getInstance() {
+  // the calling thread of a search takes part as well
+  static SearchThreadPool s_instance(std::max(2U, std::thread::hardware_concurrency()) - 1);
+  return s_instance;
+}
+
+SearchThreadPool::SearchThreadPool(size_t workerCount) {
+  for(size_t i = 0; i < workerCount; i++) {
+    m_workers.emplace_back(&SearchThreadPool::runWorker, this);
+  }
+}
+
+SearchThreadPool::~SearchThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+  m_queueChanged.notify_all();
+
+  for(std::thread& worker : m_workers) {
+    worker.join();
+  }
+}
+
+size_t SearchThreadPool::getWorkerCount() const {
+  return m_workers.size();
+}
+
+void SearchThreadPool::run(const std::function<void()>& job, size_t jobCount) {
+  auto batch = std::make_shared<Batch>();
+  batch->job = &job;
+
+  const size_t queuedCount = std::min(jobCount, m_workers.size() + 1);
+  if(queuedCount > 1) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.insert(m_queue.end(), queuedCount - 1, batch);
+    }
+    m_queueChanged.notify_all();
+  }
+
+  job();
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), batch), m_queue.end());
+  batch->finished.wait(lock, [&batch]() { return batch->runningCount == 0; });
+}
+
+void SearchThreadPool::runWorker() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while(true) {
+    m_queueChanged.wait(lock, [this]() { return m_stopped || !m_queue.empty(); });
+    if(m_stopped) {
+      return;
+    }
+
+    std::shared_ptr<Batch> batch = std::move(m_queue.front());
+    m_queue.pop_front();
+    batch->runningCount++;
+
+    lock.unlock();
+    (*batch->job)();
+    lock.lock();
+
+    if(--batch->runningCount == 0) {
+      batch->finished.notify_all();
+    }
+  }
+}
@@ -0,0 +1,49 @@
+#pragma once
+// STL
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * SearchThreadPool
+ *
+ * Worker threads shared by all searches of the process, so concurrent queries don't start threads of their own.
+ *
+ * - a search runs a job on a bounded number of threads at once, the calling thread is one of them
+ * - the job copies take their work from shared state, so copies that no worker started yet are dropped once the
+ *   calling thread is done with its own copy and a search never waits for workers busy with other searches
+ */
+class SearchThreadPool final {
+public:
+  static SearchThreadPool& getInstance();
+
+  explicit SearchThreadPool(size_t workerCount);
+  ~SearchThreadPool();
+
+  SearchThreadPool(const SearchThreadPool&) = delete;
+  SearchThreadPool& operator=(const SearchThreadPool&) = delete;
+
+  size_t getWorkerCount() const;
+
+  // runs the job on up to jobCount threads and returns once all started copies returned
+  void run(const std::function<void()>& job, size_t jobCount);
+
+private:
+  struct Batch {
+    const std::function<void()>* job;
+    size_t runningCount = 0;
+    std::condition_variable finished;
+  };
+
+  void runWorker();
+
+  std::vector<std::thread> m_workers;
+  std::deque<std::shared_ptr<Batch>> m_queue;
+  std::mutex m_mutex;
+  std::condition_variable m_queueChanged;
+  bool m_stopped = false;
+};
@@ -0,0 +1,192 @@
+#include "EdgeIndex.h"
+// STL
+#include <algorithm>
+
+namespace {
+bool compareIds(const std::pair<Id, int>& a, const std::pair<Id, int>& b) {
+  return a.first < b.first;
+}
+}    // namespace
+
+void EdgeIndex::clear() {
+  m_built = false;
+
+  m_edges.clear();
+  m_edgeTypes.clear();
+  m_nodeIds.clear();
+  m_nodeTypes.clear();
+
+  m_outgoingOffsets.clear();
+  m_outgoingEdgeIndices.clear();
+  m_incomingOffsets.clear();
+  m_incomingEdgeIndices.clear();
+}
+
+bool EdgeIndex::isBuilt() const {
+  return m_built;
+}
+
+void EdgeIndex::build(std::vector<std::pair<Id, int>> nodeTypes, std::vector<StorageEdge> edges) {
+  clear();
+
+  std::sort(nodeTypes.begin(), nodeTypes.end());
+  for(const auto& [nodeId, type] : nodeTypes) {
+    // sorted by type as well, so the last entry of an id has the largest type
+    if(!m_nodeIds.empty() && m_nodeIds.back() == nodeId) {
+      m_nodeTypes.back() = type;
+    } else {
+      m_nodeIds.push_back(nodeId);
+      m_nodeTypes.push_back(type);
+    }
+  }
+
+  m_edges = std::move(edges);
+  m_built = true;
+
+  buildRows();
+}
+
+void EdgeIndex::addNodes(const std::vector<std::pair<Id, int>>& nodeTypes) {
+  add(nodeTypes, {});
+}
+
+void EdgeIndex::addEdges(const std::vector<StorageEdge>& edges) {
+  add({}, edges);
+}
+
+void EdgeIndex::add(const std::vector<std::pair<Id, int>>& nodeTypes, const std::vector<StorageEdge>& edges) {
+  if(!m_built || (nodeTypes.empty() && edges.empty())) {
+    return;
+  }
+
+  m_edges.insert(m_edges.end(), edges.begin(), edges.end());
+
+  if(nodeTypes.empty()) {
+    buildRows();
+    return;
+  }
+
+  std::vector<std::pair<Id, int>> allNodeTypes;
+  allNodeTypes.reserve(m_nodeIds.size() + nodeTypes.size());
+  for(size_t i = 0; i < m_nodeIds.size(); i++) {
+    allNodeTypes.emplace_back(m_nodeIds[i], m_nodeTypes[i]);
+  }
+  allNodeTypes.insert(allNodeTypes.end(), nodeTypes.begin(), nodeTypes.end());
+
+  build(std::move(allNodeTypes), std::move(m_edges));
+}
+
+size_t EdgeIndex::getNodeCount() const {
+  return std::count_if(m_nodeTypes.begin(), m_nodeTypes.end(), [](int type) { return type != 0; });
+}
+
+size_t EdgeIndex::getEdgeCount() const {
+  return m_edges.size();
+}
+
+int EdgeIndex::getNodeType(Id nodeId) const {
+  const size_t row = getRow(nodeId);
+  return row < m_nodeIds.size() ? m_nodeTypes[row] : 0;
+}
+
+const StorageEdge* EdgeIndex::getEdgeById(Id edgeId) const {
+  auto it = std::lower_bound(
+      m_edges.begin(), m_edges.end(), edgeId, [](const StorageEdge& edge, Id id) { return edge.id < id; });
+  return (it != m_edges.end() && it->id == edgeId) ? &*it : nullptr;
+}
+
+std::vector<StorageEdge> EdgeIndex::getOutgoingEdges(const std::vector<Id>& nodeIds, Edge::TypeMask typeMask) const {
+  std::vector<StorageEdge> edges;
+  for(Id nodeId : nodeIds) {
+    forEachOutgoingEdge(nodeId, typeMask, [&edges](const StorageEdge& edge) { edges.push_back(edge); });
+  }
+  return edges;
+}
+
+std::vector<StorageEdge> EdgeIndex::getIncomingEdges(const std::vector<Id>& nodeIds, Edge::TypeMask typeMask) const {
+  std::vector<StorageEdge> edges;
+  for(Id nodeId : nodeIds) {
+    forEachIncomingEdge(nodeId, typeMask, [&edges](const StorageEdge& edge) { edges.push_back(edge); });
+  }
+  return edges;
+}
+
+void EdgeIndex::buildRows() {
+  // edges that already existed are added again with their old id
+  std::stable_sort(
+      m_edges.begin(), m_edges.end(), [](const StorageEdge& a, const StorageEdge& b) { return a.id < b.id; });
+  m_edges.erase(
+      std::unique(m_edges.begin(), m_edges.end(), [](const StorageEdge& a, const StorageEdge& b) { return a.id == b.id; }),
+      m_edges.end());
+
+  m_edgeTypes.clear();
+  m_edgeTypes.reserve(m_edges.size());
+
+  // edge endpoints get a row even if they aren't known as nodes
+  std::vector<std::pair<Id, int>> missingNodes;
+  for(const StorageEdge& edge : m_edges) {
+    m_edgeTypes.push_back(Edge::intToType(edge.type));
+
+    for(Id nodeId : {edge.sourceNodeId, edge.targetNodeId}) {
+      if(getRow(nodeId) == m_nodeIds.size()) {
+        missingNodes.emplace_back(nodeId, 0);
+      }
+    }
+  }
+
+  if(!missingNodes.empty()) {
+    std::vector<std::pair<Id, int>> nodes;
+    nodes.reserve(m_nodeIds.size() + missingNodes.size());
+    for(size_t i = 0; i < m_nodeIds.size(); i++) {
+      nodes.emplace_back(m_nodeIds[i], m_nodeTypes[i]);
+    }
+    std::sort(missingNodes.begin(), missingNodes.end());
+    missingNodes.erase(std::unique(missingNodes.begin(), missingNodes.end()), missingNodes.end());
+
+    const size_t middle = nodes.size();
+    nodes.insert(nodes.end(), missingNodes.begin(), missingNodes.end());
+    std::inplace_merge(nodes.begin(), nodes.begin() + middle, nodes.end(), compareIds);
+
+    m_nodeIds.clear();
+    m_nodeTypes.clear();
+    for(const auto& [nodeId, type] : nodes) {
+      m_nodeIds.push_back(nodeId);
+      m_nodeTypes.push_back(type);
+    }
+  }
+
+  const size_t rowCount = m_nodeIds.size();
+  std::vector<size_t> sourceRows;
+  std::vector<size_t> targetRows;
+  sourceRows.reserve(m_edges.size());
+  targetRows.reserve(m_edges.size());
+
+  m_outgoingOffsets.assign(rowCount + 1, 0);
+  m_incomingOffsets.assign(rowCount + 1, 0);
+  for(const StorageEdge& edge : m_edges) {
+    sourceRows.push_back(getRow(edge.sourceNodeId));
+    targetRows.push_back(getRow(edge.targetNodeId));
+    m_outgoingOffsets[sourceRows.back() + 1]++;
+    m_incomingOffsets[targetRows.back() + 1]++;
+  }
+
+  for(size_t row = 0; row < rowCount; row++) {
+    m_outgoingOffsets[row + 1] += m_outgoingOffsets[row];
+    m_incomingOffsets[row + 1] += m_incomingOffsets[row];
+  }
+
+  // edges are visited in id order, so each row lists its edges sorted by id
+  std::vector<uint32_t> outgoingPositions(m_outgoingOffsets.begin(), m_outgoingOffsets.end() - 1);
+  std::vector<uint32_t> incomingPositions(m_incomingOffsets.begin(), m_incomingOffsets.end() - 1);
+  m_outgoingEdgeIndices.resize(m_edges.size());
+  m_incomingEdgeIndices.resize(m_edges.size());
+  for(uint32_t i = 0; i < static_cast<uint32_t>(m_edges.size()); i++) {
+    m_outgoingEdgeIndices[outgoingPositions[sourceRows[i]]++] = i;
+    m_incomingEdgeIndices[incomingPositions[targetRows[i]]++] = i;
+  }
+}
+
+size_t EdgeIndex::getRow(Id nodeId) const {
+  auto it = std::lower_bound(m_nodeIds.begin(), m_nodeIds.end(), nodeId);
+  return (it != m_nodeIds.end() && *it == nodeId) ? static_cast<size_t>(it - m_nodeIds.begin()) : m_nodeIds.size();
+}
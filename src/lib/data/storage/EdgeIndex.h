@@ -0,0 +1,99 @@
+#pragma once
+// STL
+#include <cstdint>
+#include <utility>
+#include <vector>
+// internal
+#include "Edge.h"
+#include "StorageEdge.h"
+#include "types.h"
+
+/*
+ * EdgeIndex
+ *
+ * In-memory adjacency of all edges in compressed sparse row layout. Node ids are kept sorted together with the offsets
+ * of their outgoing and incoming edges, so the neighbourhood of a node is a binary search and a contiguous range of
+ * edge indices. Graph traversals use it instead of querying the database once per level.
+ */
+class EdgeIndex final {
+public:
+  void clear();
+  bool isBuilt() const;
+
+  // node types are the stored ints, a node added twice keeps the larger type like the index database does
+  void build(std::vector<std::pair<Id, int>> nodeTypes, std::vector<StorageEdge> edges);
+  void addNodes(const std::vector<std::pair<Id, int>>& nodeTypes);
+  void addEdges(const std::vector<StorageEdge>& edges);
+  // rebuilds the rows once for both, does nothing if the index isn't built
+  void add(const std::vector<std::pair<Id, int>>& nodeTypes, const std::vector<StorageEdge>& edges);
+
+  size_t getNodeCount() const;
+  size_t getEdgeCount() const;
+
+  // 0 for ids that aren't nodes
+  int getNodeType(Id nodeId) const;
+  const StorageEdge* getEdgeById(Id edgeId) const;
+
+  template <typename FuncType>
+  void forEachOutgoingEdge(Id nodeId, Edge::TypeMask typeMask, FuncType func) const;
+  template <typename FuncType>
+  void forEachIncomingEdge(Id nodeId, Edge::TypeMask typeMask, FuncType func) const;
+
+  std::vector<StorageEdge> getOutgoingEdges(const std::vector<Id>& nodeIds, Edge::TypeMask typeMask = ~0) const;
+  std::vector<StorageEdge> getIncomingEdges(const std::vector<Id>& nodeIds, Edge::TypeMask typeMask = ~0) const;
+
+private:
+  void buildRows();
+  size_t getRow(Id nodeId) const;
+
+  template <typename FuncType>
+  void forEachEdgeInRow(Id nodeId,
+                        const std::vector<uint32_t>& offsets,
+                        const std::vector<uint32_t>& edgeIndices,
+                        Edge::TypeMask typeMask,
+                        FuncType func) const;
+
+  bool m_built = false;
+
+  // sorted by id, the types are kept converted next to them for filtering
+  std::vector<StorageEdge> m_edges;
+  std::vector<Edge::EdgeType> m_edgeTypes;
+
+  // rows, sorted by id, also containing edge endpoints that aren't nodes with type 0
+  std::vector<Id> m_nodeIds;
+  std::vector<int> m_nodeTypes;
+
+  std::vector<uint32_t> m_outgoingOffsets;
+  std::vector<uint32_t> m_outgoingEdgeIndices;
+  std::vector<uint32_t> m_incomingOffsets;
+  std::vector<uint32_t> m_incomingEdgeIndices;
+};
+
+template <typename FuncType>
+void EdgeIndex::forEachOutgoingEdge(Id nodeId, Edge::TypeMask typeMask, FuncType func) const {
+  forEachEdgeInRow(nodeId, m_outgoingOffsets, m_outgoingEdgeIndices, typeMask, func);
+}
+
+template <typename FuncType>
+void EdgeIndex::forEachIncomingEdge(Id nodeId, Edge::TypeMask typeMask, FuncType func) const {
+  forEachEdgeInRow(nodeId, m_incomingOffsets, m_incomingEdgeIndices, typeMask, func);
+}
+
+template <typename FuncType>
+void EdgeIndex::forEachEdgeInRow(Id nodeId,
+                                 const std::vector<uint32_t>& offsets,
+                                 const std::vector<uint32_t>& edgeIndices,
+                                 Edge::TypeMask typeMask,
+                                 FuncType func) const {
+  const size_t row = getRow(nodeId);
+  if(row == m_nodeIds.size()) {
+    return;
+  }
+
+  for(uint32_t i = offsets[row]; i < offsets[row + 1]; i++) {
+    const uint32_t edgeIndex = edgeIndices[i];
+    if(m_edgeTypes[edgeIndex] & typeMask) {
+      func(m_edges[edgeIndex]);
+    }
+  }
+}
@@ -1,32 +1,279 @@
 #include "IntermediateStorage.h"
 
+#include <algorithm>
+#include <functional>
+#include <future>
+
 #include "LocationType.h"
+#include "logging.h"
 #include "utility.h"
 
+namespace {
+// maps the ids of each merged storage to ids of the merge result, ids within one storage are dense
+class IdRemapping {
+public:
+  explicit IdRemapping(const std::vector<std::shared_ptr<IntermediateStorage>>& storages) {
+    m_ids.reserve(storages.size());
+    for(const std::shared_ptr<IntermediateStorage>& storage : storages) {
+      Id maxId = storage->getNextId();
+      for(const StorageNode& node : storage->getStorageNodes()) {
+        maxId = std::max(maxId, node.id);
+      }
+      for(const StorageEdge& edge : storage->getStorageEdges()) {
+        maxId = std::max(maxId, edge.id);
+      }
+      for(const StorageLocalSymbol& localSymbol : storage->getStorageLocalSymbols()) {
+        maxId = std::max(maxId, localSymbol.id);
+      }
+      for(const StorageSourceLocation& location : storage->getStorageSourceLocations()) {
+        maxId = std::max(maxId, location.id);
+      }
+      for(const StorageError& error : storage->getErrors()) {
+        maxId = std::max(maxId, error.id);
+      }
+      m_ids.emplace_back(maxId + 1, 0);
+    }
+  }
+
+  // different threads may set ids of the same storage concurrently, the table never grows
+  void set(size_t storageIndex, Id oldId, Id newId) {
+    m_ids[storageIndex][oldId] = newId;
+  }
+
+  // returns 0 for unknown ids
+  Id get(size_t storageIndex, Id oldId) const {
+    const std::vector<Id>& ids = m_ids[storageIndex];
+    return oldId < ids.size() ? ids[oldId] : 0;
+  }
+
+private:
+  std::vector<std::vector<Id>> m_ids;
+};
+
+void runInParallel(const std::vector<std::function<void()>>& jobs) {
+  std::vector<std::future<void>> futures;
+  for(size_t i = 1; i < jobs.size(); i++) {
+    futures.push_back(std::async(std::launch::async, jobs[i]));
+  }
+
+  if(!jobs.empty()) {
+    jobs.front()();
+  }
+
+  for(std::future<void>& future : futures) {
+    future.get();
+  }
+}
+}    // namespace
+
+std::shared_ptr<IntermediateStorage> IntermediateStorage::merge(const std::vector<std::shared_ptr<IntermediateStorage>>& storages) {
+  std::shared_ptr<IntermediateStorage> merged = std::make_shared<IntermediateStorage>();
+  IdRemapping remapping(storages);
+
+  size_t nodeCount = 0;
+  size_t edgeCount = 0;
+  size_t localSymbolCount = 0;
+  size_t sourceLocationCount = 0;
+  size_t errorCount = 0;
+  for(const std::shared_ptr<IntermediateStorage>& storage : storages) {
+    nodeCount += storage->m_nodes.size();
+    edgeCount += storage->m_edges.size();
+    localSymbolCount += storage->m_localSymbols.size();
+    sourceLocationCount += storage->m_sourceLocations.size();
+    errorCount += storage->m_errors.size();
+  }
+
+  // each id assigning record kind owns an id range large enough for all of its input records, so ids can be assigned
+  // while the kinds are deduplicated in parallel
+  const Id nodeIdBase = 1;
+  const Id edgeIdBase = nodeIdBase + nodeCount;
+  const Id localSymbolIdBase = edgeIdBase + edgeCount;
+  const Id sourceLocationIdBase = localSymbolIdBase + localSymbolCount;
+  const Id errorIdBase = sourceLocationIdBase + sourceLocationCount;
+  merged->m_nextId = errorIdBase + errorCount;
+
+  for(const std::shared_ptr<IntermediateStorage>& storage : storages) {
+    merged->addIndexingCosts(storage->m_indexingCosts);
+  }
+
+  // records without references
+  runInParallel({
+      [&]() {
+        RecordColumn<StorageNode, StorageNodeData::Hash, StorageNodeData::Equal>& nodes = merged->m_nodes;
+        nodes.reserve(nodeCount);
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageNode& node : storages[i]->m_nodes.getRecords()) {
+            size_t index = nodes.find(node);
+            if(index == nodes.npos) {
+              index = nodes.push(StorageNode(nodeIdBase + nodes.size(), node));
+            } else if(nodes[index].type < node.type) {
+              nodes[index].type = node.type;
+            }
+            remapping.set(i, node.id, nodes[index].id);
+          }
+        }
+
+        merged->m_nodeIdIndex.reserve(nodes.size());
+        for(size_t i = 0; i < nodes.size(); i++) {
+          merged->m_nodeIdIndex.emplace(nodes[i].id, i);
+        }
+      },
+      [&]() {
+        RecordColumn<StorageLocalSymbol, StorageLocalSymbolData::Hash, StorageLocalSymbolData::Equal>& localSymbols =
+            merged->m_localSymbols;
+        localSymbols.reserve(localSymbolCount);
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageLocalSymbol& localSymbol : storages[i]->m_localSymbols.getRecords()) {
+            size_t index = localSymbols.find(localSymbol);
+            if(index == localSymbols.npos) {
+              index = localSymbols.push(StorageLocalSymbol(localSymbolIdBase + localSymbols.size(), localSymbol));
+            }
+            remapping.set(i, localSymbol.id, localSymbols[index].id);
+          }
+        }
+      },
+      [&]() {
+        RecordColumn<StorageError, StorageErrorData::Hash, StorageErrorData::Equal>& errors = merged->m_errors;
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageError& error : storages[i]->m_errors.getRecords()) {
+            size_t index = errors.find(error);
+            if(index == errors.npos) {
+              index = errors.push(StorageError(errorIdBase + errors.size(), error));
+            }
+            remapping.set(i, error.id, errors[index].id);
+          }
+        }
+      },
+  });
+
+  // records referring to nodes
+  runInParallel({
+      [&]() {
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageFile& file : storages[i]->m_files.getRecords()) {
+            if(const Id fileId = remapping.get(i, file.id)) {
+              merged->addFile(
+                  StorageFile(fileId, file.filePath, file.languageIdentifier, file.modificationTime, file.indexed, file.complete));
+            }
+          }
+        }
+      },
+      [&]() {
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageSymbol& symbol : storages[i]->m_symbols) {
+            if(const Id symbolId = remapping.get(i, symbol.id)) {
+              merged->m_symbols.emplace_back(symbolId, symbol.definitionKind);
+            } else {
+              LOG_WARNING("New symbol id could not be found.");
+            }
+          }
+        }
+      },
+      [&]() {
+        RecordColumn<StorageEdge, StorageEdgeData::Hash, StorageEdgeData::Equal>& edges = merged->m_edges;
+        edges.reserve(edgeCount);
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageEdge& edge : storages[i]->m_edges.getRecords()) {
+            const StorageEdgeData edgeData(edge.type, remapping.get(i, edge.sourceNodeId), remapping.get(i, edge.targetNodeId));
+            if(!edgeData.sourceNodeId || !edgeData.targetNodeId) {
+              LOG_WARNING("New edge source or target id could not be found.");
+              continue;
+            }
+
+            size_t index = edges.find(edgeData);
+            if(index == edges.npos) {
+              index = edges.push(StorageEdge(edgeIdBase + edges.size(), edgeData));
+            }
+            remapping.set(i, edge.id, edges[index].id);
+          }
+        }
+      },
+      [&]() {
+        RecordColumn<StorageSourceLocation, StorageSourceLocationData::Hash, StorageSourceLocationData::Equal>& locations =
+            merged->m_sourceLocations;
+        locations.reserve(sourceLocationCount);
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageSourceLocation& location : storages[i]->m_sourceLocations.getRecords()) {
+            const Id fileNodeId = remapping.get(i, location.fileNodeId);
+            if(!fileNodeId) {
+              continue;
+            }
+
+            const StorageSourceLocationData locationData(
+                fileNodeId, location.startLine, location.startCol, location.endLine, location.endCol, location.type);
+            size_t index = locations.find(locationData);
+            if(index == locations.npos) {
+              index = locations.push(StorageSourceLocation(sourceLocationIdBase + locations.size(), locationData));
+            }
+            remapping.set(i, location.id, locations[index].id);
+          }
+        }
+      },
+      [&]() {
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageComponentAccess& access : storages[i]->m_componentAccesses.getRecords()) {
+            if(const Id nodeId = remapping.get(i, access.nodeId)) {
+              merged->addComponentAccess(StorageComponentAccess(nodeId, access.type));
+            }
+          }
+        }
+      },
+  });
+
+  // records referring to edges, local symbols or source locations
+  runInParallel({
+      [&]() {
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageOccurrence& occurrence : storages[i]->m_occurrences.getRecords()) {
+            const Id elementId = remapping.get(i, occurrence.elementId);
+            const Id sourceLocationId = remapping.get(i, occurrence.sourceLocationId);
+            if(!elementId) {
+              LOG_WARNING("New occurrence element id could not be found.");
+            } else if(!sourceLocationId) {
+              LOG_WARNING("New occurrence location id could not be found.");
+            } else {
+              merged->addOccurrence(StorageOccurrence(elementId, sourceLocationId));
+            }
+          }
+        }
+      },
+      [&]() {
+        for(size_t i = 0; i < storages.size(); i++) {
+          for(const StorageElementComponent& component : storages[i]->m_elementComponents.getRecords()) {
+            if(const Id elementId = remapping.get(i, component.elementId)) {
+              merged->addElementComponent(StorageElementComponent(elementId, component.type, component.data));
+            }
+          }
+        }
+      },
+  });
+
+  return merged;
+}
+
 IntermediateStorage::IntermediateStorage() : m_nextId(1) {}
 
 void IntermediateStorage::clear() {
-  m_nodesIndex.clear();
-  m_nodeIdIndex.clear();
   m_nodes.clear();
+  m_nodeIdIndex.clear();
 
-  m_filesIndex.clear();
-  m_filesIdIndex.clear();
   m_files.clear();
+  m_filesIdIndex.clear();
 
   m_symbols.clear();
 
-  m_edgesIndex.clear();
   m_edges.clear();
 
   m_localSymbols.clear();
   m_sourceLocations.clear();
   m_occurrences.clear();
   m_componentAccesses.clear();
+  m_elementComponents.clear();
 
-  m_errorsIndex.clear();
   m_errors.clear();
 
+  m_indexingCosts.clear();
+
   m_nextId = 1;
 }
 
@@ -45,6 +292,11 @@ size_t IntermediateStorage::getByteSize(size_t stringSize) const {
     byteSize += stringSize + storageError.translationUnit.size();
   }
 
+  for(const StorageIndexingCost& indexingCost : getIndexingCosts()) {
+    byteSize += sizeof(StorageIndexingCost);
+    byteSize += stringSize + indexingCost.sourceFilePath.size();
+  }
+
   for(const StorageNode& storageNode : getStorageNodes()) {
     byteSize += sizeof(StorageNode);
     byteSize += stringSize + storageNode.serializedName.size();
@@ -69,7 +321,7 @@ size_t IntermediateStorage::getSourceLocationCount() const {
 }
 
 bool IntermediateStorage::hasFatalErrors() const {
-  for(const StorageErrorData& error : m_errors) {
+  for(const StorageErrorData& error : m_errors.getRecords()) {
     if(error.fatal) {
       return true;
     }
@@ -79,30 +331,30 @@ bool IntermediateStorage::hasFatalErrors() const {
 }
 
 void IntermediateStorage::setAllFilesIncomplete() {
-  for(StorageFile& file : m_files) {
-    file.complete = false;
+  for(size_t i = 0; i < m_files.size(); i++) {
+    m_files[i].complete = false;
   }
 }
 
 void IntermediateStorage::setFilesWithErrorsIncomplete() {
   std::set<Id> errorFileIds;
-  for(const StorageSourceLocation& location : m_sourceLocations) {
+  for(const StorageSourceLocation& location : m_sourceLocations.getRecords()) {
     if(location.type == locationTypeToInt(LOCATION_ERROR)) {
       errorFileIds.insert(location.fileNodeId);
     }
   }
 
-  for(StorageFile& file : m_files) {
-    if(errorFileIds.find(file.id) != errorFileIds.end()) {
-      file.complete = false;
+  for(size_t i = 0; i < m_files.size(); i++) {
+    if(errorFileIds.find(m_files[i].id) != errorFileIds.end()) {
+      m_files[i].complete = false;
     }
   }
 }
 
 std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData) {
-  auto it = m_nodesIndex.find(nodeData);
-  if(it != m_nodesIndex.end()) {
-    StorageNode& storedNode = m_nodes[it->second];
+  const size_t index = m_nodes.find(nodeData);
+  if(index != m_nodes.npos) {
+    StorageNode& storedNode = m_nodes[index];
     if(storedNode.type < nodeData.type) {
       storedNode.type = nodeData.type;
     }
@@ -110,13 +362,13 @@ std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData
   }
 
   Id nodeId = m_nextId++;
-  m_nodes.emplace_back(nodeId, nodeData);
-  m_nodesIndex.emplace(nodeData, m_nodes.size() - 1);
-  m_nodeIdIndex.emplace(nodeId, m_nodes.size() - 1);
+  m_nodeIdIndex.emplace(nodeId, m_nodes.push(StorageNode(nodeId, nodeData)));
   return std::make_pair(nodeId, true);
 }
 
 std::vector<Id> IntermediateStorage::addNodes(const std::vector<StorageNode>& nodes) {
+  m_nodes.reserve(m_nodes.size() + nodes.size());
+
   std::vector<Id> nodeIds;
   nodeIds.reserve(nodes.size());
   for(const StorageNode& node : nodes) {
@@ -141,9 +393,9 @@ void IntermediateStorage::addSymbols(const std::vector<StorageSymbol>& symbols)
 }
 
 void IntermediateStorage::addFile(const StorageFile& file) {
-  auto it = m_filesIndex.find(file);
-  if(it != m_filesIndex.end()) {
-    StorageFile& storedFile = m_files[it->second];
+  const size_t index = m_files.find(file);
+  if(index != m_files.npos) {
+    StorageFile& storedFile = m_files[index];
 
     if(file.indexed) {
       storedFile.indexed = true;
@@ -157,9 +409,7 @@ void IntermediateStorage::addFile(const StorageFile& file) {
       storedFile.languageIdentifier = file.languageIdentifier;
     }
   } else {
-    m_filesIndex.emplace(file, m_files.size());
-    m_filesIdIndex.emplace(file.id, m_files.size());
-    m_files.emplace_back(file);
+    m_filesIdIndex.emplace(file.id, m_files.push(file));
   }
 }
 
@@ -171,18 +421,19 @@ void IntermediateStorage::setFileLanguage(Id fileId, const std::wstring& languag
 }
 
 Id IntermediateStorage::addEdge(const StorageEdgeData& edgeData) {
-  auto it = m_edgesIndex.find(edgeData);
-  if(it != m_edgesIndex.end()) {
-    return m_edges[it->second].id;
+  const size_t index = m_edges.find(edgeData);
+  if(index != m_edges.npos) {
+    return m_edges[index].id;
   }
 
   Id edgeId = m_nextId++;
-  m_edges.emplace_back(edgeId, edgeData);
-  m_edgesIndex.emplace(edgeData, m_edges.size() - 1);
+  m_edges.push(StorageEdge(edgeId, edgeData));
   return edgeId;
 }
 
 std::vector<Id> IntermediateStorage::addEdges(const std::vector<StorageEdge>& edges) {
+  m_edges.reserve(m_edges.size() + edges.size());
+
   std::vector<Id> edgeIds;
   edgeIds.reserve(edges.size());
   for(const StorageEdge& edge : edges) {
@@ -192,17 +443,19 @@ std::vector<Id> IntermediateStorage::addEdges(const std::vector<StorageEdge>& ed
 }
 
 Id IntermediateStorage::addLocalSymbol(const StorageLocalSymbolData& localSymbolData) {
-  auto it = m_localSymbols.find(StorageLocalSymbol(0, localSymbolData));
-  if(it != m_localSymbols.end()) {
-    return it->id;
+  const size_t index = m_localSymbols.find(localSymbolData);
+  if(index != m_localSymbols.npos) {
+    return m_localSymbols[index].id;
   }
 
   Id localSymbolId = m_nextId++;
-  m_localSymbols.emplace(localSymbolId, localSymbolData);
+  m_localSymbols.push(StorageLocalSymbol(localSymbolId, localSymbolData));
   return localSymbolId;
 }
 
-std::vector<Id> IntermediateStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) {
+std::vector<Id> IntermediateStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) {
+  m_localSymbols.reserve(m_localSymbols.size() + symbols.size());
+
   std::vector<Id> symbolIds;
   symbolIds.reserve(symbols.size());
   for(const StorageLocalSymbol& symbol : symbols) {
@@ -212,17 +465,19 @@ std::vector<Id> IntermediateStorage::addLocalSymbols(const std::set<StorageLocal
 }
 
 Id IntermediateStorage::addSourceLocation(const StorageSourceLocationData& sourceLocationData) {
-  auto it = m_sourceLocations.find(StorageSourceLocation(0, sourceLocationData));
-  if(it != m_sourceLocations.end()) {
-    return it->id;
+  const size_t index = m_sourceLocations.find(sourceLocationData);
+  if(index != m_sourceLocations.npos) {
+    return m_sourceLocations[index].id;
   }
 
   Id sourceLocationId = m_nextId++;
-  m_sourceLocations.emplace(sourceLocationId, sourceLocationData);
+  m_sourceLocations.push(StorageSourceLocation(sourceLocationId, sourceLocationData));
   return sourceLocationId;
 }
 
 std::vector<Id> IntermediateStorage::addSourceLocations(const std::vector<StorageSourceLocation>& locations) {
+  m_sourceLocations.reserve(m_sourceLocations.size() + locations.size());
+
   std::vector<Id> locationIds;
   locationIds.reserve(locations.size());
   for(const StorageSourceLocation& location : locations) {
@@ -232,47 +487,68 @@ std::vector<Id> IntermediateStorage::addSourceLocations(const std::vector<Storag
 }
 
 void IntermediateStorage::addOccurrence(const StorageOccurrence& occurrence) {
-  m_occurrences.emplace(occurrence);
+  if(m_occurrences.find(occurrence) == m_occurrences.npos) {
+    m_occurrences.push(occurrence);
+  }
 }
 
 void IntermediateStorage::addOccurrences(const std::vector<StorageOccurrence>& occurrences) {
-  m_occurrences.insert(occurrences.begin(), occurrences.end());
+  m_occurrences.reserve(m_occurrences.size() + occurrences.size());
+
+  for(const StorageOccurrence& occurrence : occurrences) {
+    addOccurrence(occurrence);
+  }
 }
 
 void IntermediateStorage::addComponentAccess(const StorageComponentAccess& componentAccess) {
-  m_componentAccesses.emplace(componentAccess);
+  if(m_componentAccesses.find(componentAccess) == m_componentAccesses.npos) {
+    m_componentAccesses.push(componentAccess);
+  }
 }
 
 void IntermediateStorage::addComponentAccesses(const std::vector<StorageComponentAccess>& componentAccesses) {
-  m_componentAccesses.insert(componentAccesses.begin(), componentAccesses.end());
+  m_componentAccesses.reserve(m_componentAccesses.size() + componentAccesses.size());
+
+  for(const StorageComponentAccess& componentAccess : componentAccesses) {
+    addComponentAccess(componentAccess);
+  }
 }
 
 void IntermediateStorage::addElementComponent(const StorageElementComponent& component) {
-  m_elementComponents.emplace(component);
+  if(m_elementComponents.find(component) == m_elementComponents.npos) {
+    m_elementComponents.push(component);
+  }
 }
 
 void IntermediateStorage::addElementComponents(const std::vector<StorageElementComponent>& components) {
-  m_elementComponents.insert(components.begin(), components.end());
+  m_elementComponents.reserve(m_elementComponents.size() + components.size());
+
+  for(const StorageElementComponent& component : components) {
+    addElementComponent(component);
+  }
 }
 
 Id IntermediateStorage::addError(const StorageErrorData& errorData) {
-  auto it = m_errorsIndex.find(errorData);
-  if(it != m_errorsIndex.end()) {
-    return m_errors[it->second].id;
+  const size_t index = m_errors.find(errorData);
+  if(index != m_errors.npos) {
+    return m_errors[index].id;
   }
 
   Id errorId = m_nextId++;
-  m_errors.emplace_back(errorId, errorData);
-  m_errorsIndex.emplace(errorData, m_errors.size() - 1);
+  m_errors.push(StorageError(errorId, errorData));
   return errorId;
 }
 
+void IntermediateStorage::addIndexingCosts(const std::vector<StorageIndexingCost>& costs) {
+  m_indexingCosts.insert(m_indexingCosts.end(), costs.begin(), costs.end());
+}
+
 const std::vector<StorageNode>& IntermediateStorage::getStorageNodes() const {
-  return m_nodes;
+  return m_nodes.getRecords();
 }
 
 const std::vector<StorageFile>& IntermediateStorage::getStorageFiles() const {
-  return m_files;
+  return m_files.getRecords();
 }
 
 const std::vector<StorageSymbol>& IntermediateStorage::getStorageSymbols() const {
@@ -280,51 +556,53 @@ const std::vector<StorageSymbol>& IntermediateStorage::getStorageSymbols() const
 }
 
 const std::vector<StorageEdge>& IntermediateStorage::getStorageEdges() const {
-  return m_edges;
+  return m_edges.getRecords();
 }
 
-const std::set<StorageLocalSymbol>& IntermediateStorage::getStorageLocalSymbols() const {
-  return m_localSymbols;
+const std::vector<StorageLocalSymbol>& IntermediateStorage::getStorageLocalSymbols() const {
+  return m_localSymbols.getRecords();
 }
 
-const std::set<StorageSourceLocation>& IntermediateStorage::getStorageSourceLocations() const {
-  return m_sourceLocations;
+const std::vector<StorageSourceLocation>& IntermediateStorage::getStorageSourceLocations() const {
+  return m_sourceLocations.getRecords();
 }
 
-const std::set<StorageOccurrence>& IntermediateStorage::getStorageOccurrences() const {
-  return m_occurrences;
+const std::vector<StorageOccurrence>& IntermediateStorage::getStorageOccurrences() const {
+  return m_occurrences.getRecords();
 }
 
-const std::set<StorageComponentAccess>& IntermediateStorage::getComponentAccesses() const {
-  return m_componentAccesses;
+const std::vector<StorageComponentAccess>& IntermediateStorage::getComponentAccesses() const {
+  return m_componentAccesses.getRecords();
 }
 
-const std::set<StorageElementComponent>& IntermediateStorage::getElementComponents() const {
-  return m_elementComponents;
+const std::vector<StorageElementComponent>& IntermediateStorage::getElementComponents() const {
+  return m_elementComponents.getRecords();
 }
 
 const std::vector<StorageError>& IntermediateStorage::getErrors() const {
-  return m_errors;
+  return m_errors.getRecords();
+}
+
+const std::vector<StorageIndexingCost>& IntermediateStorage::getIndexingCosts() const {
+  return m_indexingCosts;
 }
 
 void IntermediateStorage::setStorageNodes(std::vector<StorageNode> storageNodes) {
-  m_nodes = std::move(storageNodes);
+  m_nodes.assign(std::move(storageNodes));
 
-  m_nodesIndex.clear();
   m_nodeIdIndex.clear();
+  m_nodeIdIndex.reserve(m_nodes.size());
   for(size_t i = 0; i < m_nodes.size(); i++) {
-    m_nodesIndex.emplace(m_nodes[i], i);
     m_nodeIdIndex.emplace(m_nodes[i].id, i);
   }
 }
 
 void IntermediateStorage::setStorageFiles(std::vector<StorageFile> storageFiles) {
-  m_files = std::move(storageFiles);
+  m_files.assign(std::move(storageFiles));
 
-  m_filesIndex.clear();
   m_filesIdIndex.clear();
+  m_filesIdIndex.reserve(m_files.size());
   for(size_t i = 0; i < m_files.size(); i++) {
-    m_filesIndex.emplace(m_files[i], i);
     m_filesIdIndex.emplace(m_files[i].id, i);
   }
 }
@@ -334,41 +612,35 @@ void IntermediateStorage::setStorageSymbols(std::vector<StorageSymbol> storageSy
 }
 
 void IntermediateStorage::setStorageEdges(std::vector<StorageEdge> storageEdges) {
-  m_edges = std::move(storageEdges);
-
-  m_edgesIndex.clear();
-  for(size_t i = 0; i < m_edges.size(); i++) {
-    m_edgesIndex.emplace(m_edges[i], i);
-  }
+  m_edges.assign(std::move(storageEdges));
 }
 
-void IntermediateStorage::setStorageLocalSymbols(std::set<StorageLocalSymbol> storageLocalSymbols) {
-  m_localSymbols = std::move(storageLocalSymbols);
+void IntermediateStorage::setStorageLocalSymbols(std::vector<StorageLocalSymbol> storageLocalSymbols) {
+  m_localSymbols.assign(std::move(storageLocalSymbols));
 }
 
-void IntermediateStorage::setStorageSourceLocations(std::set<StorageSourceLocation> storageSourceLocations) {
-  m_sourceLocations = std::move(storageSourceLocations);
+void IntermediateStorage::setStorageSourceLocations(std::vector<StorageSourceLocation> storageSourceLocations) {
+  m_sourceLocations.assign(std::move(storageSourceLocations));
 }
 
-void IntermediateStorage::setStorageOccurrences(std::set<StorageOccurrence> storageOccurrences) {
-  m_occurrences = std::move(storageOccurrences);
+void IntermediateStorage::setStorageOccurrences(std::vector<StorageOccurrence> storageOccurrences) {
+  m_occurrences.assign(std::move(storageOccurrences));
 }
 
-void IntermediateStorage::setComponentAccesses(std::set<StorageComponentAccess> componentAccesses) {
-  m_componentAccesses = std::move(componentAccesses);
+void IntermediateStorage::setComponentAccesses(std::vector<StorageComponentAccess> componentAccesses) {
+  m_componentAccesses.assign(std::move(componentAccesses));
 }
 
-void IntermediateStorage::setElementComponents(std::set<StorageElementComponent> components) {
-  m_elementComponents = std::move(components);
+void IntermediateStorage::setElementComponents(std::vector<StorageElementComponent> components) {
+  m_elementComponents.assign(std::move(components));
 }
 
 void IntermediateStorage::setErrors(std::vector<StorageError> errors) {
-  m_errors = std::move(errors);
+  m_errors.assign(std::move(errors));
+}
 
-  m_errorsIndex.clear();
-  for(size_t i = 0; i < m_errors.size(); i++) {
-    m_errorsIndex.emplace(m_errors[i], i);
-  }
+void IntermediateStorage::setIndexingCosts(std::vector<StorageIndexingCost> costs) {
+  m_indexingCosts = std::move(costs);
 }
 
 Id IntermediateStorage::getNextId() const {
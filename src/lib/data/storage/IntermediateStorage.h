@@ -1,13 +1,20 @@
 #pragma once
 // STL
-#include <map>
 #include <memory>
-#include <set>
+#include <unordered_map>
 // internal
+#include "RecordColumn.h"
 #include "Storage.h"
 
 class IntermediateStorage : public Storage {
 public:
+  /**
+   * Merges all storages into a new one, the result equals injecting them one after another into an empty storage (up to
+   * the assigned ids). Record kinds that don't depend on each other are deduplicated in parallel, every input id is
+   * remapped through one table. The inputs are not modified.
+   */
+  static std::shared_ptr<IntermediateStorage> merge(const std::vector<std::shared_ptr<IntermediateStorage>>& storages);
+
   IntermediateStorage();
 
   void clear();
@@ -29,7 +36,7 @@ public:
   Id addEdge(const StorageEdgeData& edgeData) override;
   std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) override;
   Id addLocalSymbol(const StorageLocalSymbolData& localSymbolData) override;
-  std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) override;
+  std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) override;
   Id addSourceLocation(const StorageSourceLocationData& sourceLocationData) override;
   std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) override;
   void addOccurrence(const StorageOccurrence& occurrence) override;
@@ -39,57 +46,59 @@ public:
   void addElementComponent(const StorageElementComponent& component) override;
   void addElementComponents(const std::vector<StorageElementComponent>& components) override;
   Id addError(const StorageErrorData& errorData) override;
+  void addIndexingCosts(const std::vector<StorageIndexingCost>& costs) override;
 
   const std::vector<StorageNode>& getStorageNodes() const override;
   const std::vector<StorageFile>& getStorageFiles() const override;
   const std::vector<StorageSymbol>& getStorageSymbols() const override;
   const std::vector<StorageEdge>& getStorageEdges() const override;
-  const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const override;
-  const std::set<StorageSourceLocation>& getStorageSourceLocations() const override;
-  const std::set<StorageOccurrence>& getStorageOccurrences() const override;
-  const std::set<StorageComponentAccess>& getComponentAccesses() const override;
-  const std::set<StorageElementComponent>& getElementComponents() const override;
+  const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const override;
+  const std::vector<StorageSourceLocation>& getStorageSourceLocations() const override;
+  const std::vector<StorageOccurrence>& getStorageOccurrences() const override;
+  const std::vector<StorageComponentAccess>& getComponentAccesses() const override;
+  const std::vector<StorageElementComponent>& getElementComponents() const override;
   const std::vector<StorageError>& getErrors() const override;
+  const std::vector<StorageIndexingCost>& getIndexingCosts() const override;
 
   void setStorageNodes(std::vector<StorageNode> storageNodes);
   void setStorageFiles(std::vector<StorageFile> storageFiles);
   void setStorageSymbols(std::vector<StorageSymbol> storageSymbols);
   void setStorageEdges(std::vector<StorageEdge> storageEdges);
-  void setStorageLocalSymbols(std::set<StorageLocalSymbol> storageLocalSymbols);
-  void setStorageSourceLocations(std::set<StorageSourceLocation> storageSourceLocations);
-  void setStorageOccurrences(std::set<StorageOccurrence> storageOccurrences);
-  void setComponentAccesses(std::set<StorageComponentAccess> componentAccesses);
-  void setElementComponents(std::set<StorageElementComponent> components);
+  void setStorageLocalSymbols(std::vector<StorageLocalSymbol> storageLocalSymbols);
+  void setStorageSourceLocations(std::vector<StorageSourceLocation> storageSourceLocations);
+  void setStorageOccurrences(std::vector<StorageOccurrence> storageOccurrences);
+  void setComponentAccesses(std::vector<StorageComponentAccess> componentAccesses);
+  void setElementComponents(std::vector<StorageElementComponent> components);
   void setErrors(std::vector<StorageError> errors);
+  void setIndexingCosts(std::vector<StorageIndexingCost> costs);
 
   Id getNextId() const;
   void setNextId(const Id nextId);
 
 private:
-  std::map<StorageNodeData, size_t> m_nodesIndex;
-  std::map<Id, size_t> m_nodeIdIndex;
-  std::vector<StorageNode> m_nodes;
+  // every record kind lives in one contiguous column, duplicates are detected via the column's hash index
+  RecordColumn<StorageNode, StorageNodeData::Hash, StorageNodeData::Equal> m_nodes;
+  std::unordered_map<Id, size_t> m_nodeIdIndex;
 
-  std::map<StorageFile, size_t> m_filesIndex;    // this is used to prevent duplicates (unique)
-  std::map<Id, size_t> m_filesIdIndex;
-  std::vector<StorageFile> m_files;
+  RecordColumn<StorageFile, StorageFile::Hash, StorageFile::Equal> m_files;
+  std::unordered_map<Id, size_t> m_filesIdIndex;
 
   std::vector<StorageSymbol> m_symbols;
 
-  std::map<StorageEdgeData, size_t> m_edgesIndex;
-  std::vector<StorageEdge> m_edges;
+  RecordColumn<StorageEdge, StorageEdgeData::Hash, StorageEdgeData::Equal> m_edges;
+
+  RecordColumn<StorageLocalSymbol, StorageLocalSymbolData::Hash, StorageLocalSymbolData::Equal> m_localSymbols;
 
-  std::set<StorageLocalSymbol> m_localSymbols;
+  RecordColumn<StorageSourceLocation, StorageSourceLocationData::Hash, StorageSourceLocationData::Equal> m_sourceLocations;
 
-  std::set<StorageSourceLocation> m_sourceLocations;
+  RecordColumn<StorageOccurrence, StorageOccurrence::Hash, StorageOccurrence::Equal> m_occurrences;
 
-  std::set<StorageOccurrence> m_occurrences;
+  RecordColumn<StorageComponentAccess, StorageComponentAccess::Hash, StorageComponentAccess::Equal> m_componentAccesses;
+  RecordColumn<StorageElementComponent, StorageElementComponent::Hash, StorageElementComponent::Equal> m_elementComponents;
 
-  std::set<StorageComponentAccess> m_componentAccesses;
-  std::set<StorageElementComponent> m_elementComponents;
+  RecordColumn<StorageError, StorageErrorData::Hash, StorageErrorData::Equal> m_errors;
 
-  std::map<StorageErrorData, size_t> m_errorsIndex;    // this is used to prevent duplicates (unique)
-  std::vector<StorageError> m_errors;
+  std::vector<StorageIndexingCost> m_indexingCosts;
 
   Id m_nextId;
 };
\ No newline at end of file
@@ -1,12 +1,18 @@
 #include "PersistentStorage.h"
 
+#include <algorithm>
+#include <fstream>
+#include <map>
 #include <queue>
+#include <set>
+#include <unordered_set>
 
 #include "AccessKind.h"
 #include "ApplicationSettings.h"
 #include "ElementComponentKind.h"
 #include "FileInfo.h"
 #include "FilePath.h"
+#include "FileSystem.h"
 #include "Graph.h"
 #include "MessageErrorCountUpdate.h"
 #include "MessageStatus.h"
@@ -44,11 +50,27 @@ PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& boo
 }
 
 std::pair<Id, bool> PersistentStorage::addNode(const StorageNodeData& data) {
-  return std::make_pair(m_sqliteIndexStorage.addNode(data), true);
+  const Id nodeId = m_sqliteIndexStorage.addNode(data);
+  {
+    std::lock_guard<std::mutex> lock(m_edgeIndexMutex);
+    if(m_edgeIndex) {
+      m_edgeIndexAddedNodes.emplace_back(nodeId, data.type);
+    }
+  }
+  return std::make_pair(nodeId, true);
 }
 
 std::vector<Id> PersistentStorage::addNodes(const std::vector<StorageNode>& nodes) {
-  return m_sqliteIndexStorage.addNodes(nodes);
+  const std::vector<Id> nodeIds = m_sqliteIndexStorage.addNodes(nodes);
+  {
+    std::lock_guard<std::mutex> lock(m_edgeIndexMutex);
+    if(m_edgeIndex) {
+      for(size_t i = 0; i < nodeIds.size(); i++) {
+        m_edgeIndexAddedNodes.emplace_back(nodeIds[i], nodes[i].type);
+      }
+    }
+  }
+  return nodeIds;
 }
 
 void PersistentStorage::addSymbol(const StorageSymbol& data) {
@@ -60,10 +82,25 @@ void PersistentStorage::addSymbols(const std::vector<StorageSymbol>& symbols) {
 }
 
 void PersistentStorage::addFile(const StorageFile& data) {
+  PreparedFile preparedFile;
+  auto it = m_injectingFiles.find(data.filePath);
+  if(it != m_injectingFiles.end()) {
+    preparedFile = std::move(it->second);
+    m_injectingFiles.erase(it);
+  }
+
   const StorageFile storedFile = m_sqliteIndexStorage.getFirstById<StorageFile>(data.id);
 
   if(storedFile.id == 0) {
-    m_sqliteIndexStorage.addFile(data);
+    clearStoredFileContents();
+
+    if(data.modificationTime.empty() && !preparedFile.modificationTime.empty()) {
+      StorageFile file(data);
+      file.modificationTime = preparedFile.modificationTime;
+      m_sqliteIndexStorage.addFile(file, preparedFile.content);
+    } else {
+      m_sqliteIndexStorage.addFile(data, preparedFile.content);
+    }
   } else {
     if(!storedFile.indexed && data.indexed) {
       m_sqliteIndexStorage.setFileIndexed(storedFile.id, data.indexed);
@@ -76,18 +113,34 @@ void PersistentStorage::addFile(const StorageFile& data) {
 }
 
 Id PersistentStorage::addEdge(const StorageEdgeData& data) {
-  return m_sqliteIndexStorage.addEdge(data);
+  const Id edgeId = m_sqliteIndexStorage.addEdge(data);
+  {
+    std::lock_guard<std::mutex> lock(m_edgeIndexMutex);
+    if(m_edgeIndex) {
+      m_edgeIndexAddedEdges.emplace_back(edgeId, data);
+    }
+  }
+  return edgeId;
 }
 
 std::vector<Id> PersistentStorage::addEdges(const std::vector<StorageEdge>& edges) {
-  return m_sqliteIndexStorage.addEdges(edges);
+  const std::vector<Id> edgeIds = m_sqliteIndexStorage.addEdges(edges);
+  {
+    std::lock_guard<std::mutex> lock(m_edgeIndexMutex);
+    if(m_edgeIndex) {
+      for(size_t i = 0; i < edgeIds.size(); i++) {
+        m_edgeIndexAddedEdges.emplace_back(edgeIds[i], edges[i]);
+      }
+    }
+  }
+  return edgeIds;
 }
 
 Id PersistentStorage::addLocalSymbol(const StorageLocalSymbolData& data) {
   return m_sqliteIndexStorage.addLocalSymbol(data);
 }
 
-std::vector<Id> PersistentStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) {
+std::vector<Id> PersistentStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) {
   return m_sqliteIndexStorage.addLocalSymbols(symbols);
 }
 
@@ -127,12 +180,20 @@ Id PersistentStorage::addError(const StorageErrorData& data) {
   return m_sqliteIndexStorage.addError(data).id;
 }
 
+void PersistentStorage::addIndexingCosts(const std::vector<StorageIndexingCost>& costs) {
+  m_sqliteIndexStorage.addIndexingCosts(costs);
+}
+
 void PersistentStorage::removeElement(const Id id) {
   m_sqliteIndexStorage.removeElement(id);
+  clearEdgeIndex();
+  clearStoredFileContents();
 }
 
 void PersistentStorage::removeElements(const std::vector<Id>& ids) {
   m_sqliteIndexStorage.removeElements(ids);
+  clearEdgeIndex();
+  clearStoredFileContents();
 }
 
 void PersistentStorage::removeOccurrence(const StorageOccurrence& occurrence) {
@@ -145,6 +206,8 @@ void PersistentStorage::removeOccurrences(const std::vector<StorageOccurrence>&
 
 void PersistentStorage::removeElementsWithoutOccurrences(const std::vector<Id>& elementIds) {
   m_sqliteIndexStorage.removeElementsWithoutOccurrences(elementIds);
+  clearEdgeIndex();
+  clearStoredFileContents();
 }
 
 const std::vector<StorageNode>& PersistentStorage::getStorageNodes() const {
@@ -163,24 +226,24 @@ const std::vector<StorageEdge>& PersistentStorage::getStorageEdges() const {
   return m_storageData.edges = m_sqliteIndexStorage.getAll<StorageEdge>();
 }
 
-const std::set<StorageLocalSymbol>& PersistentStorage::getStorageLocalSymbols() const {
-  return m_storageData.locals = utility::toSet(m_sqliteIndexStorage.getAll<StorageLocalSymbol>());
+const std::vector<StorageLocalSymbol>& PersistentStorage::getStorageLocalSymbols() const {
+  return m_storageData.locals = m_sqliteIndexStorage.getAll<StorageLocalSymbol>();
 }
 
-const std::set<StorageSourceLocation>& PersistentStorage::getStorageSourceLocations() const {
-  return m_storageData.locations = utility::toSet(m_sqliteIndexStorage.getAll<StorageSourceLocation>());
+const std::vector<StorageSourceLocation>& PersistentStorage::getStorageSourceLocations() const {
+  return m_storageData.locations = m_sqliteIndexStorage.getAll<StorageSourceLocation>();
 }
 
-const std::set<StorageOccurrence>& PersistentStorage::getStorageOccurrences() const {
-  return m_storageData.occurrences = utility::toSet(m_sqliteIndexStorage.getAll<StorageOccurrence>());
+const std::vector<StorageOccurrence>& PersistentStorage::getStorageOccurrences() const {
+  return m_storageData.occurrences = m_sqliteIndexStorage.getAll<StorageOccurrence>();
 }
 
-const std::set<StorageComponentAccess>& PersistentStorage::getComponentAccesses() const {
-  return m_storageData.accesses = utility::toSet(m_sqliteIndexStorage.getAll<StorageComponentAccess>());
+const std::vector<StorageComponentAccess>& PersistentStorage::getComponentAccesses() const {
+  return m_storageData.accesses = m_sqliteIndexStorage.getAll<StorageComponentAccess>();
 }
 
-const std::set<StorageElementComponent>& PersistentStorage::getElementComponents() const {
-  return m_storageData.components = utility::toSet(m_sqliteIndexStorage.getAll<StorageElementComponent>());
+const std::vector<StorageElementComponent>& PersistentStorage::getElementComponents() const {
+  return m_storageData.components = m_sqliteIndexStorage.getAll<StorageElementComponent>();
 }
 
 const std::vector<StorageError>& PersistentStorage::getErrors() const {
@@ -191,13 +254,55 @@ const std::vector<StorageError>& PersistentStorage::getErrors() const {
   return m_storageData.errors = errors;
 }
 
-void PersistentStorage::startInjection() {
+const std::vector<StorageIndexingCost>& PersistentStorage::getIndexingCosts() const {
+  return m_storageData.indexingCosts = m_sqliteIndexStorage.getAll<StorageIndexingCost>();
+}
+
+void PersistentStorage::prepareInjection(const Storage* injected) {
+  std::map<std::wstring, PreparedFile> preparedFiles;
+  for(const StorageFile& file : injected->getStorageFiles()) {
+    if(file.indexed || file.modificationTime.empty()) {
+      const FilePath filePath(file.filePath);
+
+      PreparedFile& preparedFile = preparedFiles[file.filePath];
+      if(file.modificationTime.empty()) {
+        preparedFile.modificationTime = FileSystem::getFileInfoForPath(filePath).lastWriteTime.toString();
+      }
+      if(file.indexed) {
+        preparedFile.content = TextAccess::createFromFile(filePath);
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(m_preparedFilesMutex);
+  m_preparedFiles[injected->getStorageId()] = std::move(preparedFiles);
+}
+
+void PersistentStorage::discardPreparedInjection(const Storage* injected) {
+  std::lock_guard<std::mutex> lock(m_preparedFilesMutex);
+  m_preparedFiles.erase(injected->getStorageId());
+}
+
+void PersistentStorage::startInjection(const Storage* injected) {
+  m_injectingFiles.clear();
+  {
+    std::lock_guard<std::mutex> lock(m_preparedFilesMutex);
+    auto it = m_preparedFiles.find(injected->getStorageId());
+    if(it != m_preparedFiles.end()) {
+      m_injectingFiles = std::move(it->second);
+      m_preparedFiles.erase(it);
+    }
+  }
+
   beforeErrorRecording();
 
   m_sqliteIndexStorage.beginTransaction();
 }
 
-void PersistentStorage::finishInjection() {
+void PersistentStorage::finishInjection(const Storage* /*injected*/) {
+  // files that were already stored don't consume their prepared content
+  m_injectingFiles.clear();
+
   m_sqliteIndexStorage.commitTransaction();
 
   afterErrorRecording();
@@ -281,8 +386,12 @@ void PersistentStorage::clear() {
 }
 
 void PersistentStorage::clearCaches() {
-  m_symbolIndex.clear();
-  m_fileIndex.clear();
+  {
+    std::lock_guard<std::mutex> lock(m_searchIndicesMutex);
+    m_symbolIndex.clear();
+    m_fileIndex.clear();
+    m_searchIndicesPending = false;
+  }
 
   m_fileNodeIds.clear();
   m_lowerCasefileNodeIds.clear();
@@ -292,7 +401,14 @@ void PersistentStorage::clearCaches() {
   m_fileNodeLanguage.clear();
   m_symbolDefinitionKinds.clear();
 
+  m_fileIdToIncludingFileIds.clear();
+  m_fileIdToIncludedFileIds.clear();
+  m_fileIdToImportingFileIds.clear();
+  m_fileIdToImportedFileIds.clear();
+
   m_hierarchyCache.clear();
+  clearEdgeIndex();
+  clearStoredFileContents();
   m_fullTextSearchIndex.clear();
   m_fullTextSearchCodec = "";
 }
@@ -316,7 +432,9 @@ std::set<FilePath> PersistentStorage::getReferencing(const std::set<FilePath>& f
 }
 
 void PersistentStorage::clearAllErrors() {
+  m_sqliteIndexStorage.beginTransaction();
   m_sqliteIndexStorage.removeAllErrors();
+  m_sqliteIndexStorage.commitTransaction();
 }
 
 void PersistentStorage::clearFileElements(const std::vector<FilePath>& filePaths, std::function<void(int)> updateStatusCallback) {
@@ -330,10 +448,32 @@ void PersistentStorage::clearFileElements(const std::vector<FilePath>& filePaths
     m_sqliteIndexStorage.removeElementsWithLocationInFiles(fileNodeIds, updateStatusCallback);
     m_sqliteIndexStorage.removeElements(fileNodeIds);
     m_sqliteIndexStorage.commitTransaction();
+    // refreshed files are added with new ids, so their arrays would never be used again
+    removeFullTextSearchSegments(fileNodeIds);
     updateStatusCallback(100);
   }
 }
 
+void PersistentStorage::updateFileDependencies() {
+  m_sqliteIndexStorage.beginTransaction();
+  m_sqliteIndexStorage.updateFileDependencies(Edge::typeToInt(Edge::EDGE_INCLUDE), Edge::typeToInt(Edge::EDGE_IMPORT));
+  m_sqliteIndexStorage.commitTransaction();
+}
+
+void PersistentStorage::removeUnreferencedNames() {
+  m_sqliteIndexStorage.beginTransaction();
+  m_sqliteIndexStorage.removeUnreferencedNameElements();
+  m_sqliteIndexStorage.commitTransaction();
+}
+
+void PersistentStorage::removeUnreferencedIndexingCosts() {
+  m_sqliteIndexStorage.removeUnreferencedIndexingCosts();
+}
+
+std::unordered_map<std::wstring, std::string> PersistentStorage::getFileContentHashes() const {
+  return m_sqliteIndexStorage.getFileContentHashes();
+}
+
 std::vector<FileInfo> PersistentStorage::getFileInfoForAllFiles() const {
   std::vector<FileInfo> fileInfos;
 
@@ -373,9 +513,11 @@ void PersistentStorage::buildCaches() {
   clearCaches();
 
   buildFilePathMaps();
+  buildFileDependencyMaps();
   buildSearchIndex();
   buildMemberEdgeIdOrderMap();
   buildHierarchyCache();
+  getEdgeIndex();
 }
 
 void PersistentStorage::optimizeMemory() {
@@ -385,6 +527,10 @@ void PersistentStorage::optimizeMemory() {
   m_sqliteBookmarkStorage.optimizeMemory();
 }
 
+void PersistentStorage::checkpoint() {
+  m_sqliteIndexStorage.checkpoint();
+}
+
 Id PersistentStorage::getNodeIdForFileNode(const FilePath& filePath) const {
   return getFileNodeId(filePath);
 }
@@ -638,6 +784,8 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(const
                                                                            const NodeTypeSet& acceptedNodeTypes,
                                                                            size_t maxResultsCount,
                                                                            size_t maxBestScoredResultsLength) const {
+  loadPendingSearchIndices();
+
   // search in indices
   const std::vector<SearchResult> results = m_symbolIndex.search(
       query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength);
@@ -713,6 +861,8 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(const
 }
 
 std::vector<SearchMatch> PersistentStorage::getAutocompletionFileMatches(const std::wstring& query, size_t maxResultsCount) const {
+  loadPendingSearchIndices();
+
   const std::vector<SearchResult> results = m_fileIndex.search(
       query, NodeTypeSet::all().getWithMatchingKept([](const NodeType& type) { return type.isFile(); }), maxResultsCount, 100);
 
@@ -882,12 +1032,14 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(const std::v
 
   bool addFileContents = false;
 
+  const std::shared_ptr<const EdgeIndex> edgeIndex = getEdgeIndex();
+
   if(tokenIds.size() == 1) {
     const Id elementId = tokenIds[0];
-    const StorageNode node = m_sqliteIndexStorage.getFirstById<StorageNode>(elementId);
+    const int elementNodeType = edgeIndex->getNodeType(elementId);
 
-    if(node.id > 0) {
-      const NodeType nodeType(intToNodeKind(node.type));
+    if(elementNodeType) {
+      const NodeType nodeType(intToNodeKind(elementNodeType));
       if(nodeType.isPackage()) {
         ids.clear();
         m_hierarchyCache.addFirstChildIdsForNodeId(elementId, &ids, &edgeIds);
@@ -905,11 +1057,15 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(const std::v
         nodeIds.push_back(elementId);
         edgeIds.clear();
 
-        for(const StorageEdge& edge : m_sqliteIndexStorage.getEdgesBySourceOrTargetId(elementId)) {
-          Edge::EdgeType edgeType = Edge::intToType(edge.type);
-          if(edgeType == Edge::EDGE_MEMBER) {
-            continue;
+        std::vector<StorageEdge> edges = edgeIndex->getOutgoingEdges({elementId}, ~Edge::EDGE_MEMBER);
+        edgeIndex->forEachIncomingEdge(elementId, ~Edge::EDGE_MEMBER, [&edges](const StorageEdge& edge) {
+          if(edge.sourceNodeId != edge.targetNodeId) {
+            edges.push_back(edge);
           }
+        });
+
+        for(const StorageEdge& edge : edges) {
+          Edge::EdgeType edgeType = Edge::intToType(edge.type);
 
           if(nodeType.isUsable() && (edgeType & Edge::EDGE_TYPE_USAGE) &&
              m_hierarchyCache.isChildOfVisibleNodeOrInvisible(edge.sourceNodeId) &&
@@ -927,7 +1083,7 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(const std::v
           addBundledEdges = true;
         }
       }
-    } else if(m_sqliteIndexStorage.isEdge(elementId)) {
+    } else if(edgeIndex->getEdgeById(elementId)) {
       edgeIds.push_back(elementId);
     }
   }
@@ -940,17 +1096,20 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForActiveTokenIds(const std::v
       }
       symbolIds.insert(symbol.id);
     }
-    for(const StorageNode& node : m_sqliteIndexStorage.getAllByIds<StorageNode>(ids)) {
-      if(symbolIds.find(node.id) == symbolIds.end()) {
-        nodeIds.push_back(node.id);
+    std::vector<Id> sortedIds(ids);
+    std::sort(sortedIds.begin(), sortedIds.end());
+    sortedIds.erase(std::unique(sortedIds.begin(), sortedIds.end()), sortedIds.end());
+    for(const Id id : sortedIds) {
+      if(edgeIndex->getNodeType(id) && symbolIds.find(id) == symbolIds.end()) {
+        nodeIds.push_back(id);
       }
     }
 
     if(!isPackage) {
       if(nodeIds.size() != ids.size()) {
-        for(const StorageEdge& edge : m_sqliteIndexStorage.getAllByIds<StorageEdge>(ids)) {
-          if(edge.id > 0) {
-            edgeIds.push_back(edge.id);
+        for(const Id id : sortedIds) {
+          if(edgeIndex->getEdgeById(id)) {
+            edgeIds.push_back(id);
           }
         }
       }
@@ -1028,8 +1187,10 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(Id originId,
                                                            bool nodeNonIndexed,
                                                            size_t depth,
                                                            bool directed) const {
-  std::set<Id> nodeIds;
-  std::set<Id> edgeIds;
+  const std::shared_ptr<const EdgeIndex> edgeIndex = getEdgeIndex();
+
+  std::unordered_set<Id> nodeIds;
+  std::unordered_set<Id> edgeIds;
 
   nodeIds.insert(originId ? originId : targetId);
   bool forward = originId != 0;
@@ -1038,7 +1199,8 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(Id originId,
   std::vector<Id> nodeIdsToProcess = {*nodeIds.begin()};
 
   bool isTerminatedTrail = originId && targetId;
-  std::map<Id, TrailNode> trailNodes;
+  // element addresses stay stable on rehashing
+  std::unordered_map<Id, TrailNode> trailNodes;
 
   if(isTerminatedTrail) {
     TrailNode root;
@@ -1047,32 +1209,38 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(Id originId,
   }
 
   while(nodeIdsToProcess.size() && (!depth || currentDepth < depth)) {
-    std::vector<StorageEdge> edges = forward ? m_sqliteIndexStorage.getEdgesBySourceIds(nodeIdsToProcess) :
-                                               m_sqliteIndexStorage.getEdgesByTargetIds(nodeIdsToProcess);
+    std::vector<StorageEdge> edges = forward ? edgeIndex->getOutgoingEdges(nodeIdsToProcess, trailTypes) :
+                                               edgeIndex->getIncomingEdges(nodeIdsToProcess, trailTypes);
 
     if(!directed || trailTypes & Edge::LAYOUT_VERTICAL) {
       utility::append(edges,
-                      forward ? m_sqliteIndexStorage.getEdgesByTargetIds(nodeIdsToProcess) :
-                                m_sqliteIndexStorage.getEdgesBySourceIds(nodeIdsToProcess));
+                      forward ? edgeIndex->getIncomingEdges(nodeIdsToProcess, trailTypes) :
+                                edgeIndex->getOutgoingEdges(nodeIdsToProcess, trailTypes));
     }
 
     std::vector<Id> nodeIdsToCheck;
-    std::map<Id, std::vector<StorageEdge>> edgesToInsert;
+    std::unordered_map<Id, std::vector<StorageEdge>> edgesToInsert;
 
     for(const StorageEdge& edge : edges) {
-      if(Edge::intToType(edge.type) & trailTypes && edgeIds.find(edge.id) == edgeIds.end()) {
+      if(edgeIds.find(edge.id) == edgeIds.end()) {
         bool isForward = forward == !(Edge::intToType(edge.type) & Edge::LAYOUT_VERTICAL);
 
         const Id targetNodeId = isForward ? edge.targetNodeId : edge.sourceNodeId;
         const Id sourceNodeId = isForward ? edge.sourceNodeId : edge.targetNodeId;
 
         if(nodeIds.find(targetNodeId) == nodeIds.end()) {
-          nodeIdsToCheck.push_back(targetNodeId);
-          edgesToInsert[targetNodeId].push_back(edge);
+          std::vector<StorageEdge>& targetEdges = edgesToInsert[targetNodeId];
+          if(targetEdges.empty()) {
+            nodeIdsToCheck.push_back(targetNodeId);
+          }
+          targetEdges.push_back(edge);
         } else if(nodeIds.find(sourceNodeId) == nodeIds.end()) {
           if(!directed) {
-            nodeIdsToCheck.push_back(sourceNodeId);
-            edgesToInsert[sourceNodeId].push_back(edge);
+            std::vector<StorageEdge>& sourceEdges = edgesToInsert[sourceNodeId];
+            if(sourceEdges.empty()) {
+              nodeIdsToCheck.push_back(sourceNodeId);
+            }
+            sourceEdges.push_back(edge);
           }
         } else {
           edgeIds.insert(edge.id);
@@ -1092,17 +1260,22 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(Id originId,
     nodeIdsToProcess.clear();
 
     if(nodeTypes != 0) {
-      for(const StorageNode& node : m_sqliteIndexStorage.getAllByIds<StorageNode>(nodeIdsToCheck)) {
-        NodeKind kind = intToNodeKind(node.type);
+      for(const Id nodeId : nodeIdsToCheck) {
+        const int nodeType = edgeIndex->getNodeType(nodeId);
+        if(!nodeType) {
+          continue;
+        }
+
+        NodeKind kind = intToNodeKind(nodeType);
         if(kind & nodeTypes || (kind == NODE_SYMBOL && nodeNonIndexed)) {
           if(!nodeNonIndexed) {
             if(kind == NODE_FILE) {
-              auto it = m_fileNodeIndexed.find(node.id);
+              auto it = m_fileNodeIndexed.find(nodeId);
               if(it == m_fileNodeIndexed.end() || !it->second) {
                 continue;
               }
             } else {
-              auto it = m_symbolDefinitionKinds.find(node.id);
+              auto it = m_symbolDefinitionKinds.find(nodeId);
               if(it == m_symbolDefinitionKinds.end() || it->second == DEFINITION_NONE) {
                 continue;
               }
@@ -1112,23 +1285,23 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(Id originId,
           // FIXME: don't add namespace nodes to the graph, because it destroys trail
           // layouting Remove when namespaces are proper nodes with children
           if((kind & (NODE_MODULE | NODE_NAMESPACE | NODE_PACKAGE)) == 0) {
-            nodeIds.insert(node.id);
-            for(const StorageEdge& edge : edgesToInsert[node.id]) {
+            nodeIds.insert(nodeId);
+            for(const StorageEdge& edge : edgesToInsert[nodeId]) {
               if((Edge::intToType(edge.type) & Edge::EDGE_MEMBER) == 0) {
                 edgeIds.insert(edge.id);
               }
             }
           }
-          nodeIdsToProcess.push_back(node.id);
+          nodeIdsToProcess.push_back(nodeId);
 
           if(isTerminatedTrail) {
-            TrailNode& targetNode = trailNodes[node.id];
-            targetNode.id = node.id;
+            TrailNode& targetNode = trailNodes[nodeId];
+            targetNode.id = nodeId;
 
-            for(const StorageEdge& edge : edgesToInsert[node.id]) {
+            for(const StorageEdge& edge : edgesToInsert[nodeId]) {
               targetNode.edgeIds.insert(edge.id);
 
-              Id sourceNodeId = (edge.targetNodeId == node.id ? edge.sourceNodeId : edge.targetNodeId);
+              Id sourceNodeId = (edge.targetNodeId == nodeId ? edge.sourceNodeId : edge.targetNodeId);
               TrailNode& oldNode = trailNodes[sourceNodeId];
               targetNode.parents.insert(&oldNode);
             }
@@ -1179,9 +1352,14 @@ std::shared_ptr<Graph> PersistentStorage::getGraphForTrail(Id originId,
     }
   }
 
+  std::vector<Id> sortedNodeIds(nodeIds.begin(), nodeIds.end());
+  std::vector<Id> sortedEdgeIds(edgeIds.begin(), edgeIds.end());
+  std::sort(sortedNodeIds.begin(), sortedNodeIds.end());
+  std::sort(sortedEdgeIds.begin(), sortedEdgeIds.end());
+
   auto graph = std::make_shared<Graph>();
 
-  addNodesWithParentsAndEdgesToGraph(utility::toVector(nodeIds), utility::toVector(edgeIds), graph.get(), false);
+  addNodesWithParentsAndEdgesToGraph(sortedNodeIds, sortedEdgeIds, graph.get(), false);
   addComponentAccessToGraph(graph.get());
   addComponentIsAmbiguousToGraph(graph.get());
 
@@ -1381,7 +1559,7 @@ std::shared_ptr<SourceLocationFile> PersistentStorage::getSourceLocationsOfTypeI
 }
 
 std::shared_ptr<TextAccess> PersistentStorage::getFileContent(const FilePath& filePath, bool /*showsErrors*/) const {
-  std::shared_ptr<TextAccess> fileContent = m_sqliteIndexStorage.getFileContentByPath(filePath.wstr());
+  std::shared_ptr<TextAccess> fileContent = getStoredFileContent(filePath);
   if(fileContent->getLineCount() > 0) {
     return fileContent;
   }
@@ -1389,7 +1567,7 @@ std::shared_ptr<TextAccess> PersistentStorage::getFileContent(const FilePath& fi
 }
 
 bool PersistentStorage::hasContentForFile(const FilePath& filePath) const {
-  std::shared_ptr<TextAccess> fileContent = m_sqliteIndexStorage.getFileContentByPath(filePath.wstr());
+  std::shared_ptr<TextAccess> fileContent = getStoredFileContent(filePath);
   if(fileContent->getLineCount() > 0) {
     return true;
   }
@@ -2044,98 +2222,34 @@ std::wstring PersistentStorage::getFileNodeLanguage(Id fileId) const {
   return L"";
 }
 
-std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToIncludingFileIdMap() const {
-  std::unordered_map<Id, std::set<Id>> fileIdToIncludingFileIdMap;
-
-  m_sqliteIndexStorage.forEachOfType<StorageEdge>(
-      Edge::typeToInt(Edge::EDGE_INCLUDE), [&fileIdToIncludingFileIdMap](StorageEdge&& edge) {
-        fileIdToIncludingFileIdMap[edge.targetNodeId].insert(edge.sourceNodeId);
-      });
-
-  return fileIdToIncludingFileIdMap;
+const std::unordered_map<Id, std::set<Id>>& PersistentStorage::getFileIdToIncludingFileIdMap() const {
+  return m_fileIdToIncludingFileIds;
 }
 
-std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToIncludedFileIdMap() const {
-  std::unordered_map<Id, std::set<Id>> fileIdToIncludingFileIdMap;
-
-  m_sqliteIndexStorage.forEachOfType<StorageEdge>(
-      Edge::typeToInt(Edge::EDGE_INCLUDE), [&fileIdToIncludingFileIdMap](StorageEdge&& edge) {
-        fileIdToIncludingFileIdMap[edge.sourceNodeId].insert(edge.targetNodeId);
-      });
-
-  return fileIdToIncludingFileIdMap;
-}
-
-std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToImportingFileIdMap() const {
-  std::unordered_map<Id, std::set<Id>> fileIdToImportingFileIdMap;
-  {
-    std::vector<Id> importedElementIds;
-    std::map<Id, std::set<Id>> elementIdToImportingFileIds;
-
-    m_sqliteIndexStorage.forEachOfType<StorageEdge>(
-        Edge::typeToInt(Edge::EDGE_IMPORT), [&importedElementIds, &elementIdToImportingFileIds](StorageEdge&& edge) {
-          importedElementIds.push_back(edge.targetNodeId);
-          elementIdToImportingFileIds[edge.targetNodeId].insert(edge.sourceNodeId);
-        });
-
-    std::unordered_map<Id, Id> importedElementIdToFileNodeId;
-    {
-      std::vector<Id> importedSourceLocationIds;
-      std::unordered_map<Id, Id> importedSourceLocationToElementIds;
-      for(const StorageOccurrence& occurrence : m_sqliteIndexStorage.getOccurrencesForElementIds(importedElementIds)) {
-        importedSourceLocationIds.push_back(occurrence.sourceLocationId);
-        importedSourceLocationToElementIds[occurrence.sourceLocationId] = occurrence.elementId;
-      }
-
-      for(const StorageSourceLocation& sourceLocation :
-          m_sqliteIndexStorage.getAllByIds<StorageSourceLocation>(importedSourceLocationIds)) {
-        auto it = importedSourceLocationToElementIds.find(sourceLocation.id);
-        if(it != importedSourceLocationToElementIds.end()) {
-          importedElementIdToFileNodeId[it->second] = sourceLocation.fileNodeId;
-        }
-      }
-    }
-
-    for(const auto& it : elementIdToImportingFileIds) {
-      auto importedFileIt = importedElementIdToFileNodeId.find(it.first);
-      if(importedFileIt != importedElementIdToFileNodeId.end()) {
-        fileIdToImportingFileIdMap[importedFileIt->second].insert(it.second.begin(), it.second.end());
-      }
-    }
-  }
-  return fileIdToImportingFileIdMap;
-}
-
-std::set<Id> PersistentStorage::getReferenced(const std::set<Id>& ids,
-                                              std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const {
-  std::unordered_map<Id, std::set<Id>> idToReferencedIdMap;
-  for(const auto& it : idToReferencingIdMap) {
-    for(Id referencingId : it.second) {
-      idToReferencedIdMap[referencingId].insert(it.first);
-    }
-  }
-
-  return getReferencing(ids, idToReferencedIdMap);
+const std::unordered_map<Id, std::set<Id>>& PersistentStorage::getFileIdToIncludedFileIdMap() const {
+  return m_fileIdToIncludedFileIds;
 }
 
 std::set<Id> PersistentStorage::getReferencing(const std::set<Id>& ids,
-                                               std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const {
+                                               const std::unordered_map<Id, std::set<Id>>& idToReferencingIdMap) const {
   std::set<Id> referencingIds;
 
-  std::set<Id> processingIds = ids;
-  std::set<Id> processedIds;
+  std::vector<Id> processingIds(ids.begin(), ids.end());
+  std::set<Id> processedIds = ids;
 
   while(!processingIds.empty()) {
-    std::set<Id> tempIds = processingIds;
-    utility::append(processedIds, processingIds);
-    processingIds.clear();
-
-    for(Id id : tempIds) {
-      utility::append(referencingIds, idToReferencingIdMap[id]);
-      for(Id referencingId : idToReferencingIdMap[id]) {
-        if(processedIds.find(referencingId) == processedIds.end()) {
-          processingIds.insert(referencingId);
-        }
+    const Id id = processingIds.back();
+    processingIds.pop_back();
+
+    auto it = idToReferencingIdMap.find(id);
+    if(it == idToReferencingIdMap.end()) {
+      continue;
+    }
+
+    for(Id referencingId : it->second) {
+      referencingIds.insert(referencingId);
+      if(processedIds.insert(referencingId).second) {
+        processingIds.push_back(referencingId);
       }
     }
   }
@@ -2144,10 +2258,10 @@ std::set<Id> PersistentStorage::getReferencing(const std::set<Id>& ids,
 }
 
 std::set<FilePath> PersistentStorage::getReferencedByIncludes(const std::set<FilePath>& filePaths) const {
-  const std::set<Id> ids = getReferenced(getFileNodeIds(filePaths), getFileIdToIncludingFileIdMap());
+  const std::set<Id> ids = getReferencing(getFileNodeIds(filePaths), m_fileIdToIncludedFileIds);
 
   std::set<FilePath> paths;
-  for(Id id : ids) {    // TODO: performance optimize: use just one request for all ids!
+  for(Id id : ids) {
     paths.insert(getFileNodePath(id));
   }
 
@@ -2155,7 +2269,7 @@ std::set<FilePath> PersistentStorage::getReferencedByIncludes(const std::set<Fil
 }
 
 std::set<FilePath> PersistentStorage::getReferencedByImports(const std::set<FilePath>& filePaths) const {
-  const std::set<Id> ids = getReferenced(getFileNodeIds(filePaths), getFileIdToImportingFileIdMap());
+  const std::set<Id> ids = getReferencing(getFileNodeIds(filePaths), m_fileIdToImportedFileIds);
 
   std::set<FilePath> paths;
   for(Id id : ids) {
@@ -2166,7 +2280,7 @@ std::set<FilePath> PersistentStorage::getReferencedByImports(const std::set<File
 }
 
 std::set<FilePath> PersistentStorage::getReferencingByIncludes(const std::set<FilePath>& filePaths) const {
-  const std::set<Id> ids = getReferencing(getFileNodeIds(filePaths), getFileIdToIncludingFileIdMap());
+  const std::set<Id> ids = getReferencing(getFileNodeIds(filePaths), m_fileIdToIncludingFileIds);
 
   std::set<FilePath> paths;
   for(Id id : ids) {
@@ -2177,7 +2291,7 @@ std::set<FilePath> PersistentStorage::getReferencingByIncludes(const std::set<Fi
 }
 
 std::set<FilePath> PersistentStorage::getReferencingByImports(const std::set<FilePath>& filePaths) const {
-  const std::set<Id> ids = getReferencing(getFileNodeIds(filePaths), getFileIdToImportingFileIdMap());
+  const std::set<Id> ids = getReferencing(getFileNodeIds(filePaths), m_fileIdToImportingFileIds);
 
   std::set<FilePath> paths;
   for(Id id : ids) {
@@ -2325,20 +2439,23 @@ void PersistentStorage::addBundledEdgesToGraph(Id nodeId, const std::vector<Stor
     connectedNodeIds[isSource ? edge.targetNodeId : edge.sourceNodeId].push_back(edgeInfo);
   }
 
-  const std::vector<StorageEdge> outgoingEdges = m_sqliteIndexStorage.getEdgesBySourceIds(childNodeIds);
-  for(const StorageEdge& outEdge : outgoingEdges) {
-    EdgeInfo edgeInfo;
-    edgeInfo.edgeId = outEdge.id;
-    edgeInfo.forward = true;
-    connectedNodeIds[outEdge.targetNodeId].push_back(edgeInfo);
+  const std::shared_ptr<const EdgeIndex> edgeIndex = getEdgeIndex();
+  for(const Id childNodeId : childNodeIds) {
+    edgeIndex->forEachOutgoingEdge(childNodeId, ~0, [&connectedNodeIds](const StorageEdge& outEdge) {
+      EdgeInfo edgeInfo;
+      edgeInfo.edgeId = outEdge.id;
+      edgeInfo.forward = true;
+      connectedNodeIds[outEdge.targetNodeId].push_back(edgeInfo);
+    });
   }
 
-  const std::vector<StorageEdge> incomingEdges = m_sqliteIndexStorage.getEdgesByTargetIds(childNodeIds);
-  for(const StorageEdge& inEdge : incomingEdges) {
-    EdgeInfo edgeInfo;
-    edgeInfo.edgeId = inEdge.id;
-    edgeInfo.forward = false;
-    connectedNodeIds[inEdge.sourceNodeId].push_back(edgeInfo);
+  for(const Id childNodeId : childNodeIds) {
+    edgeIndex->forEachIncomingEdge(childNodeId, ~0, [&connectedNodeIds](const StorageEdge& inEdge) {
+      EdgeInfo edgeInfo;
+      edgeInfo.edgeId = inEdge.id;
+      edgeInfo.forward = false;
+      connectedNodeIds[inEdge.sourceNodeId].push_back(edgeInfo);
+    });
   }
 
   // get all parent nodes of all connected nodes (up to last level except namespace/undefined)
@@ -2509,6 +2626,20 @@ void PersistentStorage::addInheritanceChainsToGraph(const std::vector<Id>& activ
   }
 }
 
+void PersistentStorage::buildFileDependencyMaps() {
+  const int includeEdgeType = Edge::typeToInt(Edge::EDGE_INCLUDE);
+
+  m_sqliteIndexStorage.forEach<StorageFileDependency>([&](StorageFileDependency&& dependency) {
+    if(dependency.type == includeEdgeType) {
+      m_fileIdToIncludingFileIds[dependency.referencedFileNodeId].insert(dependency.fileNodeId);
+      m_fileIdToIncludedFileIds[dependency.fileNodeId].insert(dependency.referencedFileNodeId);
+    } else {
+      m_fileIdToImportingFileIds[dependency.referencedFileNodeId].insert(dependency.fileNodeId);
+      m_fileIdToImportedFileIds[dependency.fileNodeId].insert(dependency.referencedFileNodeId);
+    }
+  });
+}
+
 void PersistentStorage::buildFilePathMaps() {
   m_sqliteIndexStorage.forEach<StorageFile>([&](StorageFile&& file) {
     const FilePath path(file.filePath);
@@ -2526,6 +2657,42 @@ void PersistentStorage::buildFilePathMaps() {
 }
 
 void PersistentStorage::buildSearchIndex() {
+  std::lock_guard<std::mutex> lock(m_searchIndicesMutex);
+
+  const FilePath snapshotPath = getSearchIndexFilePath();
+  const std::string validationKey = getSearchIndexValidationKey();
+
+  // only check the header here, the indices are read on first use
+  if(!validationKey.empty() && snapshotPath.recheckExists()) {
+    std::ifstream stream(snapshotPath.str(), std::ios::binary);
+    std::string storedKey;
+    if(std::getline(stream, storedKey) && storedKey == validationKey) {
+      m_searchIndicesPending = true;
+      return;
+    }
+  }
+
+  fillSearchIndices();
+
+  if(validationKey.empty()) {
+    return;
+  }
+
+  const FilePath tempSnapshotPath(snapshotPath.wstr() + L".tmp");
+  {
+    std::ofstream stream(tempSnapshotPath.str(), std::ios::binary | std::ios::trunc);
+    stream << validationKey << '\n';
+    m_symbolIndex.writeToStream(stream);
+    m_fileIndex.writeToStream(stream);
+    if(!stream) {
+      LOG_WARNING_W(L"Failed to write search index snapshot: " + tempSnapshotPath.wstr());
+    }
+  }
+  FileSystem::remove(snapshotPath);
+  FileSystem::rename(tempSnapshotPath, snapshotPath);
+}
+
+void PersistentStorage::fillSearchIndices() const {
   const FilePath dbPath = getIndexDbFilePath();
 
   m_sqliteIndexStorage.forEach<StorageNode>([&](StorageNode&& node) {
@@ -2571,6 +2738,42 @@ void PersistentStorage::buildSearchIndex() {
   m_fileIndex.finishSetup();
 }
 
+void PersistentStorage::loadPendingSearchIndices() const {
+  std::lock_guard<std::mutex> lock(m_searchIndicesMutex);
+  if(!m_searchIndicesPending) {
+    return;
+  }
+  m_searchIndicesPending = false;
+
+  std::ifstream stream(getSearchIndexFilePath().str(), std::ios::binary);
+  std::string storedKey;
+  if(std::getline(stream, storedKey) && m_symbolIndex.readFromStream(stream) && m_fileIndex.readFromStream(stream)) {
+    return;
+  }
+
+  LOG_WARNING("Search index snapshot could not be read, rebuilding search indices.");
+  m_symbolIndex.clear();
+  m_fileIndex.clear();
+  fillSearchIndices();
+}
+
+FilePath PersistentStorage::getSearchIndexFilePath() const {
+  // next to the database, concatenating would append a path component
+  return FilePath(getIndexDbFilePath().wstr() + L".searchindex");
+}
+
+std::string PersistentStorage::getSearchIndexValidationKey() const {
+  // every committed write bumps the write count, the database id tells apart databases replacing each other
+  const FilePath dbPath = getIndexDbFilePath();
+  const std::string databaseId = m_sqliteIndexStorage.getDatabaseId();
+  if(!dbPath.recheckExists() || databaseId.empty()) {
+    return {};
+  }
+
+  return "searchindex v3;" + std::to_string(m_sqliteIndexStorage.getVersion()) + ";" + databaseId + ";" +
+      std::to_string(m_sqliteIndexStorage.getWriteCount()) + ";" + utility::encodeToUtf8(dbPath.wstr());
+}
+
 void PersistentStorage::buildFullTextSearchIndex() const {
   TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
 
@@ -2578,28 +2781,97 @@ void PersistentStorage::buildFullTextSearchIndex() const {
 
   m_fullTextSearchIndex.clear();
 
+  std::vector<StorageFile> indexedFiles;
+  for(const StorageFile& file : m_sqliteIndexStorage.getAll<StorageFile>()) {
+    if(file.indexed) {
+      indexedFiles.push_back(file);
+    }
+  }
+
+  auto getFileContent = [&](Id fileId) {
+    return codec.decode(m_sqliteIndexStorage.getFileContentById(fileId)->getText());
+  };
+
+  // suffix arrays are kept in segment files next to the database, the arrays of unchanged files are only mapped
+  const FilePath segmentDirectoryPath = getFullTextSearchSegmentDirectoryPath();
+  const bool useSegments = getIndexDbFilePath().recheckExists();
+  if(useSegments && !segmentDirectoryPath.recheckExists()) {
+    FileSystem::createDirectory(segmentDirectoryPath);
+  }
+
+  // the stored modification time changes whenever the stored content of the file is replaced
+  std::map<FilePath, std::vector<std::pair<Id, std::string>>> segmentFileKeys;
+  if(useSegments) {
+    for(const StorageFile& file : indexedFiles) {
+      segmentFileKeys[getFullTextSearchSegmentFilePath(file.id)].emplace_back(
+          file.id, "fulltext v2;" + codec.getName() + ";" + file.modificationTime + ";" + utility::encodeToUtf8(file.filePath));
+    }
+  }
+  std::vector<FilePath> segmentFilePaths;
+  std::set<std::wstring> segmentFileNames;
+  for(const auto& [segmentFilePath, fileKeys] : segmentFileKeys) {
+    segmentFilePaths.push_back(segmentFilePath);
+    segmentFileNames.insert(segmentFilePath.fileName());
+  }
+
   std::vector<std::shared_ptr<std::thread>> threads;
-  {
-    std::vector<StorageFile> indexedFiles;
-    for(const StorageFile& file : m_sqliteIndexStorage.getAll<StorageFile>()) {
-      if(file.indexed) {
-        indexedFiles.push_back(file);
-      }
+  if(useSegments) {
+    for(std::vector<FilePath> part : utility::splitToEquallySizedParts(segmentFilePaths, utility::getIdealThreadCount())) {
+      threads.push_back(std::make_shared<std::thread>(
+          [&](const std::vector<FilePath>& filePaths) {
+            for(const FilePath& segmentFilePath : filePaths) {
+              m_fullTextSearchIndex.addSegment(segmentFilePath.str(), segmentFileKeys.at(segmentFilePath), getFileContent);
+            }
+          },
+          part));
     }
+  } else {
     for(std::vector<StorageFile> part : utility::splitToEquallySizedParts(indexedFiles, utility::getIdealThreadCount())) {
-      std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
+      threads.push_back(std::make_shared<std::thread>(
           [&](const std::vector<StorageFile>& files) {
             for(const StorageFile& file : files) {
-              m_fullTextSearchIndex.addFile(file.id, codec.decode(m_sqliteIndexStorage.getFileContentById(file.id)->getText()));
+              m_fullTextSearchIndex.addFile(file.id, getFileContent(file.id));
             }
           },
-          part);
-      threads.push_back(thread);
+          part));
     }
   }
   for(std::shared_ptr<std::thread> thread : threads) {
     thread->join();
   }
+
+  // segments without indexed files and segments of older versions
+  if(useSegments) {
+    for(const FilePath& filePath : FileSystem::getFilePathsFromDirectory(segmentDirectoryPath)) {
+      if(segmentFileNames.find(filePath.fileName()) == segmentFileNames.end()) {
+        FileSystem::remove(filePath);
+      }
+    }
+  }
+}
+
+FilePath PersistentStorage::getFullTextSearchSegmentDirectoryPath() const {
+  return FilePath(getIndexDbFilePath().wstr() + L".fulltext");
+}
+
+FilePath PersistentStorage::getFullTextSearchSegmentFilePath(Id fileId) const {
+  const Id segmentCount = 16;
+  return getFullTextSearchSegmentDirectoryPath().getConcatenated(L"/" + std::to_wstring(fileId % segmentCount) + L".segments");
+}
+
+void PersistentStorage::removeFullTextSearchSegments(const std::vector<Id>& fileIds) {
+  if(!getFullTextSearchSegmentDirectoryPath().recheckExists()) {
+    return;
+  }
+
+  std::map<FilePath, std::set<Id>> segmentFileIds;
+  for(Id fileId : fileIds) {
+    segmentFileIds[getFullTextSearchSegmentFilePath(fileId)].insert(fileId);
+  }
+
+  for(const auto& [segmentFilePath, segmentIds] : segmentFileIds) {
+    FullTextSearchIndex::removeFromSegment(segmentFilePath.str(), segmentIds);
+  }
 }
 
 void PersistentStorage::buildMemberEdgeIdOrderMap() {
@@ -2643,6 +2915,62 @@ void PersistentStorage::buildMemberEdgeIdOrderMap() {
   });
 }
 
+std::shared_ptr<const EdgeIndex> PersistentStorage::getEdgeIndex() const {
+  std::lock_guard<std::mutex> lock(m_edgeIndexMutex);
+  if(!m_edgeIndex) {
+    auto edgeIndex = std::make_shared<EdgeIndex>();
+    edgeIndex->build(m_sqliteIndexStorage.getNodeTypes(), m_sqliteIndexStorage.getAll<StorageEdge>());
+    m_edgeIndex = std::move(edgeIndex);
+  } else if(!m_edgeIndexAddedNodes.empty() || !m_edgeIndexAddedEdges.empty()) {
+    // the current index may still be used by other threads
+    auto edgeIndex = std::make_shared<EdgeIndex>(*m_edgeIndex);
+    edgeIndex->add(m_edgeIndexAddedNodes, m_edgeIndexAddedEdges);
+    m_edgeIndex = std::move(edgeIndex);
+  }
+
+  m_edgeIndexAddedNodes.clear();
+  m_edgeIndexAddedEdges.clear();
+  return m_edgeIndex;
+}
+
+void PersistentStorage::clearEdgeIndex() {
+  std::lock_guard<std::mutex> lock(m_edgeIndexMutex);
+  m_edgeIndex.reset();
+  m_edgeIndexAddedNodes.clear();
+  m_edgeIndexAddedEdges.clear();
+}
+
+std::shared_ptr<TextAccess> PersistentStorage::getStoredFileContent(const FilePath& filePath) const {
+  std::shared_ptr<TextAccess> fileContent;
+  size_t generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_storedFileContentsMutex);
+    if(m_storedFileContents.get(filePath.wstr(), &fileContent)) {
+      return fileContent;
+    }
+    generation = m_storedFileContentsGeneration;
+  }
+
+  fileContent = m_sqliteIndexStorage.getFileContentByPath(filePath.wstr());
+  if(fileContent->getByteSize() > 0) {
+    // determines the line offsets now instead of when the content is first shown, so they are part of the cost
+    const size_t cost = fileContent->getByteSize() + (fileContent->getLineCount() + 1) * sizeof(size_t);
+
+    std::lock_guard<std::mutex> lock(m_storedFileContentsMutex);
+    // content read before the cache was cleared may be outdated already
+    if(generation == m_storedFileContentsGeneration) {
+      m_storedFileContents.put(filePath.wstr(), fileContent, cost);
+    }
+  }
+  return fileContent;
+}
+
+void PersistentStorage::clearStoredFileContents() {
+  std::lock_guard<std::mutex> lock(m_storedFileContentsMutex);
+  m_storedFileContents.clear();
+  m_storedFileContentsGeneration++;
+}
+
 void PersistentStorage::buildHierarchyCache() {
   std::vector<Id> sourceNodeIds;
   std::vector<StorageEdge> memberEdges;
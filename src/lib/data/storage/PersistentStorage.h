@@ -3,8 +3,10 @@
 #include <memory>
 #include <vector>
 
+#include "EdgeIndex.h"
 #include "FullTextSearchIndex.h"
 #include "HierarchyCache.h"
+#include "LruCache.h"
 #include "SearchIndex.h"
 #include "SqliteBookmarkStorage.h"
 #include "SqliteIndexStorage.h"
@@ -29,7 +31,7 @@ public:
   std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) override;
 
   Id addLocalSymbol(const StorageLocalSymbolData& data) override;
-  std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) override;
+  std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) override;
 
   Id addSourceLocation(const StorageSourceLocationData& data) override;
   std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) override;
@@ -44,6 +46,7 @@ public:
   void addElementComponents(const std::vector<StorageElementComponent>& components) override;
 
   Id addError(const StorageErrorData& data) override;
+  void addIndexingCosts(const std::vector<StorageIndexingCost>& costs) override;
 
   void removeElement(const Id id);
   void removeElements(const std::vector<Id>& ids);
@@ -55,15 +58,18 @@ public:
   const std::vector<StorageFile>& getStorageFiles() const override;
   const std::vector<StorageSymbol>& getStorageSymbols() const override;
   const std::vector<StorageEdge>& getStorageEdges() const override;
-  const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const override;
-  const std::set<StorageSourceLocation>& getStorageSourceLocations() const override;
-  const std::set<StorageOccurrence>& getStorageOccurrences() const override;
-  const std::set<StorageComponentAccess>& getComponentAccesses() const override;
-  const std::set<StorageElementComponent>& getElementComponents() const override;
+  const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const override;
+  const std::vector<StorageSourceLocation>& getStorageSourceLocations() const override;
+  const std::vector<StorageOccurrence>& getStorageOccurrences() const override;
+  const std::vector<StorageComponentAccess>& getComponentAccesses() const override;
+  const std::vector<StorageElementComponent>& getElementComponents() const override;
   const std::vector<StorageError>& getErrors() const override;
+  const std::vector<StorageIndexingCost>& getIndexingCosts() const override;
 
-  void startInjection() override;
-  void finishInjection() override;
+  void prepareInjection(const Storage* injected) override;
+  void discardPreparedInjection(const Storage* injected) override;
+  void startInjection(const Storage* injected) override;
+  void finishInjection(const Storage* injected) override;
   void rollbackInjection();
 
   const std::vector<ErrorInfo> getErrorInfos() const;
@@ -92,6 +98,16 @@ public:
   void clearAllErrors();
   void clearFileElements(const std::vector<FilePath>& filePaths, std::function<void(int)> updateStatusCallback);
 
+  // persists the include and import dependencies between files, called once indexing finished
+  void updateFileDependencies();
+  // drops the name elements of nodes removed while clearing files, called once indexing finished
+  void removeUnreferencedNames();
+  // drops the indexing costs of source files removed from the project, called once indexing finished
+  void removeUnreferencedIndexingCosts();
+
+  // content hashes of all indexed files by file path, used to detect changes without comparing stored content
+  std::unordered_map<std::wstring, std::string> getFileContentHashes() const;
+
   std::vector<FileInfo> getFileInfoForAllFiles() const;
   std::set<FilePath> getIncompleteFiles() const;
   bool getFilePathIndexed(const FilePath& path) const;
@@ -99,6 +115,8 @@ public:
   void buildCaches();
 
   void optimizeMemory();
+  // has to be called before the index database file is copied or moved
+  void checkpoint();
 
   // StorageAccess implementation
   Id getNodeIdForFileNode(const FilePath& filePath) const override;
@@ -245,12 +263,13 @@ private:
     std::vector<StorageFile> files;
     std::vector<StorageSymbol> symbols;
     std::vector<StorageEdge> edges;
-    std::set<StorageLocalSymbol> locals;
-    std::set<StorageSourceLocation> locations;
-    std::set<StorageOccurrence> occurrences;
-    std::set<StorageComponentAccess> accesses;
-    std::set<StorageElementComponent> components;
+    std::vector<StorageLocalSymbol> locals;
+    std::vector<StorageSourceLocation> locations;
+    std::vector<StorageOccurrence> occurrences;
+    std::vector<StorageComponentAccess> accesses;
+    std::vector<StorageElementComponent> components;
     std::vector<StorageError> errors;
+    std::vector<StorageIndexingCost> indexingCosts;
   } m_storageData;
 
   Id getFileNodeId(const FilePath& filePath) const;
@@ -261,11 +280,10 @@ private:
   bool getFileNodeIndexed(Id fileId) const;
   std::wstring getFileNodeLanguage(Id fileId) const;
 
-  std::unordered_map<Id, std::set<Id>> getFileIdToIncludingFileIdMap() const;
-  std::unordered_map<Id, std::set<Id>> getFileIdToIncludedFileIdMap() const;
-  std::unordered_map<Id, std::set<Id>> getFileIdToImportingFileIdMap() const;
-  std::set<Id> getReferenced(const std::set<Id>& filePaths, std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const;
-  std::set<Id> getReferencing(const std::set<Id>& filePaths, std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const;
+  const std::unordered_map<Id, std::set<Id>>& getFileIdToIncludingFileIdMap() const;
+  const std::unordered_map<Id, std::set<Id>>& getFileIdToIncludedFileIdMap() const;
+  // transitive closure of the ids over the map, not containing the ids themselves unless they are part of a cycle
+  std::set<Id> getReferencing(const std::set<Id>& ids, const std::unordered_map<Id, std::set<Id>>& idToReferencingIdMap) const;
 
   std::set<FilePath> getReferencedByIncludes(const std::set<FilePath>& filePaths) const;
   std::set<FilePath> getReferencedByImports(const std::set<FilePath>& filePaths) const;
@@ -290,18 +308,38 @@ private:
   void addInheritanceChainsToGraph(const std::vector<Id>& nodeIds, Graph* graph) const;
 
   void buildFilePathMaps();
+  void buildFileDependencyMaps();
   void buildSearchIndex();
+  void fillSearchIndices() const;
+  void loadPendingSearchIndices() const;
+  FilePath getSearchIndexFilePath() const;
+  std::string getSearchIndexValidationKey() const;
   void buildFullTextSearchIndex() const;
+  FilePath getFullTextSearchSegmentDirectoryPath() const;
+  // the suffix arrays of all files are spread over a few segment files by file id, so only a few files are mapped
+  FilePath getFullTextSearchSegmentFilePath(Id fileId) const;
+  void removeFullTextSearchSegments(const std::vector<Id>& fileIds);
   void buildMemberEdgeIdOrderMap();
   void buildHierarchyCache();
+  // built from the database if it was cleared by removing elements since buildCaches(). the returned index isn't
+  // changed afterwards, nodes and edges added later are merged into a new one by the next call.
+  std::shared_ptr<const EdgeIndex> getEdgeIndex() const;
+  void clearEdgeIndex();
+  // content of the file stored in the database, empty if it has none
+  std::shared_ptr<TextAccess> getStoredFileContent(const FilePath& filePath) const;
+  void clearStoredFileContents();
 
   bool m_preIndexingErrorCountSet = false;
   size_t m_preIndexingErrorCount = 0;
   size_t m_preInjectionErrorCount = 0;
 
   SearchIndex m_commandIndex;
-  SearchIndex m_symbolIndex;
-  SearchIndex m_fileIndex;
+
+  // filled lazily from the snapshot file next to the database if it is still valid, see buildSearchIndex()
+  mutable SearchIndex m_symbolIndex;
+  mutable SearchIndex m_fileIndex;
+  mutable bool m_searchIndicesPending = false;
+  mutable std::mutex m_searchIndicesMutex;
 
   mutable FullTextSearchIndex m_fullTextSearchIndex;
   mutable std::string m_fullTextSearchCodec;
@@ -310,6 +348,16 @@ private:
   SqliteIndexStorage m_sqliteIndexStorage;
   SqliteBookmarkStorage m_sqliteBookmarkStorage;
 
+  struct PreparedFile {
+    std::string modificationTime;
+    std::shared_ptr<TextAccess> content;
+  };
+  // read by prepareInjection() off the writing thread for each storage waiting for injection, by storage id
+  std::map<Id, std::map<std::wstring, PreparedFile>> m_preparedFiles;
+  std::mutex m_preparedFilesMutex;
+  // taken from m_preparedFiles by startInjection(), consumed by addFile() and dropped by finishInjection()
+  std::map<std::wstring, PreparedFile> m_injectingFiles;
+
   std::map<FilePath, Id> m_fileNodeIds;
   std::map<FilePath, Id> m_lowerCasefileNodeIds;
   std::map<Id, FilePath> m_fileNodePaths;
@@ -317,8 +365,27 @@ private:
   std::unordered_map<Id, bool> m_fileNodeIndexed;
   std::map<Id, std::wstring> m_fileNodeLanguage;
 
+  // loaded from the file dependencies persisted when indexing finished, see updateFileDependencies()
+  std::unordered_map<Id, std::set<Id>> m_fileIdToIncludingFileIds;
+  std::unordered_map<Id, std::set<Id>> m_fileIdToIncludedFileIds;
+  std::unordered_map<Id, std::set<Id>> m_fileIdToImportingFileIds;
+  std::unordered_map<Id, std::set<Id>> m_fileIdToImportedFileIds;
+
   std::unordered_map<Id, DefinitionKind> m_symbolDefinitionKinds;
   std::map<Id, Id> m_memberEdgeIdOrderMap;
 
   HierarchyCache m_hierarchyCache;
+
+  // adjacency of all edges for graph traversals, null until it is built
+  mutable std::shared_ptr<const EdgeIndex> m_edgeIndex;
+  // added since m_edgeIndex was built, merged in at once instead of rebuilding the index for every addition
+  mutable std::vector<std::pair<Id, int>> m_edgeIndexAddedNodes;
+  mutable std::vector<StorageEdge> m_edgeIndexAddedEdges;
+  mutable std::mutex m_edgeIndexMutex;
+
+  // recently shown file contents by file path, limited by the size of their text and line offsets in bytes
+  mutable LruCache<std::wstring, std::shared_ptr<TextAccess>> m_storedFileContents {64 * 1024 * 1024};
+  // bumped by clearStoredFileContents()
+  size_t m_storedFileContentsGeneration = 0;
+  mutable std::mutex m_storedFileContentsMutex;
 };
@@ -1,17 +1,31 @@
 #include "Storage.h"
 
+#include <atomic>
+#include <unordered_map>
+
 #include "logging.h"
 #include "tracing.h"
 
-Storage::Storage() {}
+namespace {
+std::atomic<Id> s_lastStorageId = 0;
+}    // namespace
+
+Storage::Storage() : m_storageId(++s_lastStorageId) {}
+
+Id Storage::getStorageId() const {
+  return m_storageId;
+}
 
 void Storage::inject(Storage* injected) {
   std::lock_guard<std::mutex> lock(m_dataMutex);
 
-  std::map<Id, Id> injectedIdToOwnElementId;
-  std::map<Id, Id> injectedIdToOwnSourceLocationId;
+  std::unordered_map<Id, Id> injectedIdToOwnElementId;
+  std::unordered_map<Id, Id> injectedIdToOwnSourceLocationId;
+  injectedIdToOwnElementId.reserve(injected->getErrors().size() + injected->getStorageNodes().size() +
+                                   injected->getStorageEdges().size() + injected->getStorageLocalSymbols().size());
+  injectedIdToOwnSourceLocationId.reserve(injected->getStorageSourceLocations().size());
 
-  startInjection();
+  startInjection(injected);
 
   {
     // TRACE("inject errors");
@@ -108,7 +122,7 @@ void Storage::inject(Storage* injected) {
   {
     // TRACE("inject local symbols");
 
-    const std::set<StorageLocalSymbol>& symbols = injected->getStorageLocalSymbols();
+    const std::vector<StorageLocalSymbol>& symbols = injected->getStorageLocalSymbols();
     std::vector<Id> symbolIds = addLocalSymbols(symbols);
 
     auto it = symbols.begin();
@@ -123,7 +137,7 @@ void Storage::inject(Storage* injected) {
   {
     // TRACE("inject locations");
 
-    const std::set<StorageSourceLocation>& oldLocations = injected->getStorageSourceLocations();
+    const std::vector<StorageSourceLocation>& oldLocations = injected->getStorageSourceLocations();
     std::vector<StorageSourceLocation> locations;
     locations.reserve(oldLocations.size());
 
@@ -152,7 +166,7 @@ void Storage::inject(Storage* injected) {
   {
     // TRACE("inject occurrences");
 
-    const std::set<StorageOccurrence>& oldOccurrences = injected->getStorageOccurrences();
+    const std::vector<StorageOccurrence>& oldOccurrences = injected->getStorageOccurrences();
 
     std::vector<StorageOccurrence> occurrences;
     occurrences.reserve(oldOccurrences.size());
@@ -186,7 +200,7 @@ void Storage::inject(Storage* injected) {
   {
     // TRACE("inject element components");
 
-    const std::set<StorageElementComponent>& oldComponents = injected->getElementComponents();
+    const std::vector<StorageElementComponent>& oldComponents = injected->getElementComponents();
     std::vector<StorageElementComponent> components;
     components.reserve(oldComponents.size());
 
@@ -203,7 +217,7 @@ void Storage::inject(Storage* injected) {
   {
     // TRACE("inject accesses");
 
-    const std::set<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
+    const std::vector<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
     std::vector<StorageComponentAccess> accesses;
     accesses.reserve(oldAccesses.size());
 
@@ -217,13 +231,27 @@ void Storage::inject(Storage* injected) {
     addComponentAccesses(accesses);
   }
 
-  finishInjection();
+  {
+    // TRACE("inject indexing costs");
+
+    addIndexingCosts(injected->getIndexingCosts());
+  }
+
+  finishInjection(injected);
+}
+
+void Storage::prepareInjection(const Storage* /*injected*/) {
+  // may be implemented in derived
+}
+
+void Storage::discardPreparedInjection(const Storage* /*injected*/) {
+  // may be implemented in derived
 }
 
-void Storage::startInjection() {
+void Storage::startInjection(const Storage* /*injected*/) {
   // may be implemented in derived
 }
 
-void Storage::finishInjection() {
+void Storage::finishInjection(const Storage* /*injected*/) {
   // may be implemented in derived
 }
@@ -1,64 +1,259 @@
 #include "StorageProvider.h"
 
+#include <algorithm>
+#include <functional>
+#include <string>
+
 #include "logging.h"
 
+namespace {
+// bounds the quadratic pair search when many small storages are queued
+constexpr size_t s_maxMergeCandidateCount = 64;
+}    // namespace
+
+const size_t StorageProvider::s_defaultByteSizeBudget = size_t(512) * 1024 * 1024;
+
+StorageProvider::StorageProvider(size_t byteSizeBudget) : m_byteSizeBudget(byteSizeBudget) {}
+
 int StorageProvider::getStorageCount() const {
   std::lock_guard<std::mutex> lock(m_storagesMutex);
   return static_cast<int>(m_storages.size());
 }
 
+size_t StorageProvider::getByteSize() const {
+  std::lock_guard<std::mutex> lock(m_storagesMutex);
+  return m_metrics.byteSize + m_metrics.mergingByteSize;
+}
+
+size_t StorageProvider::getByteSizeBudget() const {
+  return m_byteSizeBudget;
+}
+
+StorageProvider::Metrics StorageProvider::getMetrics() const {
+  std::lock_guard<std::mutex> lock(m_storagesMutex);
+  Metrics metrics = m_metrics;
+  metrics.storageCount = m_storages.size();
+  return metrics;
+}
+
 void StorageProvider::clear() {
   std::lock_guard<std::mutex> lock(m_storagesMutex);
-  return m_storages.clear();
+  m_storages.clear();
+  m_metrics.byteSize = 0;
+  m_generation++;
 }
 
 void StorageProvider::insert(std::shared_ptr<IntermediateStorage> storage) {
-  const std::size_t storageSize = storage->getSourceLocationCount();
-  std::list<std::shared_ptr<IntermediateStorage>>::iterator it;
+  if(!storage) {
+    return;
+  }
+
+  // computed outside of the lock, storages don't change while they are queued
+  Entry entry = createEntry(std::move(storage));
 
   std::lock_guard<std::mutex> lock(m_storagesMutex);
-  for(it = m_storages.begin(); it != m_storages.end(); it++) {
-    if((*it)->getSourceLocationCount() < storageSize) {
-      break;
-    }
+  push(std::move(entry));
+}
+
+std::shared_ptr<IntermediateStorage> StorageProvider::consumeLargestStorage() {
+  std::lock_guard<std::mutex> lock(m_storagesMutex);
+  if(m_storages.empty()) {
+    return {};
   }
-  m_storages.insert(it, storage);
+
+  std::pop_heap(m_storages.begin(), m_storages.end(), EntryCompare());
+  return take(m_storages.size() - 1).storage;
 }
 
-std::shared_ptr<IntermediateStorage> StorageProvider::consumeSecondLargestStorage() {
-  std::shared_ptr<IntermediateStorage> ret;
-  {
-    std::lock_guard<std::mutex> lock(m_storagesMutex);
-    if(m_storages.size() > 1) {
-      std::list<std::shared_ptr<IntermediateStorage>>::iterator it = m_storages.begin();
-      it++;
-      ret = *it;
-      m_storages.erase(it);
+StorageProvider::MergeGroup StorageProvider::consumeMergeGroup(size_t maxStorageCount) {
+  std::lock_guard<std::mutex> lock(m_storagesMutex);
+  if(m_storages.size() < 3 || maxStorageCount < 2) {
+    return {};
+  }
+
+  // the largest storage is skipped, it is the next one to be injected
+  std::vector<size_t> candidates;
+  for(size_t i = 1; i < m_storages.size(); i++) {
+    candidates.push_back(i);
+  }
+
+  if(candidates.size() > s_maxMergeCandidateCount) {
+    std::nth_element(
+        candidates.begin(),
+        candidates.begin() + s_maxMergeCandidateCount - 1,
+        candidates.end(),
+        [this](size_t a, size_t b) { return m_storages[a].byteSize > m_storages[b].byteSize; });
+    candidates.resize(s_maxMergeCandidateCount);
+  }
+
+  // while memory is short the merge freeing the most bytes wins, otherwise the one with the best dedup ratio
+  const bool memoryPressure = m_metrics.byteSize + m_metrics.mergingByteSize > m_byteSizeBudget / 2;
+  auto getScore = [this, memoryPressure](size_t target, size_t source) {
+    const size_t savedByteSize = getEstimatedSavedByteSize(m_storages[target], m_storages[source]);
+    return memoryPressure ? double(savedByteSize) : double(savedByteSize) / double(m_storages[source].byteSize + 1);
+  };
+
+  size_t bestTarget = 0;
+  size_t bestSource = 0;
+  double bestScore = 0.0;
+  for(size_t i = 0; i < candidates.size(); i++) {
+    for(size_t j = i + 1; j < candidates.size(); j++) {
+      size_t target = candidates[i];
+      size_t source = candidates[j];
+      if(m_storages[target].byteSize < m_storages[source].byteSize) {
+        std::swap(target, source);
+      }
+
+      const double score = getScore(target, source);
+      if(score > bestScore) {
+        bestScore = score;
+        bestTarget = target;
+        bestSource = source;
+      }
     }
   }
-  return ret;
-}
 
-std::shared_ptr<IntermediateStorage> StorageProvider::consumeLargestStorage() {
-  std::shared_ptr<IntermediateStorage> ret;
-  {
-    std::lock_guard<std::mutex> lock(m_storagesMutex);
-    if(!m_storages.empty()) {
-      ret = m_storages.front();
-      m_storages.pop_front();
+  std::vector<size_t> group;
+  if(bestScore > 0.0) {
+    // add further storages sharing files with the best pair's target, best ones first
+    std::vector<std::pair<double, size_t>> additions;
+    for(size_t candidate : candidates) {
+      if(candidate != bestTarget && candidate != bestSource) {
+        const double score = getScore(bestTarget, candidate);
+        if(score > 0.0) {
+          additions.emplace_back(score, candidate);
+        }
+      }
+    }
+    std::sort(additions.begin(), additions.end(), std::greater<>());
+
+    group = {bestTarget, bestSource};
+    for(size_t i = 0; i < additions.size() && group.size() < maxStorageCount; i++) {
+      group.push_back(additions[i].second);
     }
+  } else {
+    // nothing to deduplicate, merging the smallest storages still saves injections at little cost
+    const size_t groupSize = std::min(maxStorageCount, candidates.size());
+    std::partial_sort(
+        candidates.begin(), candidates.begin() + static_cast<long>(groupSize), candidates.end(), [this](size_t a, size_t b) {
+          return m_storages[a].byteSize < m_storages[b].byteSize;
+        });
+    group.assign(candidates.begin(), candidates.begin() + static_cast<long>(groupSize));
+  }
+
+  MergeGroup mergeGroup;
+  mergeGroup.generation = m_generation;
+  for(size_t index : group) {
+    mergeGroup.byteSize += m_storages[index].byteSize;
+  }
+
+  // take higher indices first, so the remaining ones stay valid
+  std::vector<size_t> takeOrder = group;
+  std::sort(takeOrder.begin(), takeOrder.end(), std::greater<>());
+  std::vector<std::shared_ptr<IntermediateStorage>> taken(m_storages.size());
+  for(size_t index : takeOrder) {
+    taken[index] = take(index).storage;
+  }
+  std::make_heap(m_storages.begin(), m_storages.end(), EntryCompare());
+
+  for(size_t index : group) {
+    mergeGroup.storages.push_back(std::move(taken[index]));
+  }
+
+  // the taken storages stay in memory until the merge result replaces them
+  m_metrics.mergingByteSize += mergeGroup.byteSize;
+  m_metrics.runningMergeCount++;
+  return mergeGroup;
+}
+
+void StorageProvider::insertMergeResult(const MergeGroup& mergeGroup, std::shared_ptr<IntermediateStorage> mergedStorage) {
+  Entry entry = createEntry(std::move(mergedStorage));
+
+  std::lock_guard<std::mutex> lock(m_storagesMutex);
+  m_metrics.runningMergeCount--;
+  m_metrics.mergingByteSize -= mergeGroup.byteSize;
+  if(mergeGroup.generation != m_generation) {
+    return;
   }
 
-  return ret;
+  m_metrics.mergeCount++;
+  m_metrics.mergedByteSize += mergeGroup.byteSize;
+  if(mergeGroup.byteSize > entry.byteSize) {
+    m_metrics.savedByteSize += mergeGroup.byteSize - entry.byteSize;
+  }
+  push(std::move(entry));
 }
 
 void StorageProvider::logCurrentState() const {
-  std::string logString = "Storages waiting for injection:";
-  {
-    std::lock_guard<std::mutex> lock(m_storagesMutex);
-    for(const std::shared_ptr<IntermediateStorage>& storage : m_storages) {
-      logString += " " + std::to_string(storage->getSourceLocationCount()) + ";";
+  const Metrics metrics = getMetrics();
+  LOG_INFO(
+      "Storages waiting for injection: " + std::to_string(metrics.storageCount) + " (" +
+      std::to_string(metrics.byteSize / 1024 / 1024) + " MB, " + std::to_string(metrics.mergingByteSize / 1024 / 1024) +
+      " MB merging, peak " + std::to_string(metrics.peakByteSize / 1024 / 1024) +
+      " MB), merges: " + std::to_string(metrics.mergeCount) + " done, " + std::to_string(metrics.runningMergeCount) +
+      " running, " + std::to_string(metrics.mergedByteSize / 1024 / 1024) + " MB merged, " +
+      std::to_string(metrics.savedByteSize / 1024 / 1024) + " MB saved");
+}
+
+StorageProvider::Entry StorageProvider::createEntry(std::shared_ptr<IntermediateStorage> storage) {
+  Entry entry;
+  entry.byteSize = storage->getByteSize(sizeof(std::string));
+
+  const std::vector<StorageFile>& files = storage->getStorageFiles();
+  entry.fileHashes.reserve(files.size());
+  for(const StorageFile& file : files) {
+    entry.fileHashes.push_back(std::hash<std::wstring>()(file.filePath));
+  }
+  std::sort(entry.fileHashes.begin(), entry.fileHashes.end());
+  entry.fileHashes.erase(std::unique(entry.fileHashes.begin(), entry.fileHashes.end()), entry.fileHashes.end());
+
+  entry.storage = std::move(storage);
+  return entry;
+}
+
+size_t StorageProvider::getSharedFileCount(const Entry& a, const Entry& b) {
+  size_t count = 0;
+  auto itA = a.fileHashes.begin();
+  auto itB = b.fileHashes.begin();
+  while(itA != a.fileHashes.end() && itB != b.fileHashes.end()) {
+    if(*itA < *itB) {
+      itA++;
+    } else if(*itB < *itA) {
+      itB++;
+    } else {
+      count++;
+      itA++;
+      itB++;
     }
   }
-  LOG_INFO(logString);
+  return count;
+}
+
+size_t StorageProvider::getEstimatedSavedByteSize(const Entry& target, const Entry& source) const {
+  if(source.fileHashes.empty()) {
+    return 0;
+  }
+
+  // records are assumed to be spread evenly over the files of a storage, the ones of shared files are dropped
+  return source.byteSize * getSharedFileCount(target, source) / source.fileHashes.size();
+}
+
+void StorageProvider::push(Entry entry) {
+  m_metrics.byteSize += entry.byteSize;
+  m_metrics.peakByteSize = std::max(m_metrics.peakByteSize, m_metrics.byteSize + m_metrics.mergingByteSize);
+
+  m_storages.push_back(std::move(entry));
+  std::push_heap(m_storages.begin(), m_storages.end(), EntryCompare());
+}
+
+StorageProvider::Entry StorageProvider::take(size_t index) {
+  // removing anything but the top breaks the heap order, callers have to restore it
+  Entry entry = std::move(m_storages[index]);
+  m_metrics.byteSize -= entry.byteSize;
+
+  if(index + 1 != m_storages.size()) {
+    m_storages[index] = std::move(m_storages.back());
+  }
+  m_storages.pop_back();
+  return entry;
 }
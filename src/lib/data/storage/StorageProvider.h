@@ -1,30 +1,93 @@
 #ifndef STORAGE_PROVIDER_H
 #define STORAGE_PROVIDER_H
 
-#include <list>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "IntermediateStorage.h"
 
+/*
+ * Queue of intermediate storages waiting for merge and injection.
+ *
+ * Storages are kept in a max-heap by estimated byte size, so the injector always gets the largest one. Merge groups are
+ * chosen by the estimated number of bytes deduplicated by merging them, which is derived from the files the storages
+ * share (mostly headers). Several merges may run at once, each consumes its own group.
+ */
 class StorageProvider {
 public:
+  struct MergeGroup {
+    std::vector<std::shared_ptr<IntermediateStorage>> storages;
+    size_t byteSize = 0;    // estimated size of all storages before the merge
+    size_t generation = 0;    // results of groups taken before the last clear() are dropped
+  };
+
+  struct Metrics {
+    size_t storageCount = 0;
+    size_t byteSize = 0;           // estimated size of the queued storages
+    size_t mergingByteSize = 0;    // estimated size of the storages taken by running merges
+    size_t peakByteSize = 0;
+    size_t runningMergeCount = 0;
+    size_t mergeCount = 0;
+    size_t mergedByteSize = 0;    // estimated size of all merged storages before merging
+    size_t savedByteSize = 0;     // estimated size removed by deduplication during merges
+  };
+
+  static const size_t s_defaultByteSizeBudget;
+
+  explicit StorageProvider(size_t byteSizeBudget = s_defaultByteSizeBudget);
+
   int getStorageCount() const;
 
+  // estimated memory of all queued storages and of the ones still being merged
+  size_t getByteSize() const;
+
+  // producers should wait while the queued storages exceed this size
+  size_t getByteSizeBudget() const;
+
+  Metrics getMetrics() const;
+
   void clear();
 
   void insert(std::shared_ptr<IntermediateStorage> storage);
 
-  // returns empty shared_ptr if no storages available
-  std::shared_ptr<IntermediateStorage> consumeSecondLargestStorage();
-
   // returns empty shared_ptr if no storages available
   std::shared_ptr<IntermediateStorage> consumeLargestStorage();
 
+  // returns an empty group if there is nothing to merge, the largest storage is left for injection
+  MergeGroup consumeMergeGroup(size_t maxStorageCount);
+
+  // has to be called once for each group returned by consumeMergeGroup(), the result is dropped if the provider was
+  // cleared in the meantime
+  void insertMergeResult(const MergeGroup& mergeGroup, std::shared_ptr<IntermediateStorage> mergedStorage);
+
   void logCurrentState() const;
 
 private:
-  std::list<std::shared_ptr<IntermediateStorage>> m_storages;    // larger storages are in front
+  struct Entry {
+    std::shared_ptr<IntermediateStorage> storage;
+    size_t byteSize;
+    std::vector<size_t> fileHashes;    // sorted
+  };
+
+  struct EntryCompare {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return a.byteSize < b.byteSize;
+    }
+  };
+
+  static Entry createEntry(std::shared_ptr<IntermediateStorage> storage);
+  static size_t getSharedFileCount(const Entry& a, const Entry& b);
+
+  size_t getEstimatedSavedByteSize(const Entry& target, const Entry& source) const;
+  void push(Entry entry);
+  Entry take(size_t index);
+
+  const size_t m_byteSizeBudget;
+
+  std::vector<Entry> m_storages;    // heap, largest storage in front
+  Metrics m_metrics;
+  size_t m_generation = 0;
   mutable std::mutex m_storagesMutex;
 };
 
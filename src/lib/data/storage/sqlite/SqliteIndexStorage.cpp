@@ -1,5 +1,7 @@
 #include "SqliteIndexStorage.h"
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 #include <unordered_map>
@@ -11,9 +13,10 @@
 #include "TextAccess.h"
 #include "logging.h"
 #include "types.h"
+#include "utilityHash.h"
 #include "utilityString.h"
 
-const size_t SqliteIndexStorage::s_storageVersion = 25;
+const size_t SqliteIndexStorage::s_storageVersion = 28;
 
 namespace {
 std::pair<std::wstring, std::wstring> splitLocalSymbolName(const std::wstring& name) {
@@ -30,7 +33,10 @@ size_t SqliteIndexStorage::getStorageVersion() {
   return s_storageVersion;
 }
 
-SqliteIndexStorage::SqliteIndexStorage(const FilePath& dbFilePath) : SqliteStorage(dbFilePath.getCanonical()) {}
+SqliteIndexStorage::SqliteIndexStorage(const FilePath& dbFilePath) : SqliteStorage(dbFilePath.getCanonical()) {
+  // readers on other connections don't block the writer and see the last committed state
+  executeStatement("PRAGMA journal_mode=WAL;");
+}
 
 size_t SqliteIndexStorage::getStaticVersion() const {
   return s_storageVersion;
@@ -44,6 +50,17 @@ void SqliteIndexStorage::setMode(const StorageModeType mode) {
   m_tempLocalSymbolIndex.clear();
   m_tempSourceLocationIndices.clear();
 
+  {
+    std::lock_guard<std::mutex> lock(m_cachedStatementsMutex);
+    m_cachedStatements.clear();
+  }
+  setReadConnectionsEnabled(false);
+
+  if(mode == STORAGE_MODE_BULK_LOAD && !m_bulkLoading) {
+    beginBulkLoad();
+  }
+
+  // creating the indices while journaling is still off after a bulk load builds each of them in a single pass
   std::vector<std::pair<int, SqliteDatabaseIndex>> indices = getIndices();
   for(size_t i = 0; i < indices.size(); i++) {
     if(indices[i].first & mode) {
@@ -52,6 +69,20 @@ void SqliteIndexStorage::setMode(const StorageModeType mode) {
       indices[i].second.removeFromDatabase(m_database);
     }
   }
+
+  if(mode != STORAGE_MODE_BULK_LOAD && m_bulkLoading) {
+    finishBulkLoad();
+  }
+
+  setReadConnectionsEnabled(mode == STORAGE_MODE_READ);
+}
+
+void SqliteIndexStorage::rollbackTransaction() {
+  SqliteStorage::rollbackTransaction();
+
+  std::lock_guard<std::mutex> lock(m_namesMutex);
+  m_names.clear();
+  m_namesLoaded = false;
 }
 
 std::string SqliteIndexStorage::getProjectSettingsText() const {
@@ -82,7 +113,10 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
   }
 
   std::vector<Id> nodeIds(nodes.size(), 0);
-  std::vector<StorageNode> nodesToInsert;
+  std::vector<NodeRow> nodesToInsert;
+  std::vector<InternedNameTable::Element> namesToInsert;
+  std::unique_lock<std::mutex> namesLock(m_namesMutex);
+  getNames();
   for(size_t i = 0; i < nodes.size(); i++) {
     const StorageNodeData& data = nodes[i];
     std::string name = utility::encodeToUtf8(data.serializedName);
@@ -106,7 +140,7 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
         executeStatement(m_insertElementStmt);
         const Id id = static_cast<Id>(m_database.lastRowId());
 
-        nodesToInsert.emplace_back(id, data);
+        nodesToInsert.push_back({id, data.type, m_names.intern(data.serializedName, &namesToInsert)});
         nodeIds[i] = id;
 
         if(name.size() != data.serializedName.size()) {
@@ -119,6 +153,12 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
     }
   }
 
+  namesLock.unlock();
+
+  if(namesToInsert.size()) {
+    m_insertNameElementBatchStatement.execute(namesToInsert, this);
+  }
+
   if(nodesToInsert.size()) {
     m_insertNodeBatchStatement.execute(nodesToInsert, this);
   }
@@ -134,7 +174,7 @@ bool SqliteIndexStorage::addSymbols(const std::vector<StorageSymbol>& symbols) {
   return m_insertSymbolBatchStatement.execute(symbols, this);
 }
 
-bool SqliteIndexStorage::addFile(const StorageFile& data) {
+bool SqliteIndexStorage::addFile(const StorageFile& data, std::shared_ptr<TextAccess> content) {
   if(getFileByPath(data.filePath).id != 0) {
     return false;
   }
@@ -146,11 +186,16 @@ bool SqliteIndexStorage::addFile(const StorageFile& data) {
     modificationTime = FileSystem::getFileInfoForPath(filePath).lastWriteTime.toString();
   }
 
-  std::shared_ptr<TextAccess> content;
   int lineCount = 0;
+  std::string contentHash;
   if(data.indexed) {
-    content = TextAccess::createFromFile(filePath);
+    if(!content) {
+      content = TextAccess::createFromFile(filePath);
+    }
     lineCount = content->getLineCount();
+    contentHash = std::to_string(utility::getStableHash(content->getText()));
+  } else {
+    content.reset();
   }
 
   bool success = false;
@@ -162,6 +207,7 @@ bool SqliteIndexStorage::addFile(const StorageFile& data) {
     m_insertFileStmt.bind(5, data.indexed);
     m_insertFileStmt.bind(6, data.complete);
     m_insertFileStmt.bind(7, lineCount);
+    m_insertFileStmt.bind(8, contentHash.c_str());
     success = executeStatement(m_insertFileStmt);
   }
 
@@ -216,7 +262,7 @@ Id SqliteIndexStorage::addLocalSymbol(const StorageLocalSymbolData& data) {
   return ids.size() ? ids[0] : 0;
 }
 
-std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) {
+std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) {
   if(m_tempLocalSymbolIndex.empty()) {
     forEach<StorageLocalSymbol>([this](StorageLocalSymbol&& localSymbol) {
       std::pair<std::wstring, std::wstring> name = splitLocalSymbolName(localSymbol.name);
@@ -320,6 +366,12 @@ bool SqliteIndexStorage::addOccurrence(const StorageOccurrence& data) {
 }
 
 bool SqliteIndexStorage::addOccurrences(const std::vector<StorageOccurrence>& occurrences) {
+  if(m_bulkLoading && !std::is_sorted(occurrences.begin(), occurrences.end())) {
+    // rows arriving in primary key order are appended to the b-tree instead of splitting pages all over it
+    std::vector<StorageOccurrence> sortedOccurrences = occurrences;
+    std::sort(sortedOccurrences.begin(), sortedOccurrences.end());
+    return m_insertOccurrenceBatchStatement.execute(sortedOccurrences, this);
+  }
   return m_insertOccurrenceBatchStatement.execute(occurrences, this);
 }
 
@@ -328,6 +380,11 @@ bool SqliteIndexStorage::addComponentAccess(const StorageComponentAccess& compon
 }
 
 bool SqliteIndexStorage::addComponentAccesses(const std::vector<StorageComponentAccess>& componentAccesses) {
+  if(m_bulkLoading && !std::is_sorted(componentAccesses.begin(), componentAccesses.end())) {
+    std::vector<StorageComponentAccess> sortedComponentAccesses = componentAccesses;
+    std::sort(sortedComponentAccesses.begin(), sortedComponentAccesses.end());
+    return m_insertComponentAccessBatchStatement.execute(sortedComponentAccesses, this);
+  }
   return m_insertComponentAccessBatchStatement.execute(componentAccesses, this);
 }
 
@@ -379,6 +436,15 @@ StorageError SqliteIndexStorage::addError(const StorageErrorData& data) {
   return StorageError(id, data);
 }
 
+void SqliteIndexStorage::addIndexingCosts(const std::vector<StorageIndexingCost>& costs) {
+  constexpr uint64_t maxValue = static_cast<uint64_t>(std::numeric_limits<int>::max());
+  for(const StorageIndexingCost& cost : costs) {
+    m_insertIndexingCostStmt.bind(1, utility::encodeToUtf8(cost.sourceFilePath).c_str());
+    m_insertIndexingCostStmt.bind(2, static_cast<int>(std::min(cost.durationMS, maxValue)));
+    executeStatement(m_insertIndexingCostStmt);
+  }
+}
+
 void SqliteIndexStorage::removeElement(Id id) {
   std::vector<Id> ids;
   ids.push_back(id);
@@ -530,6 +596,58 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
   }
 }
 
+void SqliteIndexStorage::removeUnreferencedIndexingCosts() {
+  executeStatement("DELETE FROM indexing_cost WHERE source_file_path NOT IN (SELECT path FROM file WHERE path IS NOT NULL);");
+}
+
+void SqliteIndexStorage::removeUnreferencedNameElements() {
+  // an element is referenced if it is the name of a node or a prefix of such a name
+  const std::string removeUnreferenced =
+      "WITH RECURSIVE referenced_name_element(id) AS ("
+      "	SELECT name_id FROM node "
+      "	UNION "
+      "	SELECT name_element.parent_id FROM name_element "
+      "	INNER JOIN referenced_name_element ON name_element.id = referenced_name_element.id "
+      "	WHERE name_element.parent_id != 0"
+      ") "
+      "DELETE FROM name_element WHERE id NOT IN (SELECT id FROM referenced_name_element);";
+
+  try {
+    m_database.execDML(removeUnreferenced.c_str());
+
+    // the in memory table expects ids without gaps, renumbering in id order keeps parents in front of their children
+    if(m_database.execScalar("SELECT COUNT(*) < COALESCE(MAX(id), 0) FROM name_element;", 0) != 0) {
+      m_database.execDML("DROP TABLE IF EXISTS temp.name_element_id_map;");
+      m_database.execDML(
+          "CREATE TEMP TABLE name_element_id_map("
+          "new_id INTEGER NOT NULL, "
+          "old_id INTEGER NOT NULL UNIQUE, "
+          "PRIMARY KEY(new_id));");
+      m_database.execDML("INSERT INTO name_element_id_map(old_id) SELECT id FROM name_element ORDER BY id;");
+
+      m_database.execDML(
+          "UPDATE node SET name_id = (SELECT new_id FROM name_element_id_map WHERE old_id = node.name_id);");
+      m_database.execDML(
+          "CREATE TEMP TABLE name_element_compacted AS "
+          "SELECT id_map.new_id AS id, COALESCE(parent_map.new_id, 0) AS parent_id, name_element.data AS data "
+          "FROM name_element "
+          "INNER JOIN name_element_id_map AS id_map ON id_map.old_id = name_element.id "
+          "LEFT JOIN name_element_id_map AS parent_map ON parent_map.old_id = name_element.parent_id;");
+      m_database.execDML("DELETE FROM name_element;");
+      m_database.execDML(
+          "INSERT INTO name_element(id, parent_id, data) SELECT id, parent_id, data FROM temp.name_element_compacted;");
+      m_database.execDML("DROP TABLE temp.name_element_compacted;");
+      m_database.execDML("DROP TABLE temp.name_element_id_map;");
+    }
+  } catch(CppSQLite3Exception& e) {
+    LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+  }
+
+  std::lock_guard<std::mutex> lock(m_namesMutex);
+  m_names.clear();
+  m_namesLoaded = false;
+}
+
 void SqliteIndexStorage::removeAllErrors() {
   executeStatement("DELETE FROM error;");
 }
@@ -550,7 +668,7 @@ bool SqliteIndexStorage::isFile(Id elementId) const {
 }
 
 StorageEdge SqliteIndexStorage::getEdgeById(Id edgeId) const {
-  std::vector<StorageEdge> candidates = doGetAll<StorageEdge>("WHERE id = " + std::to_string(edgeId));
+  std::vector<StorageEdge> candidates = doGetAll<StorageEdge>("WHERE id IN " + std::string(s_idSetParameter), {edgeId});
 
   if(candidates.size() > 0) {
     return candidates[0];
@@ -573,19 +691,19 @@ StorageEdge SqliteIndexStorage::getEdgeBySourceTargetType(Id sourceId, Id target
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceId(Id sourceId) const {
-  return doGetAll<StorageEdge>("WHERE source_node_id == " + std::to_string(sourceId));
+  return doGetAll<StorageEdge>("WHERE source_node_id IN " + std::string(s_idSetParameter), {sourceId});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceIds(const std::vector<Id>& sourceIds) const {
-  return doGetAll<StorageEdge>("WHERE source_node_id IN (" + utility::join(utility::toStrings(sourceIds), ',') + ")");
+  return doGetAll<StorageEdge>("WHERE source_node_id IN " + std::string(s_idSetParameter), sourceIds);
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetId(Id targetId) const {
-  return doGetAll<StorageEdge>("WHERE target_node_id == " + std::to_string(targetId));
+  return doGetAll<StorageEdge>("WHERE target_node_id IN " + std::string(s_idSetParameter), {targetId});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetIds(const std::vector<Id>& targetIds) const {
-  return doGetAll<StorageEdge>("WHERE target_node_id IN (" + utility::join(utility::toStrings(targetIds), ',') + ")");
+  return doGetAll<StorageEdge>("WHERE target_node_id IN " + std::string(s_idSetParameter), targetIds);
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceOrTargetId(Id id) const {
@@ -597,29 +715,27 @@ std::vector<StorageEdge> SqliteIndexStorage::getEdgesByType(int type) const {
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceType(Id sourceId, int type) const {
-  return doGetAll<StorageEdge>("WHERE source_node_id == " + std::to_string(sourceId) + " AND type == " + std::to_string(type));
+  return doGetAll<StorageEdge>(
+      "WHERE source_node_id IN " + std::string(s_idSetParameter) + " AND type == " + std::to_string(type), {sourceId});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourcesType(const std::vector<Id>& sourceIds, int type) const {
-  return doGetAll<StorageEdge>("WHERE source_node_id IN (" + utility::join(utility::toStrings(sourceIds), ',') +
-                               ")"
-                               " AND type == " +
-                               std::to_string(type));
+  return doGetAll<StorageEdge>(
+      "WHERE source_node_id IN " + std::string(s_idSetParameter) + " AND type == " + std::to_string(type), sourceIds);
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetType(Id targetId, int type) const {
-  return doGetAll<StorageEdge>("WHERE target_node_id == " + std::to_string(targetId) + " AND type == " + std::to_string(type));
+  return doGetAll<StorageEdge>(
+      "WHERE target_node_id IN " + std::string(s_idSetParameter) + " AND type == " + std::to_string(type), {targetId});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetsType(const std::vector<Id>& targetIds, int type) const {
-  return doGetAll<StorageEdge>("WHERE target_node_id IN (" + utility::join(utility::toStrings(targetIds), ',') +
-                               ")"
-                               " AND type == " +
-                               std::to_string(type));
+  return doGetAll<StorageEdge>(
+      "WHERE target_node_id IN " + std::string(s_idSetParameter) + " AND type == " + std::to_string(type), targetIds);
 }
 
 StorageNode SqliteIndexStorage::getNodeById(Id id) const {
-  std::vector<StorageNode> candidates = doGetAll<StorageNode>("WHERE id = " + std::to_string(id));
+  std::vector<StorageNode> candidates = doGetAll<StorageNode>("WHERE id IN " + std::string(s_idSetParameter), {id});
 
   if(candidates.size() > 0) {
     return candidates[0];
@@ -629,19 +745,28 @@ StorageNode SqliteIndexStorage::getNodeById(Id id) const {
 }
 
 StorageNode SqliteIndexStorage::getNodeBySerializedName(const std::wstring& serializedName) const {
-  CppSQLite3Statement stmt = m_database.compileStatement(
-      "SELECT id, type, serialized_name FROM node WHERE serialized_name == ? LIMIT 1;");
+  Id nameId = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_namesMutex);
+    nameId = getNames().find(serializedName);
+  }
+
+  if(!nameId) {
+    return StorageNode();
+  }
 
-  stmt.bind(1, utility::encodeToUtf8(serializedName).c_str());
+  std::shared_ptr<CppSQLite3DB> database = acquireReadDatabase();
+  CppSQLite3Statement stmt = database->compileStatement("SELECT id, type FROM node WHERE name_id == ? LIMIT 1;");
+
+  stmt.bind(1, static_cast<int>(nameId));
   CppSQLite3Query q = executeQuery(stmt);
 
   if(!q.eof()) {
     const Id id = q.getIntField(0, 0);
     const int type = q.getIntField(1, -1);
-    const std::string name = q.getStringField(2, "");
 
     if(id != 0 && type != -1) {
-      return StorageNode(id, type, utility::decodeFromUtf8(name));
+      return StorageNode(id, type, serializedName);
     }
   }
 
@@ -667,6 +792,14 @@ std::vector<int> SqliteIndexStorage::getAvailableNodeTypes() const {
   return types;
 }
 
+std::vector<std::pair<Id, int>> SqliteIndexStorage::getNodeTypes() const {
+  std::vector<std::pair<Id, int>> nodeTypes;
+  forEachRow("SELECT id, type FROM node;", {}, [&nodeTypes](CppSQLite3Query& q) {
+    nodeTypes.emplace_back(static_cast<Id>(q.getIntField(0, 0)), q.getIntField(1, -1));
+  });
+  return nodeTypes;
+}
+
 std::vector<int> SqliteIndexStorage::getAvailableEdgeTypes() const {
   CppSQLite3Query q = executeQuery("SELECT DISTINCT type FROM edge;");
 
@@ -701,6 +834,43 @@ std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentById(Id fileId) co
   return TextAccess::createFromString("");
 }
 
+std::unordered_map<std::wstring, std::string> SqliteIndexStorage::getFileContentHashes() const {
+  std::unordered_map<std::wstring, std::string> contentHashes;
+
+  CppSQLite3Query q = executeQuery("SELECT path, content_hash FROM file WHERE content_hash != '';");
+  while(!q.eof()) {
+    contentHashes.emplace(utility::decodeFromUtf8(q.getStringField(0, "")), q.getStringField(1, ""));
+    q.nextRow();
+  }
+
+  return contentHashes;
+}
+
+void SqliteIndexStorage::updateFileDependencies(int includeEdgeType, int importEdgeType) {
+  const std::string includeDependencies =
+      "INSERT OR IGNORE INTO file_dependency(file_node_id, referenced_file_node_id, type) "
+      "SELECT source_node_id, target_node_id, type FROM edge WHERE type = " +
+      std::to_string(includeEdgeType) + ";";
+
+  // an import depends on the files defining the imported element, not on the files only qualifying it
+  const std::string importDependencies =
+      "INSERT OR IGNORE INTO file_dependency(file_node_id, referenced_file_node_id, type) "
+      "SELECT edge.source_node_id, source_location.file_node_id, edge.type FROM edge "
+      "INNER JOIN occurrence ON occurrence.element_id = edge.target_node_id "
+      "INNER JOIN source_location ON source_location.id = occurrence.source_location_id "
+      "WHERE edge.type = " +
+      std::to_string(importEdgeType) + " AND source_location.type IN (" + std::to_string(locationTypeToInt(LOCATION_TOKEN)) +
+      ", " + std::to_string(locationTypeToInt(LOCATION_SCOPE)) + ");";
+
+  try {
+    m_database.execDML("DELETE FROM file_dependency;");
+    m_database.execDML(includeDependencies.c_str());
+    m_database.execDML(importDependencies.c_str());
+  } catch(CppSQLite3Exception& e) {
+    LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+  }
+}
+
 std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::wstring& filePath) const {
   try {
     CppSQLite3Query q = executeQuery(
@@ -800,17 +970,16 @@ std::shared_ptr<SourceLocationCollection> SqliteIndexStorage::getSourceLocations
     sourceLocationIdToElementIds[occurrence.sourceLocationId].push_back(occurrence.elementId);
   }
 
-  CppSQLite3Query q = executeQuery(
+  std::shared_ptr<SourceLocationCollection> ret = std::make_shared<SourceLocationCollection>();
+
+  const std::string statement =
       "SELECT source_location.id, file.path, source_location.start_line, "
       "source_location.start_column, "
       "source_location.end_line, source_location.end_column, source_location.type "
       "FROM source_location INNER JOIN file ON (file.id = source_location.file_node_id) "
-      "WHERE source_location.id IN (" +
-      utility::join(utility::toStrings(sourceLocationIds), ',') + ");");
-
-  std::shared_ptr<SourceLocationCollection> ret = std::make_shared<SourceLocationCollection>();
-
-  while(!q.eof()) {
+      "WHERE source_location.id IN " +
+      std::string(s_idSetParameter) + ";";
+  forEachRow(statement, sourceLocationIds, [&](CppSQLite3Query& q) {
     const Id id = q.getIntField(0, 0);
     const std::string filePath = q.getStringField(1, "");
     const int startLineNumber = q.getIntField(2, -1);
@@ -830,9 +999,7 @@ std::shared_ptr<SourceLocationCollection> SqliteIndexStorage::getSourceLocations
                              endLineNumber,
                              endColNumber);
     }
-
-    q.nextRow();
-  }
+  });
 
   return ret;
 }
@@ -843,23 +1010,23 @@ std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForLocationId(I
 }
 
 std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForLocationIds(const std::vector<Id>& locationIds) const {
-  return doGetAll<StorageOccurrence>("WHERE source_location_id IN (" + utility::join(utility::toStrings(locationIds), ',') + ")");
+  return doGetAll<StorageOccurrence>("WHERE source_location_id IN " + std::string(s_idSetParameter), locationIds);
 }
 
 std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForElementIds(const std::vector<Id>& elementIds) const {
-  return doGetAll<StorageOccurrence>("WHERE element_id IN (" + utility::join(utility::toStrings(elementIds), ',') + ")");
+  return doGetAll<StorageOccurrence>("WHERE element_id IN " + std::string(s_idSetParameter), elementIds);
 }
 
 StorageComponentAccess SqliteIndexStorage::getComponentAccessByNodeId(Id nodeId) const {
-  return doGetFirst<StorageComponentAccess>("WHERE node_id == " + std::to_string(nodeId));
+  return doGetFirst<StorageComponentAccess>("WHERE node_id IN " + std::string(s_idSetParameter), {nodeId});
 }
 
 std::vector<StorageComponentAccess> SqliteIndexStorage::getComponentAccessesByNodeIds(const std::vector<Id>& nodeIds) const {
-  return doGetAll<StorageComponentAccess>("WHERE node_id IN (" + utility::join(utility::toStrings(nodeIds), ',') + ")");
+  return doGetAll<StorageComponentAccess>("WHERE node_id IN " + std::string(s_idSetParameter), nodeIds);
 }
 
 std::vector<StorageElementComponent> SqliteIndexStorage::getElementComponentsByElementIds(const std::vector<Id>& elementIds) const {
-  return doGetAll<StorageElementComponent>("WHERE element_id IN (" + utility::join(utility::toStrings(elementIds), ',') + ")");
+  return doGetAll<StorageElementComponent>("WHERE element_id IN " + std::string(s_idSetParameter), elementIds);
 }
 
 std::vector<ErrorInfo> SqliteIndexStorage::getAllErrorInfos() const {
@@ -940,16 +1107,37 @@ int SqliteIndexStorage::getErrorCount() const {
   return executeStatementScalar("SELECT COUNT(*) FROM error INNER JOIN occurrence ON (error.id = occurrence.element_id);", 0);
 }
 
+const InternedNameTable& SqliteIndexStorage::getNames() const {
+  if(!m_namesLoaded) {
+    CppSQLite3Query q = executeQuery("SELECT id, parent_id, data FROM name_element ORDER BY id;");
+    while(!q.eof()) {
+      InternedNameTable::Element element {static_cast<Id>(q.getIntField(0, 0)),
+                                          static_cast<Id>(q.getIntField(1, 0)),
+                                          utility::decodeFromUtf8(q.getStringField(2, ""))};
+      if(!m_names.add(std::move(element))) {
+        // a partially loaded table would hand out ids that are already taken, the next access loads again
+        m_names.clear();
+        return m_names;
+      }
+      q.nextRow();
+    }
+    m_namesLoaded = true;
+  }
+  return m_names;
+}
+
 std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices() const {
   std::vector<std::pair<int, SqliteDatabaseIndex>> indices;
   indices.push_back(std::make_pair(STORAGE_MODE_CLEAR, SqliteDatabaseIndex("edge_source_node_id_index", "edge(source_node_id)")));
   indices.push_back(std::make_pair(STORAGE_MODE_CLEAR, SqliteDatabaseIndex("edge_target_node_id_index", "edge(target_node_id)")));
-  indices.push_back(std::make_pair(
-      STORAGE_MODE_READ | STORAGE_MODE_CLEAR, SqliteDatabaseIndex("node_serialized_name_index", "node(serialized_name)")));
+  indices.push_back(
+      std::make_pair(STORAGE_MODE_READ | STORAGE_MODE_CLEAR, SqliteDatabaseIndex("node_name_id_index", "node(name_id)")));
   indices.push_back(std::make_pair(STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
                                    SqliteDatabaseIndex("source_location_file_node_id_index", "source_location(file_node_id)")));
-  indices.push_back(std::make_pair(STORAGE_MODE_WRITE, SqliteDatabaseIndex("error_all_data_index", "error(message, fatal)")));
-  indices.push_back(std::make_pair(STORAGE_MODE_WRITE, SqliteDatabaseIndex("file_path_index", "file(path)")));
+  indices.push_back(std::make_pair(STORAGE_MODE_WRITE | STORAGE_MODE_BULK_LOAD,
+                                   SqliteDatabaseIndex("error_all_data_index", "error(message, fatal)")));
+  indices.push_back(
+      std::make_pair(STORAGE_MODE_WRITE | STORAGE_MODE_BULK_LOAD, SqliteDatabaseIndex("file_path_index", "file(path)")));
   indices.push_back(std::make_pair(
       STORAGE_MODE_READ | STORAGE_MODE_CLEAR, SqliteDatabaseIndex("occurrence_element_id_index", "occurrence(element_id)")));
   indices.push_back(std::make_pair(STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
@@ -970,8 +1158,154 @@ std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices(
   return indices;
 }
 
+void SqliteIndexStorage::beginBulkLoad() {
+  {
+    CppSQLite3Query q = executeQuery("PRAGMA journal_mode;");
+    m_journalModeBeforeBulkLoad = q.eof() ? "DELETE" : q.getStringField(0, "DELETE");
+  }
+  m_synchronousBeforeBulkLoad = executeStatementScalar("PRAGMA synchronous;", 2);
+
+  executeStatement("PRAGMA foreign_keys=OFF;");
+  executeStatement("PRAGMA journal_mode=OFF;");
+  executeStatement("PRAGMA synchronous=OFF;");
+  executeStatement("PRAGMA locking_mode=EXCLUSIVE;");
+
+  m_bulkLoading = true;
+}
+
+void SqliteIndexStorage::finishBulkLoad() {
+  m_bulkLoading = false;
+
+  // foreign keys are still off, so removing a row doesn't cascade and may leave rows referencing it dangling. those
+  // only show up in the next check, which is why the check is repeated until it comes back empty.
+  size_t violationCount = 0;
+  while(true) {
+    // collect first, the check query must not be running while rows get deleted
+    std::vector<std::pair<std::string, int64_t>> violations;
+    {
+      CppSQLite3Query q = executeQuery("PRAGMA foreign_key_check;");
+      while(!q.eof()) {
+        violations.emplace_back(q.getStringField(0, ""), q.getInt64Field(1, 0));
+        q.nextRow();
+      }
+    }
+
+    if(violations.empty()) {
+      break;
+    }
+
+    bool removedAll = true;
+    beginTransaction();
+    for(const auto& [table, rowId] : violations) {
+      const std::string statement = "DELETE FROM " + table + " WHERE rowid = " + std::to_string(rowId) + ";";
+      removedAll = executeStatement(statement) && removedAll;
+    }
+    commitTransaction();
+
+    violationCount += violations.size();
+
+    // the same rows would be reported again
+    if(!removedAll) {
+      break;
+    }
+  }
+
+  if(violationCount > 0) {
+    LOG_WARNING(std::to_string(violationCount) + " rows violate foreign keys after bulk load and were removed.");
+  }
+
+  // the exclusive lock is only released by the next access to the database, and a write-ahead log entered with
+  // exclusive locking would keep it
+  executeStatement("PRAGMA locking_mode=NORMAL;");
+  executeStatementScalar("SELECT COUNT(*) FROM meta;", 0);
+
+  executeStatement("PRAGMA synchronous=" + std::to_string(m_synchronousBeforeBulkLoad) + ";");
+  executeStatement("PRAGMA journal_mode=" + m_journalModeBeforeBulkLoad + ";");
+  executeStatement("PRAGMA foreign_keys=ON;");
+}
+
+void SqliteIndexStorage::forEachRow(const std::string& statement,
+                                    const std::vector<Id>& ids,
+                                    const std::function<void(CppSQLite3Query&)>& readRow) const {
+  std::shared_ptr<CppSQLite3DB> readDatabase = acquireReadDatabase();
+  CppSQLite3DB& database = *readDatabase;
+
+  const size_t parameterPos = statement.find(s_idSetParameter);
+  if(parameterPos == std::string::npos) {
+    try {
+      CppSQLite3Query q = database.execQuery(statement.c_str());
+      while(!q.eof()) {
+        readRow(q);
+        q.nextRow();
+      }
+    } catch(CppSQLite3Exception& e) {
+      LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+    }
+    return;
+  }
+
+  std::vector<Id> uniqueIds = ids;
+  std::sort(uniqueIds.begin(), uniqueIds.end());
+  uniqueIds.erase(std::unique(uniqueIds.begin(), uniqueIds.end()), uniqueIds.end());
+
+  for(size_t chunkStart = 0; chunkStart < uniqueIds.size(); chunkStart += s_maxIdSetSize) {
+    const size_t chunkSize = std::min(s_maxIdSetSize, uniqueIds.size() - chunkStart);
+    size_t parameterCount = 1;
+    while(parameterCount < chunkSize) {
+      parameterCount *= 2;
+    }
+
+    const std::tuple<const CppSQLite3DB*, std::string, size_t> key(&database, statement, parameterCount);
+    CppSQLite3Statement stmt;
+    bool cached = false;
+    {
+      std::lock_guard<std::mutex> lock(m_cachedStatementsMutex);
+      auto it = m_cachedStatements.find(key);
+      if(it != m_cachedStatements.end() && !it->second.empty()) {
+        stmt = it->second.back();
+        it->second.pop_back();
+        cached = true;
+      }
+    }
+
+    try {
+      if(!cached) {
+        std::string compiledStatement = statement;
+        compiledStatement.replace(parameterPos,
+                                  std::string(s_idSetParameter).size(),
+                                  '(' + utility::join(std::vector<std::string>(parameterCount, "?"), ',') + ')');
+        stmt = database.compileStatement(compiledStatement.c_str());
+      }
+
+      for(size_t i = 0; i < parameterCount; i++) {
+        stmt.bind(static_cast<int>(i + 1), static_cast<int>(uniqueIds[chunkStart + std::min(i, chunkSize - 1)]));
+      }
+
+      CppSQLite3Query q = stmt.execQuery();
+      while(!q.eof()) {
+        readRow(q);
+        q.nextRow();
+      }
+      stmt.reset();
+    } catch(CppSQLite3Exception& e) {
+      LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+      continue;
+    }
+
+    std::lock_guard<std::mutex> lock(m_cachedStatementsMutex);
+    m_cachedStatements[key].push_back(stmt);
+  }
+}
+
 void SqliteIndexStorage::clearTables() {
+  {
+    std::lock_guard<std::mutex> lock(m_cachedStatementsMutex);
+    m_cachedStatements.clear();
+  }
+
   try {
+    m_database.execDML("DROP TABLE IF EXISTS main.indexing_cost;");
+    m_database.execDML("DROP TABLE IF EXISTS main.file_dependency;");
     m_database.execDML("DROP TABLE IF EXISTS main.error;");
     m_database.execDML("DROP TABLE IF EXISTS main.component_access;");
     m_database.execDML("DROP TABLE IF EXISTS main.occurrence;");
@@ -981,6 +1315,7 @@ void SqliteIndexStorage::clearTables() {
     m_database.execDML("DROP TABLE IF EXISTS main.file;");
     m_database.execDML("DROP TABLE IF EXISTS main.symbol;");
     m_database.execDML("DROP TABLE IF EXISTS main.node;");
+    m_database.execDML("DROP TABLE IF EXISTS main.name_element;");
     m_database.execDML("DROP TABLE IF EXISTS main.edge;");
     m_database.execDML("DROP TABLE IF EXISTS main.element_component;");
     m_database.execDML("DROP TABLE IF EXISTS main.element;");
@@ -988,6 +1323,10 @@ void SqliteIndexStorage::clearTables() {
   } catch(CppSQLite3Exception& e) {
     LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
   }
+
+  std::lock_guard<std::mutex> lock(m_namesMutex);
+  m_names.clear();
+  m_namesLoaded = false;
 }
 
 void SqliteIndexStorage::setupTables() {
@@ -1018,11 +1357,18 @@ void SqliteIndexStorage::setupTables() {
         "FOREIGN KEY(source_node_id) REFERENCES node(id) ON DELETE CASCADE, "
         "FOREIGN KEY(target_node_id) REFERENCES node(id) ON DELETE CASCADE);");
 
+    m_database.execDML(
+        "CREATE TABLE IF NOT EXISTS name_element("
+        "id INTEGER NOT NULL, "
+        "parent_id INTEGER NOT NULL, "
+        "data TEXT, "
+        "PRIMARY KEY(id));");
+
     m_database.execDML(
         "CREATE TABLE IF NOT EXISTS node("
         "id INTEGER NOT NULL, "
         "type INTEGER NOT NULL, "
-        "serialized_name TEXT, "
+        "name_id INTEGER NOT NULL, "
         "PRIMARY KEY(id), "
         "FOREIGN KEY(id) REFERENCES element(id) ON DELETE CASCADE);");
 
@@ -1042,6 +1388,7 @@ void SqliteIndexStorage::setupTables() {
         "indexed INTEGER, "
         "complete INTEGER, "
         "line_count INTEGER, "
+        "content_hash TEXT, "
         "PRIMARY KEY(id), "
         "FOREIGN KEY(id) REFERENCES node(id) ON DELETE CASCADE);");
 
@@ -1097,6 +1444,22 @@ void SqliteIndexStorage::setupTables() {
         "translation_unit TEXT, "
         "PRIMARY KEY(id), "
         "FOREIGN KEY(id) REFERENCES element(id) ON DELETE CASCADE);");
+
+    // kept across refreshes, a file's row is replaced whenever it gets indexed again
+    m_database.execDML(
+        "CREATE TABLE IF NOT EXISTS indexing_cost("
+        "source_file_path TEXT NOT NULL, "
+        "duration INTEGER NOT NULL, "
+        "PRIMARY KEY(source_file_path));");
+
+    m_database.execDML(
+        "CREATE TABLE IF NOT EXISTS file_dependency("
+        "file_node_id INTEGER NOT NULL, "
+        "referenced_file_node_id INTEGER NOT NULL, "
+        "type INTEGER NOT NULL, "
+        "PRIMARY KEY(file_node_id, referenced_file_node_id, type), "
+        "FOREIGN KEY(file_node_id) REFERENCES node(id) ON DELETE CASCADE, "
+        "FOREIGN KEY(referenced_file_node_id) REFERENCES node(id) ON DELETE CASCADE);");
   } catch(CppSQLite3Exception& e) {
     LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
 
@@ -1107,12 +1470,21 @@ void SqliteIndexStorage::setupTables() {
 void SqliteIndexStorage::setupPrecompiledStatements() {
   try {
     m_insertNodeBatchStatement.compile(
-        "INSERT INTO node(id, type, serialized_name) VALUES",
+        "INSERT INTO node(id, type, name_id) VALUES",
         3,
-        [](CppSQLite3Statement& stmt, const StorageNode& node, size_t index) {
+        [](CppSQLite3Statement& stmt, const NodeRow& node, size_t index) {
           stmt.bind(int(index) * 3 + 1, int(node.id));
           stmt.bind(int(index) * 3 + 2, int(node.type));
-          stmt.bind(int(index) * 3 + 3, utility::encodeToUtf8(node.serializedName).c_str());
+          stmt.bind(int(index) * 3 + 3, static_cast<int>(node.nameId));
+        },
+        m_database);
+    m_insertNameElementBatchStatement.compile(
+        "INSERT INTO name_element(id, parent_id, data) VALUES",
+        3,
+        [](CppSQLite3Statement& stmt, const InternedNameTable::Element& element, size_t index) {
+          stmt.bind(int(index) * 3 + 1, static_cast<int>(element.id));
+          stmt.bind(int(index) * 3 + 2, static_cast<int>(element.parentId));
+          stmt.bind(int(index) * 3 + 3, utility::encodeToUtf8(element.data).c_str());
         },
         m_database);
     m_insertEdgeBatchStatement.compile(
@@ -1176,7 +1548,7 @@ void SqliteIndexStorage::setupPrecompiledStatements() {
         "INSERT INTO element_component(id, element_id, type, data) VALUES(NULL, ?, ?, ?);");
     m_insertFileStmt = m_database.compileStatement(
         "INSERT INTO file(id, path, language, modification_time, indexed, complete, "
-        "line_count) VALUES(?, ?, ?, ?, ?, ?, ?);");
+        "line_count, content_hash) VALUES(?, ?, ?, ?, ?, ?, ?, ?);");
     m_insertFileContentStmt = m_database.compileStatement("INSERT INTO filecontent(id, content) VALUES(?, ?);");
     m_checkErrorExistsStmt = m_database.compileStatement(
         "SELECT id FROM error WHERE "
@@ -1186,6 +1558,8 @@ void SqliteIndexStorage::setupPrecompiledStatements() {
     m_insertErrorStmt = m_database.compileStatement(
         "INSERT INTO error(id, message, fatal, indexed, translation_unit) "
         "VALUES(?, ?, ?, ?, ?);");
+    m_insertIndexingCostStmt = m_database.compileStatement(
+        "INSERT OR REPLACE INTO indexing_cost(source_file_path, duration) VALUES(?, ?);");
   } catch(CppSQLite3Exception& e) {
     LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
 
@@ -1196,10 +1570,10 @@ void SqliteIndexStorage::setupPrecompiledStatements() {
 }
 
 template <>
-void SqliteIndexStorage::forEach<StorageEdge>(const std::string& query, std::function<void(StorageEdge&&)> func) const {
-  CppSQLite3Query q = executeQuery("SELECT id, type, source_node_id, target_node_id FROM edge " + query + ";");
-
-  while(!q.eof()) {
+void SqliteIndexStorage::forEach<StorageEdge>(const std::string& query,
+                                              const std::vector<Id>& ids,
+                                              std::function<void(StorageEdge&&)> func) const {
+  forEachRow("SELECT id, type, source_node_id, target_node_id FROM edge " + query + ";", ids, [&](CppSQLite3Query& q) {
     const Id id = q.getIntField(0, 0);
     const int type = q.getIntField(1, -1);
     const Id sourceId = q.getIntField(2, 0);
@@ -1208,49 +1582,49 @@ void SqliteIndexStorage::forEach<StorageEdge>(const std::string& query, std::fun
     if(id != 0 && type != -1) {
       func(StorageEdge(id, type, sourceId, targetId));
     }
-
-    q.nextRow();
-  }
+  });
 }
 
 template <>
-void SqliteIndexStorage::forEach<StorageNode>(const std::string& query, std::function<void(StorageNode&&)> func) const {
-  CppSQLite3Query q = executeQuery("SELECT id, type, serialized_name FROM node " + query + ";");
-
-  while(!q.eof()) {
+void SqliteIndexStorage::forEach<StorageNode>(const std::string& query,
+                                              const std::vector<Id>& ids,
+                                              std::function<void(StorageNode&&)> func) const {
+  forEachRow("SELECT id, type, name_id FROM node " + query + ";", ids, [&](CppSQLite3Query& q) {
     const Id id = q.getIntField(0, 0);
     const int type = q.getIntField(1, -1);
-    const std::string serializedName = q.getStringField(2, "");
+    const Id nameId = static_cast<Id>(q.getIntField(2, 0));
 
     if(id != 0 && type != -1) {
-      func(StorageNode(id, type, utility::decodeFromUtf8(serializedName)));
+      std::wstring serializedName;
+      {
+        std::lock_guard<std::mutex> lock(m_namesMutex);
+        serializedName = getNames().getSerializedName(nameId);
+      }
+      func(StorageNode(id, type, std::move(serializedName)));
     }
-
-    q.nextRow();
-  }
+  });
 }
 
 template <>
-void SqliteIndexStorage::forEach<StorageSymbol>(const std::string& query, std::function<void(StorageSymbol&&)> func) const {
-  CppSQLite3Query q = executeQuery("SELECT id, definition_kind FROM symbol " + query + ";");
-
-  while(!q.eof()) {
+void SqliteIndexStorage::forEach<StorageSymbol>(const std::string& query,
+                                                const std::vector<Id>& ids,
+                                                std::function<void(StorageSymbol&&)> func) const {
+  forEachRow("SELECT id, definition_kind FROM symbol " + query + ";", ids, [&](CppSQLite3Query& q) {
     const Id id = q.getIntField(0, 0);
     const int definitionKind = q.getIntField(1, 0);
 
     if(id != 0) {
       func(StorageSymbol(id, definitionKind));
     }
-
-    q.nextRow();
-  }
+  });
 }
 
 template <>
-void SqliteIndexStorage::forEach<StorageFile>(const std::string& query, std::function<void(StorageFile&&)> func) const {
-  CppSQLite3Query q = executeQuery("SELECT id, path, language, modification_time, indexed, complete FROM file " + query + ";");
-
-  while(!q.eof()) {
+void SqliteIndexStorage::forEach<StorageFile>(const std::string& query,
+                                              const std::vector<Id>& ids,
+                                              std::function<void(StorageFile&&)> func) const {
+  const std::string statement = "SELECT id, path, language, modification_time, indexed, complete FROM file " + query + ";";
+  forEachRow(statement, ids, [&](CppSQLite3Query& q) {
     const Id id = q.getIntField(0, 0);
     const std::string filePath = q.getStringField(1, "");
     const std::string languageIdentifier = q.getStringField(2, "");
@@ -1262,36 +1636,30 @@ void SqliteIndexStorage::forEach<StorageFile>(const std::string& query, std::fun
       func(StorageFile(
           id, utility::decodeFromUtf8(filePath), utility::decodeFromUtf8(languageIdentifier), modificationTime, indexed, complete));
     }
-    q.nextRow();
-  }
+  });
 }
 
 template <>
 void SqliteIndexStorage::forEach<StorageLocalSymbol>(const std::string& query,
+                                                     const std::vector<Id>& ids,
                                                      std::function<void(StorageLocalSymbol&&)> func) const {
-  CppSQLite3Query q = executeQuery("SELECT id, name FROM local_symbol " + query + ";");
-
-  while(!q.eof()) {
+  forEachRow("SELECT id, name FROM local_symbol " + query + ";", ids, [&](CppSQLite3Query& q) {
     const Id id = q.getIntField(0, 0);
     const std::string name = q.getStringField(1, "");
 
     if(id != 0) {
       func(StorageLocalSymbol(id, utility::decodeFromUtf8(name)));
     }
-
-    q.nextRow();
-  }
+  });
 }
 
 template <>
 void SqliteIndexStorage::forEach<StorageSourceLocation>(const std::string& query,
+                                                        const std::vector<Id>& ids,
                                                         std::function<void(StorageSourceLocation&&)> func) const {
-  CppSQLite3Query q = executeQuery(
-      "SELECT id, file_node_id, start_line, start_column, end_line, end_column, type FROM "
-      "source_location " +
-      query + ";");
-
-  while(!q.eof()) {
+  const std::string statement =
+      "SELECT id, file_node_id, start_line, start_column, end_line, end_column, type FROM source_location " + query + ";";
+  forEachRow(statement, ids, [&](CppSQLite3Query& q) {
     const Id id = q.getIntField(0, 0);
     const Id fileNodeId = q.getIntField(1, 0);
     const int startLineNumber = q.getIntField(2, -1);
@@ -1304,50 +1672,42 @@ void SqliteIndexStorage::forEach<StorageSourceLocation>(const std::string& query
        type != -1) {
       func(StorageSourceLocation(id, fileNodeId, startLineNumber, startColNumber, endLineNumber, endColNumber, type));
     }
-
-    q.nextRow();
-  }
+  });
 }
 
 template <>
-void SqliteIndexStorage::forEach<StorageOccurrence>(const std::string& query, std::function<void(StorageOccurrence&&)> func) const {
-  CppSQLite3Query q = executeQuery("SELECT element_id, source_location_id FROM occurrence " + query + ";");
-
-  while(!q.eof()) {
+void SqliteIndexStorage::forEach<StorageOccurrence>(const std::string& query,
+                                                    const std::vector<Id>& ids,
+                                                    std::function<void(StorageOccurrence&&)> func) const {
+  forEachRow("SELECT element_id, source_location_id FROM occurrence " + query + ";", ids, [&](CppSQLite3Query& q) {
     const Id elementId = q.getIntField(0, 0);
     const Id sourceLocationId = q.getIntField(1, 0);
 
     if(elementId != 0 && sourceLocationId != 0) {
       func(StorageOccurrence(elementId, sourceLocationId));
     }
-
-    q.nextRow();
-  }
+  });
 }
 
 template <>
 void SqliteIndexStorage::forEach<StorageComponentAccess>(const std::string& query,
+                                                         const std::vector<Id>& ids,
                                                          std::function<void(StorageComponentAccess&&)> func) const {
-  CppSQLite3Query q = executeQuery("SELECT node_id, type FROM component_access " + query + ";");
-
-  while(!q.eof()) {
+  forEachRow("SELECT node_id, type FROM component_access " + query + ";", ids, [&](CppSQLite3Query& q) {
     const Id nodeId = q.getIntField(0, 0);
     const int type = q.getIntField(1, -1);
 
     if(nodeId != 0 && type != -1) {
       func(StorageComponentAccess(nodeId, type));
     }
-
-    q.nextRow();
-  }
+  });
 }
 
 template <>
 void SqliteIndexStorage::forEach<StorageElementComponent>(const std::string& query,
+                                                          const std::vector<Id>& ids,
                                                           std::function<void(StorageElementComponent&&)> func) const {
-  CppSQLite3Query q = executeQuery("SELECT element_id, type, data FROM element_component " + query + ";");
-
-  while(!q.eof()) {
+  forEachRow("SELECT element_id, type, data FROM element_component " + query + ";", ids, [&](CppSQLite3Query& q) {
     const Id elementId = static_cast<uint32_t>(q.getIntField(0, 0));
     const int type = q.getIntField(1, -1);
     const std::string data = q.getStringField(2, "");
@@ -1355,16 +1715,14 @@ void SqliteIndexStorage::forEach<StorageElementComponent>(const std::string& que
     if(elementId != 0 && type != -1) {
       func(StorageElementComponent(elementId, type, utility::decodeFromUtf8(data)));
     }
-
-    q.nextRow();
-  }
+  });
 }
 
 template <>
-void SqliteIndexStorage::forEach<StorageError>(const std::string& query, std::function<void(StorageError&&)> func) const {
-  CppSQLite3Query q = executeQuery("SELECT id, message, fatal, indexed, translation_unit FROM error " + query + ";");
-
-  while(!q.eof()) {
+void SqliteIndexStorage::forEach<StorageError>(const std::string& query,
+                                               const std::vector<Id>& ids,
+                                               std::function<void(StorageError&&)> func) const {
+  forEachRow("SELECT id, message, fatal, indexed, translation_unit FROM error " + query + ";", ids, [&](CppSQLite3Query& q) {
     const Id id = static_cast<uint32_t>(q.getIntField(0, 0));
     const std::string message = q.getStringField(1, "");
     const bool fatal = q.getIntField(2, 0);
@@ -1374,7 +1732,35 @@ void SqliteIndexStorage::forEach<StorageError>(const std::string& query, std::fu
     if(id != 0) {
       func(StorageError(id, utility::decodeFromUtf8(message), utility::decodeFromUtf8(translationUnit), fatal, indexed));
     }
+  });
+}
 
-    q.nextRow();
-  }
+template <>
+void SqliteIndexStorage::forEach<StorageFileDependency>(const std::string& query,
+                                                        const std::vector<Id>& ids,
+                                                        std::function<void(StorageFileDependency&&)> func) const {
+  const std::string statement = "SELECT file_node_id, referenced_file_node_id, type FROM file_dependency " + query + ";";
+  forEachRow(statement, ids, [&](CppSQLite3Query& q) {
+    const Id fileNodeId = q.getIntField(0, 0);
+    const Id referencedFileNodeId = q.getIntField(1, 0);
+    const int type = q.getIntField(2, 0);
+
+    if(fileNodeId != 0 && referencedFileNodeId != 0) {
+      func(StorageFileDependency(fileNodeId, referencedFileNodeId, type));
+    }
+  });
+}
+
+template <>
+void SqliteIndexStorage::forEach<StorageIndexingCost>(const std::string& query,
+                                                      const std::vector<Id>& ids,
+                                                      std::function<void(StorageIndexingCost&&)> func) const {
+  forEachRow("SELECT source_file_path, duration FROM indexing_cost " + query + ";", ids, [&](CppSQLite3Query& q) {
+    const std::string sourceFilePath = q.getStringField(0, "");
+    const int duration = q.getIntField(1, 0);
+
+    if(!sourceFilePath.empty()) {
+      func(StorageIndexingCost(utility::decodeFromUtf8(sourceFilePath), static_cast<uint64_t>(std::max(duration, 0))));
+    }
+  });
 }
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include "ErrorInfo.h"
+#include "InternedNameTable.h"
 #include "LocationType.h"
 #include "LowMemoryStringMap.h"
 #include "SqliteDatabaseIndex.h"
@@ -13,7 +18,9 @@
 #include "StorageEdge.h"
 #include "StorageElementComponent.h"
 #include "StorageError.h"
+#include "StorageIndexingCost.h"
 #include "StorageFile.h"
+#include "StorageFileDependency.h"
 #include "StorageLocalSymbol.h"
 #include "StorageNode.h"
 #include "StorageOccurrence.h"
@@ -32,7 +39,11 @@ class SqliteIndexStorage final : public SqliteStorage {
 public:
   static size_t getStorageVersion();
 
-  enum StorageModeType { STORAGE_MODE_READ = 1, STORAGE_MODE_WRITE = 2, STORAGE_MODE_CLEAR = 4 };
+  // STORAGE_MODE_BULK_LOAD is meant for indexing into an empty database: journaling, syncing and foreign key checks are
+  // turned off and only the indices needed for writing exist. Switching to another mode restores the pragmas, removes
+  // rows that violate foreign keys and creates the indices of that mode once.
+  // In STORAGE_MODE_READ reads outside of transactions run on a pool of separate connections shared by the threads.
+  enum StorageModeType { STORAGE_MODE_READ = 1, STORAGE_MODE_WRITE = 2, STORAGE_MODE_CLEAR = 4, STORAGE_MODE_BULK_LOAD = 8 };
 
   SqliteIndexStorage(const FilePath& dbFilePath);
 
@@ -40,6 +51,9 @@ public:
 
   void setMode(const StorageModeType mode);
 
+  // also drops the cached name elements, they may contain elements of the discarded transaction
+  void rollbackTransaction() override;
+
   std::string getProjectSettingsText() const;
   void setProjectSettingsText(std::string text);
 
@@ -47,11 +61,12 @@ public:
   std::vector<Id> addNodes(const std::vector<StorageNode>& nodes);
   bool addSymbol(const StorageSymbol& data);
   bool addSymbols(const std::vector<StorageSymbol>& symbols);
-  bool addFile(const StorageFile& data);
+  // content is read from disk if the file is indexed and no content is passed
+  bool addFile(const StorageFile& data, std::shared_ptr<TextAccess> content = {});
   Id addEdge(const StorageEdgeData& data);
   std::vector<Id> addEdges(const std::vector<StorageEdge>& edges);
   Id addLocalSymbol(const StorageLocalSymbolData& data);
-  std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols);
+  std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols);
   Id addSourceLocation(const StorageSourceLocationData& data);
   std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations);
   bool addOccurrence(const StorageOccurrence& data);
@@ -61,6 +76,7 @@ public:
   void addElementComponent(const StorageElementComponent& component);
   void addElementComponents(const std::vector<StorageElementComponent>& components);
   StorageError addError(const StorageErrorData& data);
+  void addIndexingCosts(const std::vector<StorageIndexingCost>& costs);
 
   void removeElement(Id id);
   void removeElements(const std::vector<Id>& ids);
@@ -71,6 +87,11 @@ public:
 
   void removeAllErrors();
 
+  // removes the name elements no node name refers to anymore and renumbers the remaining ones densely
+  void removeUnreferencedNameElements();
+  // removes the indexing costs of source files that are not part of the index anymore
+  void removeUnreferencedIndexingCosts();
+
   bool isEdge(Id elementId) const;
   bool isNode(Id elementId) const;
   bool isFile(Id elementId) const;
@@ -94,6 +115,8 @@ public:
   StorageNode getNodeBySerializedName(const std::wstring& serializedName) const;
 
   std::vector<int> getAvailableNodeTypes() const;
+  // ids and types of all nodes without restoring their serialized names
+  std::vector<std::pair<Id, int>> getNodeTypes() const;
   std::vector<int> getAvailableEdgeTypes() const;
 
   StorageFile getFileByPath(const std::wstring& filePath) const;
@@ -101,6 +124,11 @@ public:
   std::vector<StorageFile> getFilesByPaths(const std::vector<FilePath>& filePaths) const;
   std::shared_ptr<TextAccess> getFileContentByPath(const std::wstring& filePath) const;
   std::shared_ptr<TextAccess> getFileContentById(Id fileId) const;
+  // content hashes of all files with stored content by file path
+  std::unordered_map<std::wstring, std::string> getFileContentHashes() const;
+
+  // derives the dependencies between files from the stored include edges and the definitions of imported elements
+  void updateFileDependencies(int includeEdgeType, int importEdgeType);
 
   void setFileIndexed(Id fileId, bool indexed);
   void setFileCompleteIfNoError(Id fileId, const std::wstring& filePath, bool complete);
@@ -133,7 +161,7 @@ public:
   template <typename ResultType>
   ResultType getFirstById(const Id id) const {
     if(id != 0) {
-      return doGetFirst<ResultType>("WHERE id == " + std::to_string(id));
+      return doGetFirst<ResultType>("WHERE id IN " + std::string(s_idSetParameter), {id});
     }
     return ResultType();
   }
@@ -141,7 +169,7 @@ public:
   template <typename ResultType>
   std::vector<ResultType> getAllByIds(const std::vector<Id>& ids) const {
     if(ids.size()) {
-      return doGetAll<ResultType>("WHERE id IN (" + utility::join(utility::toStrings(ids), ',') + ")");
+      return doGetAll<ResultType>("WHERE id IN " + std::string(s_idSetParameter), ids);
     }
     return std::vector<ResultType>();
   }
@@ -159,7 +187,7 @@ public:
   template <typename StorageType>
   void forEachByIds(const std::vector<Id> ids, std::function<void(StorageType&&)> func) const {
     if(ids.size()) {
-      forEach("WHERE id IN (" + utility::join(utility::toStrings(ids), ',') + ")", func);
+      forEach("WHERE id IN " + std::string(s_idSetParameter), ids, func);
     }
   }
 
@@ -174,6 +202,10 @@ public:
 private:
   static const size_t s_storageVersion;
 
+  // placeholder for a set of ids in read queries, it is bound to a prepared "(?,...,?)" list
+  static constexpr const char* s_idSetParameter = "(:ids)";
+  static constexpr size_t s_maxIdSetSize = 512;
+
   struct TempSourceLocation {
     TempSourceLocation(uint32_t startLine_, uint16_t lineDiff_, uint16_t startCol_, uint16_t endCol_, uint8_t type_)
         : startLine(startLine_), lineDiff(lineDiff_), startCol(startCol_), endCol(endCol_), type(type_) {}
@@ -199,22 +231,34 @@ private:
     uint8_t type;
   };
 
+  struct NodeRow {
+    Id id;
+    int type;
+    Id nameId;
+  };
+
   std::vector<std::pair<int, SqliteDatabaseIndex>> getIndices() const;
 
+  void beginBulkLoad();
+  void finishBulkLoad();
+
+  // node names are stored as chains of the name_element table, loaded on first use. m_namesMutex has to be locked.
+  const InternedNameTable& getNames() const;
+
   virtual void clearTables();
   virtual void setupTables();
   virtual void setupPrecompiledStatements();
 
   template <typename ResultType>
-  std::vector<ResultType> doGetAll(const std::string& query) const {
+  std::vector<ResultType> doGetAll(const std::string& query, const std::vector<Id>& ids = {}) const {
     std::vector<ResultType> elements;
-    forEach<ResultType>(query, [&elements](ResultType&& element) { elements.emplace_back(element); });
+    forEach<ResultType>(query, ids, [&elements](ResultType&& element) { elements.emplace_back(element); });
     return elements;
   }
 
   template <typename ResultType>
-  ResultType doGetFirst(const std::string& query) const {
-    std::vector<ResultType> results = doGetAll<ResultType>(query + " LIMIT 1");
+  ResultType doGetFirst(const std::string& query, const std::vector<Id>& ids = {}) const {
+    std::vector<ResultType> results = doGetAll<ResultType>(query + " LIMIT 1", ids);
     if(results.size() > 0) {
       return results[0];
     }
@@ -222,7 +266,19 @@ private:
   }
 
   template <typename StorageType>
-  void forEach(const std::string& query, std::function<void(StorageType&&)> func) const;
+  void forEach(const std::string& query, std::function<void(StorageType&&)> func) const {
+    forEach<StorageType>(query, {}, func);
+  }
+
+  // the ids are bound to the s_idSetParameter of the query
+  template <typename StorageType>
+  void forEach(const std::string& query, const std::vector<Id>& ids, std::function<void(StorageType&&)> func) const;
+
+  // Runs the statement once per chunk of the sorted unique ids and calls readRow for every result row. Chunks are padded
+  // to a power of two by repeating their last id, so each statement only ever needs a handful of cached shapes.
+  void forEachRow(const std::string& statement,
+                  const std::vector<Id>& ids,
+                  const std::function<void(CppSQLite3Query&)>& readRow) const;
 
   LowMemoryStringMap<std::string, uint32_t, 0> m_tempNodeNameIndex;
   LowMemoryStringMap<std::wstring, uint32_t, 0> m_tempWNodeNameIndex;
@@ -231,6 +287,10 @@ private:
   std::map<std::wstring, std::map<std::wstring, uint32_t>> m_tempLocalSymbolIndex;
   std::map<uint32_t, std::map<TempSourceLocation, uint32_t>> m_tempSourceLocationIndices;
 
+  mutable InternedNameTable m_names;
+  mutable bool m_namesLoaded = false;
+  mutable std::mutex m_namesMutex;
+
   template <typename StorageType>
   class InsertBatchStatement {
   public:
@@ -296,7 +356,8 @@ private:
     std::function<void(CppSQLite3Statement& stmt, const StorageType&, size_t)> m_bindValuesFunc;
   };
 
-  InsertBatchStatement<StorageNode> m_insertNodeBatchStatement;
+  InsertBatchStatement<NodeRow> m_insertNodeBatchStatement;
+  InsertBatchStatement<InternedNameTable::Element> m_insertNameElementBatchStatement;
   InsertBatchStatement<StorageEdge> m_insertEdgeBatchStatement;
   InsertBatchStatement<StorageSymbol> m_insertSymbolBatchStatement;
   InsertBatchStatement<StorageLocalSymbol> m_insertLocalSymbolBatchStatement;
@@ -310,28 +371,63 @@ private:
   CppSQLite3Statement m_insertFileContentStmt;
   CppSQLite3Statement m_checkErrorExistsStmt;
   CppSQLite3Statement m_insertErrorStmt;
+  CppSQLite3Statement m_insertIndexingCostStmt;
+
+  // prepared read statements by connection, statement text and id set size, a statement is taken out while it is in use
+  // so nested and concurrent queries of the same shape compile their own
+  mutable std::map<std::tuple<const CppSQLite3DB*, std::string, size_t>, std::vector<CppSQLite3Statement>> m_cachedStatements;
+  mutable std::mutex m_cachedStatementsMutex;
+
+  bool m_bulkLoading = false;
+  std::string m_journalModeBeforeBulkLoad;
+  int m_synchronousBeforeBulkLoad = 2;
 };
 
 template <>
-void SqliteIndexStorage::forEach<StorageEdge>(const std::string& query, std::function<void(StorageEdge&&)> func) const;
+void SqliteIndexStorage::forEach<StorageEdge>(const std::string& query,
+                                              const std::vector<Id>& ids,
+                                              std::function<void(StorageEdge&&)> func) const;
 template <>
-void SqliteIndexStorage::forEach<StorageNode>(const std::string& query, std::function<void(StorageNode&&)> func) const;
+void SqliteIndexStorage::forEach<StorageNode>(const std::string& query,
+                                              const std::vector<Id>& ids,
+                                              std::function<void(StorageNode&&)> func) const;
 template <>
-void SqliteIndexStorage::forEach<StorageSymbol>(const std::string& query, std::function<void(StorageSymbol&&)> func) const;
+void SqliteIndexStorage::forEach<StorageSymbol>(const std::string& query,
+                                                const std::vector<Id>& ids,
+                                                std::function<void(StorageSymbol&&)> func) const;
 template <>
-void SqliteIndexStorage::forEach<StorageFile>(const std::string& query, std::function<void(StorageFile&&)> func) const;
+void SqliteIndexStorage::forEach<StorageFile>(const std::string& query,
+                                              const std::vector<Id>& ids,
+                                              std::function<void(StorageFile&&)> func) const;
 template <>
-void SqliteIndexStorage::forEach<StorageLocalSymbol>(const std::string& query, std::function<void(StorageLocalSymbol&&)> func) const;
+void SqliteIndexStorage::forEach<StorageLocalSymbol>(const std::string& query,
+                                                     const std::vector<Id>& ids,
+                                                     std::function<void(StorageLocalSymbol&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageSourceLocation>(const std::string& query,
+                                                        const std::vector<Id>& ids,
                                                         std::function<void(StorageSourceLocation&&)> func) const;
 template <>
-void SqliteIndexStorage::forEach<StorageOccurrence>(const std::string& query, std::function<void(StorageOccurrence&&)> func) const;
+void SqliteIndexStorage::forEach<StorageOccurrence>(const std::string& query,
+                                                    const std::vector<Id>& ids,
+                                                    std::function<void(StorageOccurrence&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageComponentAccess>(const std::string& query,
+                                                         const std::vector<Id>& ids,
                                                          std::function<void(StorageComponentAccess&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageElementComponent>(const std::string& query,
+                                                          const std::vector<Id>& ids,
                                                           std::function<void(StorageElementComponent&&)> func) const;
 template <>
-void SqliteIndexStorage::forEach<StorageError>(const std::string& query, std::function<void(StorageError&&)> func) const;
\ No newline at end of file
+void SqliteIndexStorage::forEach<StorageError>(const std::string& query,
+                                               const std::vector<Id>& ids,
+                                               std::function<void(StorageError&&)> func) const;
+template <>
+void SqliteIndexStorage::forEach<StorageIndexingCost>(const std::string& query,
+                                                      const std::vector<Id>& ids,
+                                                      std::function<void(StorageIndexingCost&&)> func) const;
+template <>
+void SqliteIndexStorage::forEach<StorageFileDependency>(const std::string& query,
+                                                        const std::vector<Id>& ids,
+                                                        std::function<void(StorageFileDependency&&)> func) const;
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "TimeStamp.h"
 #include "logging.h"
 #include "utilityString.h"
+#include "utilityUuid.h"
 
 SqliteStorage::SqliteStorage(const FilePath& dbFilePath) : m_dbFilePath(dbFilePath.getCanonical()) {
   if(!m_dbFilePath.getParentDirectory().empty() && !m_dbFilePath.getParentDirectory().exists()) {
@@ -22,6 +23,8 @@ SqliteStorage::SqliteStorage(const FilePath& dbFilePath) : m_dbFilePath(dbFilePa
 }
 
 SqliteStorage::~SqliteStorage() {
+  setReadConnectionsEnabled(false);
+
   try {
     m_database.close();
   } catch(CppSQLite3Exception e) {
@@ -33,6 +36,10 @@ void SqliteStorage::setup() {
   executeStatement("PRAGMA foreign_keys=ON;");
   setupMetaTable();
 
+  if(getDatabaseId().empty()) {
+    insertOrUpdateMetaValue("database_id", utility::getUuidString());
+  }
+
   if(isEmpty() || !isIncompatible()) {
     setupTables();
 
@@ -66,21 +73,32 @@ void SqliteStorage::setVersion(size_t version) {
 }
 
 void SqliteStorage::beginTransaction() {
-  executeStatement("BEGIN TRANSACTION;");
+  m_transactionOpen = executeStatement("BEGIN TRANSACTION;");
 }
 
 void SqliteStorage::commitTransaction() {
+  executeStatement(
+      "INSERT OR REPLACE INTO meta(id, key, value) VALUES("
+      "(SELECT id FROM meta WHERE key = 'write_count'), 'write_count', "
+      "COALESCE((SELECT CAST(value AS INTEGER) FROM meta WHERE key = 'write_count'), 0) + 1"
+      ");");
   executeStatement("COMMIT TRANSACTION;");
+  m_transactionOpen = !m_database.IsAutoCommitOn();
 }
 
 void SqliteStorage::rollbackTransaction() {
   executeStatement("ROLLBACK TRANSACTION;");
+  m_transactionOpen = !m_database.IsAutoCommitOn();
 }
 
 void SqliteStorage::optimizeMemory() const {
   executeStatement("VACUUM;");
 }
 
+void SqliteStorage::checkpoint() const {
+  executeStatement("PRAGMA wal_checkpoint(TRUNCATE);");
+}
+
 FilePath SqliteStorage::getDbFilePath() const {
   return m_dbFilePath;
 }
@@ -106,6 +124,20 @@ TimeStamp SqliteStorage::getTime() const {
   return TimeStamp(getMetaValue("timestamp"));
 }
 
+std::string SqliteStorage::getDatabaseId() const {
+  return getMetaValue("database_id");
+}
+
+size_t SqliteStorage::getWriteCount() const {
+  std::string writeCountStr = getMetaValue("write_count");
+
+  if(!writeCountStr.empty()) {
+    return static_cast<size_t>(std::stoull(writeCountStr));
+  }
+
+  return 0;
+}
+
 void SqliteStorage::setupMetaTable() {
   try {
     m_database.execDML(
@@ -208,6 +240,53 @@ bool SqliteStorage::hasTable(const std::string& tableName) const {
   return false;
 }
 
+std::shared_ptr<CppSQLite3DB> SqliteStorage::acquireReadDatabase() const {
+  std::lock_guard<std::mutex> lock(m_readDatabasesMutex);
+  if(!m_readConnectionsEnabled || m_transactionOpen) {
+    return std::shared_ptr<CppSQLite3DB>(&m_database, [](CppSQLite3DB*) {});
+  }
+
+  CppSQLite3DB* readDatabase = nullptr;
+  if(!m_idleReadDatabases.empty()) {
+    readDatabase = m_idleReadDatabases.back();
+    m_idleReadDatabases.pop_back();
+  } else if(m_readDatabases.size() < s_maxReadConnectionCount) {
+    auto newReadDatabase = std::make_unique<CppSQLite3DB>();
+    try {
+      newReadDatabase->open(utility::encodeToUtf8(m_dbFilePath.wstr()).c_str());
+      newReadDatabase->execDML("PRAGMA query_only=ON;");
+    } catch(CppSQLite3Exception& e) {
+      LOG_WARNING(std::string("Failed to open read connection: ") + e.errorMessage());
+      return std::shared_ptr<CppSQLite3DB>(&m_database, [](CppSQLite3DB*) {});
+    }
+    readDatabase = m_readDatabases.emplace_back(std::move(newReadDatabase)).get();
+  } else {
+    return std::shared_ptr<CppSQLite3DB>(&m_database, [](CppSQLite3DB*) {});
+  }
+
+  return std::shared_ptr<CppSQLite3DB>(readDatabase, [this](CppSQLite3DB* database) {
+    std::lock_guard<std::mutex> lock(m_readDatabasesMutex);
+    m_idleReadDatabases.push_back(database);
+  });
+}
+
+void SqliteStorage::setReadConnectionsEnabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(m_readDatabasesMutex);
+  m_readConnectionsEnabled = enabled;
+
+  if(!enabled) {
+    for(auto& readDatabase : m_readDatabases) {
+      try {
+        readDatabase->close();
+      } catch(CppSQLite3Exception& e) {
+        LOG_ERROR(e.errorMessage());
+      }
+    }
+    m_readDatabases.clear();
+    m_idleReadDatabases.clear();
+  }
+}
+
 std::string SqliteStorage::getMetaValue(const std::string& key) const {
   if(hasTable("meta")) {
     CppSQLite3Query q = executeQuery("SELECT value FROM meta WHERE key = '" + key + "';");
@@ -1,6 +1,11 @@
 #ifndef SQLITE_STORAGE_H
 #define SQLITE_STORAGE_H
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "CppSQLite3.h"
 #include "FilePath.h"
 #include "SqliteDatabaseIndex.h"
@@ -21,9 +26,11 @@ public:
 
   void beginTransaction();
   void commitTransaction();
-  void rollbackTransaction();
+  virtual void rollbackTransaction();
 
   void optimizeMemory() const;
+  // writes the content of the write-ahead log into the database file, so the file can be copied or moved on its own
+  void checkpoint() const;
 
   FilePath getDbFilePath() const;
 
@@ -33,6 +40,11 @@ public:
   void setTime();
   TimeStamp getTime() const;
 
+  // identifies the database and the state of its content, the write count is bumped by every committed transaction.
+  // unlike the file size and modification time, these don't change when the write-ahead log is checkpointed.
+  std::string getDatabaseId() const;
+  size_t getWriteCount() const;
+
 protected:
   void setupMetaTable();
   void clearMetaTable();
@@ -46,6 +58,14 @@ protected:
 
   bool hasTable(const std::string& tableName) const;
 
+  // Checks out a connection for reads, it is handed back to the pool when the returned pointer is released. While read
+  // connections are enabled and no transaction is open, this is one of up to s_maxReadConnectionCount query only
+  // connections, so reads of different threads run in parallel. Otherwise, or if all of them are checked out, it is
+  // m_database. This requires the database to use a write-ahead log.
+  std::shared_ptr<CppSQLite3DB> acquireReadDatabase() const;
+  // must not be called while other threads are reading, disabling closes all read connections
+  void setReadConnectionsEnabled(bool enabled);
+
   std::string getMetaValue(const std::string& key) const;
   void insertOrUpdateMetaValue(const std::string& key, const std::string& value);
 
@@ -58,8 +78,18 @@ private:
   virtual void setupTables() = 0;
   virtual void setupPrecompiledStatements() = 0;
 
+  static constexpr size_t s_maxReadConnectionCount = 8;
+
   std::vector<std::pair<int, SqliteDatabaseIndex>> m_indices;
 
+  // set by the transaction methods, so reading threads don't have to ask m_database while it is used for writing
+  std::atomic<bool> m_transactionOpen = false;
+
+  bool m_readConnectionsEnabled = false;
+  mutable std::vector<std::unique_ptr<CppSQLite3DB>> m_readDatabases;
+  mutable std::vector<CppSQLite3DB*> m_idleReadDatabases;
+  mutable std::mutex m_readDatabasesMutex;
+
   bool m_precompiledStatementsInitialized = false;
 
   friend SqliteStorageMigration;
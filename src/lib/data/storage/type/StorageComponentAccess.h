@@ -1,6 +1,7 @@
 #pragma once
 // internal
 #include "types.h"
+#include "utilityHash.h"
 
 struct StorageComponentAccess {
   StorageComponentAccess() = default;
@@ -11,6 +12,18 @@ struct StorageComponentAccess {
     return nodeId < other.nodeId;
   }
 
+  struct Hash {
+    size_t operator()(const StorageComponentAccess& access) const {
+      return std::hash<Id>()(access.nodeId);
+    }
+  };
+
+  struct Equal {
+    bool operator()(const StorageComponentAccess& a, const StorageComponentAccess& b) const {
+      return a.nodeId == b.nodeId;
+    }
+  };
+
   Id nodeId = 0;
   int type = 0;
 };
@@ -1,6 +1,7 @@
 #pragma once
 // internal
 #include "types.h"
+#include "utilityHash.h"
 
 struct StorageEdgeData {
   StorageEdgeData() = default;
@@ -18,6 +19,22 @@ struct StorageEdgeData {
     }
   }
 
+  struct Hash {
+    size_t operator()(const StorageEdgeData& data) const {
+      size_t seed = 0;
+      utility::hashCombine(seed, data.type);
+      utility::hashCombine(seed, data.sourceNodeId);
+      utility::hashCombine(seed, data.targetNodeId);
+      return seed;
+    }
+  };
+
+  struct Equal {
+    bool operator()(const StorageEdgeData& a, const StorageEdgeData& b) const {
+      return a.type == b.type && a.sourceNodeId == b.sourceNodeId && a.targetNodeId == b.targetNodeId;
+    }
+  };
+
   int type = 0;
   Id sourceNodeId = 0;
   Id targetNodeId = 0;
@@ -3,6 +3,7 @@
 #include <string>
 // internal
 #include "types.h"
+#include "utilityHash.h"
 
 struct StorageElementComponent {
   StorageElementComponent() = default;
@@ -20,6 +21,22 @@ struct StorageElementComponent {
     }
   }
 
+  struct Hash {
+    size_t operator()(const StorageElementComponent& component) const {
+      size_t seed = 0;
+      utility::hashCombine(seed, component.elementId);
+      utility::hashCombine(seed, component.type);
+      utility::hashCombine(seed, component.data);
+      return seed;
+    }
+  };
+
+  struct Equal {
+    bool operator()(const StorageElementComponent& a, const StorageElementComponent& b) const {
+      return a.elementId == b.elementId && a.type == b.type && a.data == b.data;
+    }
+  };
+
   Id elementId = 0;
   int type = 0;
   std::wstring data = {};
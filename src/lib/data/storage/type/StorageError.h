@@ -3,6 +3,7 @@
 #include <string>
 // internal
 #include "types.h"
+#include "utilityHash.h"
 
 struct StorageErrorData {
   StorageErrorData() = default;
@@ -22,6 +23,24 @@ struct StorageErrorData {
     }
   }
 
+  struct Hash {
+    size_t operator()(const StorageErrorData& data) const {
+      size_t seed = 0;
+      utility::hashCombine(seed, data.message);
+      utility::hashCombine(seed, data.translationUnit);
+      utility::hashCombine(seed, data.fatal);
+      utility::hashCombine(seed, data.indexed);
+      return seed;
+    }
+  };
+
+  struct Equal {
+    bool operator()(const StorageErrorData& a, const StorageErrorData& b) const {
+      return a.message == b.message && a.translationUnit == b.translationUnit && a.fatal == b.fatal &&
+          a.indexed == b.indexed;
+    }
+  };
+
   std::wstring message = {};
   std::wstring translationUnit = {};
   bool fatal = false;
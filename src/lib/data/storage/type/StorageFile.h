@@ -3,6 +3,7 @@
 #include <string>
 // internal
 #include "types.h"
+#include "utilityHash.h"
 
 struct StorageFile {
   StorageFile() = default;
@@ -20,6 +21,18 @@ struct StorageFile {
     return filePath < other.filePath;
   }
 
+  struct Hash {
+    size_t operator()(const StorageFile& file) const {
+      return std::hash<std::wstring>()(file.filePath);
+    }
+  };
+
+  struct Equal {
+    bool operator()(const StorageFile& a, const StorageFile& b) const {
+      return a.filePath == b.filePath;
+    }
+  };
+
   Id id = 0;
   std::wstring filePath = {};
   std::wstring languageIdentifier = {};
@@ -0,0 +1,16 @@
+#pragma once
+// internal
+#include "types.h"
+
+// a file including or importing another file, refresh uses these to find the files affected by a change
+struct StorageFileDependency {
+  StorageFileDependency() = default;
+
+  StorageFileDependency(Id fileNodeId_, Id referencedFileNodeId_, int type_)
+      : fileNodeId(fileNodeId_), referencedFileNodeId(referencedFileNodeId_), type(type_) {}
+
+  Id fileNodeId = 0;
+  Id referencedFileNodeId = 0;
+  // type of the edge the dependency was derived from
+  int type = 0;
+};
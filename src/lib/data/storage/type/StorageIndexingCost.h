@@ -0,0 +1,15 @@
+#pragma once
+// STL
+#include <cstdint>
+#include <string>
+
+// measured cost of indexing one translation unit, the next refresh schedules the most expensive ones first
+struct StorageIndexingCost {
+  StorageIndexingCost() = default;
+
+  StorageIndexingCost(std::wstring sourceFilePath_, uint64_t durationMS_)
+      : sourceFilePath(std::move(sourceFilePath_)), durationMS(durationMS_) {}
+
+  std::wstring sourceFilePath = {};
+  uint64_t durationMS = 0;
+};
@@ -3,6 +3,7 @@
 #include <string>
 // internal
 #include "types.h"
+#include "utilityHash.h"
 
 struct StorageLocalSymbolData {
   StorageLocalSymbolData() = default;
@@ -13,6 +14,18 @@ struct StorageLocalSymbolData {
     return name < other.name;
   }
 
+  struct Hash {
+    size_t operator()(const StorageLocalSymbolData& data) const {
+      return std::hash<std::wstring>()(data.name);
+    }
+  };
+
+  struct Equal {
+    bool operator()(const StorageLocalSymbolData& a, const StorageLocalSymbolData& b) const {
+      return a.name == b.name;
+    }
+  };
+
   std::wstring name = {};
 };
 
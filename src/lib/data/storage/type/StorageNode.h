@@ -3,6 +3,7 @@
 #include <string>
 // internal
 #include "types.h"
+#include "utilityHash.h"
 
 struct StorageNodeData {
   StorageNodeData() : type(0), serializedName(L"") {}
@@ -13,6 +14,18 @@ struct StorageNodeData {
     return serializedName < other.serializedName;
   }
 
+  struct Hash {
+    size_t operator()(const StorageNodeData& data) const {
+      return std::hash<std::wstring>()(data.serializedName);
+    }
+  };
+
+  struct Equal {
+    bool operator()(const StorageNodeData& a, const StorageNodeData& b) const {
+      return a.serializedName == b.serializedName;
+    }
+  };
+
   int type = 0;
   std::wstring serializedName = {};
 };
@@ -1,6 +1,7 @@
 #pragma once
 // internal
 #include "types.h"
+#include "utilityHash.h"
 
 struct StorageOccurrence {
   StorageOccurrence() = default;
@@ -15,6 +16,21 @@ struct StorageOccurrence {
     }
   }
 
+  struct Hash {
+    size_t operator()(const StorageOccurrence& occurrence) const {
+      size_t seed = 0;
+      utility::hashCombine(seed, occurrence.elementId);
+      utility::hashCombine(seed, occurrence.sourceLocationId);
+      return seed;
+    }
+  };
+
+  struct Equal {
+    bool operator()(const StorageOccurrence& a, const StorageOccurrence& b) const {
+      return a.elementId == b.elementId && a.sourceLocationId == b.sourceLocationId;
+    }
+  };
+
   Id elementId = 0;
   Id sourceLocationId = 0;
 };
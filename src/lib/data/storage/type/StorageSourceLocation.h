@@ -3,6 +3,7 @@
 #include <limits>
 // internal
 #include "types.h"
+#include "utilityHash.h"
 
 struct StorageSourceLocationData {
   static constexpr size_t Invalid = std::numeric_limits<size_t>::max();
@@ -28,6 +29,26 @@ struct StorageSourceLocationData {
     }
   }
 
+  struct Hash {
+    size_t operator()(const StorageSourceLocationData& data) const {
+      size_t seed = 0;
+      utility::hashCombine(seed, data.fileNodeId);
+      utility::hashCombine(seed, data.startLine);
+      utility::hashCombine(seed, data.startCol);
+      utility::hashCombine(seed, data.endLine);
+      utility::hashCombine(seed, data.endCol);
+      utility::hashCombine(seed, data.type);
+      return seed;
+    }
+  };
+
+  struct Equal {
+    bool operator()(const StorageSourceLocationData& a, const StorageSourceLocationData& b) const {
+      return a.fileNodeId == b.fileNodeId && a.startLine == b.startLine && a.startCol == b.startCol &&
+          a.endLine == b.endLine && a.endCol == b.endCol && a.type == b.type;
+    }
+  };
+
   Id fileNodeId = 0;
   size_t startLine = Invalid;
   size_t startCol = Invalid;
@@ -1,12 +1,18 @@
 #include "Project.h"
 
+#include <map>
 #include <utility>
 
 #include "ApplicationSettings.h"
 #include "CombinedIndexerCommandProvider.h"
 #include "DialogView.h"
+#include "DirectorySnapshot.h"
 #include "FilePath.h"
 #include "FileSystem.h"
+#include "IndexedHeaderRegistry.h"
+#include "IndexerComposite.h"
+#include "IndexerThreadPool.h"
+#include "LanguagePackageManager.h"
 #include "MessageErrorCountClear.h"
 #include "MessageIndexingFinished.h"
 #include "MessageIndexingShowDialog.h"
@@ -44,6 +50,83 @@
 #include "utilityApp.h"
 #include "utilityString.h"
 
+namespace {
+// committed transactions that are not checkpointed yet live in the write-ahead log next to the database file
+FilePath getWriteAheadLogFilePath(const FilePath& dbFilePath) {
+  return FilePath(dbFilePath.wstr() + L"-wal");
+}
+
+FilePath getSharedMemoryFilePath(const FilePath& dbFilePath) {
+  return FilePath(dbFilePath.wstr() + L"-shm");
+}
+
+// the persisted search index and the full text segments are only valid for the database next to them
+FilePath getSearchIndexFilePath(const FilePath& dbFilePath) {
+  return FilePath(dbFilePath.wstr() + L".searchindex");
+}
+
+FilePath getFullTextSearchSegmentDirectoryPath(const FilePath& dbFilePath) {
+  return FilePath(dbFilePath.wstr() + L".fulltext");
+}
+
+void removeSegmentDirectory(const FilePath& directoryPath) {
+  if(directoryPath.recheckExists()) {
+    for(const FilePath& filePath : FileSystem::getFilePathsFromDirectory(directoryPath)) {
+      FileSystem::remove(filePath);
+    }
+    FileSystem::remove(directoryPath);
+  }
+}
+
+// unchanged files keep their ids in a copied database, so the copy can reuse their full text segments
+void copyFullTextSearchSegments(const FilePath& fromDbFilePath, const FilePath& toDbFilePath) {
+  const FilePath fromDirectoryPath = getFullTextSearchSegmentDirectoryPath(fromDbFilePath);
+  const FilePath toDirectoryPath = getFullTextSearchSegmentDirectoryPath(toDbFilePath);
+  removeSegmentDirectory(toDirectoryPath);
+  if(!fromDirectoryPath.recheckExists()) {
+    return;
+  }
+
+  FileSystem::createDirectory(toDirectoryPath);
+  for(const FilePath& filePath : FileSystem::getFilePathsFromDirectory(fromDirectoryPath)) {
+    FileSystem::copyFile(filePath, toDirectoryPath.getConcatenated(L"/" + filePath.fileName()));
+  }
+}
+
+void removeDatabaseFile(const FilePath& dbFilePath) {
+  FileSystem::remove(dbFilePath);
+  for(const FilePath& filePath :
+      {getWriteAheadLogFilePath(dbFilePath), getSharedMemoryFilePath(dbFilePath), getSearchIndexFilePath(dbFilePath)}) {
+    if(filePath.exists()) {
+      FileSystem::remove(filePath);
+    }
+  }
+  removeSegmentDirectory(getFullTextSearchSegmentDirectoryPath(dbFilePath));
+}
+
+void renameDatabaseFile(const FilePath& from, const FilePath& to) {
+  FileSystem::rename(from, to);
+  if(getWriteAheadLogFilePath(from).exists()) {
+    FileSystem::rename(getWriteAheadLogFilePath(from), getWriteAheadLogFilePath(to));
+  }
+  if(getSharedMemoryFilePath(from).exists()) {
+    FileSystem::remove(getSharedMemoryFilePath(from));
+  }
+
+  // stale sidecars of the replaced database must not survive next to the moved one
+  if(getSearchIndexFilePath(to).recheckExists()) {
+    FileSystem::remove(getSearchIndexFilePath(to));
+  }
+  if(getSearchIndexFilePath(from).recheckExists()) {
+    FileSystem::rename(getSearchIndexFilePath(from), getSearchIndexFilePath(to));
+  }
+  removeSegmentDirectory(getFullTextSearchSegmentDirectoryPath(to));
+  if(getFullTextSearchSegmentDirectoryPath(from).recheckExists()) {
+    FileSystem::rename(getFullTextSearchSegmentDirectoryPath(from), getFullTextSearchSegmentDirectoryPath(to));
+  }
+}
+}    // namespace
+
 Project::Project(std::shared_ptr<ProjectSettings> settings, StorageCache* storageCache, std::string appUUID, bool hasGUI)
     : m_settings(std::move(settings))
     , m_storageCache(storageCache)
@@ -129,13 +212,13 @@ void Project::load(const std::shared_ptr<DialogView>& dialogView) {
           }
         } else {
           LOG_INFO("Discarding temporary indexing data on user's decision");
-          FileSystem::remove(tempDbPath);
+          removeDatabaseFile(tempDbPath);
         }
       } else {
         LOG_INFO(
             "Switching to temporary indexing data because no other persistent data was "
             "found");
-        FileSystem::rename(tempDbPath, dbPath);
+        renameDatabaseFile(tempDbPath, dbPath);
       }
     }
   }
@@ -312,7 +395,14 @@ void Project::refresh(std::shared_ptr<DialogView> dialogView, RefreshMode refres
   m_settings->reload();
 
   m_sourceGroups = SourceGroupFactory::getInstance()->createSourceGroups(m_settings->getAllSourceGroupSettings());
+
+  m_directorySnapshot.reset();
+  if(!m_settings->getDirectorySnapshotFilePath().empty()) {
+    m_directorySnapshot = DirectorySnapshot::load(m_settings->getDirectorySnapshotFilePath());
+  }
+
   for(const std::shared_ptr<SourceGroup>& sourceGroup : m_sourceGroups) {
+    sourceGroup->setDirectorySnapshot(m_directorySnapshot);
     if(sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED && !sourceGroup->prepareIndexing()) {
       m_refreshStage = RefreshStageType::NONE;
       return;
@@ -395,6 +485,7 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
       }
 
       MessageStatus(message).dispatch();
+      saveDirectorySnapshot();
       m_refreshStage = RefreshStageType::NONE;
       return;
     }
@@ -449,13 +540,27 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
   if(info.mode != REFRESH_ALL_FILES) {
     // store the indexed data into the temp db but keep the current state to allow browsing
     // while indexing
+    if(m_storage) {
+      m_storage->checkpoint();
+    }
     FileSystem::copyFile(indexDbFilePath, tempIndexDbFilePath);
+    copyFullTextSearchSegments(indexDbFilePath, tempIndexDbFilePath);
+  }
+
+  // durations of previous runs are used to start the longest translation units first
+  std::vector<StorageIndexingCost> indexingCosts;
+  if(!m_storage->isIncompatible()) {
+    indexingCosts = m_storage->getIndexingCosts();
   }
 
   std::shared_ptr<PersistentStorage> tempStorage = std::make_shared<PersistentStorage>(
       tempIndexDbFilePath, m_storage->getBookmarkDbFilePath());
   tempStorage->setup();
 
+  if(info.mode == REFRESH_ALL_FILES) {
+    tempStorage->addIndexingCosts(indexingCosts);
+  }
+
   std::shared_ptr<TaskGroupSequence> taskSequential = std::make_shared<TaskGroupSequence>();
 
   if(info.mode != REFRESH_ALL_FILES && (info.filesToClear.size() || info.nonIndexedFilesToClear.size())) {
@@ -481,6 +586,8 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
     }
   }
 
+  saveDirectorySnapshot();
+
   size_t sourceFileCount = indexerCommandProvider->size() + customIndexerCommandProvider->size();
 
   taskSequential->addTask(std::make_shared<TaskSetValue<bool>>("shallow_indexing", info.shallow));
@@ -515,23 +622,47 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
       }
     }
 
-    std::shared_ptr<TaskParseWrapper> taskParserWrapper = std::make_shared<TaskParseWrapper>(tempStorage, dialogView);
+    // a full refresh starts from an empty temp db, so it can be filled without journal and index maintenance
+    std::shared_ptr<TaskParseWrapper> taskParserWrapper = std::make_shared<TaskParseWrapper>(
+        tempStorage, dialogView, info.mode == REFRESH_ALL_FILES);
     taskSequential->addTask(taskParserWrapper);
 
     std::shared_ptr<TaskGroupParallel> taskParallelIndexing = std::make_shared<TaskGroupParallel>();
     taskParserWrapper->setTask(taskParallelIndexing);
 
+    // without indexer processes the commands are handed to worker threads directly
+    bool multiProcess = ApplicationSettings::getInstance()->getMultiProcessIndexingEnabled() && hasCxxSourceGroup();
+    std::shared_ptr<IndexerThreadPool> indexerThreadPool;
+    if(!multiProcess) {
+      std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry;
+      if(ApplicationSettings::getInstance()->getCxxSkipIndexedHeadersEnabled()) {
+        indexedHeaderRegistry = std::make_shared<IndexedHeaderRegistry>();
+      }
+
+      indexerThreadPool = std::make_shared<IndexerThreadPool>(
+          adjustedIndexerThreadCount, [indexedHeaderRegistry]() -> std::shared_ptr<IndexerBase> {
+            std::shared_ptr<IndexerBase> indexer = LanguagePackageManager::getInstance()->instantiateSupportedIndexers();
+            indexer->setIndexedHeaderRegistry(indexedHeaderRegistry);
+            return indexer;
+          });
+    }
+
+    std::map<std::wstring, uint64_t> indexingDurationsMS;
+    for(const StorageIndexingCost& indexingCost : indexingCosts) {
+      indexingDurationsMS.emplace(indexingCost.sourceFilePath, indexingCost.durationMS);
+    }
+
     // add task for refilling the indexer command queue
-    taskParallelIndexing->addTask(std::make_shared<TaskFillIndexerCommandsQueue>(m_appUUID, std::move(indexerCommandProvider), 20));
+    taskParallelIndexing->addTask(std::make_shared<TaskFillIndexerCommandsQueue>(
+        m_appUUID, std::move(indexerCommandProvider), 20, std::move(indexingDurationsMS), indexerThreadPool));
 
     // add task for indexing
-    bool multiProcess = ApplicationSettings::getInstance()->getMultiProcessIndexingEnabled() && hasCxxSourceGroup();
     taskParallelIndexing->addChildTasks(std::make_shared<TaskGroupSequence>()->addChildTasks(
         // block until there are indexer commands to process
         std::make_shared<TaskDecoratorRepeat>(TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
             ->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
                 "indexer_command_queue_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
-        std::make_shared<TaskBuildIndex>(adjustedIndexerThreadCount, storageProvider, dialogView, m_appUUID, multiProcess)));
+        std::make_shared<TaskBuildIndex>(adjustedIndexerThreadCount, storageProvider, dialogView, m_appUUID, indexerThreadPool)));
 
     // add task for merging the intermediate storages
     taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
@@ -542,7 +673,7 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
         // merge until all indexers stopped and nothing left to merge
         std::make_shared<TaskDecoratorRepeat>(TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
             ->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
-                std::make_shared<TaskMergeStorages>(storageProvider),
+                std::make_shared<TaskMergeStorages>(storageProvider, std::max(1, adjustedIndexerThreadCount / 4)),
                 std::make_shared<TaskReturnSuccessIf<bool>>(
                     "indexer_threads_stopped", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)))));
 
@@ -563,7 +694,10 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
     taskSequential->addTask(    // we don't need to hide this dialog again, because it's
                                 // overridden by other dialogs later on.
         std::make_shared<TaskLambda>(
-            [dialogView]() { dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Saving\nRemaining Data"); }));
+            [dialogView, storageProvider]() {
+              storageProvider->logCurrentState();
+              dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Saving\nRemaining Data");
+            }));
 
     // add task that injects the remaining intermediate storages into the persistent storage
     taskSequential->addTask(
@@ -627,6 +761,9 @@ void Project::swapToTempStorage(std::shared_ptr<DialogView> dialogView) {
   const FilePath tempIndexDbFilePath = m_settings->getTempDBFilePath();
   const FilePath bookmarkDbFilePath = m_settings->getBookmarkDBFilePath();
 
+  if(m_storage) {
+    m_storage->checkpoint();
+  }
   m_storage.reset();
 
   if(!swapToTempStorageFile(indexDbFilePath, tempIndexDbFilePath, dialogView)) {
@@ -651,8 +788,8 @@ bool Project::swapToTempStorageFile(const FilePath& indexDbFilePath,
                                     const FilePath& tempIndexDbFilePath,
                                     std::shared_ptr<DialogView> dialogView) {
   try {
-    FileSystem::remove(indexDbFilePath);
-    FileSystem::rename(tempIndexDbFilePath, indexDbFilePath);
+    removeDatabaseFile(indexDbFilePath);
+    renameDatabaseFile(tempIndexDbFilePath, indexDbFilePath);
   } catch(std::exception& /*e*/) {
     if(m_hasGUI) {
       dialogView->confirm(
@@ -671,7 +808,14 @@ void Project::discardTempStorage() {
   const FilePath tempIndexDbPath = m_settings->getTempDBFilePath();
   if(tempIndexDbPath.exists()) {
     LOG_INFO("Discarding temporary indexing data");
-    FileSystem::remove(tempIndexDbPath);
+    removeDatabaseFile(tempIndexDbPath);
+  }
+}
+
+void Project::saveDirectorySnapshot() {
+  if(m_directorySnapshot) {
+    m_directorySnapshot->save(m_settings->getDirectorySnapshotFilePath());
+    m_directorySnapshot.reset();
   }
 }
 
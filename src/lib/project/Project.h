@@ -7,6 +7,7 @@
 #include "SourceGroup.h"
 
 class DialogView;
+class DirectorySnapshot;
 class FilePath;
 class PersistentStorage;
 class ProjectSettings;
@@ -71,6 +72,8 @@ private:
                              std::shared_ptr<DialogView> dialogView);
   void discardTempStorage();
 
+  void saveDirectorySnapshot();
+
   [[nodiscard]] bool hasCxxSourceGroup() const;
 
   std::shared_ptr<ProjectSettings> m_settings;
@@ -81,6 +84,8 @@ private:
 
   std::shared_ptr<PersistentStorage> m_storage;
   std::vector<std::shared_ptr<SourceGroup>> m_sourceGroups;
+  // loaded once per refresh for all walks over the source paths, saved once the indexer commands are known
+  std::shared_ptr<DirectorySnapshot> m_directorySnapshot;
 
   std::string m_appUUID;
   bool m_hasGUI;
@@ -8,6 +8,7 @@
 #include "SourceGroupStatusType.h"
 #include "TextAccess.h"
 #include "utility.h"
+#include "utilityHash.h"
 
 RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
                                                                 std::shared_ptr<const PersistentStorage> storage) {
@@ -19,6 +20,11 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(const std::vecto
 
   {
     const std::vector<FileInfo> fileInfosFromStorage = storage->getFileInfoForAllFiles();
+    const std::unordered_map<std::wstring, std::string> contentHashesFromStorage = storage->getFileContentHashes();
+    auto didChange = [&contentHashesFromStorage](const FileInfo& info, const FileInfo& diskFileInfo) {
+      auto it = contentHashesFromStorage.find(info.path.wstr());
+      return didFileChange(info, diskFileInfo, it != contentHashesFromStorage.end() ? it->second : std::string());
+    };
 
     std::set<FilePath> alreadyKnownPaths;
     {
@@ -32,11 +38,15 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(const std::vecto
       }
     }
 
-    // checking source and header files
+    // checking source and header files. the walks over the source paths don't provide write times, they list unchanged
+    // directories from the directory snapshot without touching their files, and headers outside of them aren't walked
     for(const FileInfo& info : fileInfosFromStorage) {
-      if(alreadyKnownPaths.find(info.path) != alreadyKnownPaths.end() && info.path.exists()) {
+      const FileInfo diskFileInfo = FileSystem::getFileInfoForPath(info.path);
+      const bool exists = !diskFileInfo.path.empty();
+
+      if(alreadyKnownPaths.find(info.path) != alreadyKnownPaths.end() && exists) {
         if(storage->getFilePathIndexed(info.path)) {
-          if(didFileChange(info, storage)) {
+          if(didChange(info, diskFileInfo)) {
             changedFilePaths.insert(info.path);
           } else {
             unchangedIndexedFilePaths.insert(info.path);
@@ -44,7 +54,7 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(const std::vecto
         } else {
           changedFilePaths.insert(info.path);
         }
-      } else if(!storage->getFilePathIndexed(info.path) && !didFileChange(info, storage)) {
+      } else if(!storage->getFilePathIndexed(info.path) && !didChange(info, diskFileInfo)) {
         unchangedNonindexedFilePaths.insert(info.path);
       } else    // file has been removed
       {
@@ -181,29 +191,16 @@ std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(const std::vector
   return allSourceFilePaths;
 }
 
-bool RefreshInfoGenerator::didFileChange(const FileInfo& info, std::shared_ptr<const PersistentStorage> storage) {
-  FileInfo diskFileInfo = FileSystem::getFileInfoForPath(info.path);
+bool RefreshInfoGenerator::didFileChange(const FileInfo& info,
+                                         const FileInfo& diskFileInfo,
+                                         const std::string& storedContentHash) {
   if(diskFileInfo.lastWriteTime > info.lastWriteTime) {
-    if(!storage->hasContentForFile(info.path)) {
+    if(storedContentHash.empty()) {
       return true;
     }
 
-    std::shared_ptr<TextAccess> storedFileContent = storage->getFileContent(info.path, false);
-    std::shared_ptr<TextAccess> diskFileContent = TextAccess::createFromFile(diskFileInfo.path);
-
-    const std::vector<std::string>& diskFileLines = diskFileContent->getAllLines();
-    const std::vector<std::string>& storedFileLines = storedFileContent->getAllLines();
-
-    if(diskFileLines.size() != storedFileLines.size()) {
-      return true;
-    }
-
-    for(size_t i = 0; i < diskFileLines.size(); i++) {
-      if(diskFileLines[i] != storedFileLines[i]) {
-        return true;
-      }
-    }
-    return false;
+    // only files touched since indexing are read, and the stored content is never loaded
+    return std::to_string(utility::getStableHash(TextAccess::createFromFile(diskFileInfo.path)->getText())) != storedContentHash;
   }
   return false;
-}
\ No newline at end of file
+}
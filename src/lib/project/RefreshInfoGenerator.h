@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include <set>
+#include <string>
 #include <vector>
 
 struct FileInfo;
@@ -22,5 +23,6 @@ public:
 private:
   static std::set<FilePath> getAllSourceFilePaths(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups);
 
-  static bool didFileChange(const FileInfo& info, std::shared_ptr<const PersistentStorage> storage);
+  // diskFileInfo is empty if the file doesn't exist anymore
+  static bool didFileChange(const FileInfo& info, const FileInfo& diskFileInfo, const std::string& storedContentHash);
 };
\ No newline at end of file
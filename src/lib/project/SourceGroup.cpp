@@ -56,6 +56,14 @@ bool SourceGroup::containsSourceFilePath(const FilePath& sourceFilePath) const {
   return !filterToContainedSourceFilePath({sourceFilePath}).empty();
 }
 
+void SourceGroup::setDirectorySnapshot(std::shared_ptr<DirectorySnapshot> directorySnapshot) {
+  m_directorySnapshot = std::move(directorySnapshot);
+}
+
+std::shared_ptr<DirectorySnapshot> SourceGroup::getDirectorySnapshot() const {
+  return m_directorySnapshot;
+}
+
 std::set<FilePath> SourceGroup::filterToContainedFilePaths(const std::set<FilePath>& filePaths,
                                                            const std::set<FilePath>& indexedFilePaths,
                                                            const std::set<FilePath>& indexedFileOrDirectoryPaths,
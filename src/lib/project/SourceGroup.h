@@ -9,6 +9,7 @@
 #include "SourceGroupType.h"
 
 class DialogView;
+class DirectorySnapshot;
 class FilePath;
 class FilePathFilter;
 class IndexerCommand;
@@ -40,6 +41,9 @@ public:
   std::set<FilePath> filterToContainedSourceFilePath(const std::set<FilePath>& staticSourceFilePaths) const;
   bool containsSourceFilePath(const FilePath& sourceFilePath) const;
 
+  // shared by all walks over the source paths during a refresh, they don't use a snapshot as long as none is set
+  void setDirectorySnapshot(std::shared_ptr<DirectorySnapshot> directorySnapshot);
+
 protected:
   virtual std::shared_ptr<SourceGroupSettings> getSourceGroupSettings() = 0;
   virtual std::shared_ptr<const SourceGroupSettings> getSourceGroupSettings() const = 0;
@@ -48,4 +52,9 @@ protected:
                                                 const std::set<FilePath>& indexedFilePaths,
                                                 const std::set<FilePath>& indexedFileOrDirectoryPaths,
                                                 const std::vector<FilePathFilter>& excludeFilters) const;
+
+  std::shared_ptr<DirectorySnapshot> getDirectorySnapshot() const;
+
+private:
+  std::shared_ptr<DirectorySnapshot> m_directorySnapshot;
 };
\ No newline at end of file
@@ -23,7 +23,7 @@ std::set<FilePath> SourceGroupCustomCommand::filterToContainedFilePaths(const st
 }
 
 std::set<FilePath> SourceGroupCustomCommand::getAllSourceFilePaths() const {
-  FileManager fileManager;
+  FileManager fileManager(getDirectorySnapshot());
   fileManager.update(m_settings->getSourcePathsExpandedAndAbsolute(),
                      m_settings->getExcludeFiltersExpandedAndAbsolute(),
                      m_settings->getSourceExtensions());
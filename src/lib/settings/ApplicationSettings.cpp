@@ -344,6 +344,22 @@ void ApplicationSettings::setHasPrefilledFrameworkSearchPaths(bool v) {
   setValue<bool>("indexing/cxx/has_prefilled_framework_search_paths", v);
 }
 
+bool ApplicationSettings::getCxxSharedPreamblesEnabled() const {
+  return getValue<bool>("indexing/cxx/shared_preambles", true);
+}
+
+void ApplicationSettings::setCxxSharedPreamblesEnabled(bool enabled) {
+  setValue<bool>("indexing/cxx/shared_preambles", enabled);
+}
+
+bool ApplicationSettings::getCxxSkipIndexedHeadersEnabled() const {
+  return getValue<bool>("indexing/cxx/skip_indexed_headers", false);
+}
+
+void ApplicationSettings::setCxxSkipIndexedHeadersEnabled(bool enabled) {
+  setValue<bool>("indexing/cxx/skip_indexed_headers", enabled);
+}
+
 int ApplicationSettings::getCodeTabWidth() const {
   return getValue<int>("code/tab_width", 4);
 }
@@ -117,6 +117,13 @@ public:
   bool getHasPrefilledFrameworkSearchPaths() const;
   void setHasPrefilledFrameworkSearchPaths(bool v);
 
+  // precompile include prefixes shared by translation units of compilation database source groups
+  bool getCxxSharedPreamblesEnabled() const;
+  void setCxxSharedPreamblesEnabled(bool enabled);
+
+  bool getCxxSkipIndexedHeadersEnabled() const;
+  void setCxxSkipIndexedHeadersEnabled(bool enabled);
+
   // code
   int getCodeTabWidth() const;
   void setCodeTabWidth(int codeTabWidth);
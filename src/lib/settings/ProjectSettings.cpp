@@ -18,10 +18,11 @@
 #endif    // BUILD_CXX_LANGUAGE_PACKAGE
 
 // clang-format off
-const std::wstring ProjectSettings::PROJECT_FILE_EXTENSION       = L".srctrlprj";
-const std::wstring ProjectSettings::BOOKMARK_DB_FILE_EXTENSION   = L".srctrlbm";
-const std::wstring ProjectSettings::INDEX_DB_FILE_EXTENSION      = L".srctrldb";
-const std::wstring ProjectSettings::TEMP_INDEX_DB_FILE_EXTENSION = L".srctrldb_tmp";
+const std::wstring ProjectSettings::PROJECT_FILE_EXTENSION            = L".srctrlprj";
+const std::wstring ProjectSettings::BOOKMARK_DB_FILE_EXTENSION        = L".srctrlbm";
+const std::wstring ProjectSettings::INDEX_DB_FILE_EXTENSION           = L".srctrldb";
+const std::wstring ProjectSettings::TEMP_INDEX_DB_FILE_EXTENSION      = L".srctrldb_tmp";
+const std::wstring ProjectSettings::DIRECTORY_SNAPSHOT_FILE_EXTENSION = L".srctrlfs";
 // clang-format on
 
 const size_t ProjectSettings::VERSION = 8;
@@ -122,6 +123,13 @@ FilePath ProjectSettings::getBookmarkDBFilePath() const {
   return getFilePath().replaceExtension(BOOKMARK_DB_FILE_EXTENSION);
 }
 
+FilePath ProjectSettings::getDirectorySnapshotFilePath() const {
+  if(getFilePath().empty()) {
+    return FilePath();
+  }
+  return getFilePath().replaceExtension(DIRECTORY_SNAPSHOT_FILE_EXTENSION);
+}
+
 std::wstring ProjectSettings::getProjectName() const {
   return getFilePath().withoutExtension().fileName();
 }
@@ -15,6 +15,7 @@ public:
   static const std::wstring BOOKMARK_DB_FILE_EXTENSION;
   static const std::wstring INDEX_DB_FILE_EXTENSION;
   static const std::wstring TEMP_INDEX_DB_FILE_EXTENSION;
+  static const std::wstring DIRECTORY_SNAPSHOT_FILE_EXTENSION;
 
   static const size_t VERSION;
   static LanguageType getLanguageOfProject(const FilePath& filePath);
@@ -54,6 +55,9 @@ public:
 
   [[nodiscard]] FilePath getBookmarkDBFilePath() const;
 
+  // empty as long as the project is not saved
+  [[nodiscard]] FilePath getDirectorySnapshotFilePath() const;
+
   [[nodiscard]] std::wstring getProjectName() const;
 
   [[nodiscard]] FilePath getProjectDirectoryPath() const;
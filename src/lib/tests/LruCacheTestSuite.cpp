@@ -0,0 +1,61 @@
+// GTest
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+// internal
+#include "LruCache.h"
+
+using namespace ::testing;
+
+// NOLINTNEXTLINE
+TEST(LruCache, evictsLeastRecentlyUsedValuesFirst) {
+  LruCache<int, int> cache(3);
+  cache.put(1, 10, 1);
+  cache.put(2, 20, 1);
+  cache.put(3, 30, 1);
+
+  int value = 0;
+  EXPECT_TRUE(cache.get(1, &value));
+  EXPECT_EQ(10, value);
+
+  cache.put(4, 40, 1);
+  EXPECT_FALSE(cache.get(2, &value));
+  EXPECT_TRUE(cache.get(1, &value));
+  EXPECT_TRUE(cache.get(3, &value));
+  EXPECT_TRUE(cache.get(4, &value));
+  EXPECT_EQ(3, cache.getCost());
+}
+
+// NOLINTNEXTLINE
+TEST(LruCache, evictsUntilTheCostFits) {
+  LruCache<int, int> cache(10);
+  cache.put(1, 10, 4);
+  cache.put(2, 20, 4);
+  cache.put(3, 30, 8);
+
+  int value = 0;
+  EXPECT_FALSE(cache.get(1, &value));
+  EXPECT_FALSE(cache.get(2, &value));
+  EXPECT_TRUE(cache.get(3, &value));
+  EXPECT_EQ(8, cache.getCost());
+  EXPECT_EQ(1, cache.getSize());
+}
+
+// NOLINTNEXTLINE
+TEST(LruCache, replacesValuesAndSkipsValuesTooLarge) {
+  LruCache<int, int> cache(10);
+  cache.put(1, 10, 4);
+  cache.put(1, 11, 5);
+
+  int value = 0;
+  EXPECT_TRUE(cache.get(1, &value));
+  EXPECT_EQ(11, value);
+  EXPECT_EQ(5, cache.getCost());
+
+  cache.put(2, 20, 11);
+  EXPECT_FALSE(cache.get(2, &value));
+  EXPECT_EQ(1, cache.getSize());
+
+  cache.clear();
+  EXPECT_FALSE(cache.get(1, &value));
+  EXPECT_EQ(0, cache.getCost());
+}
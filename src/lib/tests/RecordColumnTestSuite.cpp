@@ -0,0 +1,52 @@
+// GTest
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+// internal
+#include "RecordColumn.h"
+#include "StorageNode.h"
+#include "StorageSourceLocation.h"
+
+using namespace ::testing;
+
+// NOLINTNEXTLINE
+TEST(RecordColumn, findReturnsNposWhenEmpty) {
+  RecordColumn<StorageNode, StorageNodeData::Hash, StorageNodeData::Equal> column;
+  EXPECT_EQ(column.npos, column.find(StorageNodeData(0, L"a")));
+  EXPECT_TRUE(column.empty());
+}
+
+// NOLINTNEXTLINE
+TEST(RecordColumn, pushedRecordsCanBeFoundByKeyData) {
+  RecordColumn<StorageNode, StorageNodeData::Hash, StorageNodeData::Equal> column;
+  EXPECT_EQ(0, column.push(StorageNode(10, 1, L"a")));
+  EXPECT_EQ(1, column.push(StorageNode(11, 1, L"b")));
+
+  EXPECT_EQ(0, column.find(StorageNodeData(4, L"a")));
+  EXPECT_EQ(1, column.find(StorageNodeData(1, L"b")));
+  EXPECT_EQ(column.npos, column.find(StorageNodeData(1, L"c")));
+  EXPECT_EQ(11, column[1].id);
+}
+
+// NOLINTNEXTLINE
+TEST(RecordColumn, indexSurvivesGrowth) {
+  RecordColumn<StorageSourceLocation, StorageSourceLocationData::Hash, StorageSourceLocationData::Equal> column;
+  for(size_t i = 0; i < 10000; i++) {
+    column.push(StorageSourceLocation(i + 1, 1, i, 1, i, 2, 0));
+  }
+
+  ASSERT_EQ(10000, column.size());
+  for(size_t i = 0; i < 10000; i++) {
+    EXPECT_EQ(i, column.find(StorageSourceLocationData(1, i, 1, i, 2, 0)));
+  }
+  EXPECT_EQ(column.npos, column.find(StorageSourceLocationData(2, 0, 1, 0, 2, 0)));
+}
+
+// NOLINTNEXTLINE
+TEST(RecordColumn, assignKeepsFirstOfDuplicates) {
+  RecordColumn<StorageNode, StorageNodeData::Hash, StorageNodeData::Equal> column;
+  column.assign({StorageNode(1, 1, L"a"), StorageNode(2, 1, L"b"), StorageNode(3, 1, L"a")});
+
+  EXPECT_EQ(3, column.size());
+  EXPECT_EQ(0, column.find(StorageNodeData(1, L"a")));
+  EXPECT_EQ(1, column.find(StorageNodeData(1, L"b")));
+}
@@ -0,0 +1,99 @@
+#pragma once
+// STL
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+/**
+ * Keeps the most recently used values up to a total cost, the least recently used ones are evicted first.
+ */
+template <typename KeyType, typename ValType, typename Hasher = std::hash<KeyType>>
+class LruCache {
+public:
+  explicit LruCache(size_t maxCost);
+
+  // marks the value as most recently used
+  bool get(const KeyType& key, ValType* value);
+  // values that cost more than the whole cache are not kept
+  void put(const KeyType& key, ValType value, size_t cost);
+
+  void clear();
+
+  size_t getCost() const;
+  size_t getSize() const;
+
+private:
+  struct Entry {
+    KeyType key;
+    ValType value;
+    size_t cost;
+  };
+
+  void erase(typename std::list<Entry>::iterator it);
+
+  const size_t m_maxCost;
+  size_t m_cost = 0;
+
+  // most recently used first
+  std::list<Entry> m_entries;
+  std::unordered_map<KeyType, typename std::list<Entry>::iterator, Hasher> m_positions;
+};
+
+template <typename KeyType, typename ValType, typename Hasher>
+LruCache<KeyType, ValType, Hasher>::LruCache(size_t maxCost) : m_maxCost(maxCost) {}
+
+template <typename KeyType, typename ValType, typename Hasher>
+bool LruCache<KeyType, ValType, Hasher>::get(const KeyType& key, ValType* value) {
+  auto it = m_positions.find(key);
+  if(it == m_positions.end()) {
+    return false;
+  }
+
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  *value = it->second->value;
+  return true;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+void LruCache<KeyType, ValType, Hasher>::put(const KeyType& key, ValType value, size_t cost) {
+  auto it = m_positions.find(key);
+  if(it != m_positions.end()) {
+    erase(it->second);
+  }
+
+  if(cost > m_maxCost) {
+    return;
+  }
+
+  while(m_cost + cost > m_maxCost) {
+    erase(std::prev(m_entries.end()));
+  }
+
+  m_entries.push_front({key, std::move(value), cost});
+  m_positions.emplace(key, m_entries.begin());
+  m_cost += cost;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+void LruCache<KeyType, ValType, Hasher>::clear() {
+  m_entries.clear();
+  m_positions.clear();
+  m_cost = 0;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t LruCache<KeyType, ValType, Hasher>::getCost() const {
+  return m_cost;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t LruCache<KeyType, ValType, Hasher>::getSize() const {
+  return m_entries.size();
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+void LruCache<KeyType, ValType, Hasher>::erase(typename std::list<Entry>::iterator it) {
+  m_cost -= it->cost;
+  m_positions.erase(it->key);
+  m_entries.erase(it);
+}
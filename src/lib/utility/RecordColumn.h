@@ -0,0 +1,199 @@
+#pragma once
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+// internal
+#include "utilityHash.h"
+
+/*
+ * RecordColumn
+ *
+ * Contiguous array of records with an open addressing hash index on top. The index only stores positions into the
+ * array (plus the cached hash), so every record is stored exactly once and lookups never copy the key.
+ *
+ * - RecordT: stored record type
+ * - HashT: hash functor, has to accept every key type passed to find()
+ * - EqualT: equality functor, called as EqualT()(record, key)
+ */
+
+template <typename RecordT, typename HashT, typename EqualT = std::equal_to<>>
+class RecordColumn {
+public:
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  void clear();
+  void reserve(size_t count);
+
+  size_t size() const;
+  bool empty() const;
+
+  template <typename KeyT>
+  size_t find(const KeyT& key) const;
+
+  // appends the record without checking for duplicates, use find() first
+  size_t push(RecordT record);
+
+  // replaces all records and rebuilds the index, only the first of equal records is kept
+  void assign(std::vector<RecordT> records);
+
+  RecordT& operator[](size_t index);
+  const RecordT& operator[](size_t index) const;
+
+  const std::vector<RecordT>& getRecords() const;
+
+  size_t getIndexByteSize() const;
+
+private:
+  struct Slot {
+    uint32_t index = 0;    // record index + 1, 0 marks an empty slot
+    uint32_t hash = 0;
+  };
+
+  template <typename KeyT>
+  static uint32_t hashOf(const KeyT& key);
+
+  void insertSlot(uint32_t hash, size_t recordIndex);
+  void rehash(size_t slotCount);
+
+  std::vector<RecordT> m_records;
+  std::vector<Slot> m_slots;
+};
+
+template <typename RecordT, typename HashT, typename EqualT>
+void RecordColumn<RecordT, HashT, EqualT>::clear() {
+  m_records.clear();
+  m_slots.clear();
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+void RecordColumn<RecordT, HashT, EqualT>::reserve(size_t count) {
+  m_records.reserve(count);
+  if(count * 4 > m_slots.size() * 3) {
+    size_t slotCount = 16;
+    while(count * 4 > slotCount * 3) {
+      slotCount *= 2;
+    }
+    rehash(slotCount);
+  }
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+size_t RecordColumn<RecordT, HashT, EqualT>::size() const {
+  return m_records.size();
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+bool RecordColumn<RecordT, HashT, EqualT>::empty() const {
+  return m_records.empty();
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+template <typename KeyT>
+size_t RecordColumn<RecordT, HashT, EqualT>::find(const KeyT& key) const {
+  if(m_slots.empty()) {
+    return npos;
+  }
+
+  const uint32_t hash = hashOf(key);
+  const size_t mask = m_slots.size() - 1;
+  for(size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    const Slot& slot = m_slots[pos];
+    if(!slot.index) {
+      return npos;
+    }
+
+    if(slot.hash == hash && EqualT()(m_records[slot.index - 1], key)) {
+      return slot.index - 1;
+    }
+  }
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+size_t RecordColumn<RecordT, HashT, EqualT>::push(RecordT record) {
+  if((m_records.size() + 1) * 4 > m_slots.size() * 3) {
+    rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+  }
+
+  const uint32_t hash = hashOf(record);
+  m_records.emplace_back(std::move(record));
+  insertSlot(hash, m_records.size() - 1);
+  return m_records.size() - 1;
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+void RecordColumn<RecordT, HashT, EqualT>::assign(std::vector<RecordT> records) {
+  m_records = std::move(records);
+  m_slots.clear();
+
+  size_t slotCount = 16;
+  while(m_records.size() * 4 > slotCount * 3) {
+    slotCount *= 2;
+  }
+  m_slots.resize(slotCount);
+
+  size_t keptCount = 0;
+  for(size_t i = 0; i < m_records.size(); i++) {
+    if(find(m_records[i]) == npos) {
+      if(keptCount != i) {
+        m_records[keptCount] = std::move(m_records[i]);
+      }
+      insertSlot(hashOf(m_records[keptCount]), keptCount);
+      keptCount++;
+    }
+  }
+  m_records.erase(m_records.begin() + static_cast<std::ptrdiff_t>(keptCount), m_records.end());
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+RecordT& RecordColumn<RecordT, HashT, EqualT>::operator[](size_t index) {
+  return m_records[index];
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+const RecordT& RecordColumn<RecordT, HashT, EqualT>::operator[](size_t index) const {
+  return m_records[index];
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+const std::vector<RecordT>& RecordColumn<RecordT, HashT, EqualT>::getRecords() const {
+  return m_records;
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+size_t RecordColumn<RecordT, HashT, EqualT>::getIndexByteSize() const {
+  return m_slots.size() * sizeof(Slot);
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+template <typename KeyT>
+uint32_t RecordColumn<RecordT, HashT, EqualT>::hashOf(const KeyT& key) {
+  return static_cast<uint32_t>(utility::hashMix(static_cast<uint64_t>(HashT()(key))));
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+void RecordColumn<RecordT, HashT, EqualT>::insertSlot(uint32_t hash, size_t recordIndex) {
+  const size_t mask = m_slots.size() - 1;
+  size_t pos = hash & mask;
+  while(m_slots[pos].index) {
+    pos = (pos + 1) & mask;
+  }
+
+  m_slots[pos].index = static_cast<uint32_t>(recordIndex + 1);
+  m_slots[pos].hash = hash;
+}
+
+template <typename RecordT, typename HashT, typename EqualT>
+void RecordColumn<RecordT, HashT, EqualT>::rehash(size_t slotCount) {
+  std::vector<Slot> oldSlots(slotCount);
+  oldSlots.swap(m_slots);
+
+  for(const Slot& slot : oldSlots) {
+    if(slot.index) {
+      insertSlot(slot.hash, slot.index - 1);
+    }
+  }
+}
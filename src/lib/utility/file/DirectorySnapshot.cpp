@@ -0,0 +1,154 @@
+#include "DirectorySnapshot.h"
+// STL
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+// boost
+#include <boost/filesystem.hpp>
+// internal
+#include "logging.h"
+#include "utilityString.h"
+
+namespace {
+// a last write time this close to the walk may still change within the same second
+constexpr std::time_t UnstableSeconds = 2;
+
+bool isBelow(const std::wstring& path, const std::wstring& rootPath) {
+  if(path.compare(0, rootPath.size(), rootPath) != 0) {
+    return false;
+  }
+  return path.size() == rootPath.size() || rootPath.back() == L'/' || path[rootPath.size()] == L'/';
+}
+
+bool hasLineBreaks(const std::vector<std::wstring>& names) {
+  return std::any_of(names.begin(), names.end(), [](const std::wstring& name) {
+    return name.find_first_of(L"\r\n") != std::wstring::npos;
+  });
+}
+}    // namespace
+
+const std::string DirectorySnapshot::s_header = "sourcetrail directory snapshot 1";
+
+std::shared_ptr<DirectorySnapshot> DirectorySnapshot::load(const FilePath& filePath) {
+  std::shared_ptr<DirectorySnapshot> snapshot = std::make_shared<DirectorySnapshot>();
+
+  std::ifstream file(filePath.str(), std::ios::binary);
+  if(!file.is_open()) {
+    return snapshot;
+  }
+
+  std::string line;
+  if(!std::getline(file, line) || line != s_header) {
+    LOG_WARNING_W(L"Ignoring directory snapshot with unknown format: " + filePath.wstr());
+    return snapshot;
+  }
+
+  Directory* directory = nullptr;
+  while(std::getline(file, line)) {
+    if(line.size() < 2 || line[1] != ' ') {
+      continue;
+    }
+
+    if(line[0] == 'd') {
+      const size_t separator = line.find(' ', 2);
+      if(separator == std::string::npos) {
+        directory = nullptr;
+        continue;
+      }
+
+      directory = &snapshot->m_directories[utility::decodeFromUtf8(line.substr(separator + 1))];
+      directory->lastWriteTime = static_cast<std::time_t>(std::strtoll(line.c_str() + 2, nullptr, 10));
+    } else if(directory != nullptr) {
+      const std::wstring name = utility::decodeFromUtf8(line.substr(2));
+      if(line[0] == 'f') {
+        directory->fileNames.push_back(name);
+      } else if(line[0] == 's') {
+        directory->directoryNames.push_back(name);
+      } else if(line[0] == 'l') {
+        directory->symlinkNames.push_back(name);
+      }
+    }
+  }
+
+  return snapshot;
+}
+
+bool DirectorySnapshot::save(const FilePath& filePath) const {
+  // written next to the old snapshot first, so a failed write never leaves half of a snapshot behind
+  const std::string tempPath = filePath.str() + ".tmp";
+  {
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if(!file.is_open()) {
+      LOG_ERROR_W(L"Could not write directory snapshot: " + filePath.wstr());
+      return false;
+    }
+
+    file << s_header << '\n';
+    for(const auto& [directoryPath, directory] : m_directories) {
+      file << "d " << static_cast<long long>(directory.lastWriteTime) << ' ' << utility::encodeToUtf8(directoryPath) << '\n';
+      for(const std::wstring& name : directory.fileNames) {
+        file << "f " << utility::encodeToUtf8(name) << '\n';
+      }
+      for(const std::wstring& name : directory.directoryNames) {
+        file << "s " << utility::encodeToUtf8(name) << '\n';
+      }
+      for(const std::wstring& name : directory.symlinkNames) {
+        file << "l " << utility::encodeToUtf8(name) << '\n';
+      }
+    }
+
+    if(!file.good()) {
+      LOG_ERROR_W(L"Could not write directory snapshot: " + filePath.wstr());
+      return false;
+    }
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tempPath, filePath.getPath(), ec);
+  if(ec) {
+    LOG_ERROR_W(L"Could not replace directory snapshot: " + filePath.wstr());
+    boost::filesystem::remove(tempPath, ec);
+    return false;
+  }
+  return true;
+}
+
+const DirectorySnapshot::Directory* DirectorySnapshot::getDirectory(const std::wstring& directoryPath,
+                                                                    std::time_t lastWriteTime) const {
+  auto it = m_directories.find(directoryPath);
+  if(it == m_directories.end() || it->second.lastWriteTime != lastWriteTime) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+void DirectorySnapshot::replaceDirectories(const std::vector<std::wstring>& rootPaths,
+                                           const std::unordered_set<std::wstring>& walkedDirectoryPaths,
+                                           std::unordered_map<std::wstring, Directory> readDirectories,
+                                           std::time_t walkTime) {
+  for(auto it = m_directories.begin(); it != m_directories.end();) {
+    const std::wstring& directoryPath = it->first;
+    if(walkedDirectoryPaths.find(directoryPath) == walkedDirectoryPaths.end() &&
+       std::any_of(rootPaths.begin(), rootPaths.end(), [&](const std::wstring& rootPath) {
+         return isBelow(directoryPath, rootPath);
+       })) {
+      it = m_directories.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for(auto& [directoryPath, directory] : readDirectories) {
+    if(directory.lastWriteTime + UnstableSeconds > walkTime || hasLineBreaks({directoryPath}) ||
+       hasLineBreaks(directory.fileNames) || hasLineBreaks(directory.directoryNames) ||
+       hasLineBreaks(directory.symlinkNames)) {
+      m_directories.erase(directoryPath);
+      continue;
+    }
+    m_directories[directoryPath] = std::move(directory);
+  }
+}
+
+size_t DirectorySnapshot::getDirectoryCount() const {
+  return m_directories.size();
+}
@@ -0,0 +1,50 @@
+#pragma once
+// STL
+#include <ctime>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+// internal
+#include "FilePath.h"
+
+/**
+ * Entries of directories as the last walk over them found them, kept between runs in a file.
+ *
+ * Adding, removing or renaming an entry writes to its directory, so a directory with an unchanged last write time can
+ * be listed from the snapshot without reading it again. Last write times only have a resolution of seconds, so
+ * directories written to shortly before they were read are not kept.
+ */
+class DirectorySnapshot final {
+public:
+  struct Directory {
+    std::time_t lastWriteTime = 0;
+    std::vector<std::wstring> fileNames;
+    std::vector<std::wstring> directoryNames;
+    // resolved on every walk, their targets can change without their directory being written to
+    std::vector<std::wstring> symlinkNames;
+  };
+
+  // an empty snapshot if the file does not exist or has an unknown format
+  static std::shared_ptr<DirectorySnapshot> load(const FilePath& filePath);
+
+  bool save(const FilePath& filePath) const;
+
+  // nullptr if the directory is unknown or was written to since it was recorded
+  const Directory* getDirectory(const std::wstring& directoryPath, std::time_t lastWriteTime) const;
+
+  // drops the directories below the root paths that the walk started at walkTime did not reach anymore and records
+  // the ones it read
+  void replaceDirectories(const std::vector<std::wstring>& rootPaths,
+                          const std::unordered_set<std::wstring>& walkedDirectoryPaths,
+                          std::unordered_map<std::wstring, Directory> readDirectories,
+                          std::time_t walkTime);
+
+  size_t getDirectoryCount() const;
+
+private:
+  static const std::string s_header;
+
+  std::unordered_map<std::wstring, Directory> m_directories;
+};
@@ -2,14 +2,17 @@
 
 #include <range/v3/to_container.hpp>
 #include <range/v3/view/filter.hpp>
-#include <range/v3/view/transform.hpp>
 
+#include "DirectorySnapshot.h"
 #include "FilePath.h"
 #include "FilePathFilter.h"
 #include "FileSystem.h"
 
 FileManager::FileManager() = default;
 
+FileManager::FileManager(std::shared_ptr<DirectorySnapshot> directorySnapshot)
+    : m_directorySnapshot(std::move(directorySnapshot)) {}
+
 FileManager::~FileManager() = default;
 
 void FileManager::update(std::vector<FilePath> sourcePaths,
@@ -21,15 +24,10 @@ void FileManager::update(std::vector<FilePath> sourcePaths,
 
   m_allSourceFilePaths.clear();
 
-  const auto filterFunc = [this](const FileInfo& fileInfo) -> bool {
-    const FilePath& filePath = fileInfo.path;
-    return !isExcluded(filePath);
-  };
-  const auto transformFunc = [](const FileInfo& fileInfo) -> FilePath { return fileInfo.path; };
+  const auto filterFunc = [this](const FilePath& filePath) -> bool { return !isExcluded(filePath); };
 
-  const auto files = FileSystem::getFileInfosFromPaths(m_sourcePaths, m_sourceExtensions);
-  m_allSourceFilePaths = files | ranges::cpp20::views::filter(filterFunc) | ranges::cpp20::views::transform(transformFunc) |
-      ranges::to<std::set>();
+  const auto files = FileSystem::getFilePathsFromPaths(m_sourcePaths, m_sourceExtensions, m_directorySnapshot.get());
+  m_allSourceFilePaths = files | ranges::cpp20::views::filter(filterFunc) | ranges::to<std::set>();
 }
 
 std::vector<FilePath> FileManager::getSourcePaths() const {
@@ -1,16 +1,21 @@
 #pragma once
 // STL
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
+// internal
+#include "FilePath.h"
 
-class FilePath;
+class DirectorySnapshot;
 class FilePathFilter;
 
 class FileManager {
 public:
   FileManager();
+  // lists the source paths with the help of the directory snapshot, which is updated but not saved
+  explicit FileManager(std::shared_ptr<DirectorySnapshot> directorySnapshot);
   virtual ~FileManager();
 
   void update(std::vector<FilePath> sourcePaths,
@@ -32,6 +37,7 @@ private:
   std::vector<FilePath> m_sourcePaths;
   std::vector<FilePathFilter> m_excludeFilters;
   std::vector<std::wstring> m_sourceExtensions;
+  std::shared_ptr<DirectorySnapshot> m_directorySnapshot;
 
   std::set<FilePath> m_allSourceFilePaths;
 };
@@ -0,0 +1,229 @@
+#include "FilePathFilterMatcher.h"
+// STL
+#include <algorithm>
+#include <map>
+#include <queue>
+
+namespace {
+// limits the transition table to a few megabytes, larger automatons are simulated instead
+constexpr size_t MaxDeterministicStateCount = 4096;
+}    // namespace
+
+bool FilePathFilterMatcher::isMatching(const FilePath& filePath) const {
+  return isMatching(filePath.wstr());
+}
+
+bool FilePathFilterMatcher::isMatching(const std::wstring& fileStr) const {
+  if(!m_tokens.empty()) {
+    if(m_isDeterministic) {
+      uint32_t state = m_startState;
+      for(const wchar_t c : fileStr) {
+        state = m_transitions[state * m_charClassCount + getCharClass(c)];
+        if(state == 0) {
+          break;
+        }
+      }
+
+      if(m_acceptingStates[state]) {
+        return true;
+      }
+    } else {
+      std::vector<uint32_t> states = m_startStates;
+      for(const wchar_t c : fileStr) {
+        states = getNextStates(states, getCharClass(c));
+        if(states.empty()) {
+          break;
+        }
+      }
+
+      if(isAccepting(states)) {
+        return true;
+      }
+    }
+  }
+
+  for(const FilePathFilter& filter : m_regexFilters) {
+    if(filter.isMatching(fileStr)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+size_t FilePathFilterMatcher::getCompiledFilterCount() const {
+  return m_compiledFilterCount;
+}
+
+bool FilePathFilterMatcher::isDeterministic() const {
+  return m_isDeterministic;
+}
+
+bool FilePathFilterMatcher::isLineBreak(wchar_t c) {
+  // not matched by "." in the regex of FilePathFilter
+  return c == L'\n' || c == L'\r';
+}
+
+void FilePathFilterMatcher::addFilter(const FilePathFilter& filter) {
+  const std::wstring filterString = filter.wstr();
+  if(filterString.find_first_of(L"?|[]") != std::wstring::npos) {
+    m_regexFilters.push_back(filter);
+    return;
+  }
+
+  m_compiledFilterCount++;
+  m_startStates.push_back(static_cast<uint32_t>(m_tokens.size()));
+
+  for(size_t i = 0; i < filterString.size(); i++) {
+    const wchar_t c = filterString[i];
+    if(c == L'/' || c == L'\\') {
+      m_tokens.push_back({TokenType::SEPARATOR, CHAR_CLASS_SEPARATOR});
+    } else if(c == L'*') {
+      if(i + 1 < filterString.size() && filterString[i + 1] == L'*') {
+        m_tokens.push_back({TokenType::DOUBLE_STAR, 0});
+        i++;
+      } else {
+        m_tokens.push_back({TokenType::STAR, 0});
+      }
+    } else {
+      auto it = m_literalCharClasses.find(c);
+      if(it == m_literalCharClasses.end()) {
+        it = m_literalCharClasses.emplace(c, m_charClassCount++).first;
+      }
+      m_tokens.push_back({TokenType::LITERAL, it->second});
+    }
+  }
+
+  m_tokens.push_back({TokenType::END, 0});
+}
+
+void FilePathFilterMatcher::compile() {
+  std::vector<uint32_t> startStates;
+  for(const uint32_t state : m_startStates) {
+    addClosure(state, &startStates);
+  }
+  std::sort(startStates.begin(), startStates.end());
+  startStates.erase(std::unique(startStates.begin(), startStates.end()), startStates.end());
+  m_startStates = std::move(startStates);
+
+  m_lineBreakCharClasses.assign(m_charClassCount, false);
+  m_lineBreakCharClasses[CHAR_CLASS_LINE_BREAK] = true;
+  for(const auto& [c, charClass] : m_literalCharClasses) {
+    m_lineBreakCharClasses[charClass] = isLineBreak(c);
+  }
+
+  for(wchar_t c = 0; c < static_cast<wchar_t>(m_asciiCharClasses.size()); c++) {
+    auto it = m_literalCharClasses.find(c);
+    if(it != m_literalCharClasses.end()) {
+      m_asciiCharClasses[static_cast<size_t>(c)] = it->second;
+    } else if(c == L'/' || c == L'\\') {
+      m_asciiCharClasses[static_cast<size_t>(c)] = CHAR_CLASS_SEPARATOR;
+    } else if(isLineBreak(c)) {
+      m_asciiCharClasses[static_cast<size_t>(c)] = CHAR_CLASS_LINE_BREAK;
+    } else {
+      m_asciiCharClasses[static_cast<size_t>(c)] = CHAR_CLASS_OTHER;
+    }
+  }
+
+  if(m_tokens.empty()) {
+    return;
+  }
+
+  // subset construction, every state of the deterministic automaton is a sorted set of nondeterministic states
+  std::map<std::vector<uint32_t>, uint32_t> stateIds;
+  std::queue<std::vector<uint32_t>> unvisitedStates;
+
+  auto getStateId = [&](std::vector<uint32_t>&& states) {
+    auto it = stateIds.find(states);
+    if(it == stateIds.end()) {
+      const auto stateId = static_cast<uint32_t>(stateIds.size());
+      m_acceptingStates.push_back(isAccepting(states));
+      it = stateIds.emplace(states, stateId).first;
+      unvisitedStates.push(std::move(states));
+    }
+    return it->second;
+  };
+
+  getStateId({});
+  m_startState = getStateId(std::vector<uint32_t>(m_startStates));
+
+  while(!unvisitedStates.empty()) {
+    if(stateIds.size() > MaxDeterministicStateCount) {
+      m_transitions.clear();
+      m_acceptingStates.clear();
+      m_startState = 0;
+      return;
+    }
+
+    const std::vector<uint32_t> states = std::move(unvisitedStates.front());
+    unvisitedStates.pop();
+
+    const uint32_t stateId = stateIds.find(states)->second;
+    m_transitions.resize(std::max(m_transitions.size(), size_t(stateId + 1) * m_charClassCount), 0);
+
+    for(uint16_t charClass = 0; charClass < m_charClassCount; charClass++) {
+      m_transitions[stateId * m_charClassCount + charClass] = getStateId(getNextStates(states, charClass));
+    }
+  }
+
+  m_transitions.resize(stateIds.size() * m_charClassCount, 0);
+  m_isDeterministic = true;
+}
+
+uint16_t FilePathFilterMatcher::getCharClass(wchar_t c) const {
+  if(static_cast<size_t>(c) < m_asciiCharClasses.size()) {
+    return m_asciiCharClasses[static_cast<size_t>(c)];
+  }
+
+  auto it = m_literalCharClasses.find(c);
+  if(it != m_literalCharClasses.end()) {
+    return it->second;
+  }
+  return CHAR_CLASS_OTHER;
+}
+
+void FilePathFilterMatcher::addClosure(uint32_t state, std::vector<uint32_t>* states) const {
+  // stars match nothing as well, so their state also is in the state of the following token
+  states->push_back(state);
+  while(state < m_tokens.size() &&
+        (m_tokens[state].type == TokenType::STAR || m_tokens[state].type == TokenType::DOUBLE_STAR)) {
+    states->push_back(++state);
+  }
+}
+
+std::vector<uint32_t> FilePathFilterMatcher::getNextStates(const std::vector<uint32_t>& states, uint16_t charClass) const {
+  std::vector<uint32_t> nextStates;
+
+  for(const uint32_t state : states) {
+    const Token& token = m_tokens[state];
+    switch(token.type) {
+    case TokenType::LITERAL:
+    case TokenType::SEPARATOR:
+      if(token.charClass == charClass) {
+        addClosure(state + 1, &nextStates);
+      }
+      break;
+    case TokenType::STAR:
+      if(charClass != CHAR_CLASS_SEPARATOR) {
+        addClosure(state, &nextStates);
+      }
+      break;
+    case TokenType::DOUBLE_STAR:
+      if(!m_lineBreakCharClasses[charClass]) {
+        addClosure(state, &nextStates);
+      }
+      break;
+    case TokenType::END:
+      break;
+    }
+  }
+
+  std::sort(nextStates.begin(), nextStates.end());
+  nextStates.erase(std::unique(nextStates.begin(), nextStates.end()), nextStates.end());
+  return nextStates;
+}
+
+bool FilePathFilterMatcher::isAccepting(const std::vector<uint32_t>& states) const {
+  return std::any_of(
+      states.begin(), states.end(), [this](uint32_t state) { return m_tokens[state].type == TokenType::END; });
+}
@@ -0,0 +1,76 @@
+#pragma once
+// STL
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+// internal
+#include "FilePath.h"
+#include "FilePathFilter.h"
+
+/**
+ * Matches a path against a whole set of filters in a single pass.
+ *
+ * The filters are compiled into one automaton over their glob tokens ("*", "**", separators and literal characters)
+ * that is never modified after construction, so a matcher can be shared by several threads. Filters using characters
+ * that still have a meaning in the regex of FilePathFilter ("?", "|", "[" and "]") are matched by that regex instead.
+ */
+class FilePathFilterMatcher final {
+public:
+  template <typename ContainerType>
+  explicit FilePathFilterMatcher(const ContainerType& filters);
+
+  bool isMatching(const FilePath& filePath) const;
+  bool isMatching(const std::wstring& fileStr) const;
+
+  size_t getCompiledFilterCount() const;
+  // false if the automaton grew too large to be built upfront and the filters are matched state set by state set
+  bool isDeterministic() const;
+
+private:
+  enum class TokenType : uint8_t { LITERAL, SEPARATOR, STAR, DOUBLE_STAR, END };
+
+  struct Token {
+    TokenType type;
+    uint16_t charClass;
+  };
+
+  enum CharClass : uint16_t { CHAR_CLASS_OTHER = 0, CHAR_CLASS_SEPARATOR, CHAR_CLASS_LINE_BREAK, CHAR_CLASS_FIRST_LITERAL };
+
+  static bool isLineBreak(wchar_t c);
+
+  void addFilter(const FilePathFilter& filter);
+  void compile();
+
+  uint16_t getCharClass(wchar_t c) const;
+  void addClosure(uint32_t state, std::vector<uint32_t>* states) const;
+  std::vector<uint32_t> getNextStates(const std::vector<uint32_t>& states, uint16_t charClass) const;
+  bool isAccepting(const std::vector<uint32_t>& states) const;
+
+  // one token per state of the nondeterministic automaton, the last state of every filter is its END token
+  std::vector<Token> m_tokens;
+  std::vector<uint32_t> m_startStates;
+  size_t m_compiledFilterCount = 0;
+
+  std::unordered_map<wchar_t, uint16_t> m_literalCharClasses;
+  std::array<uint16_t, 128> m_asciiCharClasses {};
+  std::vector<bool> m_lineBreakCharClasses;
+  uint16_t m_charClassCount = CHAR_CLASS_FIRST_LITERAL;
+
+  // deterministic automaton with one row of transitions per state, state 0 can't match anymore
+  std::vector<uint32_t> m_transitions;
+  uint32_t m_startState = 0;
+  std::vector<bool> m_acceptingStates;
+  bool m_isDeterministic = false;
+
+  std::vector<FilePathFilter> m_regexFilters;
+};
+
+template <typename ContainerType>
+FilePathFilterMatcher::FilePathFilterMatcher(const ContainerType& filters) {
+  for(const FilePathFilter& filter : filters) {
+    addFilter(filter);
+  }
+  compile();
+}
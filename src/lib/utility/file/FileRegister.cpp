@@ -1,14 +1,42 @@
 #include "FileRegister.h"
+// STL
+#include <map>
+#include <mutex>
+// Boost
+#include <boost/filesystem/path.hpp>
 // internal
 #include "FilePath.h"
 #include "FilePathFilter.h"
+#include "FilePathFilterMatcher.h"
+
+namespace {
+std::shared_ptr<const FilePathFilterMatcher> getSharedFilterMatcher(const std::set<FilePathFilter>& filters) {
+  static std::mutex s_mutex;
+  static std::map<std::vector<std::wstring>, std::weak_ptr<const FilePathFilterMatcher>> s_matchers;
+
+  std::vector<std::wstring> filterStrings;
+  filterStrings.reserve(filters.size());
+  for(const FilePathFilter& filter : filters) {
+    filterStrings.push_back(filter.wstr());
+  }
+
+  std::lock_guard<std::mutex> lock(s_mutex);
+  std::weak_ptr<const FilePathFilterMatcher>& weakMatcher = s_matchers[filterStrings];
+  std::shared_ptr<const FilePathFilterMatcher> matcher = weakMatcher.lock();
+  if(!matcher) {
+    matcher = std::make_shared<const FilePathFilterMatcher>(filters);
+    weakMatcher = matcher;
+  }
+  return matcher;
+}
+}    // namespace
 
 FileRegister::FileRegister(const FilePath& currentPath,
                            const std::set<FilePath>& indexedPaths,
                            const std::set<FilePathFilter>& excludeFilters)
     : m_currentPath(currentPath)
-    , m_indexedPaths(indexedPaths)
-    , m_excludeFilters(excludeFilters)
+    , m_indexedPathNodes(1)
+    , m_excludeFilterMatcher(getSharedFilterMatcher(excludeFilters))
     , m_hasFilePathCache([&](const std::wstring& f) {
       const FilePath filePath(f);
       bool ret = false;
@@ -18,29 +46,74 @@ FileRegister::FileRegister(const FilePath& currentPath,
       }
 
       if(!ret) {
-        for(const auto& indexedPath : m_indexedPaths) {
-          if(indexedPath.isDirectory()) {
-            if(indexedPath.contains(filePath)) {
-              ret = true;
-              break;
-            }
-          } else {
-            if(indexedPath == filePath) {
-              ret = true;
-              break;
-            }
-          }
-        }
+        ret = isInIndexedPaths(filePath);
       }
 
       if(ret) {
-        ret = !FilePathFilter::areMatching(m_excludeFilters, filePath);
+        ret = !m_excludeFilterMatcher->isMatching(f);
       }
       return ret;
-    }) {}
+    }) {
+  for(const FilePath& indexedPath : indexedPaths) {
+    if(indexedPath.isDirectory()) {
+      addIndexedPath(indexedPath, true);
+    } else {
+      addIndexedPath(indexedPath, false);
+
+      // an indexed file also stands for the file it links to, the paths looked up are canonical
+      if(indexedPath.exists()) {
+        const FilePath canonicalPath = indexedPath.getCanonical();
+        if(canonicalPath.wstr() != indexedPath.wstr()) {
+          addIndexedPath(canonicalPath, false);
+        }
+      }
+    }
+  }
+}
 
 FileRegister::~FileRegister() = default;
 
 bool FileRegister::hasFilePath(const FilePath& filePath) const {
   return m_hasFilePathCache.getValue(filePath.wstr());
-}
\ No newline at end of file
+}
+
+void FileRegister::addIndexedPath(const FilePath& indexedPath, bool isDirectory) {
+  boost::filesystem::path path = indexedPath.getPath();
+  if(isDirectory && path.filename() == ".") {
+    path.remove_filename();
+  }
+
+  size_t nodeIndex = 0;
+  for(const boost::filesystem::path& component : path) {
+    auto [it, inserted] = m_indexedPathNodes[nodeIndex].children.emplace(component.wstring(), m_indexedPathNodes.size());
+    nodeIndex = it->second;
+    if(inserted) {
+      m_indexedPathNodes.emplace_back();
+    }
+  }
+
+  if(isDirectory) {
+    m_indexedPathNodes[nodeIndex].isIndexedDirectory = true;
+  } else {
+    m_indexedPathNodes[nodeIndex].isIndexedFile = true;
+  }
+}
+
+bool FileRegister::isInIndexedPaths(const FilePath& filePath) const {
+  const boost::filesystem::path path = filePath.getPath();
+
+  size_t nodeIndex = 0;
+  for(const boost::filesystem::path& component : path) {
+    if(m_indexedPathNodes[nodeIndex].isIndexedDirectory) {
+      return true;
+    }
+
+    auto it = m_indexedPathNodes[nodeIndex].children.find(component.wstring());
+    if(it == m_indexedPathNodes[nodeIndex].children.end()) {
+      return false;
+    }
+    nodeIndex = it->second;
+  }
+
+  return m_indexedPathNodes[nodeIndex].isIndexedDirectory || m_indexedPathNodes[nodeIndex].isIndexedFile;
+}
@@ -1,11 +1,16 @@
 #pragma once
 // STL
+#include <memory>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 // internal
 #include "FilePath.h"
 #include "UnorderedCache.h"
 
 class FilePathFilter;
+class FilePathFilterMatcher;
 
 class FileRegister {
 public:
@@ -16,8 +21,19 @@ public:
   virtual bool hasFilePath(const FilePath& filePath) const;
 
 private:
+  // one node per path component, the root node is the empty path
+  struct IndexedPathNode {
+    std::unordered_map<std::wstring, size_t> children;
+    bool isIndexedDirectory = false;
+    bool isIndexedFile = false;
+  };
+
+  void addIndexedPath(const FilePath& indexedPath, bool isDirectory);
+  bool isInIndexedPaths(const FilePath& filePath) const;
+
   const FilePath& m_currentPath;
-  const std::set<FilePath> m_indexedPaths;
-  const std::set<FilePathFilter> m_excludeFilters;
+  std::vector<IndexedPathNode> m_indexedPathNodes;
+  // compiled once for every set of filters and shared by all registers using it
+  std::shared_ptr<const FilePathFilterMatcher> m_excludeFilterMatcher;
   mutable UnorderedCache<std::wstring, bool> m_hasFilePathCache;
-};
\ No newline at end of file
+};
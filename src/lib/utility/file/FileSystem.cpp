@@ -3,9 +3,267 @@
 #include <boost/date_time.hpp>
 #include <boost/date_time/c_local_time_adjustor.hpp>
 #include <boost/filesystem.hpp>
+// STL
+#include <algorithm>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 // internal
+#include "DirectorySnapshot.h"
+#include "logging.h"
 #include "utilityString.h"
 
+namespace {
+TimeStamp toLocalTimeStamp(std::time_t time) {
+  return TimeStamp(
+      boost::date_time::c_local_adjustor<boost::posix_time::ptime>::utc_to_local(boost::posix_time::from_time_t(time)));
+}
+
+/**
+ * Reads directories on all cores, each one only once no matter how many symlinks lead to it.
+ *
+ * Directories are walked by their canonical paths, so the files found below them are canonical without resolving each
+ * one. Only symlinks are resolved.
+ */
+class ParallelDirectoryWalker {
+public:
+  ParallelDirectoryWalker(const std::vector<std::wstring>& fileExtensions,
+                          bool followSymLinks,
+                          bool readFileInfos,
+                          const DirectorySnapshot* snapshot)
+      : m_followSymLinks(followSymLinks), m_readFileInfos(readFileInfos), m_snapshot(snapshot) {
+    for(const std::wstring& fileExtension : fileExtensions) {
+      m_fileExtensions.insert(utility::toLowerCase(fileExtension));
+    }
+  }
+
+  void walk(const std::vector<FilePath>& paths) {
+    for(const FilePath& path : paths) {
+      boost::system::error_code ec;
+      if(path.isDirectory()) {
+        const boost::filesystem::path directoryPath = boost::filesystem::canonical(path.getPath(), ec);
+        if(!ec) {
+          m_rootDirectoryPaths.push_back(directoryPath.generic_wstring());
+          addDirectory(directoryPath);
+        }
+      } else if(path.exists() && hasFileExtension(path.getPath())) {
+        const boost::filesystem::path filePath = boost::filesystem::canonical(path.getPath(), ec);
+        if(!ec) {
+          m_files.push_back(getFileInfo(filePath));
+        }
+      }
+    }
+
+    if(!m_directoryQueue.empty()) {
+      const unsigned int threadCount = std::max(1U, std::thread::hardware_concurrency());
+      std::vector<std::thread> threads;
+      for(unsigned int i = 0; i < threadCount; i++) {
+        threads.emplace_back(&ParallelDirectoryWalker::runWorker, this);
+      }
+      for(std::thread& thread : threads) {
+        thread.join();
+      }
+    }
+
+    // sorted for an order independent of the threads, files reached by symlinks are found more than once
+    std::vector<std::pair<std::wstring, size_t>> sortedFiles;
+    sortedFiles.reserve(m_files.size());
+    for(size_t i = 0; i < m_files.size(); i++) {
+      sortedFiles.emplace_back(m_files[i].path.wstr(), i);
+    }
+    std::sort(sortedFiles.begin(), sortedFiles.end());
+
+    std::vector<FileInfo> files;
+    files.reserve(sortedFiles.size());
+    for(size_t i = 0; i < sortedFiles.size(); i++) {
+      if(i == 0 || sortedFiles[i].first != sortedFiles[i - 1].first) {
+        files.push_back(std::move(m_files[sortedFiles[i].second]));
+      }
+    }
+    m_files = std::move(files);
+  }
+
+  std::vector<FileInfo>& getFiles() {
+    return m_files;
+  }
+
+  const std::vector<std::wstring>& getRootDirectoryPaths() const {
+    return m_rootDirectoryPaths;
+  }
+
+  const std::unordered_set<std::wstring>& getWalkedDirectoryPaths() const {
+    return m_visitedDirectoryPaths;
+  }
+
+  std::unordered_map<std::wstring, DirectorySnapshot::Directory> takeReadDirectories() {
+    return std::move(m_readDirectories);
+  }
+
+private:
+  void runWorker() {
+    while(true) {
+      boost::filesystem::path directoryPath;
+      {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        m_queueCondition.wait(lock, [this]() { return !m_directoryQueue.empty() || m_busyWorkerCount == 0; });
+        if(m_directoryQueue.empty()) {
+          return;
+        }
+
+        directoryPath = std::move(m_directoryQueue.front());
+        m_directoryQueue.pop_front();
+        m_busyWorkerCount++;
+      }
+
+      // an exception would terminate the whole application on this thread
+      try {
+        readDirectory(directoryPath);
+      } catch(const std::exception& exception) {
+        LOG_WARNING(fmt::format("Could not read directory \"{}\": {}", directoryPath.string(), exception.what()));
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_busyWorkerCount--;
+        if(m_busyWorkerCount == 0 && m_directoryQueue.empty()) {
+          m_queueCondition.notify_all();
+        }
+      }
+    }
+  }
+
+  void addDirectory(const boost::filesystem::path& directoryPath) {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    if(m_visitedDirectoryPaths.insert(directoryPath.generic_wstring()).second) {
+      m_directoryQueue.push_back(directoryPath);
+      m_queueCondition.notify_one();
+    }
+  }
+
+  void readDirectory(const boost::filesystem::path& directoryPath) {
+    boost::system::error_code ec;
+
+    DirectorySnapshot::Directory directory;
+    const DirectorySnapshot::Directory* recordedDirectory = nullptr;
+    if(m_snapshot != nullptr) {
+      directory.lastWriteTime = boost::filesystem::last_write_time(directoryPath, ec);
+      if(!ec) {
+        recordedDirectory = m_snapshot->getDirectory(directoryPath.generic_wstring(), directory.lastWriteTime);
+      }
+    }
+
+    if(recordedDirectory == nullptr) {
+      ec.clear();
+      for(boost::filesystem::directory_iterator it(directoryPath, ec), end; !ec && it != end; it.increment(ec)) {
+        boost::system::error_code statusEc;
+        const boost::filesystem::file_status status = it->symlink_status(statusEc);
+        if(statusEc) {
+          continue;
+        }
+
+        std::wstring name;
+        try {
+          name = it->path().filename().wstring();
+        } catch(const std::exception& exception) {
+          LOG_WARNING(fmt::format("Skipping file with unreadable name \"{}\": {}", it->path().string(), exception.what()));
+          continue;
+        }
+
+        if(boost::filesystem::is_symlink(status)) {
+          directory.symlinkNames.push_back(std::move(name));
+        } else if(boost::filesystem::is_directory(status)) {
+          directory.directoryNames.push_back(std::move(name));
+        } else if(boost::filesystem::is_regular_file(status)) {
+          directory.fileNames.push_back(std::move(name));
+        }
+      }
+
+      if(m_snapshot != nullptr && !ec) {
+        std::lock_guard<std::mutex> lock(m_filesMutex);
+        m_readDirectories.emplace(directoryPath.generic_wstring(), directory);
+      }
+      recordedDirectory = &directory;
+    }
+
+    std::vector<FileInfo> files;
+    for(const std::wstring& fileName : recordedDirectory->fileNames) {
+      const boost::filesystem::path filePath = directoryPath / fileName;
+      if(hasFileExtension(filePath)) {
+        files.push_back(getFileInfo(filePath));
+      }
+    }
+
+    for(const std::wstring& directoryName : recordedDirectory->directoryNames) {
+      addDirectory(directoryPath / directoryName);
+    }
+
+    if(m_followSymLinks) {
+      for(const std::wstring& symlinkName : recordedDirectory->symlinkNames) {
+        // broken and self-referencing symlinks can't be resolved
+        const boost::filesystem::path targetPath = boost::filesystem::canonical(directoryPath / symlinkName, ec);
+        if(ec) {
+          continue;
+        }
+
+        const boost::filesystem::file_status status = boost::filesystem::status(targetPath, ec);
+        if(ec) {
+          continue;
+        }
+
+        if(boost::filesystem::is_directory(status)) {
+          addDirectory(targetPath);
+        } else if(boost::filesystem::is_regular_file(status) && hasFileExtension(directoryPath / symlinkName)) {
+          files.push_back(getFileInfo(targetPath));
+        }
+      }
+    }
+
+    if(!files.empty()) {
+      std::lock_guard<std::mutex> lock(m_filesMutex);
+      m_files.insert(m_files.end(), std::make_move_iterator(files.begin()), std::make_move_iterator(files.end()));
+    }
+  }
+
+  bool hasFileExtension(const boost::filesystem::path& filePath) const {
+    return m_fileExtensions.empty() ||
+        m_fileExtensions.find(utility::toLowerCase(filePath.extension().wstring())) != m_fileExtensions.end();
+  }
+
+  FileInfo getFileInfo(const boost::filesystem::path& filePath) const {
+    FileInfo fileInfo(FilePath(filePath.wstring()));
+    if(m_readFileInfos) {
+      boost::system::error_code ec;
+      const std::time_t lastWriteTime = boost::filesystem::last_write_time(filePath, ec);
+      if(!ec) {
+        fileInfo.lastWriteTime = toLocalTimeStamp(lastWriteTime);
+      }
+    }
+    return fileInfo;
+  }
+
+  std::set<std::wstring> m_fileExtensions;
+  const bool m_followSymLinks;
+  const bool m_readFileInfos;
+  const DirectorySnapshot* m_snapshot;
+
+  std::vector<std::wstring> m_rootDirectoryPaths;
+
+  std::mutex m_queueMutex;
+  std::condition_variable m_queueCondition;
+  std::deque<boost::filesystem::path> m_directoryQueue;
+  std::unordered_set<std::wstring> m_visitedDirectoryPaths;
+  size_t m_busyWorkerCount = 0;
+
+  std::mutex m_filesMutex;
+  std::vector<FileInfo> m_files;
+  std::unordered_map<std::wstring, DirectorySnapshot::Directory> m_readDirectories;
+};
+}    // namespace
+
 std::vector<FilePath> FileSystem::getFilePathsFromDirectory(const FilePath& path, const std::vector<std::wstring>& extensions) {
   std::set<std::wstring> ext(extensions.begin(), extensions.end());
   std::vector<FilePath> files;
@@ -42,68 +300,30 @@ FileInfo FileSystem::getFileInfoForPath(const FilePath& filePath) {
 std::vector<FileInfo> FileSystem::getFileInfosFromPaths(const std::vector<FilePath>& paths,
                                                         const std::vector<std::wstring>& fileExtensions,
                                                         bool followSymLinks) {
-  std::set<std::wstring> ext;
-  for(const std::wstring& e : fileExtensions) {
-    ext.insert(utility::toLowerCase(e));
-  }
-
-  std::set<boost::filesystem::path> symlinkDirs;
-  std::set<FilePath> filePaths;
-
-  std::vector<FileInfo> files;
-
-  for(const FilePath& path : paths) {
-    if(path.isDirectory()) {
-      boost::filesystem::recursive_directory_iterator it(path.getPath(), boost::filesystem::symlink_option::recurse);
-      boost::filesystem::recursive_directory_iterator endit;
-      boost::system::error_code ec;
-      for(; it != endit; it.increment(ec)) {
-        if(boost::filesystem::is_symlink(*it)) {
-          if(!followSymLinks) {
-            it.no_push();
-            continue;
-          }
-
-          // check for self-referencing symlinks
-          boost::filesystem::path p = boost::filesystem::read_symlink(*it);
-          if(p.filename() == p.string() && p.filename() == it->path().filename()) {
-            continue;
-          }
-
-          // check for duplicates when following directory symlinks
-          if(boost::filesystem::is_directory(*it)) {
-            boost::filesystem::path absDir = boost::filesystem::canonical(p, it->path().parent_path());
+  ParallelDirectoryWalker walker(fileExtensions, followSymLinks, true, nullptr);
+  walker.walk(paths);
+  return walker.getFiles();
+}
 
-            if(symlinkDirs.find(absDir) != symlinkDirs.end()) {
-              it.no_push();
-              continue;
-            }
+std::vector<FilePath> FileSystem::getFilePathsFromPaths(const std::vector<FilePath>& paths,
+                                                        const std::vector<std::wstring>& fileExtensions,
+                                                        DirectorySnapshot* snapshot,
+                                                        bool followSymLinks) {
+  const std::time_t walkTime = std::time(nullptr);
 
-            symlinkDirs.insert(absDir);
-          }
-        }
+  ParallelDirectoryWalker walker(fileExtensions, followSymLinks, false, snapshot);
+  walker.walk(paths);
 
-        if(boost::filesystem::is_regular_file(*it) &&
-           (ext.empty() || ext.find(utility::toLowerCase(it->path().extension().wstring())) != ext.end())) {
-          const FilePath canonicalPath = FilePath(it->path().wstring()).getCanonical();
-          if(filePaths.find(canonicalPath) != filePaths.end()) {
-            continue;
-          }
-          filePaths.insert(canonicalPath);
-          files.push_back(getFileInfoForPath(canonicalPath));
-        }
-      }
-    } else if(path.exists() && (ext.empty() || ext.find(utility::toLowerCase(path.extension())) != ext.end())) {
-      const FilePath canonicalPath = path.getCanonical();
-      if(filePaths.find(canonicalPath) != filePaths.end()) {
-        continue;
-      }
-      filePaths.insert(canonicalPath);
-      files.push_back(getFileInfoForPath(canonicalPath));
-    }
+  if(snapshot != nullptr) {
+    snapshot->replaceDirectories(
+        walker.getRootDirectoryPaths(), walker.getWalkedDirectoryPaths(), walker.takeReadDirectories(), walkTime);
   }
 
-  return files;
+  std::vector<FilePath> filePaths;
+  for(FileInfo& fileInfo : walker.getFiles()) {
+    filePaths.push_back(std::move(fileInfo.path));
+  }
+  return filePaths;
 }
 
 std::set<FilePath> FileSystem::getSymLinkedDirectories(const FilePath& path) {
@@ -154,13 +374,10 @@ unsigned long long FileSystem::getFileByteSize(const FilePath& filePath) {
 }
 
 TimeStamp FileSystem::getLastWriteTime(const FilePath& filePath) {
-  boost::posix_time::ptime lastWriteTime;
   if(filePath.exists()) {
-    std::time_t t = boost::filesystem::last_write_time(filePath.getPath());
-    lastWriteTime = boost::posix_time::from_time_t(t);
-    lastWriteTime = boost::date_time::c_local_adjustor<boost::posix_time::ptime>::utc_to_local(lastWriteTime);
+    return toLocalTimeStamp(boost::filesystem::last_write_time(filePath.getPath()));
   }
-  return TimeStamp(lastWriteTime);
+  return TimeStamp(boost::posix_time::ptime());
 }
 
 bool FileSystem::remove(const FilePath& path) {
@@ -7,16 +7,26 @@
 #include "FileInfo.h"
 #include "TimeStamp.h"
 
+class DirectorySnapshot;
+
 class FileSystem final {
 public:
   static std::vector<FilePath> getFilePathsFromDirectory(const FilePath& path, const std::vector<std::wstring>& extensions = {});
 
   static FileInfo getFileInfoForPath(const FilePath& filePath);
 
+  // reads the directories in parallel, the canonical file paths come with their last write time
   static std::vector<FileInfo> getFileInfosFromPaths(const std::vector<FilePath>& paths,
                                                      const std::vector<std::wstring>& fileExtensions,
                                                      bool followSymLinks = true);
 
+  // the files of getFileInfosFromPaths without reading anything but directories. directories not written to since the
+  // snapshot recorded them are listed from it, the others are read and recorded
+  static std::vector<FilePath> getFilePathsFromPaths(const std::vector<FilePath>& paths,
+                                                     const std::vector<std::wstring>& fileExtensions,
+                                                     DirectorySnapshot* snapshot = nullptr,
+                                                     bool followSymLinks = true);
+
   static std::set<FilePath> getSymLinkedDirectories(const FilePath& path);
   static std::set<FilePath> getSymLinkedDirectories(const std::vector<FilePath>& paths);
 
@@ -36,6 +36,59 @@ std::vector<FilePath> utility::partitionFilePathsBySize(std::vector<FilePath> fi
   return sortedFilePaths;
 }
 
+std::vector<FilePath> utility::orderFilePathsByIndexingCost(std::vector<FilePath> filePaths,
+                                                            const std::map<std::wstring, uint64_t>& indexingDurationsMS) {
+  if(indexingDurationsMS.empty()) {
+    return partitionFilePathsBySize(std::move(filePaths), 2);
+  }
+
+  struct CostEntry {
+    double expectedDurationMS;
+    unsigned long long int byteSize;
+    bool recorded;
+    FilePath filePath;
+  };
+
+  std::vector<CostEntry> entries;
+  entries.reserve(filePaths.size());
+
+  double recordedDurationMS = 0.0;
+  double recordedByteSize = 0.0;
+  for(FilePath& path : filePaths) {
+    const unsigned long long int byteSize = path.exists() ? FileSystem::getFileByteSize(path) : 1;
+
+    auto it = indexingDurationsMS.find(path.wstr());
+    if(it != indexingDurationsMS.end()) {
+      recordedDurationMS += static_cast<double>(it->second);
+      recordedByteSize += static_cast<double>(byteSize);
+      entries.push_back({static_cast<double>(it->second), byteSize, true, std::move(path)});
+    } else {
+      entries.push_back({0.0, byteSize, false, std::move(path)});
+    }
+  }
+
+  const double durationPerByte = recordedByteSize > 0.0 ? recordedDurationMS / recordedByteSize : 0.0;
+  for(CostEntry& entry : entries) {
+    if(!entry.recorded) {
+      entry.expectedDurationMS = static_cast<double>(entry.byteSize) * durationPerByte;
+    }
+  }
+
+  std::stable_sort(entries.begin(), entries.end(), [](const CostEntry& a, const CostEntry& b) {
+    if(a.expectedDurationMS != b.expectedDurationMS) {
+      return a.expectedDurationMS > b.expectedDurationMS;
+    }
+    return a.byteSize > b.byteSize;
+  });
+
+  std::vector<FilePath> sortedFilePaths;
+  sortedFilePaths.reserve(entries.size());
+  for(CostEntry& entry : entries) {
+    sortedFilePaths.push_back(std::move(entry.filePath));
+  }
+  return sortedFilePaths;
+}
+
 std::vector<FilePath> utility::getTopLevelPaths(const std::vector<FilePath>& paths) {
   return utility::getTopLevelPaths(utility::toSet(paths));
 }
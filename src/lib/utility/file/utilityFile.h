@@ -1,6 +1,9 @@
 #pragma once
 // STL
+#include <cstdint>
+#include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 class FilePath;
@@ -9,6 +12,11 @@ namespace utility {
 
 std::vector<FilePath> partitionFilePathsBySize(std::vector<FilePath> filePaths, int partitionCount = 0);
 
+// orders by expected indexing duration, longest first. files without a recorded duration are estimated from their byte
+// size at the average duration per byte of the recorded ones. falls back to partitionFilePathsBySize without records.
+std::vector<FilePath> orderFilePathsByIndexingCost(std::vector<FilePath> filePaths,
+                                                   const std::map<std::wstring, uint64_t>& indexingDurationsMS);
+
 std::vector<FilePath> getTopLevelPaths(const std::vector<FilePath>& paths);
 
 std::vector<FilePath> getTopLevelPaths(const std::set<FilePath>& paths);
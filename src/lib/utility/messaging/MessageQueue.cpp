@@ -1,6 +1,5 @@
 #include "MessageQueue.h"
 
-#include <chrono>
 #include <mutex>
 #include <thread>
 
@@ -73,11 +72,14 @@ void MessageQueue::addMessageFilter(std::shared_ptr<MessageFilter> filter) {
 }
 
 void MessageQueue::pushMessage(std::shared_ptr<MessageBase> message) {
-  std::scoped_lock<std::mutex> lock(mMessageBufferMutex);
-  if(ranges::find(mMessageBuffer, message) != mMessageBuffer.end()) {
-    return;
+  {
+    std::scoped_lock<std::mutex> lock(mMessageBufferMutex);
+    if(ranges::find(mMessageBuffer, message) != mMessageBuffer.end()) {
+      return;
+    }
+    mMessageBuffer.push_back(std::move(message));
   }
-  mMessageBuffer.push_back(std::move(message));
+  mMessageBufferCondition.notify_all();
 }
 
 void MessageQueue::processMessage(const std::shared_ptr<MessageBase>& message, bool asNextTask) {
@@ -94,9 +96,9 @@ void MessageQueue::processMessage(const std::shared_ptr<MessageBase>& message, b
 }
 
 void MessageQueue::startMessageLoopThreaded() {
+  mThreadIsRunning = true;
   // TODO(Hussein): Remove `detach()`
   std::thread(&MessageQueue::startMessageLoop, this).detach();
-  mThreadIsRunning = true;
 }
 
 void MessageQueue::startMessageLoop() {
@@ -109,17 +111,20 @@ void MessageQueue::startMessageLoop() {
   while(true) {
     processMessages();
 
+    // sleep until a message gets pushed or the loop is stopped
+    std::unique_lock<std::mutex> lock(mMessageBufferMutex);
+    mMessageBufferCondition.wait(lock, [this]() { return !mMessageBuffer.empty() || !mLoopIsRunning; });
+
     if(!mLoopIsRunning) {
       break;
     }
-
-    using namespace std::chrono_literals;
-    std::this_thread::sleep_for(25ms);
   }
 
-  if(mThreadIsRunning) {
+  {
+    std::scoped_lock<std::mutex> lock(mThreadMutex);
     mThreadIsRunning = false;
   }
+  mThreadCondition.notify_all();
 }
 
 void MessageQueue::stopMessageLoop() {
@@ -129,14 +134,14 @@ void MessageQueue::stopMessageLoop() {
 
   mLoopIsRunning = false;
 
-  while(true) {
-    if(!mThreadIsRunning) {
-      break;
-    }
-
-    using namespace std::chrono_literals;
-    std::this_thread::sleep_for(25ms);
+  {
+    // taking the lock makes sure the loop is either before its check or already waiting
+    std::scoped_lock<std::mutex> lock(mMessageBufferMutex);
   }
+  mMessageBufferCondition.notify_all();
+
+  std::unique_lock<std::mutex> lock(mThreadMutex);
+  mThreadCondition.wait(lock, [this]() { return !mThreadIsRunning; });
 }
 
 bool MessageQueue::loopIsRunning() const {
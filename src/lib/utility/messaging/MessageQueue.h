@@ -1,5 +1,6 @@
 #pragma once
 #include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -65,6 +66,12 @@ private:
 
   mutable std::mutex mMessageBufferMutex;
   mutable std::mutex mListenersMutex;
+  std::mutex mThreadMutex;
+
+  // signaled on mMessageBufferMutex when messages get pushed or the loop is stopped
+  std::condition_variable mMessageBufferCondition;
+  // signaled on mThreadMutex when the loop thread ends
+  std::condition_variable mThreadCondition;
 
   bool mSendMessagesAsTasks = false;
 };
\ No newline at end of file
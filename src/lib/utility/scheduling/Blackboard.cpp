@@ -12,12 +12,34 @@ bool Blackboard::exists(const std::string& key) {
 }
 
 bool Blackboard::clear(const std::string& key) {
-  std::lock_guard<std::mutex> lock(m_itemMutex);
+  {
+    std::lock_guard<std::mutex> lock(m_itemMutex);
 
-  ItemMap::const_iterator it = m_items.find(key);
-  if(it != m_items.end()) {
+    ItemMap::const_iterator it = m_items.find(key);
+    if(it == m_items.end()) {
+      return false;
+    }
     m_items.erase(it);
-    return true;
   }
-  return false;
+
+  notifyUpdate();
+  return true;
+}
+
+void Blackboard::notifyUpdate() {
+  {
+    std::lock_guard<std::mutex> lock(m_updateMutex);
+    m_updateCount++;
+  }
+  m_updateCondition.notify_all();
+}
+
+size_t Blackboard::getUpdateCount() {
+  std::lock_guard<std::mutex> lock(m_updateMutex);
+  return m_updateCount;
+}
+
+bool Blackboard::waitForUpdate(size_t updateCount, std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(m_updateMutex);
+  return m_updateCondition.wait_for(lock, timeout, [this, updateCount]() { return m_updateCount != updateCount; });
 }
@@ -1,6 +1,8 @@
 #ifndef BLACKBOARD_H
 #define BLACKBOARD_H
 
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <map>
 #include <memory>
@@ -42,6 +44,15 @@ public:
   bool exists(const std::string& key);
   bool clear(const std::string& key);
 
+  // wakes up all threads blocked in waitForUpdate(), every change of a value does this implicitly
+  void notifyUpdate();
+
+  // incremented with every notification, pass it to waitForUpdate() to not miss notifications in between
+  size_t getUpdateCount();
+
+  // blocks until the update count differs from updateCount or the timeout elapsed, returns false on timeout
+  bool waitForUpdate(size_t updateCount, std::chrono::milliseconds timeout);
+
 private:
   typedef std::map<std::string, std::shared_ptr<BlackboardItemBase>> ItemMap;
 
@@ -49,14 +60,22 @@ private:
 
   ItemMap m_items;
   std::mutex m_itemMutex;
+
+  size_t m_updateCount = 0;
+  std::mutex m_updateMutex;
+  std::condition_variable m_updateCondition;
 };
 
 
 template <typename T>
 void Blackboard::set(const std::string& key, const T& value) {
-  std::lock_guard<std::mutex> lock(m_itemMutex);
+  {
+    std::lock_guard<std::mutex> lock(m_itemMutex);
 
-  m_items[key] = std::make_shared<BlackboardItem<T>>(value);
+    m_items[key] = std::make_shared<BlackboardItem<T>>(value);
+  }
+
+  notifyUpdate();
 }
 
 template <typename T>
@@ -80,18 +99,26 @@ bool Blackboard::get(const std::string& key, T& value) {
 
 template <typename T>
 bool Blackboard::update(const std::string& key, std::function<T(const T&)> updater) {
-  std::lock_guard<std::mutex> lock(m_itemMutex);
-
-  ItemMap::const_iterator it = m_items.find(key);
-  if(it != m_items.end()) {
-    if(std::shared_ptr<BlackboardItem<T>> item = std::dynamic_pointer_cast<BlackboardItem<T>>(it->second)) {
-      item->value = updater(item->value);
-      return true;
+  bool updated = false;
+  {
+    std::lock_guard<std::mutex> lock(m_itemMutex);
+
+    ItemMap::const_iterator it = m_items.find(key);
+    if(it != m_items.end()) {
+      if(std::shared_ptr<BlackboardItem<T>> item = std::dynamic_pointer_cast<BlackboardItem<T>>(it->second)) {
+        item->value = updater(item->value);
+        updated = true;
+      }
     }
   }
 
-  LOG_WARNING("Entry for \"" + key + "\" not found on blackboard.");
-  return false;
+  if(!updated) {
+    LOG_WARNING("Entry for \"" + key + "\" not found on blackboard.");
+    return false;
+  }
+
+  notifyUpdate();
+  return true;
 }
 
 #endif    // BLACKBOARD_H
@@ -1,7 +1,8 @@
 #include "TaskDecoratorRepeat.h"
 
 #include <chrono>
-#include <thread>
+
+#include "Blackboard.h"
 
 TaskDecoratorRepeat::TaskDecoratorRepeat(ConditionType condition, TaskState exitState, size_t delayMS)
     : m_condition(condition), m_exitState(exitState), m_delayMS(delayMS) {}
@@ -9,6 +10,7 @@ TaskDecoratorRepeat::TaskDecoratorRepeat(ConditionType condition, TaskState exit
 void TaskDecoratorRepeat::doEnter(std::shared_ptr<Blackboard> /*blackboard*/) {}
 
 Task::TaskState TaskDecoratorRepeat::doUpdate(std::shared_ptr<Blackboard> blackboard) {
+  const size_t updateCount = blackboard->getUpdateCount();
   TaskState state = m_taskRunner->update(blackboard);
 
   switch(m_condition) {
@@ -22,7 +24,8 @@ Task::TaskState TaskDecoratorRepeat::doUpdate(std::shared_ptr<Blackboard> blackb
     break;
   }
 
-  std::this_thread::sleep_for(std::chrono::milliseconds(m_delayMS));
+  // the delay only applies while nothing changes, repeated conditions usually wait for other tasks
+  blackboard->waitForUpdate(updateCount, std::chrono::milliseconds(m_delayMS));
 
   return state;
 }
@@ -26,10 +26,12 @@ void TaskGroupParallel::doEnter(std::shared_ptr<Blackboard> blackboard) {
 }
 
 Task::TaskState TaskGroupParallel::doUpdate(std::shared_ptr<Blackboard> /*blackboard*/) {
-  std::this_thread::sleep_for(std::chrono::milliseconds(25));
-
-  if(m_tasks.size() != 0 && getActiveTaskCount() > 0) {
-    return STATE_RUNNING;
+  {
+    // wake up as soon as the last task finishes, the timeout keeps the scheduler responsive to termination
+    std::unique_lock<std::mutex> lock(*m_activeTaskCountMutex.get());
+    if(!m_activeTaskCountCondition.wait_for(lock, std::chrono::milliseconds(25), [this]() { return m_activeTaskCount <= 0; })) {
+      return STATE_RUNNING;
+    }
   }
 
   return (m_taskFailed ? STATE_FAILURE : STATE_SUCCESS);
@@ -75,8 +77,11 @@ void TaskGroupParallel::processTaskThreaded(std::shared_ptr<TaskInfo> taskInfo,
                                             std::shared_ptr<Blackboard> blackboard,
                                             std::shared_ptr<std::mutex> activeTaskCountMutex) {
   ScopedFunctor functor([&]() {
-    std::lock_guard<std::mutex> lock(*activeTaskCountMutex.get());
-    m_activeTaskCount--;
+    {
+      std::lock_guard<std::mutex> lock(*activeTaskCountMutex.get());
+      m_activeTaskCount--;
+    }
+    m_activeTaskCountCondition.notify_all();
   });
 
   while(true) {
@@ -91,8 +96,3 @@ void TaskGroupParallel::processTaskThreaded(std::shared_ptr<TaskInfo> taskInfo,
     }
   }
 }
-
-int TaskGroupParallel::getActiveTaskCount() const {
-  std::lock_guard<std::mutex> lock(*m_activeTaskCountMutex.get());
-  return m_activeTaskCount;
-}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 // STL
+#include <condition_variable>
 #include <map>
 #include <mutex>
 #include <thread>
@@ -30,7 +31,6 @@ private:
   void processTaskThreaded(std::shared_ptr<TaskInfo> taskInfo,
                            std::shared_ptr<Blackboard> blackboard,
                            std::shared_ptr<std::mutex> activeTaskCountMutex);
-  int getActiveTaskCount() const;
 
   std::vector<std::shared_ptr<TaskInfo>> m_tasks;
   bool m_needsToStartThreads;
@@ -38,4 +38,5 @@ private:
   volatile bool m_taskFailed;
   volatile int m_activeTaskCount;
   mutable std::shared_ptr<std::mutex> m_activeTaskCountMutex;
+  std::condition_variable m_activeTaskCountCondition;
 };
\ No newline at end of file
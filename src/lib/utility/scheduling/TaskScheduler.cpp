@@ -1,6 +1,5 @@
 #include "TaskScheduler.h"
 
-#include <chrono>
 #include <thread>
 
 #include "ScopedFunctor.h"
@@ -14,25 +13,33 @@ TaskScheduler::~TaskScheduler() {
 }
 
 void TaskScheduler::pushTask(std::shared_ptr<Task> task) {
-  std::lock_guard<std::mutex> lock(m_tasksMutex);
-  m_taskRunners.push_back(std::make_shared<TaskRunner>(task));
+  {
+    std::lock_guard<std::mutex> lock(m_tasksMutex);
+    m_taskRunners.push_back(std::make_shared<TaskRunner>(task));
+  }
+  m_tasksCondition.notify_all();
 }
 
 void TaskScheduler::pushNextTask(std::shared_ptr<Task> task) {
-  std::lock_guard<std::mutex> lock(m_tasksMutex);
+  {
+    std::lock_guard<std::mutex> lock(m_tasksMutex);
 
-  if(m_taskRunners.empty()) {
-    m_taskRunners.push_front(std::make_shared<TaskRunner>(task));
-  } else {
-    m_taskRunners.insert(m_taskRunners.begin() + 1, std::make_shared<TaskRunner>(task));
+    if(m_taskRunners.empty()) {
+      m_taskRunners.push_front(std::make_shared<TaskRunner>(task));
+    } else {
+      m_taskRunners.insert(m_taskRunners.begin() + 1, std::make_shared<TaskRunner>(task));
+    }
   }
+  m_tasksCondition.notify_all();
 }
 
 void TaskScheduler::startSchedulerLoopThreaded() {
-  std::thread(&TaskScheduler::startSchedulerLoop, this).detach();
+  {
+    std::lock_guard<std::mutex> lock(m_threadMutex);
+    m_threadIsRunning = true;
+  }
 
-  std::lock_guard<std::mutex> lock(m_threadMutex);
-  m_threadIsRunning = true;
+  std::thread(&TaskScheduler::startSchedulerLoop, this).detach();
 }
 
 void TaskScheduler::startSchedulerLoop() {
@@ -50,16 +57,13 @@ void TaskScheduler::startSchedulerLoop() {
   while(true) {
     processTasks();
 
-    {
-      std::lock_guard<std::mutex> lock(m_loopMutex);
+    // sleep until a task gets pushed or the loop is stopped
+    std::unique_lock<std::mutex> lock(m_tasksMutex);
+    m_tasksCondition.wait(lock, [this]() { return !m_taskRunners.empty() || !loopIsRunning(); });
 
-      if(!m_loopIsRunning) {
-        break;
-      }
+    if(!loopIsRunning()) {
+      break;
     }
-
-    constexpr auto SleepTimeForMs = 25;
-    std::this_thread::sleep_for(std::chrono::milliseconds(SleepTimeForMs));
   }
 
   {
@@ -68,6 +72,7 @@ void TaskScheduler::startSchedulerLoop() {
       m_threadIsRunning = false;
     }
   }
+  m_threadCondition.notify_all();
 }
 
 void TaskScheduler::stopSchedulerLoop() {
@@ -81,17 +86,14 @@ void TaskScheduler::stopSchedulerLoop() {
     m_loopIsRunning = false;
   }
 
-  while(true) {
-    {
-      std::lock_guard<std::mutex> lock(m_threadMutex);
-      if(!m_threadIsRunning) {
-        break;
-      }
-    }
-
-    constexpr auto SleepTimeForMs = 25;
-    std::this_thread::sleep_for(std::chrono::milliseconds(SleepTimeForMs));
+  {
+    // taking the lock makes sure the loop is either before its check or already waiting
+    std::lock_guard<std::mutex> lock(m_tasksMutex);
   }
+  m_tasksCondition.notify_all();
+
+  std::unique_lock<std::mutex> lock(m_threadMutex);
+  m_threadCondition.wait(lock, [this]() { return !m_threadIsRunning; });
 }
 
 bool TaskScheduler::loopIsRunning() const {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -39,4 +40,9 @@ private:
   mutable std::mutex m_tasksMutex;
   mutable std::mutex m_loopMutex;
   mutable std::mutex m_threadMutex;
+
+  // signaled on m_tasksMutex when tasks get pushed or the loop is stopped
+  std::condition_variable m_tasksCondition;
+  // signaled on m_threadMutex when the loop thread ends
+  std::condition_variable m_threadCondition;
 };
\ No newline at end of file
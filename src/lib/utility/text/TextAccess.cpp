@@ -4,55 +4,20 @@
 
 #include "logging.h"
 
-namespace {
-std::istream& safeGetline(std::istream& istream, std::string& text) {
-  text.clear();
-
-  // The characters in the stream are read one-by-one using a std::streambuf.
-  // That is faster than reading them one-by-one using the std::istream.
-  // Code that uses streambuf this way must be guarded by a sentry object.
-  // The sentry object performs various tasks,
-  // such as thread synchronization and updating the stream state.
-
-  std::istream::sentry sentry(istream, true);
-  std::streambuf* pStreambuf = istream.rdbuf();
-
-  while(true) {
-    const int character = pStreambuf->sbumpc();
-    switch(character) {
-    case '\n':
-      return istream;
-    case '\r':
-      if(pStreambuf->sgetc() == '\n') {
-        pStreambuf->sbumpc();
-      }
-      return istream;
-    case std::streambuf::traits_type::eof():
-      // Also handle the case when the last line has no line ending
-      if(text.empty()) {
-        istream.setstate(std::ios::eofbit);
-      }
-      return istream;
-    default:
-      text += static_cast<char>(character);
-    }
-  }
-}
-}    // namespace
-
 std::shared_ptr<TextAccess> TextAccess::createFromFile(const FilePath& filePath) {
   std::shared_ptr<TextAccess> result(new TextAccess());
 
   result->m_filePath = filePath;
-  result->m_lines = readFile(filePath);
+  result->m_text = readFile(filePath);
+  result->m_normalizeLineEndings = true;
 
   return result;
 }
 
-std::shared_ptr<TextAccess> TextAccess::createFromString(const std::string& text, const FilePath& filePath) {
+std::shared_ptr<TextAccess> TextAccess::createFromString(std::string text, const FilePath& filePath) {
   std::shared_ptr<TextAccess> result(new TextAccess());
 
-  result->m_lines = splitStringByLines(text);
+  result->m_text = std::move(text);
   result->m_filePath = filePath;
 
   return result;
@@ -61,7 +26,14 @@ std::shared_ptr<TextAccess> TextAccess::createFromString(const std::string& text
 std::shared_ptr<TextAccess> TextAccess::createFromLines(const std::vector<std::string>& lines, const FilePath& filePath) {
   std::shared_ptr<TextAccess> result(new TextAccess());
 
-  result->m_lines = lines;
+  // the lines are kept as they are, even if they don't end with a line break
+  std::call_once(result->m_lineBeginsFlag, [&result, &lines]() {
+    for(const std::string& line : lines) {
+      result->m_lineBegins.push_back(result->m_text.size());
+      result->m_text += line;
+    }
+    result->m_lineBegins.push_back(result->m_text.size());
+  });
   result->m_filePath = filePath;
 
   return result;
@@ -70,23 +42,27 @@ std::shared_ptr<TextAccess> TextAccess::createFromLines(const std::vector<std::s
 TextAccess::~TextAccess() = default;
 
 uint32_t TextAccess::getLineCount() const {
-  return static_cast<uint32_t>(m_lines.size());
+  return static_cast<uint32_t>(getLineBegins().size() - 1);
 }
 
 bool TextAccess::isEmpty() const {
-  return m_lines.empty();
+  return getLineCount() == 0;
 }
 
 FilePath TextAccess::getFilePath() const {
   return m_filePath;
 }
 
+size_t TextAccess::getByteSize() const {
+  return m_text.size();
+}
+
 std::string TextAccess::getLine(const uint32_t lineNumber) const {
   if(!checkIndexInRange(lineNumber)) {
     return "";
   }
 
-  return m_lines[lineNumber - 1];    // -1 to correct for use as index
+  return getLineByIndex(lineNumber - 1);    // -1 to correct for use as index
 }
 
 std::vector<std::string> TextAccess::getLines(const uint32_t firstLineNumber, const uint32_t lastLineNumber) {
@@ -94,41 +70,60 @@ std::vector<std::string> TextAccess::getLines(const uint32_t firstLineNumber, co
     return {};
   }
 
-  auto first = m_lines.begin() + firstLineNumber - 1;    // -1 to correct for use as index
-  auto last = m_lines.begin() + lastLineNumber;
-  return {first, last};
+  std::vector<std::string> lines;
+  lines.reserve(lastLineNumber - firstLineNumber + 1);
+  for(uint32_t lineNumber = firstLineNumber; lineNumber <= lastLineNumber; lineNumber++) {
+    lines.push_back(getLineByIndex(lineNumber - 1));    // -1 to correct for use as index
+  }
+  return lines;
 }
 
-const std::vector<std::string>& TextAccess::getAllLines() const {
-  return m_lines;
+std::vector<std::string> TextAccess::getAllLines() const {
+  const size_t lineCount = getLineCount();
+
+  std::vector<std::string> lines;
+  lines.reserve(lineCount);
+  for(size_t i = 0; i < lineCount; i++) {
+    lines.push_back(getLineByIndex(i));
+  }
+  return lines;
 }
 
 std::string TextAccess::getText() const {
-  std::string result;
+  if(!m_normalizeLineEndings) {
+    return m_text;
+  }
 
-  for(const auto& m_line : m_lines) {
-    result += m_line;
+  if(m_text.find('\r') == std::string::npos) {
+    return (m_text.empty() || m_text.back() == '\n') ? m_text : m_text + '\n';
   }
 
+  std::string result;
+  result.reserve(m_text.size() + 1);
+  for(size_t i = 0; i < getLineCount(); i++) {
+    result += getLineByIndex(i);
+  }
   return result;
 }
 
-std::vector<std::string> TextAccess::readFile(const FilePath& filePath) {
-  std::vector<std::string> result;
+std::string TextAccess::readFile(const FilePath& filePath) {
+  std::string result;
 
   try {
     std::ifstream srcFile;
-    srcFile.open(filePath.str(), std::ios::binary | std::ios::in);
+    srcFile.open(filePath.str(), std::ios::binary | std::ios::in | std::ios::ate);
 
     if(srcFile.fail()) {
       LOG_ERROR_W(L"Could not open file " + filePath.wstr());
       return result;
     }
 
-    while(!srcFile.eof()) {
-      std::string line;
-      safeGetline(srcFile, line);
-      result.push_back(line + '\n');
+    const std::streamoff size = srcFile.tellg();
+    if(size > 0) {
+      result.resize(static_cast<size_t>(size));
+      srcFile.seekg(0);
+      srcFile.read(result.data(), size);
+      result.resize(static_cast<size_t>(srcFile.gcount()));
     }
 
     srcFile.close();
@@ -140,44 +135,66 @@ std::vector<std::string> TextAccess::readFile(const FilePath& filePath) {
     result.clear();
   }
 
-  if(!result.empty()) {
-    std::string last = result.back().substr(0, result.back().size() - 1);
-    result.pop_back();
-    if(!last.empty()) {
-      result.push_back(last);
-    }
-  }
-
   return result;
 }
 
-std::vector<std::string> TextAccess::splitStringByLines(const std::string& text) {
-  std::vector<std::string> result;
-  size_t prevIndex = 0;
-  size_t index = text.find('\n');
+TextAccess::TextAccess() = default;
+
+const std::vector<size_t>& TextAccess::getLineBegins() const {
+  std::call_once(m_lineBeginsFlag, [this]() {
+    size_t begin = 0;
+    for(size_t i = 0; i < m_text.size(); i++) {
+      if(m_text[i] == '\n') {
+        m_lineBegins.push_back(begin);
+        begin = i + 1;
+      } else if(m_text[i] == '\r' && m_normalizeLineEndings) {
+        if(i + 1 < m_text.size() && m_text[i + 1] == '\n') {
+          i++;
+        }
+        m_lineBegins.push_back(begin);
+        begin = i + 1;
+      }
+    }
+
+    // the last line doesn't need a line break
+    if(begin < m_text.size()) {
+      m_lineBegins.push_back(begin);
+    }
+    m_lineBegins.push_back(m_text.size());
+  });
+
+  return m_lineBegins;
+}
 
-  while(index != std::string::npos) {
-    result.push_back(text.substr(prevIndex, index - prevIndex) + '\n');
+std::string TextAccess::getLineByIndex(const size_t index) const {
+  const std::vector<size_t>& lineBegins = getLineBegins();
+  const size_t begin = lineBegins[index];
+  size_t end = lineBegins[index + 1];
 
-    prevIndex = index + 1;
-    index = text.find('\n', prevIndex);
+  if(!m_normalizeLineEndings) {
+    return m_text.substr(begin, end - begin);
   }
 
-  if(prevIndex < text.length()) {
-    result.push_back(text.substr(prevIndex));
+  if(end > begin && m_text[end - 1] == '\n') {
+    end--;
+  }
+  if(end > begin && m_text[end - 1] == '\r') {
+    end--;
   }
 
-  return result;
+  std::string line;
+  line.reserve(end - begin + 1);
+  line.append(m_text, begin, end - begin);
+  line += '\n';
+  return line;
 }
 
-TextAccess::TextAccess() = default;
-
 bool TextAccess::checkIndexInRange(const uint32_t index) const {
   if(index < 1) {
     LOG_WARNING(fmt::format("Line numbers start with one, is ", index));
     return false;
-  } else if(index > m_lines.size()) {
-    LOG_WARNING(fmt::format("Tried to access index {}. Maximum index is {}", index, m_lines.size()));
+  } else if(index > getLineCount()) {
+    LOG_WARNING(fmt::format("Tried to access index {}. Maximum index is {}", index, getLineCount()));
     return false;
   }
 
@@ -193,4 +210,4 @@ bool TextAccess::checkIndexIntervalInRange(const uint32_t firstIndex, const uint
   }
 
   return true;
-}
\ No newline at end of file
+}
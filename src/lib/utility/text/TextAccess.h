@@ -1,15 +1,22 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "FilePath.h"
 
+/**
+ * Line based read access to a text.
+ *
+ * The text is kept as one buffer and the offsets of its lines are only determined when a line is first accessed, so
+ * creating an instance for a whole file allocates once no matter how many lines it has.
+ */
 class TextAccess final {
 public:
   static std::shared_ptr<TextAccess> createFromFile(const FilePath& filePath);
-  static std::shared_ptr<TextAccess> createFromString(const std::string& text, const FilePath& filePath = FilePath());
+  static std::shared_ptr<TextAccess> createFromString(std::string text, const FilePath& filePath = FilePath());
   static std::shared_ptr<TextAccess> createFromLines(const std::vector<std::string>& lines, const FilePath& filePath = FilePath());
 
   TextAccess(const TextAccess&) = delete;
@@ -23,6 +30,9 @@ public:
 
   [[nodiscard]] FilePath getFilePath() const;
 
+  // size of the text buffer in bytes
+  [[nodiscard]] size_t getByteSize() const;
+
   /**
    * @param lineNumber: starts with 1
    */
@@ -34,19 +44,29 @@ public:
    */
   std::vector<std::string> getLines(const uint32_t firstLineNumber, const uint32_t lastLineNumber);
 
-  const std::vector<std::string>& getAllLines() const;
+  [[nodiscard]] std::vector<std::string> getAllLines() const;
 
   [[nodiscard]] std::string getText() const;
 
 private:
-  static std::vector<std::string> readFile(const FilePath& filePath);
-  static std::vector<std::string> splitStringByLines(const std::string& text);
+  static std::string readFile(const FilePath& filePath);
 
   TextAccess();
 
+  const std::vector<size_t>& getLineBegins() const;
+  std::string getLineByIndex(const size_t index) const;
+
   bool checkIndexInRange(const uint32_t index) const;
   bool checkIndexIntervalInRange(const uint32_t firstIndex, const uint32_t lastIndex) const;
 
   FilePath m_filePath;
-  std::vector<std::string> m_lines;
-};
\ No newline at end of file
+  std::string m_text;
+
+  // files end lines at "\n", "\r\n" or "\r" and every returned line ends with "\n", strings end lines at "\n" only and
+  // return them unchanged
+  bool m_normalizeLineEndings = false;
+
+  // begin of every line followed by the end of the text
+  mutable std::vector<size_t> m_lineBegins;
+  mutable std::once_flag m_lineBeginsFlag;
+};
@@ -0,0 +1,33 @@
+#pragma once
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace utility {
+template <typename T>
+inline void hashCombine(size_t& seed, const T& value) {
+  seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// spreads the entropy of weak hashes (e.g. identity hashes of integers) over all bits
+inline uint64_t hashMix(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// FNV-1a, unlike std::hash the result is the same on every platform and run, so it can be persisted
+inline uint64_t getStableHash(std::string_view data) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for(const char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+}    // namespace utility
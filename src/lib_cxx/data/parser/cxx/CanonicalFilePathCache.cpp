@@ -1,12 +1,23 @@
 #include "CanonicalFilePathCache.h"
 
+#include <string_view>
+
 #include <clang/AST/ASTContext.h>
 #include <clang/Basic/FileManager.h>
+#include <clang/Lex/MacroInfo.h>
 
+#include "IndexedHeaderRegistry.h"
 #include "utilityClang.h"
 #include "utilityString.h"
 
-CanonicalFilePathCache::CanonicalFilePathCache(std::shared_ptr<FileRegister> fileRegister) : m_fileRegister(fileRegister) {}
+CanonicalFilePathCache::CanonicalFilePathCache(std::shared_ptr<FileRegister> fileRegister,
+                                               std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry,
+                                               Id indexedHeaderOwnerId,
+                                               std::string translationUnitContext)
+    : m_fileRegister(fileRegister)
+    , m_indexedHeaderRegistry(std::move(indexedHeaderRegistry))
+    , m_indexedHeaderOwnerId(indexedHeaderOwnerId)
+    , m_translationUnitContext(std::move(translationUnitContext)) {}
 
 std::shared_ptr<FileRegister> CanonicalFilePathCache::getFileRegister() const {
   return m_fileRegister;
@@ -128,3 +139,90 @@ bool CanonicalFilePathCache::isProjectFile(const clang::FileID& fileId, const cl
   m_isProjectFileMap.emplace(fileId, ret);
   return ret;
 }
+
+void CanonicalFilePathCache::addMacroUsage(const clang::FileID& fileId,
+                                           const clang::IdentifierInfo* macroName,
+                                           const clang::MacroInfo* macroInfo) {
+  if(m_indexedHeaderRegistry && fileId.isValid() && macroName != nullptr) {
+    m_macroUsages[fileId].emplace(macroName, macroInfo);
+  }
+}
+
+bool CanonicalFilePathCache::isIndexedByOtherTranslationUnit(const clang::FileID& fileId,
+                                                             const clang::SourceManager& sourceManager,
+                                                             const clang::DeclContext* lexicalContext) {
+  if(!m_indexedHeaderRegistry || !fileId.isValid() || fileId == sourceManager.getMainFileID()) {
+    return false;
+  }
+
+  auto it = m_isIndexedByOtherTranslationUnitMap.find(fileId);
+  if(it != m_isIndexedByOtherTranslationUnitMap.end()) {
+    return it->second;
+  }
+
+  const FilePath filePath = getCanonicalFilePath(fileId, sourceManager);
+  if(filePath.empty()) {
+    return false;
+  }
+
+  // a header included several times in the same context is claimed once, with the macro context of all its inclusions
+  std::pair<FilePath, std::string> pathKey(filePath, getInclusionContext(fileId, sourceManager, lexicalContext));
+  auto pathIt = m_isIndexedByOtherTranslationUnitPathMap.find(pathKey);
+  if(pathIt == m_isIndexedByOtherTranslationUnitPathMap.end()) {
+    const bool ret = !m_indexedHeaderRegistry->claimHeader(getHeaderKey(filePath, fileId, sourceManager, pathKey.second),
+                                                           m_indexedHeaderOwnerId);
+    pathIt = m_isIndexedByOtherTranslationUnitPathMap.emplace(std::move(pathKey), ret).first;
+  }
+
+  m_isIndexedByOtherTranslationUnitMap.emplace(fileId, pathIt->second);
+  return pathIt->second;
+}
+
+std::string CanonicalFilePathCache::getInclusionContext(const clang::FileID& fileId,
+                                                        const clang::SourceManager& sourceManager,
+                                                        const clang::DeclContext* lexicalContext) const {
+  // the innermost enclosing declaration outside of the file, e.g. a namespace or class the header is included in
+  for(; lexicalContext != nullptr && !lexicalContext->isTranslationUnit(); lexicalContext = lexicalContext->getLexicalParent()) {
+    const clang::Decl* contextDecl = clang::Decl::castFromDeclContext(lexicalContext);
+    const clang::SourceLocation loc = sourceManager.getExpansionLoc(contextDecl->getBeginLoc());
+    if(loc.isValid() && sourceManager.getFileID(loc) == fileId) {
+      continue;
+    }
+
+    std::string context = contextDecl->getDeclKindName();
+    if(const auto* namedDecl = clang::dyn_cast<clang::NamedDecl>(contextDecl)) {
+      context += ' ' + namedDecl->getQualifiedNameAsString();
+    }
+    return context;
+  }
+  return {};
+}
+
+std::string CanonicalFilePathCache::getHeaderKey(const FilePath& filePath,
+                                                 const clang::FileID& fileId,
+                                                 const clang::SourceManager& sourceManager,
+                                                 const std::string& inclusionContext) {
+  // macros are identified by their definition location, a different definition or an undefined macro changes the key
+  std::set<std::string> macroUsages;
+  for(const auto& [usageFileId, usages] : m_macroUsages) {
+    if(usageFileId != fileId && getCanonicalFilePath(usageFileId, sourceManager) != filePath) {
+      continue;
+    }
+
+    for(const auto& [macroName, macroInfo] : usages) {
+      macroUsages.insert(macroName->getName().str() + '@' +
+                         (macroInfo != nullptr ? macroInfo->getDefinitionLoc().printToString(sourceManager) : "-"));
+    }
+  }
+
+  std::string macroContext = m_translationUnitContext;
+  for(const std::string& macroUsage : macroUsages) {
+    macroContext += '\n' + macroUsage;
+  }
+
+  const llvm::StringRef content = sourceManager.getBufferData(fileId);
+
+  return utility::encodeToUtf8(filePath.wstr()) + '\n' +
+      std::to_string(std::hash<std::string_view>()(std::string_view(content.data(), content.size()))) + '\n' +
+      std::to_string(std::hash<std::string>()(macroContext)) + '\n' + inclusionContext;
+}
@@ -2,6 +2,7 @@
 #define CANONICAL_FILE_PATH_CACHE_H
 
 #include <map>
+#include <set>
 #include <string>
 
 #include <clang/AST/Decl.h>
@@ -12,9 +13,19 @@
 #include "FileRegister.h"
 #include "types.h"
 
+class IndexedHeaderRegistry;
+
+namespace clang {
+class IdentifierInfo;
+class MacroInfo;
+}    // namespace clang
+
 class CanonicalFilePathCache {
 public:
-  CanonicalFilePathCache(std::shared_ptr<FileRegister> fileRegister);
+  CanonicalFilePathCache(std::shared_ptr<FileRegister> fileRegister,
+                         std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry = nullptr,
+                         Id indexedHeaderOwnerId = 0,
+                         std::string translationUnitContext = {});
 
   std::shared_ptr<FileRegister> getFileRegister() const;
 
@@ -33,7 +44,24 @@ public:
 
   bool isProjectFile(const clang::FileID& fileId, const clang::SourceManager& sourceManager);
 
+  // macros used within a file make up the macro context the file was parsed in, macroInfo is null for undefined macros
+  void addMacroUsage(const clang::FileID& fileId, const clang::IdentifierInfo* macroName, const clang::MacroInfo* macroInfo);
+
+  // claims the header for this translation unit on first call, only valid once preprocessing finished
+  // lexicalContext is the declaration context of a declaration within the file, it tells where the file was included
+  bool isIndexedByOtherTranslationUnit(const clang::FileID& fileId,
+                                       const clang::SourceManager& sourceManager,
+                                       const clang::DeclContext* lexicalContext);
+
 private:
+  std::string getInclusionContext(const clang::FileID& fileId,
+                                  const clang::SourceManager& sourceManager,
+                                  const clang::DeclContext* lexicalContext) const;
+  std::string getHeaderKey(const FilePath& filePath,
+                           const clang::FileID& fileId,
+                           const clang::SourceManager& sourceManager,
+                           const std::string& inclusionContext);
+
   std::shared_ptr<FileRegister> m_fileRegister;
 
   std::map<clang::FileID, FilePath> m_fileIdMap;
@@ -44,6 +72,13 @@ private:
   std::unordered_map<std::wstring, Id> m_fileStringSymbolIdMap;
 
   std::map<clang::FileID, bool> m_isProjectFileMap;
+
+  std::shared_ptr<IndexedHeaderRegistry> m_indexedHeaderRegistry;
+  Id m_indexedHeaderOwnerId;
+  std::string m_translationUnitContext;
+  std::map<clang::FileID, std::set<std::pair<const clang::IdentifierInfo*, const clang::MacroInfo*>>> m_macroUsages;
+  std::map<clang::FileID, bool> m_isIndexedByOtherTranslationUnitMap;
+  std::map<std::pair<FilePath, std::string>, bool> m_isIndexedByOtherTranslationUnitPathMap;
 };
 
 #endif    // CANONICAL_FILE_PATH_CACHE_H
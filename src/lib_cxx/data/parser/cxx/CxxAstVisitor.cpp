@@ -136,7 +136,14 @@ bool CxxAstVisitor::TraverseDecl(clang::Decl* decl) {
         m_canonicalFilePathCache->addFileSymbolId(fileId, filePath, symbolId);
       }
 
+      // declarations of headers another translation unit already recorded in the same macro and lexical context are skipped,
+      // except for implicit template instantiations that depend on the template arguments of this translation unit
       traverse = isLocatedInProjectFile(loc);
+      if(traverse && !utility::isPartOfImplicitTemplateInstantiation(decl) &&
+         m_canonicalFilePathCache->isIndexedByOtherTranslationUnit(fileId, sourceManager, decl->getLexicalDeclContext())) {
+        traverse = false;
+        traverseImplicitInstantiations(decl);
+      }
     }
   }
 
@@ -414,6 +421,39 @@ void CxxAstVisitor::traverseDeclContextHelper(clang::DeclContext* d) {
   }
 }
 
+// same as the instantiations Base::TraverseDecl(..) visits for templates, used for templates that are skipped otherwise
+void CxxAstVisitor::traverseImplicitInstantiations(clang::Decl* d) {
+  if(auto* classTemplateDecl = clang::dyn_cast<clang::ClassTemplateDecl>(d)) {
+    if(classTemplateDecl == classTemplateDecl->getCanonicalDecl()) {
+      for(clang::ClassTemplateSpecializationDecl* specializationDecl : classTemplateDecl->specializations()) {
+        if(specializationDecl->getSpecializationKind() == clang::TSK_ImplicitInstantiation) {
+          TraverseDecl(specializationDecl);
+        }
+      }
+    }
+  } else if(auto* functionTemplateDecl = clang::dyn_cast<clang::FunctionTemplateDecl>(d)) {
+    if(functionTemplateDecl == functionTemplateDecl->getCanonicalDecl()) {
+      for(clang::FunctionDecl* specializationDecl : functionTemplateDecl->specializations()) {
+        if(specializationDecl->getTemplateSpecializationKind() == clang::TSK_ImplicitInstantiation) {
+          TraverseDecl(specializationDecl);
+        }
+      }
+    }
+  } else if(auto* varTemplateDecl = clang::dyn_cast<clang::VarTemplateDecl>(d)) {
+    if(varTemplateDecl == varTemplateDecl->getCanonicalDecl()) {
+      for(clang::VarTemplateSpecializationDecl* specializationDecl : varTemplateDecl->specializations()) {
+        if(specializationDecl->getSpecializationKind() == clang::TSK_ImplicitInstantiation) {
+          TraverseDecl(specializationDecl);
+        }
+      }
+    }
+  } else if(clang::isa<clang::NamespaceDecl>(d) || clang::isa<clang::LinkageSpecDecl>(d) || clang::isa<clang::CXXRecordDecl>(d)) {
+    for(clang::Decl* child : clang::cast<clang::DeclContext>(d)->decls()) {
+      traverseImplicitInstantiations(child);
+    }
+  }
+}
+
 bool CxxAstVisitor::TraverseCallCommon(clang::CallExpr* s) {
   FOREACH_COMPONENT(beginTraverseCallCommonCallee());
   TraverseStmt(s->getCallee());
@@ -104,6 +104,7 @@ public:
 #undef OPERATOR
 
   void traverseDeclContextHelper(clang::DeclContext* d);
+  void traverseImplicitInstantiations(clang::Decl* d);
   bool TraverseCallCommon(clang::CallExpr* s);
   bool TraverseAssignCommon(clang::BinaryOperator* s);
 
@@ -18,14 +18,18 @@
 #include "ClangInvocationInfo.h"
 #include "CxxCompilationDatabaseSingle.h"
 #include "CxxDiagnosticConsumer.h"
+#include "CxxSharedPreambleDetector.h"
 #include "FilePath.h"
 #include "FileRegister.h"
+#include "IndexedHeaderRegistry.h"
 #include "IndexerCommandCxx.h"
+#include "IndexerStateInfo.h"
 #include "ParserClient.h"
 #include "SingleFrontendActionFactory.h"
 #include "TextAccess.h"
 #include "logging.h"
 #include "utility.h"
+#include "utilitySourceGroupCxx.h"
 #include "utilityString.h"
 
 namespace {
@@ -37,6 +41,28 @@ std::vector<std::string> appendFilePath(const std::vector<std::string>& args, ll
   return utility::concat(args, {filePath.str()});
 }
 
+// a precompiled header that failed to build must not fail the translation units using it, they parse the headers instead
+void removeMissingIncludePch(std::vector<std::wstring>& args) {
+  for(size_t i = 0; i + 1 < args.size(); i++) {
+    if(args[i] == L"-include-pch" && !FilePath(args[i + 1]).exists()) {
+      LOG_WARNING_W(L"Precompiled header \"" + args[i + 1] + L"\" does not exist, parsing without it.");
+      utility::removeIncludePchFlag(args);
+      return;
+    }
+  }
+}
+
+// flags and working directory decide how the included headers are preprocessed, the source file and outputs don't
+std::string getTranslationUnitContext(const std::vector<std::wstring>& args,
+                                      const FilePath& sourceFilePath,
+                                      const FilePath& workingDirectory) {
+  std::wstring context = workingDirectory.wstr();
+  for(const std::wstring& flag : CxxSharedPreambleDetector::getPreambleCompilerFlags(args, sourceFilePath)) {
+    context += L'\n' + flag;
+  }
+  return utility::encodeToUtf8(context);
+}
+
 // custom implementation of clang::runToolOnCodeWithArgs which also sets our custom DiagnosticConsumer
 bool runToolOnCodeWithArgs(
     clang::DiagnosticConsumer* DiagConsumer,
@@ -124,11 +150,14 @@ void CxxParser::buildIndex(const std::shared_ptr<IndexerCommandCxx>& indexerComm
   if(!args.empty() && !utility::isPrefix<std::wstring>(L"-", args.front())) {
     args.erase(args.begin());
   }
+  removeMissingIncludePch(args);
   compileCommand.CommandLine = getCommandlineArgumentsEssential(args);
   compileCommand.CommandLine = prependSyntaxOnlyToolArgs(compileCommand.CommandLine);
 
   CxxCompilationDatabaseSingle compilationDatabase(compileCommand);
-  runTool(&compilationDatabase, indexerCommand->getSourceFilePath());
+  runTool(&compilationDatabase,
+          indexerCommand->getSourceFilePath(),
+          getTranslationUnitContext(args, indexerCommand->getSourceFilePath(), indexerCommand->getWorkingDirectory()));
 }
 
 void CxxParser::buildIndex(const std::wstring& fileName,
@@ -144,12 +173,18 @@ void CxxParser::buildIndex(const std::wstring& fileName,
   runToolOnCodeWithArgs(diagnostics.get(), std::move(action), fileContent->getText(), args, utility::encodeToUtf8(fileName));
 }
 
-void CxxParser::runTool(clang::tooling::CompilationDatabase* pCompilationDatabase, const FilePath& sourceFilePath) {
+void CxxParser::runTool(clang::tooling::CompilationDatabase* pCompilationDatabase,
+                        const FilePath& sourceFilePath,
+                        const std::string& translationUnitContext) {
   initializeLLVM();
 
   clang::tooling::ClangTool tool(*pCompilationDatabase, std::vector<std::string>(1, utility::encodeToUtf8(sourceFilePath.wstr())));
 
-  auto pCanonicalFilePathCache = std::make_shared<CanonicalFilePathCache>(m_fileRegister);
+  auto pCanonicalFilePathCache = std::make_shared<CanonicalFilePathCache>(
+      m_fileRegister,
+      m_indexerStateInfo ? m_indexerStateInfo->indexedHeaderRegistry : nullptr,
+      m_indexerStateInfo ? m_indexerStateInfo->indexedHeaderOwnerId : 0,
+      translationUnitContext);
   auto pDiagnostics = getDiagnostics(sourceFilePath, pCanonicalFilePathCache, true);
 
   tool.setDiagnosticConsumer(pDiagnostics.get());
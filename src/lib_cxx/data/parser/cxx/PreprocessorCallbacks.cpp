@@ -78,36 +78,40 @@ void PreprocessorCallbacks::MacroDefined(const clang::Token& macroNameToken, con
 }
 
 void PreprocessorCallbacks::MacroUndefined(const clang::Token& macroNameToken,
-                                           const clang::MacroDefinition& /*macroDefinition*/,
+                                           const clang::MacroDefinition& macroDefinition,
                                            const clang::MacroDirective* /*macroUndefinition*/) {
-  onMacroUsage(macroNameToken);
+  onMacroUsage(macroNameToken, macroDefinition);
 }
 
 void PreprocessorCallbacks::Defined(const clang::Token& macroNameToken,
-                                    const clang::MacroDefinition& /*macroDefinition*/,
+                                    const clang::MacroDefinition& macroDefinition,
                                     clang::SourceRange /*range*/) {
-  onMacroUsage(macroNameToken);
+  onMacroUsage(macroNameToken, macroDefinition);
 }
 
 void PreprocessorCallbacks::Ifdef(clang::SourceLocation /*location*/,
                                   const clang::Token& macroNameToken,
-                                  const clang::MacroDefinition& /*macroDefinition*/) {
-  onMacroUsage(macroNameToken);
+                                  const clang::MacroDefinition& macroDefinition) {
+  onMacroUsage(macroNameToken, macroDefinition);
 }
 void PreprocessorCallbacks::Ifndef(clang::SourceLocation /*location*/,
                                    const clang::Token& macroNameToken,
-                                   const clang::MacroDefinition& /*macroDefinition*/) {
-  onMacroUsage(macroNameToken);
+                                   const clang::MacroDefinition& macroDefinition) {
+  onMacroUsage(macroNameToken, macroDefinition);
 }
 
 void PreprocessorCallbacks::MacroExpands(const clang::Token& macroNameToken,
-                                         const clang::MacroDefinition& /*macroDirective*/,
+                                         const clang::MacroDefinition& macroDirective,
                                          clang::SourceRange /*range*/,
                                          const clang::MacroArgs* /*args*/) {
-  onMacroUsage(macroNameToken);
+  onMacroUsage(macroNameToken, macroDirective);
 }
 
-void PreprocessorCallbacks::onMacroUsage(const clang::Token& macroNameToken) {
+void PreprocessorCallbacks::onMacroUsage(const clang::Token& macroNameToken, const clang::MacroDefinition& macroDefinition) {
+  m_canonicalFilePathCache->addMacroUsage(m_sourceManager.getFileID(m_sourceManager.getExpansionLoc(macroNameToken.getLocation())),
+                                          macroNameToken.getIdentifierInfo(),
+                                          macroDefinition.getMacroInfo());
+
   if(m_currentPathIsProjectFile && isLocatedInProjectFile(macroNameToken.getLocation())) {
     const ParseLocation loc = getParseLocation(macroNameToken);
 
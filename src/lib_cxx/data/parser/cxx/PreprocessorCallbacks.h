@@ -55,7 +55,7 @@ public:
                     const clang::MacroArgs* args) override;
 
 private:
-  void onMacroUsage(const clang::Token& macroNameToken);
+  void onMacroUsage(const clang::Token& macroNameToken, const clang::MacroDefinition& macroDefinition);
 
   ParseLocation getParseLocation(const clang::Token& macroNameToc) const;
   ParseLocation getParseLocation(const clang::MacroInfo* macroNameToc) const;
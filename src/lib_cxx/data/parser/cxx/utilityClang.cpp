@@ -41,6 +41,25 @@ bool utility::isImplicit(const clang::Decl* d) {
   return isImplicit(clang::dyn_cast_or_null<clang::Decl>(d->getDeclContext()));
 }
 
+bool utility::isPartOfImplicitTemplateInstantiation(const clang::Decl* d) {
+  // members of an instantiation are declared within its semantic context
+  for(; d != nullptr; d = clang::dyn_cast_or_null<clang::Decl>(d->getDeclContext())) {
+    clang::TemplateSpecializationKind kind = clang::TSK_Undeclared;
+    if(const auto* recordDecl = clang::dyn_cast<clang::CXXRecordDecl>(d)) {
+      kind = recordDecl->getTemplateSpecializationKind();
+    } else if(const auto* functionDecl = clang::dyn_cast<clang::FunctionDecl>(d)) {
+      kind = functionDecl->getTemplateSpecializationKind();
+    } else if(const auto* varDecl = clang::dyn_cast<clang::VarDecl>(d)) {
+      kind = varDecl->getTemplateSpecializationKind();
+    }
+
+    if(kind == clang::TSK_ImplicitInstantiation) {
+      return true;
+    }
+  }
+  return false;
+}
+
 AccessKind utility::convertAccessSpecifier(clang::AccessSpecifier access) {
   switch(access) {
   case clang::AS_public:
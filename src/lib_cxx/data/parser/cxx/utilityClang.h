@@ -20,6 +20,7 @@ namespace utility {
 template <typename T>
 const T* getFirstDecl(const T* decl);
 bool isImplicit(const clang::Decl* d);
+bool isPartOfImplicitTemplateInstantiation(const clang::Decl* d);
 AccessKind convertAccessSpecifier(clang::AccessSpecifier access);
 SymbolKind convertTagKind(const clang::TagTypeKind tagKind);
 bool isLocalVariable(const clang::VarDecl* d);
@@ -1,5 +1,7 @@
 #include "SourceGroupCxxCdb.h"
 
+#include <map>
+
 #include <clang/Tooling/JSONCompilationDatabase.h>
 #include <clang/Tooling/Tooling.h>
 
@@ -78,6 +80,25 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
   const std::set<FilePathFilter> excludeFilters = utility::toSet(m_settings->getExcludeFiltersExpandedAndAbsolute());
   const std::set<FilePath>& sourceFilePaths = getAllSourceFilePaths(cdb);
 
+  // include prefixes shared between translation units are only precompiled if no explicit pch is used
+  const bool detectSharedPreambles = includePchFlags.empty() &&
+      ApplicationSettings::getInstance()->getCxxSharedPreamblesEnabled();
+  CxxSharedPreambleDetector sharedPreambleDetector;
+
+  struct CommandInfo {
+    FilePath sourcePath;
+    FilePath workingDirectory;
+    std::vector<std::wstring> compilerFlags;
+  };
+  std::vector<CommandInfo> commandInfos;
+
+  struct PreambleCandidate {
+    FilePath sourcePath;
+    FilePath workingDirectory;
+    std::vector<std::wstring> preambleCompilerFlags;
+  };
+  std::vector<PreambleCandidate> preambleCandidates;
+
   for(const clang::tooling::CompileCommand& command : cdb->getAllCompileCommands()) {
     FilePath sourcePath = FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
     if(!sourcePath.isAbsolute()) {
@@ -95,17 +116,57 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 
       if(command.CommandLine.size() != cdbFlags.size()) {
         utility::append(cdbFlags, includePchFlags);
+      } else if(detectSharedPreambles) {
+        preambleCandidates.push_back(
+            {sourcePath,
+             FilePath(utility::decodeFromUtf8(command.Directory)),
+             utility::concat(CxxSharedPreambleDetector::getPreambleCompilerFlags(cdbFlags, sourcePath), compilerFlags)});
       }
 
-      provider->addCommand(std::make_shared<IndexerCommandCxx>(sourcePath,
-                                                               utility::concat(indexedHeaderPaths, {sourcePath}),
-                                                               excludeFilters,
-                                                               std::set<FilePathFilter>(),
-                                                               FilePath(utility::decodeFromUtf8(command.Directory)),
-                                                               utility::concat(cdbFlags, compilerFlags)));
+      commandInfos.push_back(
+          {sourcePath, FilePath(utility::decodeFromUtf8(command.Directory)), utility::concat(cdbFlags, compilerFlags)});
+    }
+  }
+
+  if(!preambleCandidates.empty()) {
+    std::vector<FilePath> candidatePaths;
+    for(const PreambleCandidate& candidate : preambleCandidates) {
+      candidatePaths.push_back(candidate.sourcePath);
+    }
+
+    std::vector<std::vector<std::string>> leadingIncludes = CxxSharedPreambleDetector::readLeadingBracketIncludes(
+        candidatePaths);
+    for(size_t i = 0; i < preambleCandidates.size(); i++) {
+      sharedPreambleDetector.addSourceFile(preambleCandidates[i].sourcePath,
+                                           preambleCandidates[i].workingDirectory,
+                                           std::move(preambleCandidates[i].preambleCompilerFlags),
+                                           std::move(leadingIncludes[i]));
     }
   }
 
+  m_sharedPreambles = sharedPreambleDetector.getSharedPreambles(m_settings->getPchDependenciesDirectoryPath());
+
+  std::map<FilePath, FilePath> sourceFilePathToPchFilePath;
+  for(const CxxSharedPreamble& preamble : m_sharedPreambles) {
+    for(const FilePath& sourceFilePath : preamble.sourceFilePaths) {
+      sourceFilePathToPchFilePath.emplace(sourceFilePath, preamble.pchFilePath);
+    }
+  }
+
+  for(CommandInfo& commandInfo : commandInfos) {
+    auto it = sourceFilePathToPchFilePath.find(commandInfo.sourcePath);
+    if(it != sourceFilePathToPchFilePath.end()) {
+      utility::append(commandInfo.compilerFlags, {L"-fallow-pch-with-compiler-errors", L"-include-pch", it->second.wstr()});
+    }
+
+    provider->addCommand(std::make_shared<IndexerCommandCxx>(commandInfo.sourcePath,
+                                                             utility::concat(indexedHeaderPaths, {commandInfo.sourcePath}),
+                                                             excludeFilters,
+                                                             std::set<FilePathFilter>(),
+                                                             commandInfo.workingDirectory,
+                                                             commandInfo.compilerFlags));
+  }
+
   provider->logStats();
 
   return provider;
@@ -118,7 +179,11 @@ std::vector<std::shared_ptr<IndexerCommand>> SourceGroupCxxCdb::getIndexerComman
 std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(std::shared_ptr<StorageProvider> storageProvider,
                                                          std::shared_ptr<DialogView> dialogView) const {
   if(m_settings->getPchInputFilePath().empty()) {
-    return std::make_shared<TaskLambda>([]() {});
+    return utility::createBuildSharedPreamblesTask(m_sharedPreambles,
+                                                   utility::toSet(m_settings->getIndexedHeaderPathsExpandedAndAbsolute()),
+                                                   utility::toSet(m_settings->getExcludeFiltersExpandedAndAbsolute()),
+                                                   storageProvider,
+                                                   dialogView);
   }
 
   std::vector<std::wstring> compilerFlags;
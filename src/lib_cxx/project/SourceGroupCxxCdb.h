@@ -5,6 +5,7 @@
 #include <set>
 #include <vector>
 
+#include "CxxSharedPreambleDetector.h"
 #include "SourceGroup.h"
 
 class FilePath;
@@ -33,6 +34,9 @@ private:
   std::vector<std::wstring> getBaseCompilerFlags() const;
 
   std::shared_ptr<SourceGroupSettingsCxxCdb> m_settings;
+
+  // detected while the indexer commands are created, precompiled by the pre index task
+  mutable std::vector<CxxSharedPreamble> m_sharedPreambles;
 };
 
 #endif    // SOURCE_GROUP_CXX_CDB_H
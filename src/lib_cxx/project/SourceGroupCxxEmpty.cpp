@@ -4,6 +4,7 @@
 #include "CxxIndexerCommandProvider.h"
 #include "FileManager.h"
 #include "IndexerCommandCxx.h"
+#include "ProjectSettings.h"
 #include "RefreshInfo.h"
 #include "SourceGroupSettingsCEmpty.h"
 #include "SourceGroupSettingsCppEmpty.h"
@@ -33,7 +34,7 @@ std::set<FilePath> SourceGroupCxxEmpty::filterToContainedFilePaths(const std::se
 }
 
 std::set<FilePath> SourceGroupCxxEmpty::getAllSourceFilePaths() const {
-  FileManager fileManager;
+  FileManager fileManager(getDirectorySnapshot());
   if(std::shared_ptr<SourceGroupSettingsCEmpty> settings = std::dynamic_pointer_cast<SourceGroupSettingsCEmpty>(m_settings)) {
     fileManager.update(settings->getSourcePathsExpandedAndAbsolute(),
                        settings->getExcludeFiltersExpandedAndAbsolute(),
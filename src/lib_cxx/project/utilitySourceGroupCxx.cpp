@@ -1,11 +1,14 @@
 #include "utilitySourceGroupCxx.h"
 
+#include <fstream>
+
 #include <clang/Tooling/JSONCompilationDatabase.h>
 
 #include "CanonicalFilePathCache.h"
 #include "CxxCompilationDatabaseSingle.h"
 #include "CxxDiagnosticConsumer.h"
 #include "CxxParser.h"
+#include "CxxSharedPreambleDetector.h"
 #include "DialogView.h"
 #include "FilePathFilter.h"
 #include "FileRegister.h"
@@ -19,6 +22,52 @@
 #include "logging.h"
 #include "utility.h"
 
+namespace {
+void buildPch(const FilePath& pchInputFilePath,
+              const FilePath& pchOutputFilePath,
+              const FilePath& workingDirectory,
+              const std::vector<std::wstring>& compilerFlags,
+              const std::set<FilePath>& indexedPaths,
+              const std::set<FilePathFilter>& excludeFilters,
+              std::shared_ptr<StorageProvider> storageProvider) {
+  CxxParser::initializeLLVM();
+
+  if(!pchOutputFilePath.getParentDirectory().exists()) {
+    FileSystem::createDirectory(pchOutputFilePath.getParentDirectory());
+  }
+
+  std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+  std::shared_ptr<ParserClientImpl> client = std::make_shared<ParserClientImpl>(storage.get());
+
+  std::shared_ptr<FileRegister> fileRegister = std::make_shared<FileRegister>(pchInputFilePath, indexedPaths, excludeFilters);
+
+  std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache = std::make_shared<CanonicalFilePathCache>(fileRegister);
+
+  clang::tooling::CompileCommand pchCommand;
+  pchCommand.Filename = utility::encodeToUtf8(pchInputFilePath.fileName());
+  pchCommand.Directory = workingDirectory.str();
+  // DON'T use "-fsyntax-only" here because it will cause the output file to be erased
+  pchCommand.CommandLine = utility::concat({"clang-tool"}, CxxParser::getCommandlineArgumentsEssential(compilerFlags));
+
+  CxxCompilationDatabaseSingle compilationDatabase(pchCommand);
+  clang::tooling::ClangTool tool(compilationDatabase, {utility::encodeToUtf8(pchInputFilePath.wstr())});
+  auto* action = new GeneratePCHAction(client, canonicalFilePathCache);
+
+  llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> options = new clang::DiagnosticOptions();
+  CxxDiagnosticConsumer diagnostics(llvm::errs(), &*options, client, canonicalFilePathCache, pchInputFilePath, true);
+
+  tool.setDiagnosticConsumer(&diagnostics);
+  tool.clearArgumentsAdjusters();
+  tool.run(new SingleFrontendActionFactory(action));
+
+  storageProvider->insert(storage);
+}
+
+std::vector<std::wstring> getEmitPchFlags(const FilePath& pchInputFilePath, const FilePath& pchOutputFilePath) {
+  return {pchInputFilePath.wstr(), L"-emit-pch", L"-o", pchOutputFilePath.wstr()};
+}
+}    // namespace
+
 namespace utility {
 std::shared_ptr<Task> createBuildPchTask(const SourceGroupSettingsWithCxxPchOptions* settings,
                                          std::vector<std::wstring> compilerFlags,
@@ -40,48 +89,69 @@ std::shared_ptr<Task> createBuildPchTask(const SourceGroupSettingsWithCxxPchOpti
       pchDependenciesDirectoryPath.getConcatenated(pchInputFilePath.fileName()).replaceExtension(L"pch");
 
   utility::removeIncludePchFlag(compilerFlags);
-  compilerFlags.push_back(pchInputFilePath.wstr());
-  compilerFlags.emplace_back(L"-emit-pch");
-  compilerFlags.emplace_back(L"-o");
-  compilerFlags.push_back(pchOutputFilePath.wstr());
+  utility::append(compilerFlags, getEmitPchFlags(pchInputFilePath, pchOutputFilePath));
 
   return std::make_shared<TaskLambda>([dialogView, storageProvider, pchInputFilePath, pchOutputFilePath, compilerFlags]() {
     dialogView->showUnknownProgressDialog(L"Preparing Indexing", L"Processing Precompiled Headers");
     LOG_INFO_W(L"Generating precompiled header output for input file \"" + pchInputFilePath.wstr() + L"\" at location \"" +
              pchOutputFilePath.wstr() + L"\"");
 
-    CxxParser::initializeLLVM();
-
-    if(!pchOutputFilePath.getParentDirectory().exists()) {
-      FileSystem::createDirectory(pchOutputFilePath.getParentDirectory());
-    }
-
-    std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
-    std::shared_ptr<ParserClientImpl> client = std::make_shared<ParserClientImpl>(storage.get());
-
-    std::shared_ptr<FileRegister> fileRegister = std::make_shared<FileRegister>(
-        pchInputFilePath, std::set<FilePath> {pchInputFilePath}, std::set<FilePathFilter> {});
+    buildPch(pchInputFilePath,
+             pchOutputFilePath,
+             pchOutputFilePath.getParentDirectory(),
+             compilerFlags,
+             {pchInputFilePath},
+             {},
+             storageProvider);
+  });
+}
 
-    std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache = std::make_shared<CanonicalFilePathCache>(fileRegister);
+std::shared_ptr<Task> createBuildSharedPreamblesTask(std::vector<CxxSharedPreamble> preambles,
+                                                     std::set<FilePath> indexedHeaderPaths,
+                                                     std::set<FilePathFilter> excludeFilters,
+                                                     std::shared_ptr<StorageProvider> storageProvider,
+                                                     std::shared_ptr<DialogView> dialogView) {
+  if(preambles.empty()) {
+    return std::make_shared<TaskLambda>([]() {});
+  }
 
-    clang::tooling::CompileCommand pchCommand;
-    pchCommand.Filename = utility::encodeToUtf8(pchInputFilePath.fileName());
-    pchCommand.Directory = pchOutputFilePath.getParentDirectory().str();
-    // DON'T use "-fsyntax-only" here because it will cause the output file to be erased
-    pchCommand.CommandLine = utility::concat({"clang-tool"}, CxxParser::getCommandlineArgumentsEssential(compilerFlags));
+  return std::make_shared<TaskLambda>([preambles = std::move(preambles),
+                                       indexedHeaderPaths = std::move(indexedHeaderPaths),
+                                       excludeFilters = std::move(excludeFilters),
+                                       storageProvider,
+                                       dialogView]() {
+    dialogView->showUnknownProgressDialog(L"Preparing Indexing", L"Precompiling Shared Headers");
 
-    CxxCompilationDatabaseSingle compilationDatabase(pchCommand);
-    clang::tooling::ClangTool tool(compilationDatabase, {utility::encodeToUtf8(pchInputFilePath.wstr())});
-    auto* action = new GeneratePCHAction(client, canonicalFilePathCache);
+    for(const CxxSharedPreamble& preamble : preambles) {
+      LOG_INFO_W(L"Precompiling shared preamble of " + std::to_wstring(preamble.sourceFilePaths.size()) +
+                 L" source files at location \"" + preamble.pchFilePath.wstr() + L"\"");
 
-    llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> options = new clang::DiagnosticOptions();
-    CxxDiagnosticConsumer diagnostics(llvm::errs(), &*options, client, canonicalFilePathCache, pchInputFilePath, true);
+      if(!preamble.headerFilePath.getParentDirectory().exists()) {
+        FileSystem::createDirectory(preamble.headerFilePath.getParentDirectory());
+      }
 
-    tool.setDiagnosticConsumer(&diagnostics);
-    tool.clearArgumentsAdjusters();
-    tool.run(new SingleFrontendActionFactory(action));
+      FileSystem::remove(preamble.pchFilePath);
+      {
+        std::ofstream headerFile(preamble.headerFilePath.str(), std::ios::trunc);
+        for(const std::string& includeDirective : preamble.includeDirectives) {
+          headerFile << includeDirective << '\n';
+        }
+        if(!headerFile) {
+          LOG_ERROR_W(L"Unable to write shared preamble header \"" + preamble.headerFilePath.wstr() + L"\"");
+          continue;
+        }
+      }
 
-    storageProvider->insert(storage);
+      // the generated header itself is not part of the project, only the indexed headers it includes are recorded
+      // relative include paths have to resolve like for the translation units using the preamble
+      buildPch(preamble.headerFilePath,
+               preamble.pchFilePath,
+               preamble.workingDirectory.empty() ? preamble.pchFilePath.getParentDirectory() : preamble.workingDirectory,
+               utility::concat(preamble.compilerFlags, getEmitPchFlags(preamble.headerFilePath, preamble.pchFilePath)),
+               indexedHeaderPaths,
+               excludeFilters,
+               storageProvider);
+    }
   });
 }
 
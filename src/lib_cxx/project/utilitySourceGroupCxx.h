@@ -2,6 +2,7 @@
 #define UTILITY_SOURCE_GROUP_CXX_H
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -9,8 +10,10 @@ namespace clang { namespace tooling {
 class JSONCompilationDatabase;
 }}    // namespace clang::tooling
 
+struct CxxSharedPreamble;
 class DialogView;
 class FilePath;
+class FilePathFilter;
 class SourceGroupSettingsWithCxxPchOptions;
 class StorageProvider;
 class Task;
@@ -21,6 +24,13 @@ std::shared_ptr<Task> createBuildPchTask(const SourceGroupSettingsWithCxxPchOpti
                                          std::shared_ptr<StorageProvider> storageProvider,
                                          std::shared_ptr<DialogView> dialogView);
 
+// precompiles every preamble into its pch file, the translation units include these via -include-pch
+std::shared_ptr<Task> createBuildSharedPreamblesTask(std::vector<CxxSharedPreamble> preambles,
+                                                     std::set<FilePath> indexedHeaderPaths,
+                                                     std::set<FilePathFilter> excludeFilters,
+                                                     std::shared_ptr<StorageProvider> storageProvider,
+                                                     std::shared_ptr<DialogView> dialogView);
+
 std::shared_ptr<clang::tooling::JSONCompilationDatabase> loadCDB(const FilePath& cdbPath, std::string* error = nullptr);
 bool containsIncludePchFlags(std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb);
 bool containsIncludePchFlag(const std::vector<std::string>& args);
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "CxxSharedPreambleDetector.h"
+
+TEST(CxxSharedPreambleDetector, leadingBracketIncludesSkipCommentsAndPragmaOnce) {
+  const std::vector<std::string> includes = CxxSharedPreambleDetector::getLeadingBracketIncludes({
+      "// license",
+      "/* multi",
+      "   line */",
+      "#pragma once",
+      "",
+      "#include <vector>",
+      "#  include   <QString>  // for names",
+      "#include \"local.h\"",
+      "#include <map>",
+  });
+
+  ASSERT_EQ(2U, includes.size());
+  EXPECT_EQ("#include <vector>", includes[0]);
+  EXPECT_EQ("#include <QString>", includes[1]);
+}
+
+TEST(CxxSharedPreambleDetector, leadingBracketIncludesStopAtDefines) {
+  const std::vector<std::string> includes = CxxSharedPreambleDetector::getLeadingBracketIncludes({
+      "#include <cstdio>",
+      "#define NOMINMAX",
+      "#include <windows.h>",
+  });
+
+  ASSERT_EQ(1U, includes.size());
+  EXPECT_EQ("#include <cstdio>", includes[0]);
+}
+
+TEST(CxxSharedPreambleDetector, preambleCompilerFlagsDropOutputsAndSourceFile) {
+  const std::vector<std::wstring> flags = CxxSharedPreambleDetector::getPreambleCompilerFlags(
+      {L"/usr/bin/clang++", L"-DFOO", L"-c", L"-o", L"foo.o", L"-MD", L"-MF", L"foo.d", L"-Iinclude", L"src/foo.cpp"},
+      FilePath(L"/project/src/foo.cpp"));
+
+  const std::vector<std::wstring> expected = {L"-DFOO", L"-Iinclude", L"-x", L"c++-header"};
+  EXPECT_EQ(expected, flags);
+}
+
+TEST(CxxSharedPreambleDetector, filesGetTheLongestSufficientlySharedPrefix) {
+  const std::vector<std::wstring> flags = {L"-DFOO", L"-x", L"c++-header"};
+  const FilePath dir(L"/build");
+
+  CxxSharedPreambleDetector detector;
+  detector.addSourceFile(FilePath(L"/src/a.cpp"), dir, flags, {"#include <vector>", "#include <map>", "#include <set>"});
+  detector.addSourceFile(FilePath(L"/src/b.cpp"), dir, flags, {"#include <vector>", "#include <map>"});
+  detector.addSourceFile(FilePath(L"/src/c.cpp"), dir, flags, {"#include <vector>", "#include <map>", "#include <string>"});
+  detector.addSourceFile(FilePath(L"/src/d.cpp"), dir, flags, {"#include <vector>"});
+  detector.addSourceFile(FilePath(L"/src/e.cpp"), dir, {L"-DBAR", L"-x", L"c++-header"}, {"#include <vector>"});
+
+  const std::vector<CxxSharedPreamble> preambles = detector.getSharedPreambles(FilePath(L"/pch"));
+  ASSERT_EQ(2U, preambles.size());
+
+  EXPECT_EQ(2U, preambles[0].includeDirectives.size());
+  EXPECT_EQ(3U, preambles[0].sourceFilePaths.size());
+  EXPECT_EQ(flags, preambles[0].compilerFlags);
+  EXPECT_EQ(L"/pch/shared_preamble_1.pch", preambles[0].pchFilePath.wstr());
+
+  EXPECT_EQ(1U, preambles[1].includeDirectives.size());
+  ASSERT_EQ(1U, preambles[1].sourceFilePaths.size());
+  EXPECT_EQ(L"d.cpp", preambles[1].sourceFilePaths.begin()->fileName());
+}
+
+TEST(CxxSharedPreambleDetector, filesInDifferentWorkingDirectoriesDontSharePreambles) {
+  const std::vector<std::wstring> flags = {L"-Iinclude", L"-x", L"c++-header"};
+  const std::vector<std::string> includes = {"#include <vector>"};
+
+  CxxSharedPreambleDetector detector;
+  for(const std::wstring& name : {L"a", L"b", L"c"}) {
+    detector.addSourceFile(FilePath(L"/one/" + name + L".cpp"), FilePath(L"/one"), flags, includes);
+  }
+  detector.addSourceFile(FilePath(L"/two/a.cpp"), FilePath(L"/two"), flags, includes);
+  detector.addSourceFile(FilePath(L"/two/b.cpp"), FilePath(L"/two"), flags, includes);
+
+  const std::vector<CxxSharedPreamble> preambles = detector.getSharedPreambles(FilePath(L"/pch"));
+  ASSERT_EQ(1U, preambles.size());
+  EXPECT_EQ(L"/one", preambles[0].workingDirectory.wstr());
+  EXPECT_EQ(3U, preambles[0].sourceFilePaths.size());
+}
@@ -0,0 +1,184 @@
+#include "CxxSharedPreambleDetector.h"
+// STL
+#include <thread>
+// internal
+#include "TextAccess.h"
+#include "utility.h"
+#include "utilityApp.h"
+#include "utilityString.h"
+
+std::vector<std::string> CxxSharedPreambleDetector::getLeadingBracketIncludes(const std::vector<std::string>& lines) {
+  std::vector<std::string> includes;
+
+  bool inBlockComment = false;
+  for(const std::string& line : lines) {
+    std::string code;
+    size_t i = 0;
+    while(i < line.size()) {
+      if(inBlockComment) {
+        const size_t end = line.find("*/", i);
+        inBlockComment = end == std::string::npos;
+        i = inBlockComment ? line.size() : end + 2;
+      } else if(line.compare(i, 2, "/*") == 0) {
+        inBlockComment = true;
+        i += 2;
+      } else if(line.compare(i, 2, "//") == 0) {
+        break;
+      } else {
+        code += line[i++];
+      }
+    }
+
+    code = utility::trim(code);
+    if(code.empty()) {
+      continue;
+    }
+
+    if(code[0] != '#') {
+      break;
+    }
+
+    const std::string directive = utility::trim(code.substr(1));
+    if(utility::isPrefix<std::string>("pragma", directive) && utility::trim(directive.substr(6)) == "once") {
+      continue;
+    }
+
+    if(!utility::isPrefix<std::string>("include", directive)) {
+      break;
+    }
+
+    const std::string includedFile = utility::trim(directive.substr(7));
+    if(includedFile.size() < 3 || includedFile.front() != '<' || includedFile.back() != '>') {
+      break;
+    }
+
+    includes.push_back("#include " + includedFile);
+  }
+
+  return includes;
+}
+
+std::vector<std::vector<std::string>> CxxSharedPreambleDetector::readLeadingBracketIncludes(
+    const std::vector<FilePath>& sourceFilePaths) {
+  std::vector<size_t> indices(sourceFilePaths.size());
+  for(size_t i = 0; i < indices.size(); i++) {
+    indices[i] = i;
+  }
+
+  std::vector<std::vector<std::string>> includes(sourceFilePaths.size());
+
+  std::vector<std::thread> threads;
+  for(const std::vector<size_t>& part : utility::splitToEquallySizedParts(indices, utility::getIdealThreadCount())) {
+    threads.emplace_back([&sourceFilePaths, &includes, part]() {
+      for(size_t index : part) {
+        if(sourceFilePaths[index].exists()) {
+          includes[index] = getLeadingBracketIncludes(TextAccess::createFromFile(sourceFilePaths[index])->getAllLines());
+        }
+      }
+    });
+  }
+  for(std::thread& thread : threads) {
+    thread.join();
+  }
+
+  return includes;
+}
+
+std::vector<std::wstring> CxxSharedPreambleDetector::getPreambleCompilerFlags(const std::vector<std::wstring>& commandLine,
+                                                                              const FilePath& sourceFilePath) {
+  const std::wstring sourceFileName = sourceFilePath.fileName();
+
+  std::vector<std::wstring> flags;
+  for(size_t i = 0; i < commandLine.size(); i++) {
+    const std::wstring& arg = commandLine[i];
+    if(i == 0 && !utility::isPrefix<std::wstring>(L"-", arg)) {
+      continue;
+    }
+
+    if(arg == L"-c" || arg == L"-M" || arg == L"-MM" || arg == L"-MD" || arg == L"-MMD") {
+      continue;
+    }
+
+    if(arg == L"-o" || arg == L"-MF" || arg == L"-MT" || arg == L"-MQ") {
+      i++;
+      continue;
+    }
+
+    if(!utility::isPrefix<std::wstring>(L"-", arg) && FilePath(arg).fileName() == sourceFileName) {
+      continue;
+    }
+
+    flags.push_back(arg);
+  }
+
+  flags.emplace_back(L"-x");
+  flags.emplace_back(sourceFilePath.extension() == L".c" ? L"c-header" : L"c++-header");
+  return flags;
+}
+
+void CxxSharedPreambleDetector::addSourceFile(const FilePath& sourceFilePath,
+                                              const FilePath& workingDirectory,
+                                              std::vector<std::wstring> preambleCompilerFlags,
+                                              std::vector<std::string> leadingIncludes) {
+  if(leadingIncludes.empty()) {
+    return;
+  }
+
+  // relative include paths in the flags only mean the same in the same working directory
+  std::wstring key = workingDirectory.wstr() + L'\n';
+  for(const std::wstring& flag : preambleCompilerFlags) {
+    key += flag + L'\n';
+  }
+
+  SourceFileGroup& group = m_sourceFileGroups[key];
+  if(group.compilerFlags.empty()) {
+    group.workingDirectory = workingDirectory;
+    group.compilerFlags = std::move(preambleCompilerFlags);
+  }
+  group.sourceFiles.push_back({sourceFilePath, std::move(leadingIncludes)});
+}
+
+std::vector<CxxSharedPreamble> CxxSharedPreambleDetector::getSharedPreambles(const FilePath& pchDirectoryPath) const {
+  std::vector<CxxSharedPreamble> preambles;
+
+  for(const auto& [key, group] : m_sourceFileGroups) {
+    const std::vector<SourceFile>& sourceFiles = group.sourceFiles;
+
+    std::map<std::vector<std::string>, size_t> prefixCounts;
+    for(const SourceFile& sourceFile : sourceFiles) {
+      for(size_t length = 1; length <= sourceFile.leadingIncludes.size(); length++) {
+        prefixCounts[std::vector<std::string>(sourceFile.leadingIncludes.begin(), sourceFile.leadingIncludes.begin() + length)]++;
+      }
+    }
+
+    std::map<std::vector<std::string>, size_t> preambleIndices;
+    for(const SourceFile& sourceFile : sourceFiles) {
+      for(size_t length = sourceFile.leadingIncludes.size(); length > 0; length--) {
+        std::vector<std::string> prefix(sourceFile.leadingIncludes.begin(), sourceFile.leadingIncludes.begin() + length);
+        if(prefixCounts[prefix] < s_minSharingFileCount) {
+          continue;
+        }
+
+        auto it = preambleIndices.find(prefix);
+        if(it == preambleIndices.end()) {
+          const std::wstring fileName = L"shared_preamble_" + std::to_wstring(preambles.size() + 1);
+
+          CxxSharedPreamble preamble;
+          preamble.includeDirectives = prefix;
+          preamble.compilerFlags = group.compilerFlags;
+          preamble.workingDirectory = group.workingDirectory;
+          preamble.headerFilePath = pchDirectoryPath.getConcatenated(fileName + L".h");
+          preamble.pchFilePath = pchDirectoryPath.getConcatenated(fileName + L".pch");
+
+          it = preambleIndices.emplace(std::move(prefix), preambles.size()).first;
+          preambles.push_back(std::move(preamble));
+        }
+
+        preambles[it->second].sourceFilePaths.insert(sourceFile.filePath);
+        break;
+      }
+    }
+  }
+
+  return preambles;
+}
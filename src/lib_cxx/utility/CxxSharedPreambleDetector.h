@@ -0,0 +1,67 @@
+#pragma once
+// STL
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+// internal
+#include "FilePath.h"
+
+class TextAccess;
+
+struct CxxSharedPreamble {
+  // include directives in the order they appear at the top of every source file using the preamble
+  std::vector<std::string> includeDirectives;
+  std::vector<std::wstring> compilerFlags;
+  // relative paths in the compiler flags are resolved against it, like for the source files using the preamble
+  FilePath workingDirectory;
+  FilePath headerFilePath;
+  FilePath pchFilePath;
+  std::set<FilePath> sourceFilePaths;
+};
+
+/*
+ * CxxSharedPreambleDetector
+ *
+ * Finds include prefixes shared by translation units that are compiled with the same flags in the same working
+ * directory. Only the leading bracket
+ * includes of a source file are considered, so putting them into a precompiled header that is included before the file
+ * doesn't change its meaning. Every file is assigned the longest prefix it shares with enough other files.
+ */
+class CxxSharedPreambleDetector final {
+public:
+  static constexpr size_t s_minSharingFileCount = 3;
+
+  // bracket includes before the first other directive or declaration, comments and #pragma once are skipped
+  static std::vector<std::string> getLeadingBracketIncludes(const std::vector<std::string>& lines);
+
+  // reads the files on several threads, files that don't exist have no includes
+  static std::vector<std::vector<std::string>> readLeadingBracketIncludes(const std::vector<FilePath>& sourceFilePaths);
+
+  // removes compiler, source file, output and dependency file arguments, adds the header language for -emit-pch
+  static std::vector<std::wstring> getPreambleCompilerFlags(const std::vector<std::wstring>& commandLine,
+                                                            const FilePath& sourceFilePath);
+
+  void addSourceFile(const FilePath& sourceFilePath,
+                     const FilePath& workingDirectory,
+                     std::vector<std::wstring> preambleCompilerFlags,
+                     std::vector<std::string> leadingIncludes);
+
+  std::vector<CxxSharedPreamble> getSharedPreambles(const FilePath& pchDirectoryPath) const;
+
+private:
+  struct SourceFile {
+    FilePath filePath;
+    std::vector<std::string> leadingIncludes;
+  };
+
+  struct SourceFileGroup {
+    FilePath workingDirectory;
+    std::vector<std::wstring> compilerFlags;
+    std::vector<SourceFile> sourceFiles;
+  };
+
+  // source files by their working directory and joined preamble compiler flags
+  std::map<std::wstring, SourceFileGroup> m_sourceFileGroups;
+};
@@ -247,4 +247,35 @@ TEST(TaskScheduler, taskSchedulingWithinTaskProcessing) {
   EXPECT_TRUE(4 == task->subTask->enterCallOrder);
   EXPECT_TRUE(5 == task->subTask->updateCallOrder);
   EXPECT_TRUE(6 == task->subTask->exitCallOrder);
-}
\ No newline at end of file
+}
+
+TEST(TaskScheduler, blackboardWaitForUpdateWakesUpOnChange) {
+  std::shared_ptr<Blackboard> blackboard = std::make_shared<Blackboard>();
+  const size_t updateCount = blackboard->getUpdateCount();
+
+  std::thread thread([blackboard]() { blackboard->set<bool>("started", true); });
+
+  EXPECT_TRUE(blackboard->waitForUpdate(updateCount, std::chrono::seconds(10)));
+  thread.join();
+
+  EXPECT_FALSE(blackboard->waitForUpdate(blackboard->getUpdateCount(), std::chrono::milliseconds(1)));
+}
+
+TEST(TaskScheduler, taskPushedToWaitingLoopGetsProcessed) {
+  TaskScheduler scheduler(0);
+  scheduler.startSchedulerLoopThreaded();
+
+  waitForThread(scheduler);
+
+  int order = 0;
+  std::shared_ptr<TestTask> task = std::make_shared<TestTask>(&order, 1);
+
+  scheduler.pushTask(task);
+
+  waitForThread(scheduler);
+
+  scheduler.stopSchedulerLoop();
+
+  EXPECT_FALSE(scheduler.loopIsRunning());
+  EXPECT_TRUE(3 == task->exitCallOrder);
+}
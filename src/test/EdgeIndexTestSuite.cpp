@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include "EdgeIndex.h"
+
+namespace {
+std::vector<Id> getEdgeIds(const std::vector<StorageEdge>& edges) {
+  std::vector<Id> edgeIds;
+  for(const StorageEdge& edge : edges) {
+    edgeIds.push_back(edge.id);
+  }
+  return edgeIds;
+}
+
+EdgeIndex createIndex() {
+  EdgeIndex index;
+  index.build({{1, 2}, {2, 4}, {3, 4}, {4, 8}},
+              {StorageEdge(12, Edge::EDGE_CALL, 1, 2),
+               StorageEdge(10, Edge::EDGE_MEMBER, 1, 3),
+               StorageEdge(11, Edge::EDGE_CALL, 1, 3),
+               StorageEdge(13, Edge::EDGE_USAGE, 2, 3),
+               StorageEdge(14, Edge::EDGE_CALL, 3, 3)});
+  return index;
+}
+}    // namespace
+
+TEST(EdgeIndex, emptyIndexIsNotBuilt) {
+  EdgeIndex index;
+  EXPECT_FALSE(index.isBuilt());
+  EXPECT_EQ(0, index.getNodeType(1));
+  EXPECT_EQ(nullptr, index.getEdgeById(1));
+  EXPECT_TRUE(index.getOutgoingEdges({1}).empty());
+}
+
+TEST(EdgeIndex, edgesAreFoundByBothEndpointsSortedById) {
+  const EdgeIndex index = createIndex();
+  ASSERT_TRUE(index.isBuilt());
+
+  EXPECT_EQ(std::vector<Id>({10, 11, 12}), getEdgeIds(index.getOutgoingEdges({1})));
+  EXPECT_EQ(std::vector<Id>({10, 11, 13, 14}), getEdgeIds(index.getIncomingEdges({3})));
+  EXPECT_EQ(std::vector<Id>({11, 12, 13, 14}),
+            getEdgeIds(index.getOutgoingEdges({1, 2, 3}, Edge::EDGE_CALL | Edge::EDGE_USAGE)));
+  EXPECT_EQ(std::vector<Id>({13}), getEdgeIds(index.getOutgoingEdges({1, 2, 3}, Edge::EDGE_USAGE)));
+  EXPECT_TRUE(index.getIncomingEdges({1}).empty());
+
+  ASSERT_NE(nullptr, index.getEdgeById(13));
+  EXPECT_EQ(2U, index.getEdgeById(13)->sourceNodeId);
+  EXPECT_EQ(nullptr, index.getEdgeById(3));
+}
+
+TEST(EdgeIndex, nodeTypesOfNodesAndEdgeEndpoints) {
+  EdgeIndex index;
+  index.build({{1, 2}, {1, 16}, {2, 4}}, {StorageEdge(5, Edge::EDGE_CALL, 2, 7)});
+
+  EXPECT_EQ(16, index.getNodeType(1));
+  EXPECT_EQ(4, index.getNodeType(2));
+  EXPECT_EQ(0, index.getNodeType(7));
+  EXPECT_EQ(2U, index.getNodeCount());
+  EXPECT_EQ(std::vector<Id>({5}), getEdgeIds(index.getIncomingEdges({7})));
+}
+
+TEST(EdgeIndex, addedNodesAndEdgesExtendTheIndex) {
+  EdgeIndex index = createIndex();
+
+  index.addNodes({{5, 2}, {4, 1}});
+  index.addEdges({StorageEdge(15, Edge::EDGE_CALL, 5, 1), StorageEdge(12, Edge::EDGE_CALL, 1, 2)});
+
+  EXPECT_EQ(2, index.getNodeType(5));
+  EXPECT_EQ(8, index.getNodeType(4));
+  EXPECT_EQ(6U, index.getEdgeCount());
+  EXPECT_EQ(std::vector<Id>({15}), getEdgeIds(index.getIncomingEdges({1})));
+  EXPECT_EQ(std::vector<Id>({10, 11, 12}), getEdgeIds(index.getOutgoingEdges({1})));
+}
+
+TEST(EdgeIndex, nodesAndEdgesAddedTogetherMatchAddingThemSeparately) {
+  EdgeIndex index = createIndex();
+
+  // the source node of the first edge is added in the same call
+  index.add({{5, 2}, {4, 1}}, {StorageEdge(15, Edge::EDGE_CALL, 5, 1), StorageEdge(12, Edge::EDGE_CALL, 1, 2)});
+
+  EXPECT_EQ(2, index.getNodeType(5));
+  EXPECT_EQ(8, index.getNodeType(4));
+  EXPECT_EQ(6U, index.getEdgeCount());
+  EXPECT_EQ(std::vector<Id>({15}), getEdgeIds(index.getIncomingEdges({1})));
+  EXPECT_EQ(std::vector<Id>({15}), getEdgeIds(index.getOutgoingEdges({5})));
+  EXPECT_EQ(std::vector<Id>({10, 11, 12}), getEdgeIds(index.getOutgoingEdges({1})));
+}
+
+TEST(EdgeIndex, addingToAnIndexThatIsNotBuiltDoesNothing) {
+  EdgeIndex index;
+  index.addNodes({{1, 2}});
+  index.addEdges({StorageEdge(2, Edge::EDGE_CALL, 1, 1)});
+
+  EXPECT_FALSE(index.isBuilt());
+  EXPECT_EQ(0U, index.getEdgeCount());
+}
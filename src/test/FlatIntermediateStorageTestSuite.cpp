@@ -0,0 +1,100 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "FlatIntermediateStorage.h"
+#include "IntermediateStorage.h"
+
+namespace {
+std::shared_ptr<IntermediateStorage> roundTrip(const IntermediateStorage& storage) {
+  std::vector<char> buffer(FlatIntermediateStorage::getByteSize(storage));
+  FlatIntermediateStorage::write(storage, buffer.data());
+  return FlatIntermediateStorage::read(buffer.data(), buffer.size());
+}
+}    // namespace
+
+TEST(FlatIntermediateStorage, emptyStorageRoundTrip) {
+  IntermediateStorage storage;
+  std::shared_ptr<IntermediateStorage> result = roundTrip(storage);
+
+  ASSERT_TRUE(result);
+  EXPECT_TRUE(result->getStorageNodes().empty());
+  EXPECT_TRUE(result->getStorageSourceLocations().empty());
+  EXPECT_EQ(storage.getNextId(), result->getNextId());
+}
+
+TEST(FlatIntermediateStorage, recordsSurviveRoundTrip) {
+  IntermediateStorage storage;
+  const Id nodeId = storage.addNode(StorageNodeData(2, L"foo::bar")).first;
+  const Id fileId = storage.addNode(StorageNodeData(1, L"/src/foo.cpp")).first;
+  storage.addFile(StorageFile(fileId, L"/src/foo.cpp", L"cpp", "2024-01-01 10:00:00", true, false));
+  storage.addSymbol(StorageSymbol(nodeId, 1));
+  const Id edgeId = storage.addEdge(StorageEdgeData(4, fileId, nodeId));
+  const Id localSymbolId = storage.addLocalSymbol(StorageLocalSymbolData(L"foo.cpp<1:2>"));
+  const Id locationId = storage.addSourceLocation(StorageSourceLocationData(fileId, 1, 2, 3, 4, 0));
+  storage.addOccurrence(StorageOccurrence(nodeId, locationId));
+  storage.addOccurrence(StorageOccurrence(edgeId, locationId));
+  storage.addComponentAccess(StorageComponentAccess(nodeId, 1));
+  storage.addElementComponent(StorageElementComponent(nodeId, 1, L"data"));
+  storage.addError(StorageErrorData(L"error", L"/src/foo.cpp", true, true));
+  storage.addIndexingCosts({StorageIndexingCost(L"/src/foo.cpp", 1200)});
+
+  std::shared_ptr<IntermediateStorage> result = roundTrip(storage);
+  ASSERT_TRUE(result);
+
+  ASSERT_EQ(2, result->getStorageNodes().size());
+  EXPECT_EQ(nodeId, result->getStorageNodes()[0].id);
+  EXPECT_EQ(2, result->getStorageNodes()[0].type);
+  EXPECT_EQ(L"foo::bar", result->getStorageNodes()[0].serializedName);
+
+  ASSERT_EQ(1, result->getStorageFiles().size());
+  EXPECT_EQ(L"/src/foo.cpp", result->getStorageFiles()[0].filePath);
+  EXPECT_EQ(L"cpp", result->getStorageFiles()[0].languageIdentifier);
+  EXPECT_EQ("2024-01-01 10:00:00", result->getStorageFiles()[0].modificationTime);
+  EXPECT_TRUE(result->getStorageFiles()[0].indexed);
+  EXPECT_FALSE(result->getStorageFiles()[0].complete);
+
+  ASSERT_EQ(1, result->getStorageSymbols().size());
+  ASSERT_EQ(1, result->getStorageEdges().size());
+  EXPECT_EQ(edgeId, result->getStorageEdges()[0].id);
+  EXPECT_EQ(fileId, result->getStorageEdges()[0].sourceNodeId);
+
+  ASSERT_EQ(1, result->getStorageLocalSymbols().size());
+  EXPECT_EQ(localSymbolId, result->getStorageLocalSymbols()[0].id);
+  EXPECT_EQ(L"foo.cpp<1:2>", result->getStorageLocalSymbols()[0].name);
+
+  ASSERT_EQ(1, result->getStorageSourceLocations().size());
+  EXPECT_EQ(4, result->getStorageSourceLocations()[0].endCol);
+  EXPECT_EQ(2, result->getStorageOccurrences().size());
+  EXPECT_EQ(1, result->getComponentAccesses().size());
+  ASSERT_EQ(1, result->getElementComponents().size());
+  EXPECT_EQ(L"data", result->getElementComponents()[0].data);
+
+  ASSERT_EQ(1, result->getErrors().size());
+  EXPECT_EQ(L"error", result->getErrors()[0].message);
+  EXPECT_TRUE(result->getErrors()[0].fatal);
+  EXPECT_TRUE(result->hasFatalErrors());
+
+  ASSERT_EQ(1, result->getIndexingCosts().size());
+  EXPECT_EQ(L"/src/foo.cpp", result->getIndexingCosts()[0].sourceFilePath);
+  EXPECT_EQ(1200U, result->getIndexingCosts()[0].durationMS);
+
+  EXPECT_EQ(storage.getNextId(), result->getNextId());
+
+  // dedup indices are rebuilt on read
+  EXPECT_EQ(nodeId, result->addNode(StorageNodeData(1, L"foo::bar")).first);
+  EXPECT_EQ(locationId, result->addSourceLocation(StorageSourceLocationData(fileId, 1, 2, 3, 4, 0)));
+}
+
+TEST(FlatIntermediateStorage, invalidBufferIsRejected) {
+  IntermediateStorage storage;
+  storage.addNode(StorageNodeData(2, L"foo"));
+
+  std::vector<char> buffer(FlatIntermediateStorage::getByteSize(storage));
+  FlatIntermediateStorage::write(storage, buffer.data());
+
+  EXPECT_FALSE(FlatIntermediateStorage::read(buffer.data(), buffer.size() / 2));
+
+  buffer[0] = 0;
+  EXPECT_FALSE(FlatIntermediateStorage::read(buffer.data(), buffer.size()));
+}
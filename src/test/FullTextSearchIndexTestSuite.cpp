@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+#include "FullTextSearchIndex.h"
+#include "SuffixArray.h"
+
+namespace {
+std::string getSegmentFilePath() {
+  return (std::filesystem::temp_directory_path() / "FullTextSearchIndexTestSuite.segments").string();
+}
+
+std::vector<Id> getResultFileIds(const FullTextSearchIndex& index, const std::wstring& term) {
+  std::vector<Id> fileIds;
+  for(const FullTextSearchResult& result : index.searchForTerm(term)) {
+    fileIds.push_back(result.fileId);
+  }
+  std::sort(fileIds.begin(), fileIds.end());
+  return fileIds;
+}
+}    // namespace
+
+TEST(FullTextSearchIndex, segmentArraysAreOnlyBuiltForChangedFiles) {
+  std::remove(getSegmentFilePath().c_str());
+
+  std::vector<Id> readFileIds;
+  auto getFileContent = [&readFileIds](Id fileId) {
+    readFileIds.push_back(fileId);
+    return L"int foo" + std::to_wstring(fileId) + L";";
+  };
+
+  {
+    FullTextSearchIndex index;
+    index.addSegment(getSegmentFilePath(), {{1, "a"}, {2, "a"}}, getFileContent);
+    EXPECT_EQ(std::vector<Id>({1, 2}), getResultFileIds(index, L"int foo"));
+  }
+  EXPECT_EQ(2U, SuffixArray::loadFromFile(getSegmentFilePath()).size());
+
+  readFileIds.clear();
+  {
+    FullTextSearchIndex index;
+    index.addSegment(getSegmentFilePath(), {{1, "a"}, {2, "b"}, {3, "a"}}, getFileContent);
+    EXPECT_EQ(std::vector<Id>({1, 2, 3}), getResultFileIds(index, L"int foo"));
+    EXPECT_EQ(std::vector<Id>({3}), getResultFileIds(index, L"foo3"));
+  }
+  EXPECT_EQ(std::vector<Id>({2, 3}), readFileIds);
+  EXPECT_EQ(3U, SuffixArray::loadFromFile(getSegmentFilePath()).size());
+
+  FullTextSearchIndex::removeFromSegment(getSegmentFilePath(), {2, 3});
+  EXPECT_EQ(1U, SuffixArray::loadFromFile(getSegmentFilePath()).size());
+
+  FullTextSearchIndex::removeFromSegment(getSegmentFilePath(), {1});
+  EXPECT_FALSE(std::filesystem::exists(getSegmentFilePath()));
+}
@@ -93,3 +93,72 @@ TEST(HierarchyCache, returnsInheritanceEdgesForDiamondInheritance) {
   EXPECT_TRUE(utility::containsElement(inheritanceEdges, TestEdge(1, 3, {2}).toString()));
   EXPECT_TRUE(utility::containsElement(inheritanceEdges, TestEdge(1, 4, {1, 2, 3, 4}).toString()));
 }
+
+TEST(HierarchyCache, lastVisibleParentStopsBelowInvisibleParent) {
+  HierarchyCache cache;
+  cache.createConnection(10, 1, 2, false, false, false);
+  cache.createConnection(11, 2, 3, true, false, false);
+  cache.createConnection(12, 3, 4, true, false, false);
+
+  EXPECT_EQ(2U, cache.getLastVisibleParentNodeId(4));
+  EXPECT_EQ(2U, cache.getLastVisibleParentNodeId(2));
+  EXPECT_EQ(1U, cache.getLastVisibleParentNodeId(1));
+  EXPECT_EQ(5U, cache.getLastVisibleParentNodeId(5));
+  EXPECT_EQ(1U, cache.getIndexOfLastVisibleParentNode(4));
+  EXPECT_TRUE(cache.isChildOfVisibleNodeOrInvisible(4));
+  EXPECT_FALSE(cache.isChildOfVisibleNodeOrInvisible(2));
+
+  std::set<Id> nodeIds, edgeIds;
+  cache.addAllVisibleParentIdsForNodeId(4, &nodeIds, &edgeIds);
+  EXPECT_EQ(std::set<Id>({2, 3, 4}), nodeIds);
+  EXPECT_EQ(std::set<Id>({11, 12}), edgeIds);
+}
+
+TEST(HierarchyCache, visibleParentsOfNodesOnCycleAreCollectedOnce) {
+  HierarchyCache cache;
+  cache.createConnection(10, 1, 2, true, false, false);
+  cache.createConnection(11, 2, 1, true, false, false);
+  cache.createConnection(12, 2, 3, true, false, false);
+
+  std::set<Id> nodeIds, edgeIds;
+  cache.addAllVisibleParentIdsForNodeId(3, &nodeIds, &edgeIds);
+  EXPECT_EQ(std::set<Id>({1, 2, 3}), nodeIds);
+  EXPECT_EQ(std::set<Id>({10, 12}), edgeIds);
+
+  nodeIds.clear();
+  edgeIds.clear();
+  cache.addAllVisibleParentIdsForNodeId(1, &nodeIds, &edgeIds);
+  EXPECT_EQ(std::set<Id>({1}), nodeIds);
+  EXPECT_TRUE(edgeIds.empty());
+}
+
+TEST(HierarchyCache, returnsChildrenInConnectionOrderAndWholeSubtrees) {
+  HierarchyCache cache;
+  cache.createConnection(10, 1, 3, true, false, false);
+  cache.createConnection(11, 1, 2, true, false, true);
+  cache.createConnection(12, 2, 4, true, true, false);
+  cache.createConnection(13, 5, 6, true, false, false);
+
+  std::vector<Id> nodeIds, edgeIds;
+  cache.addFirstChildIdsForNodeId(1, &nodeIds, &edgeIds);
+  EXPECT_EQ(std::vector<Id>({3}), nodeIds);
+  EXPECT_EQ(1U, cache.getFirstChildIdsCountForNodeId(1));
+
+  nodeIds.clear();
+  edgeIds.clear();
+  cache.addFirstChildIdsForNodeId(2, &nodeIds, &edgeIds);
+  EXPECT_EQ(std::vector<Id>({4}), nodeIds);
+  EXPECT_EQ(std::vector<Id>({12}), edgeIds);
+
+  std::set<Id> allNodeIds, allEdgeIds;
+  cache.addAllChildIdsForNodeId(1, &allNodeIds, &allEdgeIds);
+  EXPECT_EQ(std::set<Id>({2, 3, 4}), allNodeIds);
+  EXPECT_EQ(std::set<Id>({10, 11, 12}), allEdgeIds);
+
+  // connections created after a query are part of the next one
+  cache.createConnection(14, 4, 7, true, false, false);
+  cache.addAllChildIdsForNodeId(1, &allNodeIds, &allEdgeIds);
+  EXPECT_EQ(std::set<Id>({2, 3, 4, 7}), allNodeIds);
+  EXPECT_TRUE(cache.nodeHasChildren(4));
+  EXPECT_FALSE(cache.nodeHasChildren(6));
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "IndexedHeaderRegistry.h"
+#include "InterprocessIndexedHeaderRegistry.h"
+#include "InterprocessIndexingStatusManager.h"
+
+TEST(IndexedHeaderRegistry, onlyConfirmedClaimOfHeaderKeyIsSkipped) {
+  IndexedHeaderRegistry registry;
+  const Id owner = registry.createOwnerId();
+  const Id otherOwner = registry.createOwnerId();
+
+  EXPECT_TRUE(registry.claimHeader("/src/a.h\n1\n2", owner));
+  EXPECT_TRUE(registry.claimHeader("/src/a.h\n1\n2", otherOwner));
+
+  registry.confirmClaims(owner);
+  EXPECT_FALSE(registry.claimHeader("/src/a.h\n1\n2", otherOwner));
+  EXPECT_TRUE(registry.claimHeader("/src/a.h\n1\n3", otherOwner));
+  EXPECT_EQ(2U, registry.getClaimedHeaderCount());
+}
+
+TEST(IndexedHeaderRegistry, concurrentClaimsOfConfirmedHeadersFail) {
+  IndexedHeaderRegistry registry;
+  const Id firstOwner = registry.createOwnerId();
+  for(size_t j = 0; j < 100; j++) {
+    registry.claimHeader("/src/header" + std::to_string(j) + ".h", firstOwner);
+  }
+  registry.confirmClaims(firstOwner);
+
+  std::atomic<size_t> successfulClaimCount = 0;
+  std::vector<std::thread> threads;
+  for(size_t i = 0; i < 8; i++) {
+    threads.emplace_back([&]() {
+      const Id owner = registry.createOwnerId();
+      for(size_t j = 0; j < 200; j++) {
+        if(registry.claimHeader("/src/header" + std::to_string(j) + ".h", owner)) {
+          successfulClaimCount++;
+        }
+      }
+      registry.confirmClaims(owner);
+    });
+  }
+
+  for(std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // headers that are only claimed provisionally may be recorded by several owners
+  EXPECT_LE(100U, successfulClaimCount);
+  EXPECT_GE(800U, successfulClaimCount);
+  EXPECT_EQ(200U, registry.getClaimedHeaderCount());
+}
+
+TEST(IndexedHeaderRegistry, claimsAreSharedBetweenProcesses) {
+  InterprocessIndexingStatusManager owner("indexed_header_registry_test", 0, true);
+  InterprocessIndexingStatusManager indexerProcess("indexed_header_registry_test", 1, false);
+  InterprocessIndexedHeaderRegistry registry(indexerProcess);
+
+  EXPECT_TRUE(registry.claimHeader("/src/a.h\n1\n2", registry.createOwnerId()));
+  EXPECT_TRUE(owner.claimIndexedHeader("/src/a.h\n1\n2"));
+  registry.confirmClaims(registry.createOwnerId());
+  EXPECT_FALSE(owner.claimIndexedHeader("/src/a.h\n1\n2"));
+
+  EXPECT_TRUE(owner.claimIndexedHeader("/src/b.h\n1\n2"));
+  owner.confirmIndexedHeaders({"/src/b.h\n1\n2"});
+  EXPECT_FALSE(registry.claimHeader("/src/b.h\n1\n2", registry.createOwnerId()));
+}
+
+TEST(IndexedHeaderRegistry, releasedClaimsCanBeClaimedAgain) {
+  IndexedHeaderRegistry registry;
+  const Id failingOwner = registry.createOwnerId();
+  const Id owner = registry.createOwnerId();
+
+  EXPECT_TRUE(registry.claimHeader("/src/a.h\n1\n2", failingOwner));
+  EXPECT_TRUE(registry.claimHeader("/src/a.h\n1\n2", failingOwner));
+  // the provisional claim does not prevent others from recording the header
+  EXPECT_TRUE(registry.claimHeader("/src/a.h\n1\n2", owner));
+
+  registry.releaseClaims(failingOwner);
+  EXPECT_EQ(0U, registry.getClaimedHeaderCount());
+
+  EXPECT_TRUE(registry.claimHeader("/src/a.h\n1\n2", owner));
+  registry.confirmClaims(owner);
+  registry.releaseClaims(owner);
+  EXPECT_FALSE(registry.claimHeader("/src/a.h\n1\n2", failingOwner));
+  EXPECT_EQ(1U, registry.getClaimedHeaderCount());
+}
+
+TEST(IndexedHeaderRegistry, claimsOfCrashedProcessAreReleased) {
+  InterprocessIndexingStatusManager owner("indexed_header_registry_release_test", 0, true);
+  InterprocessIndexingStatusManager indexerProcess("indexed_header_registry_release_test", 1, false);
+  InterprocessIndexedHeaderRegistry registry(indexerProcess);
+
+  indexerProcess.startIndexingSourceFile(FilePath(L"/src/a.cpp"));
+  EXPECT_TRUE(registry.claimHeader("/src/a.h\n1\n2", registry.createOwnerId()));
+  EXPECT_TRUE(registry.claimHeader("/src/b.h\n1\n2", registry.createOwnerId()));
+  registry.confirmClaims(registry.createOwnerId());
+  EXPECT_TRUE(registry.claimHeader("/src/c.h\n1\n2", registry.createOwnerId()));
+  EXPECT_TRUE(owner.claimIndexedHeader("/src/c.h\n1\n2"));
+
+  // the restarted process finds its previous file unfinished
+  InterprocessIndexingStatusManager restartedProcess("indexed_header_registry_release_test", 1, false);
+  restartedProcess.startIndexingSourceFile(FilePath(L"/src/b.cpp"));
+
+  EXPECT_FALSE(owner.claimIndexedHeader("/src/a.h\n1\n2"));
+  EXPECT_TRUE(owner.claimIndexedHeader("/src/c.h\n1\n2"));
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "IndexedHeaderRegistry.h"
+#include "IndexerBase.h"
+#include "IndexerCommand.h"
+#include "IndexerThreadPool.h"
+#include "IntermediateStorage.h"
+
+namespace {
+struct TestIndexerCommand final : public IndexerCommand {
+  explicit TestIndexerCommand(const FilePath& sourceFilePath) : IndexerCommand(sourceFilePath) {}
+
+  IndexerCommandType getIndexerCommandType() const override {
+    return INDEXER_COMMAND_CUSTOM;
+  }
+};
+
+struct TestIndexer final : public IndexerBase {
+  IndexerCommandType getSupportedIndexerCommandType() const override {
+    return INDEXER_COMMAND_CUSTOM;
+  }
+
+  std::shared_ptr<IntermediateStorage> index(std::shared_ptr<IndexerCommand> indexerCommand) override {
+    if(indexedHeaderRegistry && indexedHeaderRegistry->claimHeader("/src/shared.h", ownerId)) {
+      successfulClaimCount++;
+    }
+
+    if(indexerCommand->getSourceFilePath().fileName() == L"crash.cpp") {
+      throw std::runtime_error("crash");
+    }
+    return std::make_shared<IntermediateStorage>();
+  }
+
+  void interrupt() override {}
+
+  void setIndexedHeaderRegistry(std::shared_ptr<IndexedHeaderRegistry> registry) override {
+    indexedHeaderRegistry = std::move(registry);
+    ownerId = indexedHeaderRegistry->createOwnerId();
+  }
+
+  void confirmIndexedHeaders() override {
+    if(indexedHeaderRegistry) {
+      indexedHeaderRegistry->confirmClaims(ownerId);
+    }
+  }
+
+  void releaseIndexedHeaders() override {
+    if(indexedHeaderRegistry) {
+      indexedHeaderRegistry->releaseClaims(ownerId);
+    }
+  }
+
+  static inline std::atomic<size_t> successfulClaimCount = 0;
+  std::shared_ptr<IndexedHeaderRegistry> indexedHeaderRegistry;
+  Id ownerId = 0;
+};
+
+std::vector<std::shared_ptr<IndexerCommand>> createCommands(size_t count) {
+  std::vector<std::shared_ptr<IndexerCommand>> commands;
+  for(size_t i = 0; i < count; i++) {
+    commands.push_back(std::make_shared<TestIndexerCommand>(FilePath(L"/src/file" + std::to_wstring(i) + L".cpp")));
+  }
+  return commands;
+}
+
+size_t collectResults(IndexerThreadPool& pool) {
+  size_t resultCount = 0;
+  while(true) {
+    const bool running = pool.getRunningWorkerCount() > 0;
+    while(pool.popResult()) {
+      resultCount++;
+    }
+
+    if(!running) {
+      return resultCount;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+}    // namespace
+
+TEST(IndexerThreadPool, indexesAllPushedCommands) {
+  IndexerThreadPool pool(4, []() { return std::make_shared<TestIndexer>(); });
+  pool.start();
+
+  pool.pushCommands(createCommands(100));
+  pool.finish();
+
+  EXPECT_EQ(100U, collectResults(pool));
+  pool.join();
+
+  EXPECT_EQ(0U, pool.getQueuedCommandCount());
+  EXPECT_EQ(100U, pool.popStartedSourceFilePaths().size());
+  EXPECT_TRUE(pool.popStartedSourceFilePaths().empty());
+  EXPECT_TRUE(pool.getCrashedSourceFilePaths().empty());
+}
+
+TEST(IndexerThreadPool, reportsCommandsWhoseIndexerThrew) {
+  IndexerThreadPool pool(2, []() { return std::make_shared<TestIndexer>(); });
+  pool.start();
+
+  std::vector<std::shared_ptr<IndexerCommand>> commands = createCommands(3);
+  commands.push_back(std::make_shared<TestIndexerCommand>(FilePath(L"/src/crash.cpp")));
+  pool.pushCommands(commands);
+  pool.finish();
+
+  EXPECT_EQ(3U, collectResults(pool));
+  pool.join();
+
+  const std::vector<FilePath> crashedFiles = pool.getCrashedSourceFilePaths();
+  ASSERT_EQ(1U, crashedFiles.size());
+  EXPECT_EQ(L"crash.cpp", crashedFiles.front().fileName());
+}
+
+TEST(IndexerThreadPool, clearingCommandsEmptiesAllQueues) {
+  IndexerThreadPool pool(3, []() { return std::make_shared<TestIndexer>(); });
+
+  pool.pushCommands(createCommands(10));
+  EXPECT_EQ(10U, pool.getQueuedCommandCount());
+
+  pool.clearCommands();
+  EXPECT_EQ(0U, pool.getQueuedCommandCount());
+}
+
+TEST(IndexerThreadPool, attachesIndexingCostToResults) {
+  IndexerThreadPool pool(1, []() { return std::make_shared<TestIndexer>(); });
+  pool.start();
+
+  pool.pushCommands(createCommands(1));
+  pool.finish();
+  pool.join();
+
+  std::shared_ptr<IntermediateStorage> result = pool.popResult();
+  ASSERT_TRUE(result);
+  ASSERT_EQ(1U, result->getIndexingCosts().size());
+  EXPECT_EQ(L"/src/file0.cpp", result->getIndexingCosts().front().sourceFilePath);
+}
+
+TEST(IndexerThreadPool, headersClaimedByThrowingIndexerAreReleased) {
+  auto registry = std::make_shared<IndexedHeaderRegistry>();
+  IndexerThreadPool pool(1, [registry]() {
+    auto indexer = std::make_shared<TestIndexer>();
+    indexer->setIndexedHeaderRegistry(registry);
+    return indexer;
+  });
+  TestIndexer::successfulClaimCount = 0;
+  pool.start();
+
+  pool.pushCommands({std::make_shared<TestIndexerCommand>(FilePath(L"/src/crash.cpp")),
+                     std::make_shared<TestIndexerCommand>(FilePath(L"/src/file0.cpp")),
+                     std::make_shared<TestIndexerCommand>(FilePath(L"/src/file1.cpp"))});
+  pool.finish();
+
+  EXPECT_EQ(2U, collectResults(pool));
+  pool.join();
+
+  // the crashed translation unit released the header, the next one claimed it and confirmed the claim with its result
+  EXPECT_EQ(2U, TestIndexer::successfulClaimCount);
+  EXPECT_EQ(1U, registry->getClaimedHeaderCount());
+  EXPECT_FALSE(registry->claimHeader("/src/shared.h", registry->createOwnerId()));
+}
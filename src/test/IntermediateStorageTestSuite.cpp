@@ -0,0 +1,133 @@
+#include <map>
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include "IntermediateStorage.h"
+
+namespace {
+std::shared_ptr<IntermediateStorage> createStorage(const std::wstring& sourceFile, const std::wstring& symbolName) {
+  auto storage = std::make_shared<IntermediateStorage>();
+  const Id sourceId = storage->addNode(StorageNodeData(1, sourceFile)).first;
+  const Id headerId = storage->addNode(StorageNodeData(1, L"/shared.h")).first;
+  storage->addFile(StorageFile(sourceId, sourceFile, L"cpp", "", true, true));
+  storage->addFile(StorageFile(headerId, L"/shared.h", L"cpp", "", true, false));
+
+  const Id sharedId = storage->addNode(StorageNodeData(2, L"shared")).first;
+  const Id symbolId = storage->addNode(StorageNodeData(2, symbolName)).first;
+  storage->addSymbol(StorageSymbol(sharedId, 1));
+
+  const Id edgeId = storage->addEdge(StorageEdgeData(4, symbolId, sharedId));
+  const Id headerLocationId = storage->addSourceLocation(StorageSourceLocationData(headerId, 1, 1, 1, 6, 0));
+  const Id sourceLocationId = storage->addSourceLocation(StorageSourceLocationData(sourceId, 2, 1, 2, 6, 0));
+  storage->addOccurrence(StorageOccurrence(sharedId, headerLocationId));
+  storage->addOccurrence(StorageOccurrence(edgeId, sourceLocationId));
+
+  const Id localSymbolId = storage->addLocalSymbol(StorageLocalSymbolData(L"shared.h<1:1>"));
+  storage->addOccurrence(StorageOccurrence(localSymbolId, headerLocationId));
+  storage->addComponentAccess(StorageComponentAccess(sharedId, 1));
+  storage->addElementComponent(StorageElementComponent(edgeId, 1, L""));
+  return storage;
+}
+
+// describes the records by content, so storages with different ids can be compared
+std::set<std::wstring> describe(const IntermediateStorage& storage) {
+  std::map<Id, std::wstring> names;
+  for(const StorageNode& node : storage.getStorageNodes()) {
+    names[node.id] = node.serializedName;
+  }
+  for(const StorageLocalSymbol& localSymbol : storage.getStorageLocalSymbols()) {
+    names[localSymbol.id] = localSymbol.name;
+  }
+  for(const StorageEdge& edge : storage.getStorageEdges()) {
+    names[edge.id] = names[edge.sourceNodeId] + L"->" + names[edge.targetNodeId];
+  }
+  for(const StorageSourceLocation& location : storage.getStorageSourceLocations()) {
+    names[location.id] = names[location.fileNodeId] + L":" + std::to_wstring(location.startLine);
+  }
+
+  std::set<std::wstring> descriptions;
+  for(const auto& name : names) {
+    descriptions.insert(name.second);
+  }
+  for(const StorageFile& file : storage.getStorageFiles()) {
+    descriptions.insert(L"file " + names[file.id] + (file.complete ? L" complete" : L""));
+  }
+  for(const StorageSymbol& symbol : storage.getStorageSymbols()) {
+    descriptions.insert(L"symbol " + names[symbol.id]);
+  }
+  for(const StorageOccurrence& occurrence : storage.getStorageOccurrences()) {
+    descriptions.insert(L"occurrence " + names[occurrence.elementId] + L" @ " + names[occurrence.sourceLocationId]);
+  }
+  for(const StorageComponentAccess& access : storage.getComponentAccesses()) {
+    descriptions.insert(L"access " + names[access.nodeId]);
+  }
+  for(const StorageElementComponent& component : storage.getElementComponents()) {
+    descriptions.insert(L"component " + names[component.elementId]);
+  }
+  return descriptions;
+}
+}    // namespace
+
+TEST(IntermediateStorage, mergeOfNothingIsEmpty) {
+  std::shared_ptr<IntermediateStorage> merged = IntermediateStorage::merge({});
+
+  ASSERT_TRUE(merged);
+  EXPECT_TRUE(merged->getStorageNodes().empty());
+  EXPECT_EQ(1u, merged->getNextId());
+}
+
+TEST(IntermediateStorage, mergeEqualsSequentialInjection) {
+  std::vector<std::shared_ptr<IntermediateStorage>> storages = {
+      createStorage(L"/a.cpp", L"a"), createStorage(L"/b.cpp", L"b"), createStorage(L"/c.cpp", L"c")};
+
+  IntermediateStorage injected;
+  for(const std::shared_ptr<IntermediateStorage>& storage : storages) {
+    injected.inject(storage.get());
+  }
+
+  std::shared_ptr<IntermediateStorage> merged = IntermediateStorage::merge(storages);
+
+  EXPECT_EQ(injected.getStorageNodes().size(), merged->getStorageNodes().size());
+  EXPECT_EQ(injected.getStorageEdges().size(), merged->getStorageEdges().size());
+  EXPECT_EQ(injected.getStorageSourceLocations().size(), merged->getStorageSourceLocations().size());
+  EXPECT_EQ(injected.getStorageOccurrences().size(), merged->getStorageOccurrences().size());
+  EXPECT_EQ(injected.getStorageLocalSymbols().size(), merged->getStorageLocalSymbols().size());
+  EXPECT_EQ(describe(injected), describe(*merged));
+}
+
+TEST(IntermediateStorage, mergeAssignsUniqueIds) {
+  std::shared_ptr<IntermediateStorage> merged =
+      IntermediateStorage::merge({createStorage(L"/a.cpp", L"a"), createStorage(L"/b.cpp", L"b")});
+
+  std::set<Id> ids;
+  size_t count = 0;
+  for(const StorageNode& node : merged->getStorageNodes()) {
+    ids.insert(node.id);
+    count++;
+  }
+  for(const StorageEdge& edge : merged->getStorageEdges()) {
+    ids.insert(edge.id);
+    count++;
+  }
+  for(const StorageSourceLocation& location : merged->getStorageSourceLocations()) {
+    ids.insert(location.id);
+    count++;
+  }
+
+  EXPECT_EQ(count, ids.size());
+  EXPECT_LT(*ids.rbegin(), merged->getNextId());
+}
+
+TEST(IntermediateStorage, assignedRecordsAreDeduplicated) {
+  IntermediateStorage storage;
+  storage.setStorageOccurrences({StorageOccurrence(1, 2), StorageOccurrence(3, 4), StorageOccurrence(1, 2)});
+
+  ASSERT_EQ(2U, storage.getStorageOccurrences().size());
+  EXPECT_EQ(3U, storage.getStorageOccurrences()[1].elementId);
+
+  // the index refers to the compacted records
+  storage.addOccurrence(StorageOccurrence(1, 2));
+  storage.addOccurrence(StorageOccurrence(3, 4));
+  EXPECT_EQ(2U, storage.getStorageOccurrences().size());
+}
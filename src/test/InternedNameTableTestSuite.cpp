@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include "InternedNameTable.h"
+#include "NameHierarchy.h"
+
+namespace {
+std::wstring serialize(const std::vector<std::wstring>& names) {
+  return NameHierarchy::serialize(NameHierarchy(names, NAME_DELIMITER_CXX));
+}
+}    // namespace
+
+TEST(InternedNameTable, namesSharePrefixElements) {
+  InternedNameTable table;
+  std::vector<InternedNameTable::Element> addedElements;
+
+  const Id first = table.intern(serialize({L"a", L"b", L"c"}), &addedElements);
+  EXPECT_EQ(3, addedElements.size());
+
+  addedElements.clear();
+  const Id second = table.intern(serialize({L"a", L"b", L"d"}), &addedElements);
+  ASSERT_EQ(1, addedElements.size());
+  EXPECT_EQ(second, addedElements[0].id);
+  EXPECT_EQ(first - 1, addedElements[0].parentId);
+
+  EXPECT_EQ(first, table.intern(serialize({L"a", L"b", L"c"})));
+  EXPECT_EQ(4, table.size());
+}
+
+TEST(InternedNameTable, reconstructsSerializedNames) {
+  InternedNameTable table;
+  NameHierarchy name(std::vector<std::wstring>({L"std", L"vector<int>"}), NAME_DELIMITER_CXX);
+  name.back().setSignature(L"void", L"(int) const");
+  const std::wstring serializedName = NameHierarchy::serialize(name);
+
+  const Id id = table.intern(serializedName);
+  EXPECT_EQ(serializedName, table.getSerializedName(id));
+  EXPECT_EQ(id, table.find(serializedName));
+  EXPECT_EQ(serialize({L"std"}), table.getSerializedName(table.find(serialize({L"std"}))));
+}
+
+TEST(InternedNameTable, doesNotFindNamesThatWereNotInterned) {
+  InternedNameTable table;
+  table.intern(serialize({L"a", L"b"}));
+
+  EXPECT_EQ(0, table.find(serialize({L"a", L"c"})));
+  EXPECT_EQ(0, table.find(serialize({L"b"})));
+  EXPECT_EQ(L"", table.getSerializedName(0));
+}
+
+TEST(InternedNameTable, restoresElementsInIdOrder) {
+  InternedNameTable table;
+  std::vector<InternedNameTable::Element> elements;
+  const Id id = table.intern(serialize({L"a", L"b"}), &elements);
+
+  InternedNameTable restored;
+  for(const InternedNameTable::Element& element : elements) {
+    EXPECT_TRUE(restored.add(element));
+  }
+  EXPECT_EQ(table.getSerializedName(id), restored.getSerializedName(id));
+
+  EXPECT_FALSE(restored.add({5, 0, L"x"}));
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+
+#include "IntermediateStorage.h"
+#include "NameHierarchy.h"
+#include "ParseLocation.h"
+#include "ParserClientImpl.h"
+#include "PersistentStorage.h"
+#include "ReferenceKind.h"
+
+namespace {
+FilePath getDbFilePath() {
+  return FilePath((std::filesystem::temp_directory_path() / "PersistentStorageTestSuite.srctrldb").wstring());
+}
+
+FilePath getBookmarkDbFilePath() {
+  return FilePath((std::filesystem::temp_directory_path() / "PersistentStorageTestSuite.srctrlbm").wstring());
+}
+
+void removeDatabases() {
+  std::remove(getDbFilePath().str().c_str());
+  std::remove(getBookmarkDbFilePath().str().c_str());
+}
+}    // namespace
+
+TEST(PersistentStorage, fileDependencyMapsAreLoadedFromPersistedDependencies) {
+  removeDatabases();
+  {
+    PersistentStorage storage(getDbFilePath(), getBookmarkDbFilePath());
+    storage.setup();
+
+    // a.cpp includes b.h which includes c.h, d.cpp imports a symbol defined in e.cpp
+    auto intermediateStorage = std::make_shared<IntermediateStorage>();
+    {
+      ParserClientImpl client(intermediateStorage.get());
+      const Id a = client.recordFile(FilePath(L"/src/a.cpp"), true);
+      const Id b = client.recordFile(FilePath(L"/src/b.h"), true);
+      const Id c = client.recordFile(FilePath(L"/src/c.h"), true);
+      const Id d = client.recordFile(FilePath(L"/src/d.cpp"), true);
+      const Id e = client.recordFile(FilePath(L"/src/e.cpp"), true);
+      client.recordReference(REFERENCE_INCLUDE, b, a, ParseLocation(a, 1, 1, 1, 10));
+      client.recordReference(REFERENCE_INCLUDE, c, b, ParseLocation(b, 1, 1, 1, 10));
+
+      const Id imported = client.recordSymbol(NameHierarchy(L"E", NAME_DELIMITER_CXX));
+      client.recordLocation(imported, ParseLocation(e, 1, 7, 1, 7), ParseLocationType::TOKEN);
+      client.recordReference(REFERENCE_IMPORT, imported, d, ParseLocation(d, 1, 1, 1, 8));
+    }
+    storage.inject(intermediateStorage.get());
+
+    storage.updateFileDependencies();
+    storage.buildCaches();
+
+    EXPECT_EQ(std::set<FilePath>({FilePath(L"/src/a.cpp"), FilePath(L"/src/b.h")}),
+              storage.getReferencing({FilePath(L"/src/c.h")}));
+    EXPECT_EQ(std::set<FilePath>({FilePath(L"/src/b.h"), FilePath(L"/src/c.h")}),
+              storage.getReferenced({FilePath(L"/src/a.cpp")}));
+    EXPECT_EQ(std::set<FilePath>({FilePath(L"/src/d.cpp")}), storage.getReferencing({FilePath(L"/src/e.cpp")}));
+    EXPECT_EQ(std::set<FilePath>({FilePath(L"/src/e.cpp")}), storage.getReferenced({FilePath(L"/src/d.cpp")}));
+    EXPECT_TRUE(storage.getReferencing({FilePath(L"/src/a.cpp")}).empty());
+
+    // the maps are rebuilt from the database
+    storage.clearCaches();
+    EXPECT_TRUE(storage.getReferencing({FilePath(L"/src/c.h")}).empty());
+    storage.buildCaches();
+    EXPECT_EQ(2U, storage.getReferencing({FilePath(L"/src/c.h")}).size());
+  }
+  removeDatabases();
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "FilePath.h"
+#include "IntermediateStorage.h"
+#include "ParseLocation.h"
+#include "ParserClientImpl.h"
+#include "PersistentStorage.h"
+#include "ReferenceKind.h"
+#include "RefreshInfo.h"
+#include "RefreshInfoGenerator.h"
+#include "SourceGroup.h"
+#include "SourceGroupSettingsUnloadable.h"
+
+namespace {
+class TestSourceGroup final : public SourceGroup {
+public:
+  explicit TestSourceGroup(std::set<FilePath> sourceFilePaths)
+      : m_sourceFilePaths(std::move(sourceFilePaths))
+      , m_settings(std::make_shared<SourceGroupSettingsUnloadable>("test", nullptr)) {}
+
+  std::set<FilePath> filterToContainedFilePaths(const std::set<FilePath>& filePaths) const override {
+    return filePaths;
+  }
+
+  std::set<FilePath> getAllSourceFilePaths() const override {
+    return m_sourceFilePaths;
+  }
+
+  std::vector<std::shared_ptr<IndexerCommand>> getIndexerCommands(const RefreshInfo& /*info*/) const override {
+    return {};
+  }
+
+private:
+  std::shared_ptr<SourceGroupSettings> getSourceGroupSettings() override {
+    return m_settings;
+  }
+
+  std::shared_ptr<const SourceGroupSettings> getSourceGroupSettings() const override {
+    return m_settings;
+  }
+
+  std::set<FilePath> m_sourceFilePaths;
+  std::shared_ptr<SourceGroupSettings> m_settings;
+};
+
+// main.cpp includes header.h, other.cpp is independent, all of them are indexed
+class RefreshInfoGeneratorFix : public testing::Test {
+protected:
+  void SetUp() override {
+    std::filesystem::remove_all(m_directory);
+    std::filesystem::create_directories(m_directory);
+
+    writeFile(L"main.cpp", "#include \"header.h\"\nint main() { return value; }\n");
+    writeFile(L"header.h", "int value = 1;\n");
+    writeFile(L"other.cpp", "int other() { return 0; }\n");
+
+    m_storage = std::make_shared<PersistentStorage>(getPath(L"project.srctrldb"), getPath(L"project.srctrlbm"));
+    m_storage->setup();
+
+    auto intermediateStorage = std::make_shared<IntermediateStorage>();
+    {
+      ParserClientImpl client(intermediateStorage.get());
+      const Id mainId = client.recordFile(getPath(L"main.cpp"), true);
+      const Id headerId = client.recordFile(getPath(L"header.h"), true);
+      client.recordFile(getPath(L"other.cpp"), true);
+      client.recordReference(REFERENCE_INCLUDE, headerId, mainId, ParseLocation(mainId, 1, 1, 1, 19));
+    }
+    m_storage->inject(intermediateStorage.get());
+    m_storage->updateFileDependencies();
+    m_storage->buildCaches();
+
+    m_sourceGroups = {std::make_shared<TestSourceGroup>(std::set<FilePath>({getPath(L"main.cpp"), getPath(L"other.cpp")}))};
+  }
+
+  void TearDown() override {
+    m_storage.reset();
+    std::filesystem::remove_all(m_directory);
+  }
+
+  FilePath getPath(const std::wstring& fileName) const {
+    return FilePath((m_directory / fileName).wstring());
+  }
+
+  void writeFile(const std::wstring& fileName, const std::string& content) const {
+    std::ofstream(m_directory / fileName, std::ios::binary | std::ios::trunc) << content;
+  }
+
+  // the stored modification time has a resolution of seconds
+  void touchFile(const std::wstring& fileName) const {
+    const std::filesystem::path path = m_directory / fileName;
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::hours(1));
+  }
+
+  const std::filesystem::path m_directory = std::filesystem::temp_directory_path() / "RefreshInfoGeneratorTestSuite";
+  std::shared_ptr<PersistentStorage> m_storage;
+  std::vector<std::shared_ptr<SourceGroup>> m_sourceGroups;
+};
+}    // namespace
+
+TEST_F(RefreshInfoGeneratorFix, filesWithNewerModificationTimeButSameContentAreNotReindexed) {
+  touchFile(L"main.cpp");
+  touchFile(L"header.h");
+  touchFile(L"other.cpp");
+
+  const RefreshInfo info = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage);
+
+  EXPECT_TRUE(info.filesToIndex.empty());
+  EXPECT_TRUE(info.filesToClear.empty());
+  EXPECT_TRUE(info.nonIndexedFilesToClear.empty());
+}
+
+TEST_F(RefreshInfoGeneratorFix, includingFileIsReindexedWhenHeaderContentChanges) {
+  writeFile(L"header.h", "int value = 2;\n");
+  touchFile(L"header.h");
+  touchFile(L"other.cpp");
+
+  const RefreshInfo info = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage);
+
+  EXPECT_EQ(std::set<FilePath>({getPath(L"main.cpp")}), info.filesToIndex);
+  EXPECT_EQ(std::set<FilePath>({getPath(L"header.h"), getPath(L"main.cpp")}), info.filesToClear);
+}
+
+TEST_F(RefreshInfoGeneratorFix, changedContentIsIgnoredWithoutNewerModificationTime) {
+  const auto writeTime = std::filesystem::last_write_time(m_directory / L"other.cpp");
+  writeFile(L"other.cpp", "int other() { return 1; }\n");
+  std::filesystem::last_write_time(m_directory / L"other.cpp", writeTime);
+
+  const RefreshInfo info = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage);
+
+  EXPECT_TRUE(info.filesToIndex.empty());
+  EXPECT_TRUE(info.filesToClear.empty());
+}
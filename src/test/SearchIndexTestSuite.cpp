@@ -1,3 +1,5 @@
+#include <sstream>
+
 #include <gtest/gtest.h>
 
 #include "NameHierarchy.h"
@@ -82,3 +84,77 @@ TEST(SearchIndex, searchIndexRatesHigherOnConsecutiveLetters) {
   EXPECT_TRUE(L"ocbcabc" == results[0].text);
   EXPECT_TRUE(L"oaabbcc" == results[1].text);
 }
+
+TEST(SearchIndex, searchIndexFindsElementsOfSplitEdgesAndSharedNames) {
+  SearchIndex index;
+  index.addNode(3, L"foobar");
+  index.addNode(1, L"foo");
+  index.addNode(2, L"foobar", NodeType(NODE_FUNCTION));
+  index.finishSetup();
+
+  std::vector<SearchResult> results = index.search(L"fb", NodeTypeSet::all(), 0);
+  EXPECT_TRUE(1 == results.size());
+  EXPECT_TRUE(L"foobar" == results[0].text);
+  EXPECT_TRUE(std::vector<Id>({2, 3}) == results[0].elementIds);
+
+  results = index.search(L"fb", NodeTypeSet(NodeType(NODE_FUNCTION)), 0);
+  EXPECT_TRUE(1 == results.size());
+  EXPECT_TRUE(std::vector<Id>({2}) == results[0].elementIds);
+
+  EXPECT_TRUE(2 == index.search(L"fo", NodeTypeSet::all(), 0).size());
+  EXPECT_TRUE(index.search(L"fx", NodeTypeSet::all(), 0).empty());
+}
+
+TEST(SearchIndex, searchIndexFindsResultsInLargeIndex) {
+  SearchIndex index;
+  for(Id i = 1; i <= 30000; i++) {
+    index.addNode(i, L"name" + std::to_wstring(i));
+    index.addNode(i + 30000, L"other" + std::to_wstring(i));
+  }
+  index.finishSetup();
+
+  std::vector<SearchResult> results = index.search(L"name12345", NodeTypeSet::all(), 0);
+  EXPECT_TRUE(1 == results.size());
+  EXPECT_TRUE(std::vector<Id>({12345}) == results[0].elementIds);
+
+  results = index.search(L"er99", NodeTypeSet::all(), 10);
+  EXPECT_TRUE(10 == results.size());
+  for(size_t i = 0; i < results.size(); i++) {
+    EXPECT_TRUE(results[i].elementIds[0] > 30000);
+    EXPECT_TRUE(i == 0 || results[i - 1].score >= results[i].score);
+  }
+}
+
+TEST(SearchIndex, searchIndexSnapshotKeepsSearchResults) {
+  SearchIndex index;
+  index.addNode(1, L"foo::bar", NodeType(NODE_FUNCTION));
+  index.addNode(2, L"foo::baz", NodeType(NODE_CLASS));
+  index.addNode(3, L"foobar", NodeType(NODE_FUNCTION));
+  index.finishSetup();
+
+  std::stringstream stream;
+  index.writeToStream(stream);
+
+  SearchIndex loadedIndex;
+  EXPECT_TRUE(loadedIndex.readFromStream(stream));
+
+  for(const NodeTypeSet& types : {NodeTypeSet::all(), NodeTypeSet(NodeType(NODE_CLASS))}) {
+    const std::vector<SearchResult> results = index.search(L"fba", types, 0);
+    const std::vector<SearchResult> loadedResults = loadedIndex.search(L"fba", types, 0);
+
+    ASSERT_EQ(results.size(), loadedResults.size());
+    for(size_t i = 0; i < results.size(); i++) {
+      EXPECT_EQ(results[i].text, loadedResults[i].text);
+      EXPECT_EQ(results[i].elementIds, loadedResults[i].elementIds);
+      EXPECT_EQ(results[i].score, loadedResults[i].score);
+    }
+  }
+}
+
+TEST(SearchIndex, searchIndexRejectsInvalidSnapshot) {
+  std::stringstream stream("no snapshot");
+
+  SearchIndex index;
+  EXPECT_FALSE(index.readFromStream(stream));
+  EXPECT_TRUE(index.search(L"no", NodeTypeSet::all(), 0).empty());
+}
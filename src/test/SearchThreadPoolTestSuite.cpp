@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "SearchThreadPool.h"
+
+TEST(SearchThreadPool, jobRunsOnBoundedNumberOfThreads) {
+  SearchThreadPool pool(2);
+  std::mutex mutex;
+  std::set<std::thread::id> threadIds;
+  std::atomic<size_t> nextItem = 0;
+
+  pool.run(
+      [&]() {
+        for(size_t i = nextItem++; i < 1000; i = nextItem++) {
+          std::lock_guard<std::mutex> lock(mutex);
+          threadIds.insert(std::this_thread::get_id());
+        }
+      },
+      10);
+
+  EXPECT_LE(1000U, nextItem);
+  EXPECT_GE(3U, threadIds.size());
+  EXPECT_EQ(1U, threadIds.count(std::this_thread::get_id()));
+}
+
+TEST(SearchThreadPool, concurrentRunsShareWorkers) {
+  SearchThreadPool pool(1);
+  std::atomic<size_t> itemCount = 0;
+
+  std::vector<std::thread> threads;
+  for(size_t i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      std::atomic<size_t> nextItem = 0;
+      pool.run(
+          [&]() {
+            for(size_t j = nextItem++; j < 100; j = nextItem++) {
+              itemCount++;
+            }
+          },
+          4);
+    });
+  }
+
+  for(std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(400U, itemCount);
+}
@@ -0,0 +1,320 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+#include "LocationType.h"
+#include "SqliteIndexStorage.h"
+#include "TextAccess.h"
+
+namespace {
+FilePath getDbFilePath() {
+  return FilePath((std::filesystem::temp_directory_path() / "SqliteIndexStorageTestSuite.srctrldb").wstring());
+}
+
+std::vector<Id> addNodes(SqliteIndexStorage& storage, size_t count) {
+  std::vector<StorageNode> nodes;
+  for(size_t i = 0; i < count; i++) {
+    nodes.emplace_back(0, 1, L"::\tmnode" + std::to_wstring(i) + L"\ts\tp");
+  }
+  return storage.addNodes(nodes);
+}
+}    // namespace
+
+TEST(SqliteIndexStorage, idSetQueriesReturnEveryMatchOnce) {
+  std::remove(getDbFilePath().str().c_str());
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+
+    storage.beginTransaction();
+    const std::vector<Id> nodeIds = addNodes(storage, 1300);
+    std::vector<StorageEdge> edges;
+    for(size_t i = 1; i < nodeIds.size(); i++) {
+      edges.emplace_back(0, StorageEdgeData(static_cast<int>(i % 3), nodeIds[0], nodeIds[i]));
+    }
+    storage.addEdges(edges);
+    storage.commitTransaction();
+
+    // more ids than fit into one statement
+    EXPECT_EQ(1300U, storage.getAllByIds<StorageNode>(nodeIds).size());
+    EXPECT_EQ(1299U, storage.getEdgesByTargetIds(nodeIds).size());
+    EXPECT_EQ(433U, storage.getEdgesBySourceType(nodeIds[0], 1).size());
+    EXPECT_EQ(nodeIds[5], storage.getFirstById<StorageNode>(nodeIds[5]).id);
+
+    // duplicates don't duplicate results and the cached statements are reused
+    std::vector<Id> someIds(nodeIds.begin(), nodeIds.begin() + 37);
+    someIds.push_back(nodeIds[3]);
+    EXPECT_EQ(37U, storage.getAllByIds<StorageNode>(someIds).size());
+    EXPECT_EQ(37U, storage.getAllByIds<StorageNode>(someIds).size());
+
+    size_t nestedCount = 0;
+    storage.forEachByIds<StorageNode>(
+        someIds, [&](StorageNode&&) { nestedCount += storage.getAllByIds<StorageNode>(someIds).size(); });
+    EXPECT_EQ(37U * 37U, nestedCount);
+  }
+  std::remove(getDbFilePath().str().c_str());
+}
+
+TEST(SqliteIndexStorage, bulkLoadedDataIsReadableAfterSwitchingMode) {
+  std::remove(getDbFilePath().str().c_str());
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+    storage.setMode(SqliteIndexStorage::STORAGE_MODE_BULK_LOAD);
+
+    storage.beginTransaction();
+    const std::vector<Id> nodeIds = addNodes(storage, 10);
+    storage.addComponentAccesses({StorageComponentAccess(nodeIds[3], 1), StorageComponentAccess(nodeIds[1], 2)});
+    storage.commitTransaction();
+
+    storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+    EXPECT_EQ(10, storage.getNodeCount());
+    EXPECT_EQ(2U, storage.getComponentAccessesByNodeIds(nodeIds).size());
+    EXPECT_EQ(2, storage.getComponentAccessByNodeId(nodeIds[1]).type);
+  }
+  std::remove(getDbFilePath().str().c_str());
+}
+
+TEST(SqliteIndexStorage, rowsLeftDanglingByBulkLoadAreRemovedTransitively) {
+  std::remove(getDbFilePath().str().c_str());
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+    storage.setMode(SqliteIndexStorage::STORAGE_MODE_BULK_LOAD);
+
+    storage.beginTransaction();
+    const std::vector<Id> nodeIds = addNodes(storage, 2);
+    const Id missingNodeId = nodeIds.back() + 100;
+    const Id validLocationId = storage.addSourceLocation(StorageSourceLocationData(nodeIds[0], 1, 1, 1, 5, 0));
+    // the occurrence only dangles once the location referencing the missing file is removed
+    const Id orphanedLocationId = storage.addSourceLocation(StorageSourceLocationData(missingNodeId, 2, 1, 2, 5, 0));
+    storage.addOccurrences({StorageOccurrence(nodeIds[1], validLocationId), StorageOccurrence(nodeIds[1], orphanedLocationId)});
+    storage.addEdge(StorageEdgeData(1, nodeIds[0], missingNodeId));
+    storage.addEdge(StorageEdgeData(1, nodeIds[0], nodeIds[1]));
+    storage.commitTransaction();
+
+    storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+    EXPECT_EQ(1, storage.getSourceLocationCount());
+    EXPECT_EQ(1, storage.getEdgeCount());
+    EXPECT_EQ(1U, storage.getOccurrencesForElementIds({nodeIds[1]}).size());
+    EXPECT_TRUE(storage.getOccurrencesForLocationId(orphanedLocationId).empty());
+  }
+  std::remove(getDbFilePath().str().c_str());
+}
+
+TEST(SqliteIndexStorage, readModeQueriesRunOnEveryThreadAndSeeOpenTransactions) {
+  std::remove(getDbFilePath().str().c_str());
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+
+    storage.beginTransaction();
+    const std::vector<Id> nodeIds = addNodes(storage, 100);
+    storage.commitTransaction();
+
+    storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+    std::vector<size_t> nodeCounts(4, 0);
+    std::vector<std::thread> threads;
+    for(size_t i = 0; i < nodeCounts.size(); i++) {
+      threads.emplace_back([&, i]() { nodeCounts[i] = storage.getAllByIds<StorageNode>(nodeIds).size(); });
+    }
+    for(std::thread& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(std::vector<size_t>(4, 100), nodeCounts);
+
+    // connections are handed back after each read, so short lived threads don't use up the pool
+    for(size_t i = 0; i < 20; i++) {
+      size_t nodeCount = 0;
+      std::thread([&]() { nodeCount = storage.getAllByIds<StorageNode>(nodeIds).size(); }).join();
+      EXPECT_EQ(100U, nodeCount);
+    }
+
+    // uncommitted data is only visible on the writing connection
+    storage.beginTransaction();
+    const Id nodeId = storage.addNode(StorageNodeData(1, L"::\tmadded\ts\tp"));
+    EXPECT_EQ(nodeId, storage.getNodeById(nodeId).id);
+    storage.commitTransaction();
+
+    EXPECT_EQ(101, storage.getNodeCount());
+  }
+  std::remove(getDbFilePath().str().c_str());
+}
+
+TEST(SqliteIndexStorage, committedTransactionsBumpWriteCount) {
+  std::remove(getDbFilePath().str().c_str());
+  std::string databaseId;
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+    databaseId = storage.getDatabaseId();
+    EXPECT_FALSE(databaseId.empty());
+
+    const size_t writeCount = storage.getWriteCount();
+    storage.beginTransaction();
+    addNodes(storage, 3);
+    storage.commitTransaction();
+    EXPECT_EQ(writeCount + 1, storage.getWriteCount());
+
+    storage.checkpoint();
+    EXPECT_EQ(writeCount + 1, storage.getWriteCount());
+  }
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+    EXPECT_EQ(databaseId, storage.getDatabaseId());
+
+    // a cleared database is a different one
+    storage.clear();
+    EXPECT_NE(databaseId, storage.getDatabaseId());
+  }
+  std::remove(getDbFilePath().str().c_str());
+}
+
+TEST(SqliteIndexStorage, fileDependenciesAreDerivedFromIncludesAndImportedDefinitions) {
+  const int includeType = 1;
+  const int importType = 2;
+
+  std::remove(getDbFilePath().str().c_str());
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+
+    storage.beginTransaction();
+    // a.cpp includes b.h, c.java imports a symbol defined in d.java and qualified in a.cpp
+    const std::vector<Id> nodeIds = addNodes(storage, 5);
+    const Id symbolId = nodeIds[4];
+    const std::vector<std::wstring> filePaths = {L"/src/a.cpp", L"/src/b.h", L"/src/c.java", L"/src/d.java"};
+    for(size_t i = 0; i < filePaths.size(); i++) {
+      storage.addFile(StorageFile(nodeIds[i], filePaths[i], L"", "2000-01-01 00:00:00", true, true),
+                      TextAccess::createFromString("content " + std::to_string(i)));
+    }
+
+    storage.addEdges({StorageEdge(0, StorageEdgeData(includeType, nodeIds[0], nodeIds[1])),
+                      StorageEdge(0, StorageEdgeData(importType, nodeIds[2], symbolId))});
+
+    const Id definitionLocationId = storage.addSourceLocation(StorageSourceLocationData(nodeIds[3], 1, 1, 1, 5, LOCATION_TOKEN));
+    const Id qualifierLocationId = storage.addSourceLocation(
+        StorageSourceLocationData(nodeIds[0], 1, 1, 1, 5, LOCATION_QUALIFIER));
+    storage.addOccurrences({StorageOccurrence(symbolId, definitionLocationId), StorageOccurrence(symbolId, qualifierLocationId)});
+
+    storage.updateFileDependencies(includeType, importType);
+    // updating again replaces the dependencies
+    storage.updateFileDependencies(includeType, importType);
+    storage.commitTransaction();
+
+    std::vector<StorageFileDependency> dependencies;
+    storage.forEach<StorageFileDependency>([&](StorageFileDependency&& dependency) { dependencies.push_back(dependency); });
+    std::sort(dependencies.begin(), dependencies.end(), [](const StorageFileDependency& a, const StorageFileDependency& b) {
+      return a.type < b.type;
+    });
+
+    ASSERT_EQ(2U, dependencies.size());
+    EXPECT_EQ(nodeIds[0], dependencies[0].fileNodeId);
+    EXPECT_EQ(nodeIds[1], dependencies[0].referencedFileNodeId);
+    EXPECT_EQ(includeType, dependencies[0].type);
+    EXPECT_EQ(nodeIds[2], dependencies[1].fileNodeId);
+    EXPECT_EQ(nodeIds[3], dependencies[1].referencedFileNodeId);
+    EXPECT_EQ(importType, dependencies[1].type);
+
+    // removing a file removes its dependencies
+    storage.beginTransaction();
+    storage.removeElement(nodeIds[1]);
+    storage.commitTransaction();
+
+    dependencies.clear();
+    storage.forEach<StorageFileDependency>([&](StorageFileDependency&& dependency) { dependencies.push_back(dependency); });
+    ASSERT_EQ(1U, dependencies.size());
+    EXPECT_EQ(nodeIds[2], dependencies[0].fileNodeId);
+  }
+  std::remove(getDbFilePath().str().c_str());
+}
+
+TEST(SqliteIndexStorage, contentHashesAreStoredForIndexedFiles) {
+  std::remove(getDbFilePath().str().c_str());
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+
+    storage.beginTransaction();
+    const std::vector<Id> nodeIds = addNodes(storage, 3);
+    storage.addFile(StorageFile(nodeIds[0], L"/src/a.cpp", L"cpp", "2000-01-01 00:00:00", true, true),
+                    TextAccess::createFromString("int a;"));
+    storage.addFile(StorageFile(nodeIds[1], L"/src/b.cpp", L"cpp", "2000-01-01 00:00:00", true, true),
+                    TextAccess::createFromString("int a;"));
+    storage.addFile(StorageFile(nodeIds[2], L"/src/c.h", L"cpp", "2000-01-01 00:00:00", false, true),
+                    TextAccess::createFromString("int c;"));
+    storage.commitTransaction();
+
+    const std::unordered_map<std::wstring, std::string> contentHashes = storage.getFileContentHashes();
+    ASSERT_EQ(2U, contentHashes.size());
+    EXPECT_FALSE(contentHashes.at(L"/src/a.cpp").empty());
+    EXPECT_EQ(contentHashes.at(L"/src/a.cpp"), contentHashes.at(L"/src/b.cpp"));
+  }
+  std::remove(getDbFilePath().str().c_str());
+}
+
+TEST(SqliteIndexStorage, indexingCostsOfRemovedFilesAreRemoved) {
+  std::remove(getDbFilePath().str().c_str());
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+
+    storage.beginTransaction();
+    const std::vector<Id> nodeIds = addNodes(storage, 2);
+    storage.addFile(StorageFile(nodeIds[0], L"/src/a.cpp", L"cpp", "2000-01-01 00:00:00", true, true),
+                    TextAccess::createFromString("int a;"));
+    storage.addFile(StorageFile(nodeIds[1], L"/src/b.cpp", L"cpp", "2000-01-01 00:00:00", true, true),
+                    TextAccess::createFromString("int b;"));
+    storage.addIndexingCosts({StorageIndexingCost(L"/src/a.cpp", 10), StorageIndexingCost(L"/src/b.cpp", 20)});
+    storage.removeElement(nodeIds[1]);
+    storage.removeUnreferencedIndexingCosts();
+    storage.commitTransaction();
+
+    const std::vector<StorageIndexingCost> indexingCosts = storage.getAll<StorageIndexingCost>();
+    ASSERT_EQ(1U, indexingCosts.size());
+    EXPECT_EQ(L"/src/a.cpp", indexingCosts[0].sourceFilePath);
+    EXPECT_EQ(10U, indexingCosts[0].durationMS);
+  }
+  std::remove(getDbFilePath().str().c_str());
+}
+
+TEST(SqliteIndexStorage, nameElementsOfRemovedNodesAreRemovedAndRemainingNamesStayIntact) {
+  std::remove(getDbFilePath().str().c_str());
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+
+    storage.beginTransaction();
+    const std::vector<Id> nodeIds = storage.addNodes({StorageNode(0, 1, L"::\tmremoved\ts\tp"),
+                                                      StorageNode(0, 1, L"::\tmremoved\ts\tp\tnchild\ts\tp"),
+                                                      StorageNode(0, 1, L"::\tmkept\ts\tp"),
+                                                      StorageNode(0, 1, L"::\tmkept\ts\tp\tnchild\ts\tp")});
+    storage.removeElements({nodeIds[0], nodeIds[1], nodeIds[2]});
+    storage.removeUnreferencedNameElements();
+    storage.commitTransaction();
+
+    EXPECT_EQ(0U, storage.getNodeBySerializedName(L"::\tmremoved\ts\tp").id);
+    EXPECT_EQ(nodeIds[3], storage.getNodeBySerializedName(L"::\tmkept\ts\tp\tnchild\ts\tp").id);
+
+    storage.beginTransaction();
+    const Id addedId = storage.addNode(StorageNodeData(1, L"::\tmadded\ts\tp"));
+    storage.commitTransaction();
+    EXPECT_EQ(L"::\tmadded\ts\tp", storage.getNodeById(addedId).serializedName);
+  }
+  {
+    SqliteIndexStorage storage(getDbFilePath());
+    storage.setup();
+
+    const StorageNode node = storage.getNodeBySerializedName(L"::\tmkept\ts\tp\tnchild\ts\tp");
+    EXPECT_EQ(L"::\tmkept\ts\tp\tnchild\ts\tp", storage.getNodeById(node.id).serializedName);
+    EXPECT_EQ(L"::\tmadded\ts\tp", storage.getNodeBySerializedName(L"::\tmadded\ts\tp").serializedName);
+  }
+  std::remove(getDbFilePath().str().c_str());
+}
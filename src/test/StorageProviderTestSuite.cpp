@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include "IntermediateStorage.h"
+#include "StorageProvider.h"
+
+namespace {
+std::shared_ptr<IntermediateStorage> createStorage(const std::vector<std::wstring>& filePaths, size_t locationCount) {
+  auto storage = std::make_shared<IntermediateStorage>();
+  for(const std::wstring& filePath : filePaths) {
+    const Id fileId = storage->addNode(StorageNodeData(1, filePath)).first;
+    storage->addFile(StorageFile(fileId, filePath, L"cpp", "", true, true));
+    for(size_t i = 0; i < locationCount; i++) {
+      storage->addSourceLocation(StorageSourceLocationData(fileId, i + 1, 1, i + 1, 2, 0));
+    }
+  }
+  return storage;
+}
+}    // namespace
+
+TEST(StorageProvider, largestStorageIsConsumedFirst) {
+  StorageProvider provider;
+  auto small = createStorage({L"/a.cpp"}, 1);
+  auto large = createStorage({L"/b.cpp"}, 100);
+  auto medium = createStorage({L"/c.cpp"}, 10);
+
+  provider.insert(small);
+  provider.insert(large);
+  provider.insert(medium);
+
+  EXPECT_EQ(3, provider.getStorageCount());
+  EXPECT_EQ(large, provider.consumeLargestStorage());
+  EXPECT_EQ(medium, provider.consumeLargestStorage());
+  EXPECT_EQ(small, provider.consumeLargestStorage());
+  EXPECT_FALSE(provider.consumeLargestStorage());
+}
+
+TEST(StorageProvider, byteSizeFollowsQueuedStorages) {
+  StorageProvider provider;
+  auto storage = createStorage({L"/a.cpp"}, 10);
+
+  provider.insert(storage);
+  EXPECT_EQ(storage->getByteSize(sizeof(std::string)), provider.getByteSize());
+
+  provider.consumeLargestStorage();
+  EXPECT_EQ(0u, provider.getByteSize());
+  EXPECT_EQ(storage->getByteSize(sizeof(std::string)), provider.getMetrics().peakByteSize);
+}
+
+TEST(StorageProvider, noMergeWithLessThanThreeStorages) {
+  StorageProvider provider;
+  provider.insert(createStorage({L"/a.cpp"}, 1));
+  provider.insert(createStorage({L"/b.cpp"}, 1));
+
+  EXPECT_TRUE(provider.consumeMergeGroup(8).storages.empty());
+  EXPECT_EQ(2, provider.getStorageCount());
+}
+
+TEST(StorageProvider, mergeGroupPrefersSharedFiles) {
+  StorageProvider provider;
+  auto largest = createStorage({L"/a.cpp", L"/common.h"}, 100);
+  auto first = createStorage({L"/b.cpp", L"/shared.h"}, 20);
+  auto unrelated = createStorage({L"/c.cpp"}, 15);
+  auto second = createStorage({L"/d.cpp", L"/shared.h"}, 10);
+  auto third = createStorage({L"/e.cpp", L"/shared.h"}, 5);
+
+  provider.insert(largest);
+  provider.insert(first);
+  provider.insert(unrelated);
+  provider.insert(second);
+  provider.insert(third);
+
+  StorageProvider::MergeGroup mergeGroup = provider.consumeMergeGroup(8);
+  ASSERT_EQ(3u, mergeGroup.storages.size());
+  EXPECT_EQ(first, mergeGroup.storages[0]);
+  EXPECT_EQ(2, provider.getStorageCount());
+  EXPECT_EQ(1u, provider.getMetrics().runningMergeCount);
+
+  provider.insertMergeResult(mergeGroup, IntermediateStorage::merge(mergeGroup.storages));
+
+  const StorageProvider::Metrics metrics = provider.getMetrics();
+  EXPECT_EQ(3u, metrics.storageCount);
+  EXPECT_EQ(0u, metrics.runningMergeCount);
+  EXPECT_EQ(1u, metrics.mergeCount);
+  EXPECT_GT(metrics.savedByteSize, 0u);
+  EXPECT_EQ(largest, provider.consumeLargestStorage());
+}
+
+TEST(StorageProvider, mergeGroupIsLimited) {
+  StorageProvider provider;
+  for(size_t i = 0; i < 6; i++) {
+    provider.insert(createStorage({L"/" + std::to_wstring(i) + L".cpp"}, i + 1));
+  }
+
+  EXPECT_EQ(3u, provider.consumeMergeGroup(3).storages.size());
+  EXPECT_EQ(3, provider.getStorageCount());
+}
+
+TEST(StorageProvider, byteSizeIncludesRunningMerges) {
+  StorageProvider provider;
+  for(size_t i = 0; i < 4; i++) {
+    provider.insert(createStorage({L"/" + std::to_wstring(i) + L".cpp"}, i + 1));
+  }
+  const size_t byteSize = provider.getByteSize();
+
+  StorageProvider::MergeGroup mergeGroup = provider.consumeMergeGroup(3);
+  ASSERT_EQ(3u, mergeGroup.storages.size());
+  EXPECT_EQ(byteSize, provider.getByteSize());
+  EXPECT_EQ(mergeGroup.byteSize, provider.getMetrics().mergingByteSize);
+
+  provider.insertMergeResult(mergeGroup, IntermediateStorage::merge(mergeGroup.storages));
+  EXPECT_EQ(0u, provider.getMetrics().mergingByteSize);
+  EXPECT_EQ(2, provider.getStorageCount());
+}
+
+TEST(StorageProvider, mergeResultIsDroppedAfterClear) {
+  StorageProvider provider;
+  for(size_t i = 0; i < 4; i++) {
+    provider.insert(createStorage({L"/" + std::to_wstring(i) + L".cpp"}, i + 1));
+  }
+
+  StorageProvider::MergeGroup mergeGroup = provider.consumeMergeGroup(3);
+  ASSERT_EQ(3u, mergeGroup.storages.size());
+
+  provider.clear();
+  EXPECT_EQ(mergeGroup.byteSize, provider.getByteSize());
+
+  provider.insertMergeResult(mergeGroup, IntermediateStorage::merge(mergeGroup.storages));
+
+  const StorageProvider::Metrics metrics = provider.getMetrics();
+  EXPECT_EQ(0u, metrics.storageCount);
+  EXPECT_EQ(0u, metrics.runningMergeCount);
+  EXPECT_EQ(0u, provider.getByteSize());
+}
@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+#include "SuffixArray.h"
+
+TEST(SuffixArray, findsAllOccurrencesOfTerm) {
+  SuffixArray array(L"abracadabra");
+
+  EXPECT_EQ(std::vector<int>({0, 7}), array.searchForTerm(L"abra"));
+  EXPECT_EQ(std::vector<int>({0, 3, 5, 7, 10}), array.searchForTerm(L"a"));
+  EXPECT_EQ(std::vector<int>({4}), array.searchForTerm(L"cad"));
+}
+
+TEST(SuffixArray, searchIsCaseInsensitive) {
+  SuffixArray array(L"Foo foo FOO");
+
+  EXPECT_EQ(std::vector<int>({0, 4, 8}), array.searchForTerm(L"fOo"));
+}
+
+TEST(SuffixArray, doesNotFindMissingTerms) {
+  SuffixArray array(L"abracadabra");
+
+  EXPECT_TRUE(array.searchForTerm(L"abrax").empty());
+  EXPECT_TRUE(array.searchForTerm(L"z").empty());
+  EXPECT_TRUE(array.searchForTerm(L"abracadabra!").empty());
+  EXPECT_TRUE(array.searchForTerm(L"").empty());
+}
+
+TEST(SuffixArray, findsSameOccurrencesAsNaiveSearch) {
+  std::wstring text;
+  for(int i = 0; i < 5000; i++) {
+    text += static_cast<wchar_t>(L'a' + (i * 7 + i / 13) % 4);
+  }
+  SuffixArray array(text);
+
+  for(const std::wstring term : {L"ab", L"dab", L"cdcd", L"aaaa", L"bcda"}) {
+    std::vector<int> expected;
+    for(size_t pos = text.find(term); pos != std::wstring::npos; pos = text.find(term, pos + 1)) {
+      expected.push_back(static_cast<int>(pos));
+    }
+    EXPECT_EQ(expected, array.searchForTerm(term));
+  }
+}
+
+TEST(SuffixArray, segmentFileKeepsSearchResults) {
+  const std::string filePath = (std::filesystem::temp_directory_path() / "SuffixArrayTestSuite.segment").string();
+  ASSERT_TRUE(SuffixArray::writeToFile(
+      filePath, {{"first", std::make_shared<SuffixArray>(L"abracadabra")}, {"second", std::make_shared<SuffixArray>(L"cab")}}));
+
+  SuffixArray::KeyedArrays arrays = SuffixArray::loadFromFile(filePath);
+  ASSERT_EQ(2U, arrays.size());
+  EXPECT_EQ("first", arrays[0].first);
+  EXPECT_EQ(std::vector<int>({0, 7}), arrays[0].second->searchForTerm(L"abra"));
+  EXPECT_EQ(0, arrays[0].second->getByteSize());
+  EXPECT_EQ("second", arrays[1].first);
+  EXPECT_EQ(std::vector<int>({1}), arrays[1].second->searchForTerm(L"ab"));
+
+  EXPECT_TRUE(SuffixArray::loadFromFile(filePath + ".missing").empty());
+
+  arrays.clear();
+  std::remove(filePath.c_str());
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <set>
+
+#include "Blackboard.h"
+#include "IntermediateStorage.h"
+#include "MessageIndexingInterrupted.h"
+#include "StorageProvider.h"
+#include "TaskInjectStorage.h"
+
+namespace {
+std::shared_ptr<IntermediateStorage> createStorage(const std::wstring& filePath) {
+  auto storage = std::make_shared<IntermediateStorage>();
+  const Id fileId = storage->addNode(StorageNodeData(1, filePath)).first;
+  storage->addFile(StorageFile(fileId, filePath, L"cpp", "", true, true));
+  return storage;
+}
+
+struct TestStorage final : public IntermediateStorage {
+  void prepareInjection(const Storage* injected) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    prepared.insert(injected);
+  }
+
+  void discardPreparedInjection(const Storage* injected) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    discarded.insert(injected);
+  }
+
+  std::mutex mutex;
+  std::set<const Storage*> prepared;
+  std::set<const Storage*> discarded;
+};
+}    // namespace
+
+TEST(TaskInjectStorage, injectsAllQueuedStorages) {
+  auto provider = std::make_shared<StorageProvider>();
+  auto target = std::make_shared<TestStorage>();
+  auto blackboard = std::make_shared<Blackboard>();
+
+  provider->insert(createStorage(L"/a.cpp"));
+  provider->insert(createStorage(L"/b.cpp"));
+
+  TaskInjectStorage task(provider, target);
+  EXPECT_EQ(Task::STATE_SUCCESS, task.update(blackboard));
+  EXPECT_EQ(Task::STATE_SUCCESS, task.update(blackboard));
+  EXPECT_EQ(Task::STATE_FAILURE, task.update(blackboard));
+
+  EXPECT_EQ(2u, target->getStorageFiles().size());
+  EXPECT_EQ(2u, target->prepared.size());
+  EXPECT_TRUE(target->discarded.empty());
+}
+
+TEST(TaskInjectStorage, preparedStorageIsDroppedOnInterrupt) {
+  auto provider = std::make_shared<StorageProvider>();
+  auto target = std::make_shared<TestStorage>();
+  auto blackboard = std::make_shared<Blackboard>();
+
+  provider->insert(createStorage(L"/a.cpp"));
+  provider->insert(createStorage(L"/b.cpp"));
+  provider->insert(createStorage(L"/c.cpp"));
+
+  TaskInjectStorage task(provider, target);
+  // injects the first storage and prepares the second one
+  EXPECT_EQ(Task::STATE_SUCCESS, task.update(blackboard));
+
+  MessageIndexingInterrupted message;
+  static_cast<MessageListenerBase&>(task).handleMessageBase(&message);
+
+  EXPECT_EQ(Task::STATE_FAILURE, task.update(blackboard));
+  EXPECT_EQ(Task::STATE_FAILURE, task.update(blackboard));
+
+  EXPECT_EQ(1u, target->getStorageFiles().size());
+  EXPECT_EQ(0, provider->getStorageCount());
+  EXPECT_EQ(2u, target->prepared.size());
+  EXPECT_EQ(1u, target->discarded.size());
+}
+
+TEST(TaskInjectStorage, resetTaskInjectsStoragesProvidedAfterInterrupt) {
+  auto provider = std::make_shared<StorageProvider>();
+  auto target = std::make_shared<TestStorage>();
+  auto blackboard = std::make_shared<Blackboard>();
+
+  TaskInjectStorage task(provider, target);
+  MessageIndexingInterrupted message;
+  static_cast<MessageListenerBase&>(task).handleMessageBase(&message);
+  EXPECT_EQ(Task::STATE_FAILURE, task.update(blackboard));
+
+  task.reset(blackboard);
+  provider->insert(createStorage(L"/a.cpp"));
+  EXPECT_EQ(Task::STATE_SUCCESS, task.update(blackboard));
+  EXPECT_EQ(1u, target->getStorageFiles().size());
+}
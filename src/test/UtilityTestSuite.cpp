@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include "FilePath.h"
 #include "utility.h"
+#include "utilityFile.h"
+#include "utilityHash.h"
 
 TEST(utility, trimBlankSpacesOfString) {
   EXPECT_TRUE(utility::trim(" foo  ") == "foo");
@@ -9,3 +12,23 @@ TEST(utility, trimBlankSpacesOfString) {
 TEST(utility, trimBlankSpacesOfWstring) {
   EXPECT_TRUE(utility::trim(L" foo  ") == L"foo");
 }
+
+TEST(utility, orderFilePathsByIndexingCostPutsLongestFirst) {
+  const std::vector<FilePath> filePaths = {
+      FilePath(L"/missing/a.cpp"), FilePath(L"/missing/b.cpp"), FilePath(L"/missing/c.cpp")};
+
+  // c.cpp has no record and is estimated at the average duration of the recorded files
+  const std::vector<FilePath> ordered = utility::orderFilePathsByIndexingCost(
+      filePaths, {{L"/missing/a.cpp", 10}, {L"/missing/b.cpp", 100}});
+
+  ASSERT_EQ(3U, ordered.size());
+  EXPECT_EQ(L"b.cpp", ordered[0].fileName());
+  EXPECT_EQ(L"c.cpp", ordered[1].fileName());
+  EXPECT_EQ(L"a.cpp", ordered[2].fileName());
+}
+
+TEST(utility, stableHashMatchesKnownValues) {
+  EXPECT_EQ(0xcbf29ce484222325ULL, utility::getStableHash(""));
+  EXPECT_EQ(0xaf63dc4c8601ec8cULL, utility::getStableHash("a"));
+  EXPECT_NE(utility::getStableHash("int a;\n"), utility::getStableHash("int b;\n"));
+}